@@ -28,9 +28,21 @@
 #include "AliCFGridSparse.h"
 #include "AliCFContainer.h"
 #include "TAxis.h"
+#include "TFile.h"
+#include "TList.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+#include "TROOT.h"
+#include "RVersion.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 //____________________________________________________________________
 ClassImp(AliCFContainer)
 
+Int_t AliCFContainer::fgMergeThreads = 1;
+
 //____________________________________________________________________
 AliCFContainer::AliCFContainer() : 
   AliCFFrame(),
@@ -203,12 +215,30 @@ AliCFContainer* AliCFContainer::MakeSlice(Int_t nSteps, const Int_t* steps,
   return out;
 }
 
+//____________________________________________________________________
+void AliCFContainer::SetMergeThreads(Int_t nThreads)
+{
+  //
+  // Sets the number of threads used in Merge (default 1).
+  // The grids are added on several threads, so ROOT's thread safety is
+  // switched on here, once, when more than one thread is requested.
+  //
+
+  fgMergeThreads = (nThreads > 0) ? nThreads : 1;
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+  if (fgMergeThreads > 1)
+    ROOT::EnableThreadSafety();
+#endif
+}
+
 //____________________________________________________________________
 Long64_t AliCFContainer::Merge(TCollection* list)
 {
   // Merge a list of AliCorrection objects with this (needed for
   // PROOF). 
   // Returns the number of merged objects (including this).
+  // With SetMergeThreads(n) the steps are distributed over n threads,
+  // each step being merged with all entries of the list.
 
   if (!list)
     return 0;
@@ -220,17 +250,131 @@ Long64_t AliCFContainer::Merge(TCollection* list)
   TObject* obj;
   
   Int_t count = 0;
+  if (fgMergeThreads <= 1 || fNStep <= 1) {
+    while ((obj = iter())) {
+      AliCFContainer* entry = dynamic_cast<AliCFContainer*> (obj);
+      if (entry == 0) 
+        continue;
+      this->Add(entry);
+      count++;
+    }
+    return count+1;
+  }
+
+  std::vector<const AliCFContainer*> entries;
   while ((obj = iter())) {
     AliCFContainer* entry = dynamic_cast<AliCFContainer*> (obj);
     if (entry == 0) 
       continue;
-    this->Add(entry);
     count++;
+    if ((entry->GetNStep()      != fNStep)    ||
+        (entry->GetNVar()       != GetNVar()) ||
+        (entry->GetNBinsTotal() != GetNBinsTotal())) {
+      AliError("Different number of steps/sensitive variables/grid elements: cannot add the containers");
+      continue;
+    }
+    entries.push_back(entry);
+  }
+
+  // the grids of the different steps are independent, each thread picks the next free step
+  std::atomic<Int_t> nextStep(0);
+  Int_t nThreads = TMath::Min(fgMergeThreads, fNStep);
+  std::vector<std::thread> threads;
+  for (Int_t ithread=0; ithread<nThreads; ithread++) {
+    threads.push_back(std::thread([this, &entries, &nextStep]() {
+      Int_t istep;
+      while ((istep = nextStep++) < fNStep) {
+        for (UInt_t ientry=0; ientry<entries.size(); ientry++)
+          fGrid[istep]->Add(entries[ientry]->GetGrid(istep));
+      }
+    }));
   }
+  for (UInt_t ithread=0; ithread<threads.size(); ithread++)
+    threads[ithread].join();
 
   return count+1;
 }
 
+//____________________________________________________________________
+Long64_t AliCFContainer::MergeFiles(const TCollection* fileNames, const Char_t* objectPath)
+{
+  //
+  // Merges the object objectPath of each file in the list fileNames (TObjString) with this,
+  // holding only one input in memory at a time.
+  // objectPath is a '/'-separated path through directories and collections
+  // (e.g. "PWGCF/histos/container").
+  // Returns the number of merged objects (including this).
+  //
+
+  if (!fileNames)
+    return 0;
+
+  TObjArray* tokens = TString(objectPath).Tokenize("/");
+  if (tokens->GetEntriesFast() == 0) {
+    AliError(Form("Invalid object path %s", objectPath));
+    delete tokens;
+    return 0;
+  }
+
+  Long64_t count = 1;
+  TIter nextFile(fileNames);
+  TObject* fileName;
+  while ((fileName = nextFile())) {
+    TFile* file = TFile::Open(fileName->GetName());
+    if (!file || file->IsZombie()) {
+      AliError(Form("Cannot open file %s", fileName->GetName()));
+      delete file;
+      continue;
+    }
+
+    // walk through the directories, then through the collections
+    TDirectory* dir = file;
+    TObject* top = 0;
+    TObject* obj = 0;
+    TCollection* parent = 0;
+    for (Int_t itoken=0; itoken<tokens->GetEntriesFast(); itoken++) {
+      const char* token = tokens->At(itoken)->GetName();
+      if (!top) {
+        TObject* entry = dir->Get(token);
+        if (entry && entry->InheritsFrom(TDirectory::Class())) {
+          dir = static_cast<TDirectory*>(entry);
+          continue;
+        }
+        top = obj = entry;
+      } else {
+        parent = dynamic_cast<TCollection*>(obj);
+        obj = parent ? parent->FindObject(token) : 0;
+      }
+      if (!obj)
+        break;
+    }
+
+    if (obj) {
+      TList list;
+      list.Add(obj);
+      count += Merge(&list) - 1;
+      list.Clear();
+    } else {
+      AliError(Form("Object %s not found in file %s", objectPath, fileName->GetName()));
+    }
+
+    // delete the input before opening the next file
+    if (obj && obj != top) {
+      if (parent->IsOwner())
+        obj = 0;
+      else
+        parent->Remove(obj);
+    }
+    delete obj;
+    if (top != obj)
+      delete top;
+    delete file;
+  }
+
+  delete tokens;
+  return count;
+}
+
 //____________________________________________________________________
 void AliCFContainer::Add(const AliCFContainer* aContainerToAdd, Double_t c)
 {
@@ -72,6 +72,10 @@ class AliCFContainer : public AliCFFrame
   //basic operations
   virtual void     Add(const AliCFContainer* aContainerToAdd, Double_t c=1.);
   virtual Long64_t Merge(TCollection* list);
+  virtual Long64_t MergeFiles(const TCollection* fileNames, const Char_t* objectPath);
+
+  static void  SetMergeThreads(Int_t nThreads); // number of threads used in Merge (default 1)
+  static Int_t GetMergeThreads() {return fgMergeThreads;}
 
   virtual TH1* Project (Int_t istep, Int_t ivar1, Int_t ivar2=-1 ,Int_t ivar3=-1) const;
   virtual AliCFContainer* MakeSlice(Int_t nVars, const Int_t* vars, const Double_t* varMin=0x0, const Double_t* varMax=0x0, Bool_t useBins=0) const ;
@@ -96,6 +100,8 @@ class AliCFContainer : public AliCFFrame
  private:
   Int_t    fNStep; //number of selection steps
   AliCFGridSparse **fGrid;//[fNStep]
+
+  static Int_t fgMergeThreads; // number of threads used in Merge
   
   ClassDef(AliCFContainer,5);
 };
@@ -0,0 +1,224 @@
+//
+// Class AliMixEventCache
+//
+// AliMixEventCache keeps already decoded mixing events in memory,
+// so that events which are mixed several times (once per buffer
+// slot or mix number) are read and decompressed from file only once.
+//
+
+
+#include "AliLog.h"
+#include "AliVEvent.h"
+#include "AliESDEvent.h"
+#include "AliAODEvent.h"
+
+#include "AliMixEventCache.h"
+
+ClassImp(AliMixEventCache)
+
+//_________________________________________________________________________________________________
+AliMixEventCache::AliMixEventCache(const char *name, Double_t maxSizeMB) : TNamed(name, "Mixing event cache"),
+   fMaxSize((Long64_t)(maxSizeMB * 1024 * 1024)),
+   fMaxEventsPerBin(0),
+   fSize(0),
+   fTick(0),
+   fNHits(0),
+   fNMisses(0),
+   fSlotOfEntry(),
+   fEventsInBin(),
+   fSlotEvent(),
+   fSlotEntry(),
+   fSlotSize(),
+   fSlotBin(),
+   fSlotLastUse(),
+   fFreeSlots()
+{
+   //
+   // Default constructor.
+   //
+   AliDebug(AliLog::kDebug + 5, "<-");
+   AliDebug(AliLog::kDebug + 5, "->");
+}
+
+//_________________________________________________________________________________________________
+AliMixEventCache::~AliMixEventCache()
+{
+   //
+   // Destructor
+   //
+   Reset();
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventCache::Reset()
+{
+   //
+   // Removes all cached events
+   //
+   for (UInt_t i = 0; i < fSlotEvent.size(); i++) delete fSlotEvent[i];
+   fSlotOfEntry.clear();
+   fEventsInBin.clear();
+   fSlotEvent.clear();
+   fSlotEntry.clear();
+   fSlotSize.clear();
+   fSlotBin.clear();
+   fSlotLastUse.clear();
+   fFreeSlots.clear();
+   fSize = 0;
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliMixEventCache::Restore(Long64_t entry, AliVEvent *ev)
+{
+   //
+   // Copies cached event with chain entry 'entry' to 'ev'.
+   // Returns kFALSE when event is not in cache
+   //
+   if (!ev) return kFALSE;
+   std::map<Long64_t, Int_t>::const_iterator it = fSlotOfEntry.find(entry);
+   if (it == fSlotOfEntry.end()) {
+      fNMisses++;
+      return kFALSE;
+   }
+   Int_t slot = it->second;
+   if (!AssignEvent(ev, fSlotEvent[slot])) {
+      fNMisses++;
+      return kFALSE;
+   }
+   fSlotLastUse[slot] = ++fTick;
+   fNHits++;
+   AliDebug(AliLog::kDebug + 3, Form("Entry %lld restored from slot %d", entry, slot));
+   return kTRUE;
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliMixEventCache::Store(Long64_t entry, Int_t binIndex, const AliVEvent *ev, Long64_t size)
+{
+   //
+   // Stores copy of event 'ev' (chain entry 'entry', pool bin 'binIndex').
+   // 'size' is uncompressed size of event in bytes (as returned by GetEntry)
+   //
+   if (!ev || entry < 0 || Contains(entry)) return kFALSE;
+   if (size <= 0 || size > fMaxSize) return kFALSE;
+
+   // free space
+   if (fMaxEventsPerBin > 0) {
+      while (fEventsInBin[binIndex] >= fMaxEventsPerBin) {
+         Int_t slot = FindLeastRecentlyUsed(binIndex);
+         if (slot < 0) break;
+         Evict(slot);
+      }
+   }
+   while (fSize + size > fMaxSize) {
+      Int_t slot = FindLeastRecentlyUsed(-1);
+      if (slot < 0) break;
+      Evict(slot);
+   }
+
+   AliVEvent *copy = CopyEvent(ev);
+   if (!copy) {
+      AliDebug(AliLog::kDebug + 1, Form("Event type %s is not supported", ev->ClassName()));
+      return kFALSE;
+   }
+
+   Int_t slot;
+   if (fFreeSlots.empty()) {
+      slot = (Int_t)fSlotEvent.size();
+      fSlotEvent.push_back(0);
+      fSlotEntry.push_back(-1);
+      fSlotSize.push_back(0);
+      fSlotBin.push_back(-1);
+      fSlotLastUse.push_back(0);
+   } else {
+      slot = fFreeSlots.back();
+      fFreeSlots.pop_back();
+   }
+   fSlotEvent[slot] = copy;
+   fSlotEntry[slot] = entry;
+   fSlotSize[slot] = size;
+   fSlotBin[slot] = binIndex;
+   fSlotLastUse[slot] = ++fTick;
+   fSlotOfEntry[entry] = slot;
+   fEventsInBin[binIndex]++;
+   fSize += size;
+   AliDebug(AliLog::kDebug + 3, Form("Entry %lld (bin %d, %lld B) stored in slot %d (total %.1f MB)", entry, binIndex, size, slot, GetSize()));
+   return kTRUE;
+}
+
+//_________________________________________________________________________________________________
+Int_t AliMixEventCache::FindLeastRecentlyUsed(Int_t binIndex) const
+{
+   //
+   // Returns least recently used slot (in pool bin 'binIndex' or in all
+   // bins when binIndex < 0). Returns -1 when there is no such slot
+   //
+   Int_t found = -1;
+   for (UInt_t i = 0; i < fSlotEntry.size(); i++) {
+      if (fSlotEntry[i] < 0) continue;
+      if (binIndex >= 0 && fSlotBin[i] != binIndex) continue;
+      if (found < 0 || fSlotLastUse[i] < fSlotLastUse[found]) found = i;
+   }
+   return found;
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventCache::Evict(Int_t slot)
+{
+   //
+   // Removes event in slot from cache
+   //
+   AliDebug(AliLog::kDebug + 3, Form("Evicting entry %lld from slot %d", fSlotEntry[slot], slot));
+   delete fSlotEvent[slot];
+   fSlotEvent[slot] = 0;
+   fSlotOfEntry.erase(fSlotEntry[slot]);
+   fEventsInBin[fSlotBin[slot]]--;
+   fSize -= fSlotSize[slot];
+   fSlotEntry[slot] = -1;
+   fSlotSize[slot] = 0;
+   fSlotBin[slot] = -1;
+   fFreeSlots.push_back(slot);
+}
+
+//_________________________________________________________________________________________________
+AliVEvent *AliMixEventCache::CopyEvent(const AliVEvent *ev)
+{
+   //
+   // Returns deep copy of event (ESD and AOD events are supported)
+   //
+   const AliESDEvent *esd = dynamic_cast<const AliESDEvent *>(ev);
+   if (esd) return new AliESDEvent(*esd);
+   const AliAODEvent *aod = dynamic_cast<const AliAODEvent *>(ev);
+   if (aod) return new AliAODEvent(*aod);
+   return 0;
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliMixEventCache::AssignEvent(AliVEvent *dest, const AliVEvent *src)
+{
+   //
+   // Copies content of event src to event dest (must be of same type)
+   //
+   AliESDEvent *esdDest = dynamic_cast<AliESDEvent *>(dest);
+   const AliESDEvent *esdSrc = dynamic_cast<const AliESDEvent *>(src);
+   if (esdDest && esdSrc) {
+      *esdDest = *esdSrc;
+      return kTRUE;
+   }
+   AliAODEvent *aodDest = dynamic_cast<AliAODEvent *>(dest);
+   const AliAODEvent *aodSrc = dynamic_cast<const AliAODEvent *>(src);
+   if (aodDest && aodSrc) {
+      *aodDest = *aodSrc;
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
+//_________________________________________________________________________________________________
+void AliMixEventCache::Print(Option_t *) const
+{
+   //
+   // Prints cache statistics
+   //
+   Double_t all = fNHits + fNMisses;
+   AliInfo(Form("%s : %d events, %.1f MB of %.1f MB, hits %lld (%.1f %%), misses %lld", GetName(), GetNEvents(), GetSize(), GetMaxSize(), fNHits, all > 0 ? 100.0 * fNHits / all : 0.0, fNMisses));
+}
@@ -0,0 +1,76 @@
+//
+// Class AliMixEventCache
+//
+// AliMixEventCache keeps already decoded mixing events in memory,
+// so that events which are mixed several times (once per buffer
+// slot or mix number) are read and decompressed from file only once.
+// Events are keyed by their entry in the mixing chain and accounted
+// per event pool bin. The cache is bounded by a memory budget (MB)
+// and an optional number of events per bin, the least recently used
+// event is dropped first.
+//
+
+#ifndef ALIMIXEVENTCACHE_H
+#define ALIMIXEVENTCACHE_H
+
+#include <map>
+#include <vector>
+
+#include <TNamed.h>
+
+class AliVEvent;
+class AliMixEventCache : public TNamed {
+
+public:
+   AliMixEventCache(const char *name = "mixEventCache", Double_t maxSizeMB = 256.0);
+   virtual ~AliMixEventCache();
+
+   virtual void      Print(Option_t *opt = "") const;
+
+   void              SetMaxSize(Double_t maxSizeMB) { fMaxSize = (Long64_t)(maxSizeMB * 1024 * 1024); }
+   void              SetMaxEventsPerBin(Int_t n) { fMaxEventsPerBin = n; }
+
+   Double_t          GetMaxSize() const { return fMaxSize / 1024. / 1024.; }
+   Int_t             GetMaxEventsPerBin() const { return fMaxEventsPerBin; }
+   Double_t          GetSize() const { return fSize / 1024. / 1024.; }
+   Int_t             GetNEvents() const { return (Int_t)fSlotOfEntry.size(); }
+   Long64_t          GetNHits() const { return fNHits; }
+   Long64_t          GetNMisses() const { return fNMisses; }
+
+   Bool_t            Contains(Long64_t entry) const { return fSlotOfEntry.find(entry) != fSlotOfEntry.end(); }
+   Bool_t            Restore(Long64_t entry, AliVEvent *ev);
+   Bool_t            Store(Long64_t entry, Int_t binIndex, const AliVEvent *ev, Long64_t size);
+   void              Reset();
+
+   static AliVEvent *CopyEvent(const AliVEvent *ev);
+   static Bool_t     AssignEvent(AliVEvent *dest, const AliVEvent *src);
+
+private:
+
+   Long64_t                 fMaxSize;          // memory budget (bytes)
+   Int_t                    fMaxEventsPerBin;  // max number of events per pool bin (<=0 no limit)
+
+   Long64_t                 fSize;             //! current size (bytes)
+   ULong64_t                fTick;             //! access counter used for LRU
+   Long64_t                 fNHits;            //! number of restored events
+   Long64_t                 fNMisses;          //! number of events not found in cache
+
+   std::map<Long64_t, Int_t> fSlotOfEntry;     //! chain entry -> slot
+   std::map<Int_t, Int_t>   fEventsInBin;      //! pool bin -> number of cached events
+   std::vector<AliVEvent *> fSlotEvent;        //! cached event
+   std::vector<Long64_t>    fSlotEntry;        //! chain entry of slot (-1 when free)
+   std::vector<Long64_t>    fSlotSize;         //! size of slot (bytes)
+   std::vector<Int_t>       fSlotBin;          //! pool bin of slot
+   std::vector<ULong64_t>   fSlotLastUse;      //! last access of slot
+   std::vector<Int_t>       fFreeSlots;        //! list of free slots
+
+   void                     Evict(Int_t slot);
+   Int_t                    FindLeastRecentlyUsed(Int_t binIndex) const;
+
+   AliMixEventCache(const AliMixEventCache &cache);
+   AliMixEventCache &operator=(const AliMixEventCache &cache);
+
+   ClassDef(AliMixEventCache, 1)
+};
+
+#endif
@@ -11,12 +11,14 @@
 #include <TChain.h>
 #include <TChainElement.h>
 #include <TSystem.h>
+#include <TObjString.h>
 
 #include "AliLog.h"
 #include "AliAnalysisManager.h"
 #include "AliInputEventHandler.h"
 
 #include "AliMixEventPool.h"
+#include "AliMixEventCache.h"
 #include "AliMixInputEventHandler.h"
 #include "AliMixInputHandlerInfo.h"
 
@@ -43,13 +45,16 @@ AliMixInputEventHandler::AliMixInputEventHandler(const Int_t size, const Int_t m
    fCurrentBinIndex(-1),
    fOfflineTriggerMask(0),
    fCurrentMixEntry(),
-   fCurrentEntryMainTree(0)
+   fCurrentEntryMainTree(0),
+   fEventCache(0),
+   fMixBranches()
 {
    //
    // Default constructor.
    //
    AliDebug(AliLog::kDebug + 10, "<-");
    SetMixNumber(mixNum);
+   fMixBranches.SetOwner(kTRUE);
    AliDebug(AliLog::kDebug + 10, "->");
 }
 
@@ -59,6 +64,7 @@ AliMixInputEventHandler::~AliMixInputEventHandler() {
    // Destructor
    //
    fMixTrees.Clear();
+   delete fEventCache;
 }
 
 //_____________________________________________________________________________
@@ -153,6 +159,7 @@ Bool_t AliMixInputEventHandler::Notify(const char *path)
    for (Int_t i = 0; i < fInputHandlers.GetEntries(); i++) {
       AliDebug(AliLog::kDebug + 5, Form("fInputHandlers[%d]", i));
       mixIHI = new AliMixInputHandlerInfo(fMixIntupHandlerInfoTmp->GetName(), fMixIntupHandlerInfoTmp->GetTitle());
+      if (fMixBranches.GetEntries() > 0) mixIHI->SetActiveBranches(&fMixBranches);
       if (doPrepareEntry) mixIHI->PrepareEntry(che, -1, (AliInputEventHandler *)InputEventHandler(i), fAnalysisType);
       AliDebug(AliLog::kDebug + 5, Form("chain[%d]->GetEntries() = %lld", i, mixIHI->GetChain()->GetEntries()));
       fMixTrees.Add(mixIHI);
@@ -245,7 +252,6 @@ Bool_t AliMixInputEventHandler::MixStd()
    AliDebug(AliLog::kDebug + 3, Form("++++++++++++++ BEGIN SETUP EVENT %lld +++++++++++++++++++", fEntryCounter));
    // reset mix number
    fNumberMixed = 0;
-   AliMixInputHandlerInfo *mihi = 0;
    Long64_t entryMix = 0, entryMixReal = 0;
    Int_t counter = 0;
    for (counter = 0; counter < mixNum; counter++) {
@@ -253,12 +259,11 @@ Bool_t AliMixInputEventHandler::MixStd()
       AliDebug(AliLog::kDebug + 5, Form("Handler[%d] entryMix %lld ", counter, entryMix));
       if (entryMix < 0) break;
       entryMixReal = entryMix;
-      mihi = (AliMixInputHandlerInfo *) fMixTrees.At(0);
       TChainElement *te = fMixIntupHandlerInfoTmp->GetEntryInTree(entryMix);
       if (!te) {
          AliError("te is null. this is error. tell to developer (#1)");
       } else {
-         if (fDoMixEventGetEntryAuto) mihi->PrepareEntry(te, entryMix, (AliInputEventHandler *)InputEventHandler(0), fAnalysisType);
+         if (fDoMixEventGetEntryAuto) PrepareMixedEntry(0, te, entryMix, entryMixReal, -1);
          // runs UserExecMix for all tasks
          fNumberMixed++;
          UserExecMixAllTasks(fEntryCounter, 1, fEntryCounter, entryMixReal, fNumberMixed);
@@ -328,7 +333,6 @@ Bool_t AliMixInputEventHandler::MixBuffer()
       }
    }
 
-   AliMixInputHandlerInfo *mihi = 0;
    Long64_t entryMix = 0, entryMixReal = 0;
    Int_t counter = 0;
    AliInputEventHandler *eh = 0;
@@ -348,14 +352,13 @@ Bool_t AliMixInputEventHandler::MixBuffer()
          break;
       }
       entryMixReal = entryMix;
-      mihi = (AliMixInputHandlerInfo *) fMixTrees.At(counter);
       TChainElement *te = fMixIntupHandlerInfoTmp->GetEntryInTree(entryMix);
       if (!te) {
          AliError("te is null. this is error. tell to developer (#1)");
       } else {
          fCurrentMixEntry.Enter(entryMixReal);
          AliDebug(AliLog::kDebug + 3, Form("Preparing InputEventHandler(%d)", counter));
-         if (fDoMixEventGetEntryAuto) mihi->PrepareEntry(te, entryMix, (AliInputEventHandler *)InputEventHandler(counter), fAnalysisType);
+         if (fDoMixEventGetEntryAuto) PrepareMixedEntry(counter, te, entryMix, entryMixReal, idEntryList);
          fNumberMixed++;
       }
       counter++;
@@ -452,10 +455,8 @@ Bool_t AliMixInputEventHandler::MixEventsMoreTimesWithOneEvent()
    if (fDoMixExtra) {
       if (elNum <= 2 * fMixNumber + 1) mixNum = elNum + 1;
    }
-   AliMixInputHandlerInfo *mihi = 0;
    Long64_t entryMix = 0, entryMixReal = 0;
    Int_t counter = 0;
-   mihi = (AliMixInputHandlerInfo *) fMixTrees.At(0);
    // fills num for main events
    for (counter = 0; counter < mixNum; counter++) {
       fCurrentMixEntry.Reset();
@@ -471,7 +472,7 @@ Bool_t AliMixInputEventHandler::MixEventsMoreTimesWithOneEvent()
          AliError("te is null. this is error. tell to developer (#2)");
       } else {
          fCurrentMixEntry.Enter(entryMixReal);
-         if (fDoMixEventGetEntryAuto) mihi->PrepareEntry(te, entryMix, (AliInputEventHandler *)InputEventHandler(0), fAnalysisType);
+         if (fDoMixEventGetEntryAuto) PrepareMixedEntry(0, te, entryMix, entryMixReal, idEntryList);
          // runs UserExecMix for all tasks
          fNumberMixed++;
          UserExecMixAllTasks(fEntryCounter, idEntryList, currentMainEntry, entryMixReal, fNumberMixed);
@@ -605,9 +606,8 @@ Bool_t AliMixInputEventHandler::GetEntryMixedEvent(Int_t id) {
    // (Should be used in UserExecMix() only)
    //
 
-   AliMixInputHandlerInfo *mihi = (AliMixInputHandlerInfo *) fMixTrees.At(id);
-
    Long64_t entryMix = fCurrentMixEntry.GetEntry(fCurrentMixEntry.GetN()-id-1);
+   Long64_t entryMixReal = entryMix;
    if(entryMix<0) {
       AliError(Form("GetEntryMixedEvent(%d) => entryMix<0 [1]",id));
       return kFALSE;
@@ -621,7 +621,79 @@ Bool_t AliMixInputEventHandler::GetEntryMixedEvent(Int_t id) {
       AliError(Form("GetEntryMixedEvent(%d) => entryMix<0 [2]",id));
       return kFALSE;
    }
-   mihi->PrepareEntry(te, entryMix, (AliInputEventHandler *)InputEventHandler(id), fAnalysisType);
+   return PrepareMixedEntry(id, te, entryMix, entryMixReal, fCurrentBinIndex);
+}
+
+//_____________________________________________________________________________
+Bool_t AliMixInputEventHandler::PrepareMixedEntry(Int_t id, TChainElement *te, Long64_t entryInTree, Long64_t entryChain, Int_t binIndex)
+{
+   //
+   // Prepares mixed event (chain entry 'entryChain') in input handler with id.
+   // When event cache is used and event is there, it is copied from memory
+   // and the per-event setup of the input handler (BeginEvent) is done on it,
+   // otherwise it is read from file and stored in cache
+   //
+   AliMixInputHandlerInfo *mihi = (AliMixInputHandlerInfo *) fMixTrees.At(id);
+   if (!mihi) return kFALSE;
+   AliInputEventHandler *eh = (AliInputEventHandler *)InputEventHandler(id);
+   if (fEventCache && IsEventCacheUsable(eh) && fEventCache->Restore(entryChain, eh->GetEvent())) {
+      AliDebug(AliLog::kDebug + 3, Form("Handler[%d] entry %lld taken from cache", id, entryChain));
+      eh->BeginEvent(entryInTree);
+      return kTRUE;
+   }
+   mihi->PrepareEntry(te, entryInTree, eh, fAnalysisType);
+   if (fEventCache && IsEventCacheUsable(eh)) fEventCache->Store(entryChain, binIndex, eh->GetEvent(), mihi->GetLastReadBytes());
+   return kTRUE;
+}
 
+//_____________________________________________________________________________
+Bool_t AliMixInputEventHandler::IsEventCacheUsable(AliInputEventHandler *eh) const
+{
+   //
+   // Only the event of the input handler is cached. Handlers which read
+   // per-event data from other trees (friends, MC) always read from file
+   //
+   if (!eh || !eh->GetEvent()) return kFALSE;
+   if (eh->MCEvent()) return kFALSE;
+   TTree *tree = eh->GetTree();
+   if (tree && tree->GetListOfFriends() && tree->GetListOfFriends()->GetEntries() > 0) return kFALSE;
    return kTRUE;
 }
+
+//_____________________________________________________________________________
+void AliMixInputEventHandler::SetEventCache(AliMixEventCache *const cache)
+{
+   //
+   // Sets cache of decoded mixed events, the handler takes its ownership
+   // (the previous cache is deleted)
+   //
+   if (cache == fEventCache) return;
+   delete fEventCache;
+   fEventCache = cache;
+}
+
+//_____________________________________________________________________________
+void AliMixInputEventHandler::UseEventCache(Double_t maxSizeMB, Int_t maxEventsPerBin)
+{
+   //
+   // Keeps decoded mixed events in memory (up to maxSizeMB and
+   // maxEventsPerBin events per pool bin), so events mixed several
+   // times are read from file only once
+   //
+   if (!fEventCache) fEventCache = new AliMixEventCache(Form("%sCache", GetName()), maxSizeMB);
+   fEventCache->SetMaxSize(maxSizeMB);
+   fEventCache->SetMaxEventsPerBin(maxEventsPerBin);
+}
+
+//_____________________________________________________________________________
+void AliMixInputEventHandler::AddMixBranch(const char *name)
+{
+   //
+   // Declares branch needed by mixing tasks (e.g. "tracks", "header").
+   // When at least one branch is declared, only declared branches are read
+   // (and cached, see UseEventCache) for mixed events.
+   // Should be called before analysis starts
+   //
+   if (!name || fMixBranches.FindObject(name)) return;
+   fMixBranches.Add(new TObjString(name));
+}
@@ -21,6 +21,7 @@
 class TChain;
 class TChainElement;
 class AliMixEventPool;
+class AliMixEventCache;
 class AliMixInputHandlerInfo;
 class AliInputEventHandler;
 class AliMixInputEventHandler : public AliMultiInputEventHandler {
@@ -71,6 +72,11 @@ public:
 
    void                    DoMixEventGetEntryAuto(Bool_t doAuto=kTRUE) { fDoMixEventGetEntryAuto = doAuto; }
 
+   void                    SetEventCache(AliMixEventCache *const cache);
+   AliMixEventCache       *GetEventCache() const { return fEventCache; }
+   void                    UseEventCache(Double_t maxSizeMB = 256.0, Int_t maxEventsPerBin = 0);
+   void                    AddMixBranch(const char *name);
+
    Bool_t                  GetEntryMainEvent();
    Bool_t                  GetEntryMixedEvent(Int_t idHandler=0);
 protected:
@@ -100,17 +106,22 @@ private:
    TEntryList fCurrentMixEntry;    //! array of mix entries currently used (user should touch)
    Long64_t fCurrentEntryMainTree; //! current entry in current tree (main event)
 
+   AliMixEventCache *fEventCache;  // cache of decoded mixed events, owned (null = no cache)
+   TObjArray fMixBranches;         // branches read for mixed events (empty = all)
+
    virtual Bool_t          MixStd();
    virtual Bool_t          MixBuffer();
    virtual Bool_t          MixEventsMoreTimesWithOneEvent();
    virtual Bool_t          MixEventsMoreTimesWithBuffer();
 
+   Bool_t                  PrepareMixedEntry(Int_t id, TChainElement *te, Long64_t entryInTree, Long64_t entryChain, Int_t binIndex);
+   Bool_t                  IsEventCacheUsable(AliInputEventHandler *eh) const;
    void                    UserExecMixAllTasks(Long64_t entryCounter, Int_t idEntryList, Long64_t entryMainReal, Long64_t entryMixReal, Int_t numMixed);
 
    AliMixInputEventHandler(const AliMixInputEventHandler &handler);
    AliMixInputEventHandler &operator=(const AliMixInputEventHandler &handler);
 
-   ClassDef(AliMixInputEventHandler, 5)
+   ClassDef(AliMixInputEventHandler, 6)
 };
 
 #endif
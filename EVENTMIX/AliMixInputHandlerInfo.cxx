@@ -11,6 +11,7 @@
 #include <TChain.h>
 #include <TFile.h>
 #include <TChainElement.h>
+#include <TObjArray.h>
 
 #include "AliLog.h"
 #include "AliInputEventHandler.h"
@@ -24,7 +25,9 @@ AliMixInputHandlerInfo::AliMixInputHandlerInfo(const char *name, const char *tit
    fChain(0),
    fChainEntriesArray(),
    fZeroEntryNumber(0),
-   fNeedNotify(kFALSE)
+   fNeedNotify(kFALSE),
+   fActiveBranches(0),
+   fLastReadBytes(0)
 {
    //
    // Default constructor.
@@ -121,6 +124,7 @@ void AliMixInputHandlerInfo::PrepareEntry(TChainElement *te, Long64_t entry, Ali
    // Prepare Entry
    //
    AliDebug(AliLog::kDebug + 5, Form("<- %lld", entry));
+   fLastReadBytes = 0;
    if (!te) {
       AliDebug(AliLog::kDebug + 5, "-> te is null");
       return;
@@ -133,6 +137,7 @@ void AliMixInputHandlerInfo::PrepareEntry(TChainElement *te, Long64_t entry, Ali
          fChain->GetEntry(0);
          eh->Init(opt);
          eh->Init(fChain->GetTree(), opt);
+         ApplyBranchStatus();
       }
       fNeedNotify = kTRUE;
       AliDebug(AliLog::kDebug + 5, "->");
@@ -151,8 +156,9 @@ void AliMixInputHandlerInfo::PrepareEntry(TChainElement *te, Long64_t entry, Ali
          fChain->GetEntry(0);
          eh->Init(opt);
          eh->Init(fChain->GetTree(), opt);
+         ApplyBranchStatus();
          eh->Notify(te->GetTitle());
-         fChain->GetEntry(entry);
+         fLastReadBytes = fChain->GetEntry(entry);
          eh->BeginEvent(entry);
          fNeedNotify = kFALSE;
       } else {
@@ -160,7 +166,7 @@ void AliMixInputHandlerInfo::PrepareEntry(TChainElement *te, Long64_t entry, Ali
          if (fNeedNotify) eh->Notify(te->GetTitle());
          fNeedNotify = kFALSE;
          AliDebug(AliLog::kDebug, Form("Entry is %lld  fChain->GetEntries %lld ...", entry, fChain->GetEntries()));
-         fChain->GetEntry(entry);
+         fLastReadBytes = fChain->GetEntry(entry);
          eh->BeginEvent(entry);
          // file is in tree fChain already
       }
@@ -171,6 +177,20 @@ void AliMixInputHandlerInfo::PrepareEntry(TChainElement *te, Long64_t entry, Ali
    AliDebug(AliLog::kDebug + 5, "->");
 }
 
+//_____________________________________________________________________________
+void AliMixInputHandlerInfo::ApplyBranchStatus()
+{
+   //
+   // Reads only branches needed by mixing tasks (if any was declared)
+   //
+   if (!fChain || !fActiveBranches || fActiveBranches->GetEntries() == 0) return;
+   fChain->SetBranchStatus("*", 0);
+   for (Int_t i = 0; i < fActiveBranches->GetEntries(); i++) {
+      AliDebug(AliLog::kDebug + 1, Form("Enabling branch %s", fActiveBranches->At(i)->GetName()));
+      fChain->SetBranchStatus(fActiveBranches->At(i)->GetName(), 1);
+   }
+}
+
 //_____________________________________________________________________________
 Long64_t AliMixInputHandlerInfo::GetEntries()
 {
@@ -14,6 +14,7 @@
 
 class TTree;
 class TChain;
+class TObjArray;
 class TChainElement;
 class AliInputEventHandler;
 class AliMixInputHandlerInfo : public TNamed {
@@ -33,11 +34,18 @@ public:
    TChainElement *GetEntryInTree(Long64_t &entry);
    Long64_t      GetEntries();
 
+   void SetActiveBranches(const TObjArray *branches) { fActiveBranches = branches; }
+   Int_t GetLastReadBytes() const { return fLastReadBytes; }
+
 private:
    TChain    *fChain;              // current chain
    TArrayI   fChainEntriesArray;   // array of entries of every chaing
    Long64_t  fZeroEntryNumber;     // zero entry number (will be used when we will delete not needed chains)
    Bool_t    fNeedNotify;          // flag if Notify is needed for current input handler
+   const TObjArray *fActiveBranches; //! branches to read (all when null or empty)
+   Int_t     fLastReadBytes;       //! bytes read by last PrepareEntry
+
+   void ApplyBranchStatus();
 
    AliMixInputHandlerInfo(const AliMixInputHandlerInfo &handler);
    AliMixInputHandlerInfo &operator=(const AliMixInputHandlerInfo &handler);
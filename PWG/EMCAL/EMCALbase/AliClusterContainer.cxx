@@ -391,6 +391,21 @@ Int_t AliClusterContainer::GetNAcceptedClusters() const
   return nClus;
 }
 
+/**
+ * Selection key of the container, extending the key of the EMCAL container
+ * with the cluster cuts and the cluster energy used for the momentum.
+ * @param[out] key Selection key
+ * @return True if the key contains all cuts of the container
+ */
+Bool_t AliClusterContainer::GetSelectionKey(TString &key) const
+{
+  AliEmcalContainer::GetSelectionKey(key);
+  key += TString::Format("|%.17g|%.17g|%d|%d|%d|%d|%.17g", fClusTimeCutLow, fClusTimeCutUp, fExoticCut,
+      fDefaultClusterEnergy, fIncludePHOS, fPhosMinNcells, fPhosMinM02);
+  for (Int_t i = 0; i <= AliVCluster::kLastUserDefEnergy; i++) key += TString::Format("|%.17g", fUserDefEnergyCut[i]);
+  return IsA() == AliClusterContainer::Class();
+}
+
 /**
  * Get the energy cut of the applied on cluster energy of type t
  * @param t Cluster energy type (base energy, non-linearity corrected energy, hadronically corrected energy)
@@ -41,6 +41,7 @@ class AliClusterContainer : public AliEmcalContainer {
   virtual Bool_t              AcceptCluster(Int_t i, UInt_t &rejectionReason)                 const;
   virtual Bool_t              AcceptCluster(const AliVCluster* vp, UInt_t &rejectionReason)   const;
   virtual Bool_t              ApplyClusterCuts(const AliVCluster* clus, UInt_t &rejectionReason) const;
+  virtual Bool_t              GetSelectionKey(TString &key) const;
   AliVCluster                *GetAcceptCluster(Int_t i)              const;
   AliVCluster                *GetAcceptClusterWithLabel(Int_t lab)   const;
   void                        SetClusECut(Double_t cut)                    { SetMinE(cut)     ; }
@@ -12,7 +12,11 @@
  * about the suitability of this software for any purpose. It is          *
  * provided "as is" without express or implied warranty.                  *
  **************************************************************************/
+#include <map>
+#include <string>
+
 #include <TClonesArray.h>
+#include "AliAnalysisManager.h"
 #include "AliVEvent.h"
 #include "AliLog.h"
 #include "AliNamedArrayI.h"
@@ -25,6 +29,11 @@
 ClassImp(AliEmcalContainer);
 /// \endcond
 
+namespace {
+/// Accepted objects of the current event, by selection key (see AliEmcalContainer::GetAcceptedCache)
+std::map<std::string, std::shared_ptr<EMCALIterableContainer::accepted_cache> > gAcceptedCaches;
+}
+
 /**
  * Default constructor. This constructor is only for ROOT I/O and
  * not to be used by users. The container will not connect to an
@@ -48,6 +57,7 @@ AliEmcalContainer::AliEmcalContainer():
   fMinMCLabel(-1),
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
+  fAcceptCacheMode(kNoAcceptCache),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
@@ -84,6 +94,7 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fMinMCLabel(-1),
   fMaxMCLabel(-1),
   fMassHypothesis(-1),
+  fAcceptCacheMode(kNoAcceptCache),
   fClArray(0),
   fCurrentID(0),
   fLabelMap(0),
@@ -297,6 +308,67 @@ const AliEmcalIterableMomentumContainer AliEmcalContainer::accepted_momentum() c
   return AliEmcalIterableMomentumContainer(this, true);
 }
 
+/**
+ * Key describing the selection of the container: two containers of the same
+ * class and with the same key accept the same objects, with the same momenta.
+ * Derived classes with additional cuts extend the key with their cuts and
+ * return true only if the container is of their own class, so that derived
+ * classes which do not extend the key are never cached.
+ * @param[out] key Selection key
+ * @return True if the key contains all cuts of the container
+ */
+Bool_t AliEmcalContainer::GetSelectionKey(TString &key) const
+{
+  key = TString::Format("%s|%s|%p|%s|%d|%u|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%d|%d|%.17g",
+      IsA()->GetName(), fClArrayName.Data(), static_cast<void*>(fClArray), fClassName.Data(),
+      fIsParticleLevel, fBitMap, fMinPt, fMaxPt, fMinE, fMaxE, fMinEta, fMaxEta, fMinPhi, fMaxPhi,
+      fMinMCLabel, fMaxMCLabel, fMassHypothesis);
+  return IsA() == AliEmcalContainer::Class();
+}
+
+/**
+ * Get the accepted objects of the current event from the cache, building
+ * the cache if it does not exist yet for the current analysis manager
+ * entry and the current selection. Caches of previous entries are dropped.
+ * @return Cache of the accepted objects, empty pointer if caching is
+ * disabled or not possible (no array, no analysis manager entry, or a
+ * selection not described by GetSelectionKey)
+ */
+std::shared_ptr<const EMCALIterableContainer::accepted_cache> AliEmcalContainer::GetAcceptedCache() const
+{
+  if (fAcceptCacheMode == kNoAcceptCache || !fClArray) return std::shared_ptr<const EMCALIterableContainer::accepted_cache>();
+
+  AliAnalysisManager *mgr = AliAnalysisManager::GetAnalysisManager();
+  Long64_t entry = mgr ? mgr->GetCurrentEntry() : -1;
+  if (entry < 0) return std::shared_ptr<const EMCALIterableContainer::accepted_cache>();
+
+  TString key;
+  if (!GetSelectionKey(key)) return std::shared_ptr<const EMCALIterableContainer::accepted_cache>();
+  if (fAcceptCacheMode == kPrivateAcceptCache) key += TString::Format("|%p", static_cast<const void*>(this));
+
+  auto found = gAcceptedCaches.find(key.Data());
+  if (found != gAcceptedCaches.end() && found->second->fEntry == entry) return found->second;
+
+  for (auto it = gAcceptedCaches.begin(); it != gAcceptedCaches.end(); ) {
+    if (it->second->fEntry != entry) it = gAcceptedCaches.erase(it);
+    else ++it;
+  }
+
+  auto cache = std::make_shared<EMCALIterableContainer::accepted_cache>();
+  cache->fEntry = entry;
+  AliTLorentzVector mom;
+  for (Int_t index = 0; index < GetNEntries(); index++) {
+    UInt_t rejectionReason = 0;
+    if (!AcceptObject(index, rejectionReason)) continue;
+    GetMomentum(mom, index);
+    cache->fIndices.push_back(index);
+    cache->fMomenta.push_back(mom);
+  }
+  gAcceptedCaches[key.Data()] = cache;
+
+  return cache;
+}
+
 /**
  * Calculates the relative phi between two angle values and returns it in [-Pi, +Pi] range.
  * @param mphi First angle value
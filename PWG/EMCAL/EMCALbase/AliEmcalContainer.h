@@ -70,6 +70,20 @@ typedef EMCALIterableContainer::AliEmcalIterableContainerT<TObject, EMCALIterabl
  * }
  * ~~~
  *
+ * Building the list of accepted objects runs the full selection on every object
+ * of the array. When the same accepted objects are iterated several times per event,
+ * possibly by different tasks, the list can be cached (SetAcceptCacheMode):
+ * - kPrivateAcceptCache: the accepted indices and momenta are built once per event
+ *   and container and reused by all following calls of accepted() and accepted_momentum()
+ * - kSharedAcceptCache: in addition, the cache is shared between all containers of
+ *   the same class, connected to the same array and with the same selection, e.g.
+ *   containers with identical cuts in different tasks of a train
+ * The cache is rebuilt when the analysis manager moves to the next entry or the
+ * selection changes. The objects must not be modified while the cache is used
+ * (with kSharedAcceptCache, also by tasks executed in between), otherwise the cached
+ * selection and momenta are out of date. Derived classes with additional cuts have
+ * to include them in GetSelectionKey in order to use the cache.
+ *
  * The usage of EMCAL containers is described under \subpage EMCALcontainers
  */
 class AliEmcalContainer : public TObject {
@@ -118,6 +132,16 @@ class AliEmcalContainer : public TObject {
     kOverlapTpcHole = 1<<29             ///<Cut  on the regions of acceptance with bad sectors 
   };
 
+  /**
+   * @enum EAcceptCacheMode_t
+   * @brief Caching of the accepted objects per event
+   */
+  enum EAcceptCacheMode_t {
+    kNoAcceptCache = 0,                  ///< Selection is run for every iterable container over accepted objects
+    kPrivateAcceptCache = 1,             ///< Accepted objects are cached per event for this container
+    kSharedAcceptCache = 2               ///< Accepted objects are cached per event and shared among containers with the same selection
+  };
+
   AliEmcalContainer();
   AliEmcalContainer(const char *name); 
   virtual ~AliEmcalContainer(){;}
@@ -169,6 +193,9 @@ class AliEmcalContainer : public TObject {
   void                        SetPhiLimits(Double_t min, Double_t max)  { fMaxPhi = max ; fMinPhi = min ; }
   void                        SetMassHypothesis(Double_t m)             { fMassHypothesis         = m   ; }
   void                        SetClassName(const char *clname);
+  void                        SetAcceptCacheMode(EAcceptCacheMode_t m)  { fAcceptCacheMode = m      ; }
+  EAcceptCacheMode_t          GetAcceptCacheMode()            const { return fAcceptCacheMode           ; }
+  virtual Bool_t              GetSelectionKey(TString &key) const;
 
   const char*                 GetName()                       const { return fName.Data()               ; }
   void                        SetName(const char* n)                { fName = n                         ; }
@@ -183,6 +210,8 @@ class AliEmcalContainer : public TObject {
 
   const AliEmcalIterableMomentumContainer   all_momentum() const;
   const AliEmcalIterableMomentumContainer   accepted_momentum() const;
+
+  std::shared_ptr<const EMCALIterableContainer::accepted_cache> GetAcceptedCache() const;
 #endif
 
  protected:
@@ -202,6 +231,7 @@ class AliEmcalContainer : public TObject {
   Int_t                       fMinMCLabel;              ///< minimum MC label
   Int_t                       fMaxMCLabel;              ///< maximum MC label
   Double_t                    fMassHypothesis;          ///< if < 0 it will use a PID mass when available
+  EAcceptCacheMode_t          fAcceptCacheMode;         ///< caching of the accepted objects per event
   TClonesArray               *fClArray;                 //!<! Pointer to array in input event
   Int_t                       fCurrentID;               //!<! current ID for automatic loops
   AliNamedArrayI             *fLabelMap;                //!<! Label-Index map
@@ -215,7 +245,7 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer& operator=(const AliEmcalContainer& other); // assignment
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalContainer,8);
+  ClassDef(AliEmcalContainer,9);
   /// \endcond
 };
 #endif
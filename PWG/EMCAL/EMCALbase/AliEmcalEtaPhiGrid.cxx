@@ -0,0 +1,180 @@
+/**************************************************************************
+ * Copyright(c) 1998-2016, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+#include <algorithm>
+
+#include <TMath.h>
+#include <TVector2.h>
+#include <TVector3.h>
+
+#include "AliVCluster.h"
+
+#include "AliEmcalEtaPhiGrid.h"
+
+const Int_t AliEmcalEtaPhiGrid::fgkMaxCells = 1000;
+
+/**
+ * Default constructor.
+ */
+AliEmcalEtaPhiGrid::AliEmcalEtaPhiGrid() :
+  fIds(),
+  fEta(),
+  fPhi(),
+  fUnbinned(),
+  fCellStart(),
+  fCellIds(),
+  fEtaMin(0),
+  fEtaWidth(1),
+  fNEta(1),
+  fPhiWidth(TMath::TwoPi()),
+  fNPhi(1)
+{
+}
+
+/**
+ * Remove all objects.
+ */
+void AliEmcalEtaPhiGrid::Clear()
+{
+  fIds.clear();
+  fEta.clear();
+  fPhi.clear();
+  fUnbinned.clear();
+  fCellStart.clear();
+  fCellIds.clear();
+}
+
+/**
+ * Add an object. Build() has to be called after the last object was added.
+ * @param id Index returned by GetCandidates
+ * @param eta Pseudorapidity of the object
+ * @param phi Azimuth of the object (any range)
+ */
+void AliEmcalEtaPhiGrid::Add(Int_t id, Double_t eta, Double_t phi)
+{
+  if (!TMath::Finite(eta) || !TMath::Finite(phi)) {
+    fUnbinned.push_back(id);
+    return;
+  }
+
+  fIds.push_back(id);
+  fEta.push_back(eta);
+  fPhi.push_back(TVector2::Phi_0_2pi(phi));
+}
+
+/**
+ * Sort the objects into cells.
+ * @param maxDistance Largest sqrt(deta^2 + dphi^2) that has to be found by GetCandidates
+ */
+void AliEmcalEtaPhiGrid::Build(Double_t maxDistance)
+{
+  // the cells are made slightly larger than maxDistance, so that rounding can
+  // never move an object within maxDistance beyond the neighbouring cell
+  const Double_t cellSize = maxDistance * (1 + 1e-6);
+
+  fEtaMin = 0;
+  fEtaWidth = 1;
+  fNEta = 1;
+  fPhiWidth = TMath::TwoPi();
+  fNPhi = 1;
+
+  if (!fIds.empty() && cellSize > 0 && TMath::Finite(cellSize)) {
+    const Double_t etaMin = *std::min_element(fEta.begin(), fEta.end());
+    const Double_t etaMax = *std::max_element(fEta.begin(), fEta.end());
+
+    fEtaMin = etaMin;
+    fEtaWidth = TMath::Max(cellSize, (etaMax - etaMin) / fgkMaxCells);
+    fNEta = TMath::Min(Int_t((etaMax - etaMin) / fEtaWidth) + 1, fgkMaxCells + 1);
+
+    fNPhi = TMath::Max(1, Int_t(TMath::Min(TMath::TwoPi() / cellSize, Double_t(fgkMaxCells))));
+    fPhiWidth = TMath::TwoPi() / fNPhi;
+  }
+
+  // counting sort, keeping the order of insertion within a cell
+  const Int_t nCells = fNEta * fNPhi;
+  const Int_t n = fIds.size();
+  std::vector<Int_t> cellOf(n);
+  fCellStart.assign(nCells + 1, 0);
+  for (Int_t i = 0; i < n; i++) {
+    const Int_t ieta = fNEta > 1 ? TMath::Min(Int_t((fEta[i] - fEtaMin) / fEtaWidth), fNEta - 1) : 0;
+    const Int_t iphi = TMath::Min(Int_t(fPhi[i] / fPhiWidth), fNPhi - 1);
+    cellOf[i] = ieta * fNPhi + iphi;
+    fCellStart[cellOf[i] + 1]++;
+  }
+  for (Int_t icell = 0; icell < nCells; icell++) {
+    fCellStart[icell + 1] += fCellStart[icell];
+  }
+
+  fCellIds.resize(n);
+  std::vector<Int_t> next(fCellStart.begin(), fCellStart.end() - 1);
+  for (Int_t i = 0; i < n; i++) {
+    fCellIds[next[cellOf[i]]++] = fIds[i];
+  }
+}
+
+/**
+ * Get the indices of the objects which may be within the maximum distance
+ * of the point (eta, phi), in ascending order.
+ * @param eta Pseudorapidity of the point
+ * @param phi Azimuth of the point (any range)
+ * @param ids Output: indices of the candidate objects
+ */
+void AliEmcalEtaPhiGrid::GetCandidates(Double_t eta, Double_t phi, std::vector<Int_t> &ids) const
+{
+  ids.clear();
+
+  if (!TMath::Finite(eta) || !TMath::Finite(phi) || (fNEta == 1 && fNPhi == 1)) {
+    // no cell can be excluded
+    ids = fCellIds;
+  }
+  else if (!fCellIds.empty()) {
+    const Double_t etaCell = TMath::Floor((eta - fEtaMin) / fEtaWidth);
+    if (etaCell >= -1 && etaCell <= fNEta) {
+      const Int_t ieta = Int_t(etaCell);
+      const Int_t iphi = TMath::Min(Int_t(TVector2::Phi_0_2pi(phi) / fPhiWidth), fNPhi - 1);
+
+      for (Int_t jeta = TMath::Max(ieta - 1, 0); jeta <= TMath::Min(ieta + 1, fNEta - 1); jeta++) {
+        if (fNPhi <= 3) {
+          // all phi cells are neighbours
+          ids.insert(ids.end(), fCellIds.begin() + fCellStart[jeta * fNPhi], fCellIds.begin() + fCellStart[(jeta + 1) * fNPhi]);
+          continue;
+        }
+        for (Int_t dphi = -1; dphi <= 1; dphi++) {
+          const Int_t jphi = (iphi + dphi + fNPhi) % fNPhi;
+          const Int_t icell = jeta * fNPhi + jphi;
+          ids.insert(ids.end(), fCellIds.begin() + fCellStart[icell], fCellIds.begin() + fCellStart[icell + 1]);
+        }
+      }
+    }
+  }
+
+  ids.insert(ids.end(), fUnbinned.begin(), fUnbinned.end());
+  std::sort(ids.begin(), ids.end());
+}
+
+/**
+ * Cluster position as used in the cluster-track matching
+ * (AliEmcalCorrectionComponent::GetEtaPhiDiff).
+ * @param cluster EMCal cluster
+ * @param eta Output: pseudorapidity of the cluster position
+ * @param phi Output: azimuth of the cluster position
+ */
+void AliEmcalEtaPhiGrid::GetClusterEtaPhi(const AliVCluster *cluster, Double_t &eta, Double_t &phi)
+{
+  Float_t pos[3] = {0};
+  cluster->GetPosition(pos);
+  TVector3 cpos(pos);
+  eta = cpos.Eta();
+  phi = cpos.Phi();
+}
@@ -0,0 +1,68 @@
+#ifndef ALIEMCALETAPHIGRID_H
+#define ALIEMCALETAPHIGRID_H
+/* Copyright(c) 1998-2016, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+#include <Rtypes.h>
+#include <vector>
+
+class AliVCluster;
+
+/**
+ * @class AliEmcalEtaPhiGrid
+ * @brief Cell grid in (eta, phi) for geometrical cluster-track matching
+ * @ingroup EMCALCOREFW
+ * @since Oct 18, 2026
+ *
+ * Objects (usually clusters) are added with their index and (eta, phi) and
+ * sorted into cells of at least the maximum matching distance in both
+ * directions; the phi cells wrap around at 2pi. A query for a point
+ * (usually the track position on the EMCal surface) returns the indices of
+ * all objects in the cell of the point and its neighbours, which contain
+ * every object within the maximum distance. The indices are returned in
+ * ascending order, so a loop over the candidates visits the objects in the
+ * same order as a loop over all objects.
+ *
+ * ~~~{.cxx}
+ * grid.Clear();
+ * for (Int_t icl = 0; icl < ncl; icl++) {
+ *   Double_t eta = 0, phi = 0;
+ *   AliEmcalEtaPhiGrid::GetClusterEtaPhi(cluster[icl], eta, phi);
+ *   grid.Add(icl, eta, phi);
+ * }
+ * grid.Build(maxDistance);
+ * grid.GetCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), candidates);
+ * ~~~
+ *
+ * Objects and query points with non-finite coordinates are never excluded.
+ */
+class AliEmcalEtaPhiGrid {
+public:
+  AliEmcalEtaPhiGrid();
+  virtual ~AliEmcalEtaPhiGrid() {}
+
+  void        Clear();
+  void        Add(Int_t id, Double_t eta, Double_t phi);
+  void        Build(Double_t maxDistance);
+  void        GetCandidates(Double_t eta, Double_t phi, std::vector<Int_t> &ids) const;
+  Int_t       GetNEntries() const { return fIds.size(); }
+
+  static void GetClusterEtaPhi(const AliVCluster *cluster, Double_t &eta, Double_t &phi);
+
+protected:
+  static const Int_t fgkMaxCells;      ///< maximum number of cells per direction
+
+  std::vector<Int_t>    fIds;          ///< indices of the added objects
+  std::vector<Double_t> fEta;          ///< eta of the added objects
+  std::vector<Double_t> fPhi;          ///< phi of the added objects, in [0, 2pi)
+  std::vector<Int_t>    fUnbinned;     ///< objects with non-finite coordinates, candidates for every query
+  std::vector<Int_t>    fCellStart;    ///< first entry of each cell in fCellIds (fNEta*fNPhi+1 entries)
+  std::vector<Int_t>    fCellIds;      ///< object indices ordered by cell
+  Double_t              fEtaMin;       ///< lower edge of the first eta cell
+  Double_t              fEtaWidth;     ///< width of the eta cells
+  Int_t                 fNEta;         ///< number of eta cells
+  Double_t              fPhiWidth;     ///< width of the phi cells
+  Int_t                 fNPhi;         ///< number of phi cells
+};
+
+#endif
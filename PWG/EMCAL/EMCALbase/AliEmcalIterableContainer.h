@@ -6,6 +6,7 @@
  * See cxx source for full Copyright notice                               */
 
 #include <iterator>
+#include <memory>
 #include <vector>
 #include <type_traits>
 #include <TArrayI.h>
@@ -28,6 +29,21 @@ class AliEmcalContainer;
 
 namespace EMCALIterableContainer {
 
+/**
+ * @struct accepted_cache
+ * @brief Accepted objects of an EMCAL container in one event
+ * @ingroup EMCALCOREFW
+ *
+ * Indices of the accepted objects and their momenta, built once per event by
+ * AliEmcalContainer::GetAcceptedCache and used by all iterable containers over
+ * accepted objects created in that event with the same selection.
+ */
+struct accepted_cache {
+  Long64_t                        fEntry;     ///< analysis manager entry the cache was built for
+  std::vector<int>                fIndices;   ///< indices of the accepted objects
+  std::vector<AliTLorentzVector>  fMomenta;   ///< momenta of the accepted objects
+};
+
 template <typename T>
 class operator_star_pair {
 public:
@@ -150,7 +166,7 @@ public:
       }
       else {
         this->fCurrentElement.second = (*fkData)[fCurrent];
-        fkData->GetContainer()->GetMomentum(this->fCurrentElement.first, fkData->GetInternalIndex(fCurrent));
+        fkData->GetMomentum(this->fCurrentElement.first, fCurrent);
       }
     }
   };
@@ -216,15 +232,22 @@ private:
   const AliEmcalContainer     *fkContainer;         ///< Container to be iterated over
   TArrayI                     fAcceptIndices;       ///< Array of accepted indices
   Bool_t                      fUseAccepted;         ///< Switch between accepted and all objects
+  std::shared_ptr<const accepted_cache> fAcceptCache; ///< Per-event cache of accepted objects (if enabled in the container)
 
   inline int GetInternalIndex(int index) const {
     if (fUseAccepted) {
+      if (fAcceptCache) return index < 0 || index >= int(fAcceptCache->fIndices.size()) ? -1 : fAcceptCache->fIndices[index];
       return index < 0 || index >= fAcceptIndices.GetSize() ? -1 : fAcceptIndices[index];
     }
     else {
       return index;
     }
   }
+
+  inline void GetMomentum(AliTLorentzVector &mom, int index) const {
+    if (fUseAccepted && fAcceptCache) mom = fAcceptCache->fMomenta[index];
+    else fkContainer->GetMomentum(mom, GetInternalIndex(index));
+  }
 };
 }
 
@@ -242,14 +265,16 @@ template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT():
   fkContainer(NULL),
   fAcceptIndices(),
-  fUseAccepted(kFALSE)
+  fUseAccepted(kFALSE),
+  fAcceptCache()
 {
 
 }
 
 /**
  * Standard constructor, to be used by the users. Specifying the type of iteration (all vs. accepted).
- * In case the iterator runs over accepted object, an index map is build inside the constructor.
+ * In case the iterator runs over accepted object, an index map is build inside the constructor,
+ * unless the container provides a cache of the accepted objects for the current event.
  * @param[in] cont EMCAL container to iterate over
  * @param[in] useAccept If true accepted objects are used in the iteration, otherwise all objects
  */
@@ -257,9 +282,13 @@ template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT(const AliEmcalContainer *cont, bool useAccept):
   fkContainer(cont),
   fAcceptIndices(),
-  fUseAccepted(useAccept)
+  fUseAccepted(useAccept),
+  fAcceptCache()
 {
-  if (fUseAccepted) BuildAcceptIndices();
+  if (fUseAccepted) {
+    fAcceptCache = fkContainer->GetAcceptedCache();
+    if (!fAcceptCache) BuildAcceptIndices();
+  }
 }
 
 /**
@@ -271,7 +300,8 @@ template <typename T, typename STAR>
 AliEmcalIterableContainerT<T, STAR>::AliEmcalIterableContainerT(const AliEmcalIterableContainerT<T, STAR> &ref):
   fkContainer(ref.fkContainer),
   fAcceptIndices(ref.fAcceptIndices),
-  fUseAccepted(ref.fUseAccepted)
+  fUseAccepted(ref.fUseAccepted),
+  fAcceptCache(ref.fAcceptCache)
 {
 
 }
@@ -288,6 +318,7 @@ AliEmcalIterableContainerT<T, STAR> &AliEmcalIterableContainerT<T, STAR>::operat
     fkContainer = ref.fkContainer;
     fAcceptIndices = ref.fAcceptIndices;
     fUseAccepted = ref.fUseAccepted;
+    fAcceptCache = ref.fAcceptCache;
   }
   return *this;
 }
@@ -299,7 +330,8 @@ AliEmcalIterableContainerT<T, STAR> &AliEmcalIterableContainerT<T, STAR>::operat
  */
 template <typename T, typename STAR>
 int AliEmcalIterableContainerT<T, STAR>::GetEntries() const {
-  return fUseAccepted ? fAcceptIndices.GetSize() : fkContainer->GetNEntries();
+  if (!fUseAccepted) return fkContainer->GetNEntries();
+  return fAcceptCache ? int(fAcceptCache->fIndices.size()) : fAcceptIndices.GetSize();
 }
 
 /**
@@ -328,16 +360,17 @@ T *AliEmcalIterableContainerT<T, STAR>::operator[](int index) const {
 /**
  * Build list of accepted indices inside the container.
  * For this all objects inside the container are checked
- * for being accepted or not.
+ * for being accepted or not (once per object).
  */
 template <typename T, typename STAR>
 void AliEmcalIterableContainerT<T, STAR>::BuildAcceptIndices(){
-  fAcceptIndices.Set(fkContainer->GetNAcceptEntries());
+  fAcceptIndices.Set(fkContainer->GetNEntries());
   int acceptCounter = 0;
   for(int index = 0; index < fkContainer->GetNEntries(); index++){
     UInt_t rejectionReason = 0;
     if(fkContainer->AcceptObject(index, rejectionReason)) fAcceptIndices[acceptCounter++] = index;
   }
+  fAcceptIndices.Set(acceptCounter);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -194,6 +194,19 @@ Bool_t AliMCParticleContainer::ApplyMCParticleCuts(const AliAODMCParticle* vp, U
   return ApplyParticleCuts(vp, rejectionReason);
 }
 
+/**
+ * Selection key of the container, extending the key of the particle container
+ * with the MC flag selection.
+ * @param[out] key Selection key
+ * @return True if the key contains all cuts of the container
+ */
+Bool_t AliMCParticleContainer::GetSelectionKey(TString &key) const
+{
+  AliParticleContainer::GetSelectionKey(key);
+  key += TString::Format("|%u", fMCFlag);
+  return IsA() == AliMCParticleContainer::Class();
+}
+
 /**
  * Create an iterable container interface over all objects in the
  * EMCAL container.
@@ -35,6 +35,7 @@ class AliMCParticleContainer : public AliParticleContainer {
   virtual Bool_t              AcceptParticle(const AliVParticle* vp, UInt_t &rejectionReason) const { return AcceptMCParticle(dynamic_cast<const AliAODMCParticle*>(vp), rejectionReason);}
   virtual Bool_t              AcceptMCParticle(const AliAODMCParticle* vp, UInt_t &rejectionReason) const;
   virtual Bool_t              AcceptMCParticle(Int_t i, UInt_t &rejectionReason) const;
+  virtual Bool_t              GetSelectionKey(TString &key) const;
   virtual AliAODMCParticle   *GetMCParticleWithLabel(Int_t lab)         const;
   virtual AliAODMCParticle   *GetAcceptMCParticleWithLabel(Int_t lab)        ;
   virtual AliAODMCParticle   *GetLeadingMCParticle(const char* opt="")        { return static_cast<AliAODMCParticle*>(GetLeadingParticle(opt)); }
@@ -421,6 +421,19 @@ Int_t AliParticleContainer::GetNAcceptedParticles() const
   return nPart;
 }
 
+/**
+ * Selection key of the container, extending the key of the EMCAL container
+ * with the particle cuts.
+ * @param[out] key Selection key
+ * @return True if the key contains all cuts of the container
+ */
+Bool_t AliParticleContainer::GetSelectionKey(TString &key) const
+{
+  AliEmcalContainer::GetSelectionKey(key);
+  key += TString::Format("|%.17g|%d|%d", fMinDistanceTPCSectorEdge, fChargeCut, fGeneratorIndex);
+  return IsA() == AliParticleContainer::Class();
+}
+
 /**
  * Make a title of the container name based on the min \f$ p_{t} \f$ used
  * in the particle selection process.
@@ -47,6 +47,7 @@ class AliParticleContainer : public AliEmcalContainer {
   virtual Bool_t              AcceptObject(const TObject* obj, UInt_t &rejectionReason) const   { return AcceptParticle(dynamic_cast<const AliVParticle*>(obj), rejectionReason);}
   virtual Bool_t              AcceptParticle(const AliVParticle* vp, UInt_t &rejectionReason) const        ;
   virtual Bool_t              AcceptParticle(Int_t i, UInt_t &rejectionReason) const                       ;
+  virtual Bool_t              GetSelectionKey(TString &key) const;
   Double_t                    GetParticlePtCut()                        const   { return GetMinPt()     ; }
   Double_t                    GetParticleEtaMin()                       const   { return GetMinEta()    ; }
   Double_t                    GetParticleEtaMax()                       const   { return GetMaxEta()    ; }
@@ -513,6 +513,21 @@ Bool_t AliTrackContainer::ApplyTrackCuts(const AliVTrack* vp, UInt_t &rejectionR
   return ApplyParticleCuts(vp, rejectionReason);
 }
 
+/**
+ * Selection key of the container, extending the key of the particle container
+ * with the track selection. Track cut objects are identified by their address,
+ * hence containers with their own cut objects never share a cache.
+ * @param[out] key Selection key
+ * @return True if the key contains all cuts of the container
+ */
+Bool_t AliTrackContainer::GetSelectionKey(TString &key) const
+{
+  AliParticleContainer::GetSelectionKey(key);
+  key += TString::Format("|%d|%p|%d|%u|%s", fTrackFilterType, static_cast<void*>(fListOfCuts),
+      fSelectionModeAny, fAODFilterBits, fTrackCutsPeriod.Data());
+  return IsA() == AliTrackContainer::Class();
+}
+
 /**
  * Add new track cuts to the container.
  * @param[in] cuts Cuts to be  added
@@ -58,6 +58,7 @@ class AliTrackContainer : public AliParticleContainer {
   virtual AliVParticle       *GetNextParticle()                            { return GetNextTrack()        ; }
   virtual Bool_t              AcceptTrack(const AliVTrack* vp, UInt_t &rejectionReason)  const;
   virtual Bool_t              AcceptTrack(Int_t i, UInt_t &rejectionReason) const;
+  virtual Bool_t              GetSelectionKey(TString &key) const;
   virtual AliVTrack          *GetLeadingTrack(const char* opt="")          { return static_cast<AliVTrack*>(GetLeadingParticle(opt)); }
   virtual AliVTrack          *GetTrack(Int_t i=-1)                   const;
   virtual AliVTrack          *GetAcceptTrack(Int_t i=-1)             const;
@@ -18,6 +18,7 @@
 #include "AliEmcalParticle.h"
 #include "AliParticleContainer.h"
 #include "AliClusterContainer.h"
+#include "AliEmcalEtaPhiGrid.h"
 
 ClassImp(AliEmcalClusTrackMatcherTask)
 
@@ -37,7 +38,8 @@ AliEmcalClusTrackMatcherTask::AliEmcalClusTrackMatcherTask() :
   fNEmcalTracks(0),
   fNEmcalClusters(0),
   fHistMatchEtaAll(0),
-  fHistMatchPhiAll(0)
+  fHistMatchPhiAll(0),
+  fClusterGrid(0)
 {
   // Constructor.
 
@@ -67,7 +69,8 @@ AliEmcalClusTrackMatcherTask::AliEmcalClusTrackMatcherTask(const char *name, Boo
   fNEmcalTracks(0),
   fNEmcalClusters(0),
   fHistMatchEtaAll(0),
-  fHistMatchPhiAll(0)
+  fHistMatchPhiAll(0),
+  fClusterGrid(0)
 {
   // Standard constructor.
 
@@ -85,6 +88,8 @@ AliEmcalClusTrackMatcherTask::AliEmcalClusTrackMatcherTask(const char *name, Boo
 AliEmcalClusTrackMatcherTask::~AliEmcalClusTrackMatcherTask()
 {
   // Destructor.
+
+  delete fClusterGrid;
 }
 
 //________________________________________________________________________
@@ -283,11 +288,29 @@ void AliEmcalClusTrackMatcherTask::DoMatching()
 
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
+  // bin the clusters in (eta, phi), so that each track is only compared to
+  // the clusters in the neighbouring cells (in the same order as before)
+  if (!fClusterGrid) fClusterGrid = new AliEmcalEtaPhiGrid;
+  fClusterGrid->Clear();
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
+    Double_t ceta = 0;
+    Double_t cphi = 0;
+    AliEmcalEtaPhiGrid::GetClusterEtaPhi(emcalCluster->GetCluster(), ceta, cphi);
+    fClusterGrid->Add(icluster, ceta, cphi);
+  }
+  fClusterGrid->Build(fMaxDistance);
+
+  std::vector<Int_t> candidates;
+
   for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
     AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
     AliVTrack* track = emcalTrack->GetTrack();
 
-    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    fClusterGrid->GetCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), candidates);
+
+    for (UInt_t icand = 0; icand < candidates.size(); icand++) {
+      const Int_t icluster = candidates[icand];
       AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
       AliVCluster* cluster = emcalCluster->GetCluster();
 
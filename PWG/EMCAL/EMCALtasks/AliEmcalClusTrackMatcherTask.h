@@ -3,6 +3,8 @@
 
 #include "AliAnalysisTaskEmcal.h"
 
+class AliEmcalEtaPhiGrid;
+
 class AliEmcalClusTrackMatcherTask : public AliAnalysisTaskEmcal {
  public:
   AliEmcalClusTrackMatcherTask();
@@ -46,6 +48,7 @@ class AliEmcalClusTrackMatcherTask : public AliAnalysisTaskEmcal {
   TH1          *fHistMatchPhiAll;       //!dphi distribution
   TH1          *fHistMatchEta[10][9][2]; //!deta distribution
   TH1          *fHistMatchPhi[10][9][2]; //!dphi distribution
+  AliEmcalEtaPhiGrid *fClusterGrid;     //!(eta, phi) cells of the clusters, to find the matching candidates of a track
   
  private:
   AliEmcalClusTrackMatcherTask(const AliEmcalClusTrackMatcherTask&);            // not implemented
@@ -15,6 +15,7 @@
 #include "AliEmcalParticle.h"
 #include "AliEMCALGeometry.h"
 #include "AliMCEvent.h"
+#include "AliEmcalEtaPhiGrid.h"
 
 /// \cond CLASSIMP
 ClassImp(AliEmcalCorrectionClusterTrackMatcher);
@@ -44,7 +45,8 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fHistMatchEtaAll(0),
   fHistMatchPhiAll(0),
   fMCGenerToAcceptForTrack(1),
-  fNMCGenerToAccept(0)
+  fNMCGenerToAccept(0),
+  fClusterGrid(0)
 {
   for(Int_t icent=0; icent<8; ++icent) {
     for(Int_t ipt=0; ipt<9; ++ipt) {
@@ -63,6 +65,7 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
  */
 AliEmcalCorrectionClusterTrackMatcher::~AliEmcalCorrectionClusterTrackMatcher()
 {
+  delete fClusterGrid;
 }
 
 /**
@@ -307,11 +310,29 @@ void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
 {
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
+  // bin the clusters in (eta, phi), so that each track is only compared to
+  // the clusters in the neighbouring cells (in the same order as before)
+  if (!fClusterGrid) fClusterGrid = new AliEmcalEtaPhiGrid;
+  fClusterGrid->Clear();
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
+    Double_t ceta = 0;
+    Double_t cphi = 0;
+    AliEmcalEtaPhiGrid::GetClusterEtaPhi(emcalCluster->GetCluster(), ceta, cphi);
+    fClusterGrid->Add(icluster, ceta, cphi);
+  }
+  fClusterGrid->Build(fMaxDistance);
+
+  std::vector<Int_t> candidates;
+
   for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
     AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
     AliVTrack* track = emcalTrack->GetTrack();
 
-    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    fClusterGrid->GetCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), candidates);
+
+    for (UInt_t icand = 0; icand < candidates.size(); icand++) {
+      const Int_t icluster = candidates[icand];
       AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
       AliVCluster* cluster = emcalCluster->GetCluster();
       
@@ -7,6 +7,7 @@ class TH1;
 class TClonesArray;
 
 class AliVParticle;
+class AliEmcalEtaPhiGrid;
 
 /**
  * @class AliEmcalCorrectionClusterTrackMatcher
@@ -95,6 +96,8 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   Int_t      fNMCGenerToAccept;          ///<  Number of MC generators that should not be included in analysis
   TString    fMCGenerToAccept[5];        ///<  List with name of generators that should not be included
   Bool_t     fMCGenerToAcceptForTrack;   ///<  Activate the removal of tracks entering the track matching that come from a particular generator
+
+  AliEmcalEtaPhiGrid *fClusterGrid;      //!<! (eta, phi) cells of the clusters, to find the matching candidates of a track
   
 private:
   AliEmcalCorrectionClusterTrackMatcher(const AliEmcalCorrectionClusterTrackMatcher &);               // Not implemented
@@ -134,6 +134,8 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
  fUse2DHistograms(kFALSE),
  fFillProfilesVsMUsingWeights(kTRUE),
  fUseQvectorTerms(kFALSE),
+ fUseFastQVectors(kFALSE),
+ fUseQVectorRecurrence(kFALSE),
  fReQ(NULL),
  fImQ(NULL),
  fSpk(NULL),
@@ -374,6 +376,7 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  this->FillCommonControlHistograms(anEvent);                                                               
  this->FillAverageMultiplicities((Int_t)(fNumberOfRPsEBE)); 
  if(fStoreControlHistograms){this->FillControlHistograms(anEvent);}                                                              
+ if(fUseFastQVectors){this->PrepareDiffFlowBuffers();}
                                                                                                                                                                                                                                                                                         
  // d) Loop over data and calculate e-b-e quantities Q_{n,k}, S_{p,k} and s_{p,k}:
  Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
@@ -409,89 +412,95 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     {
      wTrack = aftsTrack->Weight(); 
     }
-    // Calculate Re[Q_{m*n,k}] and Im[Q_{m*n,k}] for this event (m = 1,2,...,12, k = 0,1,...,8):
-    for(Int_t m=0;m<12;m++) // to be improved - hardwired 6 
+    if(fUseFastQVectors) // same quantities as below, with cos/sin and weight powers evaluated only once for this particle:
     {
-     for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-     {
-      (*fReQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1)*n*dPhi); 
-      (*fImQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1)*n*dPhi); 
-     } 
-    }
-    // Calculate S_{p,k} for this event (Remark: final calculation of S_{p,k} follows after the loop over data bellow):
-    for(Int_t p=0;p<8;p++)
-    {
-     for(Int_t k=0;k<9;k++)
-     {     
-      (*fSpk)(p,k)+=pow(wPhi*wPt*wEta*wTrack,k);
-     }
-    } 
-    // Differential flow:
-    if(fCalculateDiffFlow || fCalculate2DDiffFlow)
-    {
-     ptEta[0] = dPt; 
-     ptEta[1] = dEta; 
-     // Calculate r_{m*n,k} and s_{p,k} (r_{m,k} is 'p-vector' for RPs): 
-     for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-     {
-      for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+     this->AccumulateQVectors(dPhi,dPt,dEta,wPhi*wPt*wEta*wTrack,0,aftsTrack->InPOISelection());
+    } else // to if(fUseFastQVectors)
       {
-       if(fCalculateDiffFlow)
+       // Calculate Re[Q_{m*n,k}] and Im[Q_{m*n,k}] for this event (m = 1,2,...,12, k = 0,1,...,8):
+       for(Int_t m=0;m<12;m++) // to be improved - hardwired 6 
        {
-        for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+        for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
         {
-         fReRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-         fImRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
-         if(m==0) // s_{p,k} does not depend on index m
-         {
-          fs1dEBE[0][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
-         } // end of if(m==0) // s_{p,k} does not depend on index m
-        } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
-       } // end of if(fCalculateDiffFlow) 
-       if(fCalculate2DDiffFlow)
+         (*fReQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1)*n*dPhi); 
+         (*fImQ)(m,k)+=pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1)*n*dPhi); 
+        } 
+       }
+       // Calculate S_{p,k} for this event (Remark: final calculation of S_{p,k} follows after the loop over data bellow):
+       for(Int_t p=0;p<8;p++)
        {
-        fReRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-        fImRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
-        if(m==0) // s_{p,k} does not depend on index m
-        {
-         fs2dEBE[0][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
-        } // end of if(m==0) // s_{p,k} does not depend on index m
-       } // end of if(fCalculate2DDiffFlow)
-      } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
-     } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-     // Checking if RP particle is also POI particle:      
-     if(aftsTrack->InPOISelection())
-     {
-      // Calculate q_{m*n,k} and s_{p,k} ('q-vector' and 's' for RPs && POIs): 
-      for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
-      {
-       for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+        for(Int_t k=0;k<9;k++)
+        {     
+         (*fSpk)(p,k)+=pow(wPhi*wPt*wEta*wTrack,k);
+        }
+       } 
+       // Differential flow:
+       if(fCalculateDiffFlow || fCalculate2DDiffFlow)
        {
-        if(fCalculateDiffFlow)
+        ptEta[0] = dPt; 
+        ptEta[1] = dEta; 
+        // Calculate r_{m*n,k} and s_{p,k} (r_{m,k} is 'p-vector' for RPs): 
+        for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
         {
-         for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+         for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
          {
-          fReRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-          fImRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
-          if(m==0) // s_{p,k} does not depend on index m
+          if(fCalculateDiffFlow)
           {
-           fs1dEBE[2][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
-          } // end of if(m==0) // s_{p,k} does not depend on index m
-         } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
-        } // end of if(fCalculateDiffFlow) 
-        if(fCalculate2DDiffFlow)
+           for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+           {
+            fReRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+            fImRPQ1dEBE[0][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+            if(m==0) // s_{p,k} does not depend on index m
+            {
+             fs1dEBE[0][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
+            } // end of if(m==0) // s_{p,k} does not depend on index m
+           } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
+          } // end of if(fCalculateDiffFlow) 
+          if(fCalculate2DDiffFlow)
+          {
+           fReRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+           fImRPQ2dEBE[0][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+           if(m==0) // s_{p,k} does not depend on index m
+           {
+            fs2dEBE[0][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
+           } // end of if(m==0) // s_{p,k} does not depend on index m
+          } // end of if(fCalculate2DDiffFlow)
+         } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+        } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
+        // Checking if RP particle is also POI particle:      
+        if(aftsTrack->InPOISelection())
         {
-         fReRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-         fImRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
-         if(m==0) // s_{p,k} does not depend on index m
+         // Calculate q_{m*n,k} and s_{p,k} ('q-vector' and 's' for RPs && POIs): 
+         for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
          {
-          fs2dEBE[2][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
-         } // end of if(m==0) // s_{p,k} does not depend on index m
-        } // end of if(fCalculate2DDiffFlow)
-       } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
-      } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9    
-     } // end of if(aftsTrack->InPOISelection())  
-    } // end of if(fCalculateDiffFlow || fCalculate2DDiffFlow)         
+          for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+          {
+           if(fCalculateDiffFlow)
+           {
+            for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+            {
+             fReRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+             fImRPQ1dEBE[2][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+             if(m==0) // s_{p,k} does not depend on index m
+             {
+              fs1dEBE[2][pe][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k),1.);
+             } // end of if(m==0) // s_{p,k} does not depend on index m
+            } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
+           } // end of if(fCalculateDiffFlow) 
+           if(fCalculate2DDiffFlow)
+           {
+            fReRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+            fImRPQ2dEBE[2][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+            if(m==0) // s_{p,k} does not depend on index m
+            {
+             fs2dEBE[2][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k),1.);
+            } // end of if(m==0) // s_{p,k} does not depend on index m
+           } // end of if(fCalculate2DDiffFlow)
+          } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+         } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9    
+        } // end of if(aftsTrack->InPOISelection())  
+       } // end of if(fCalculateDiffFlow || fCalculate2DDiffFlow)         
+      } // end of else // to if(fUseFastQVectors)
    } // end of if(pTrack->InRPSelection())
    if(aftsTrack->InPOISelection())
    {
@@ -519,28 +528,34 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     {
      wTrack = aftsTrack->Weight(); 
     }
-    ptEta[0] = dPt;
-    ptEta[1] = dEta;
-    // Calculate p_{m*n,k} ('p-vector' for POIs): 
-    for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
+    if(fUseFastQVectors) // same quantities as below, with cos/sin and weight powers evaluated only once for this particle:
     {
-     for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
-     {
-      if(fCalculateDiffFlow)
+     this->AccumulateQVectors(dPhi,dPt,dEta,wPhi*wPt*wEta*wTrack,1,kFALSE);
+    } else // to if(fUseFastQVectors)
       {
-       for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+       ptEta[0] = dPt;
+       ptEta[1] = dEta;
+       // Calculate p_{m*n,k} ('p-vector' for POIs): 
+       for(Int_t k=0;k<9;k++) // to be improved - hardwired 9
        {
-        fReRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-        fImRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
-       } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
-      } // end of if(fCalculateDiffFlow) 
-      if(fCalculate2DDiffFlow)
-      {
-       fReRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
-       fImRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
-      } // end of if(fCalculate2DDiffFlow)
-     } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
-    } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9    
+        for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+        {
+         if(fCalculateDiffFlow)
+         {
+          for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+          {
+           fReRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+           fImRPQ1dEBE[1][pe][m][k]->Fill(ptEta[pe],pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);          
+          } // end of for(Int_t pe=0;pe<2;pe++) // pt or eta
+         } // end of if(fCalculateDiffFlow) 
+         if(fCalculate2DDiffFlow)
+         {
+          fReRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Cos((m+1.)*n*dPhi),1.);
+          fImRPQ2dEBE[1][m][k]->Fill(dPt,dEta,pow(wPhi*wPt*wEta*wTrack,k)*TMath::Sin((m+1.)*n*dPhi),1.);      
+         } // end of if(fCalculate2DDiffFlow)
+        } // end of for(Int_t m=0;m<4;m++) // to be improved - hardwired 4
+       } // end of for(Int_t k=0;k<9;k++) // to be improved - hardwired 9    
+      } // end of else // to if(fUseFastQVectors)
    } // end of if(pTrack->InPOISelection())    
   } else // to if(aftsTrack)
     {
@@ -548,6 +563,19 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
     }
  } // end of for(Int_t i=0;i<nPrim;i++) 
 
+ // Fast Q-vectors: S_{p,k} was accumulated only for p = 0 and the differential quantities were buffered:
+ if(fUseFastQVectors)
+ {
+  for(Int_t p=1;p<8;p++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    (*fSpk)(p,k)=(*fSpk)(0,k);
+   }
+  }
+  this->FlushDiffFlowBuffers();
+ } // end of if(fUseFastQVectors)
+
  // e) Calculate the final expressions for S_{p,k} and s_{p,k} (important !!!!):
  for(Int_t p=0;p<8;p++)
  {
@@ -21086,6 +21114,316 @@ void AliFlowAnalysisWithQCumulants::ResetEventByEventQuantities()
 
 //=======================================================================================================================
 
+void AliFlowAnalysisWithQCumulants::CalculateHarmonicsAndWeightPowers(Double_t dPhi, Double_t dWeight, Double_t *cosMn, Double_t *sinMn, Double_t *wPow) const
+{
+ // Calculate cos((m+1)*n*phi), sin((m+1)*n*phi) for m = 0,1,...,11 and w^k for k = 0,1,...,8 for one particle.
+
+ // Remarks:
+ //  1.) By default each value is obtained exactly as in the standard loop in Make(), so the e-b-e quantities are identical;
+ //  2.) With fUseQVectorRecurrence higher harmonics are obtained by complex multiplication e^{i(m+1)n phi} = e^{imn phi}*e^{in phi}
+ //      and weight powers as w^k = w^{k-1}*w, which agrees with the standard loop only up to rounding.
+
+ Int_t n = fHarmonic; // shortcut for the harmonic
+
+ if(fUseQVectorRecurrence)
+ {
+  Double_t dCos = TMath::Cos(n*dPhi);
+  Double_t dSin = TMath::Sin(n*dPhi);
+  cosMn[0] = dCos;
+  sinMn[0] = dSin;
+  for(Int_t m=1;m<12;m++)
+  {
+   cosMn[m] = cosMn[m-1]*dCos-sinMn[m-1]*dSin;
+   sinMn[m] = sinMn[m-1]*dCos+cosMn[m-1]*dSin;
+  }
+  wPow[0] = 1.;
+  for(Int_t k=1;k<9;k++)
+  {
+   wPow[k] = wPow[k-1]*dWeight;
+  }
+  return;
+ } // end of if(fUseQVectorRecurrence)
+
+ for(Int_t m=0;m<12;m++)
+ {
+  cosMn[m] = TMath::Cos((m+1)*n*dPhi);
+  sinMn[m] = TMath::Sin((m+1)*n*dPhi);
+ }
+ for(Int_t k=0;k<9;k++)
+ {
+  wPow[k] = (1. == dWeight) ? 1. : pow(dWeight,k);
+ }
+
+} // end of void AliFlowAnalysisWithQCumulants::CalculateHarmonicsAndWeightPowers(Double_t dPhi, Double_t dWeight, Double_t *cosMn, Double_t *sinMn, Double_t *wPow) const
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::AccumulateQVectors(Double_t dPhi, Double_t dPt, Double_t dEta, Double_t dWeight, Int_t typeFlag, Bool_t alsoPOI)
+{
+ // Accumulate e-b-e quantities for one particle when fUseFastQVectors is set:
+ //  typeFlag = 0: RP => Q_{m*n,k}, S_{0,k} and r_{m*n,k} (and q_{m*n,k} if alsoPOI);
+ //  typeFlag = 1: POI => p_{m*n,k}.
+
+ // Remark: fReQ, fImQ and fSpk are addressed through their contiguous row-major storage; only the row p = 0
+ //         of fSpk is accumulated here, the other rows are identical and are copied in Make() after the loop.
+
+ Double_t cosMn[12] = {0.};
+ Double_t sinMn[12] = {0.};
+ Double_t wPow[9] = {0.};
+
+ if(1 == typeFlag && !(fCalculateDiffFlow || fCalculate2DDiffFlow)){return;} // nothing to be done for POIs
+
+ this->CalculateHarmonicsAndWeightPowers(dPhi,dWeight,cosMn,sinMn,wPow);
+
+ if(0 == typeFlag)
+ {
+  Double_t *reQ = fReQ->GetMatrixArray();
+  Double_t *imQ = fImQ->GetMatrixArray();
+  Double_t *spk = fSpk->GetMatrixArray();
+  for(Int_t m=0;m<12;m++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    reQ[m*9+k] += wPow[k]*cosMn[m];
+    imQ[m*9+k] += wPow[k]*sinMn[m];
+   }
+  }
+  for(Int_t k=0;k<9;k++)
+  {
+   spk[k] += wPow[k];
+  }
+ } // end of if(0 == typeFlag)
+
+ if(fCalculateDiffFlow || fCalculate2DDiffFlow)
+ {
+  this->BufferDiffFlowQVectors(typeFlag,dPt,dEta,cosMn,sinMn,wPow);
+  if(0 == typeFlag && alsoPOI)
+  {
+   this->BufferDiffFlowQVectors(2,dPt,dEta,cosMn,sinMn,wPow);
+  }
+ } // end of if(fCalculateDiffFlow || fCalculate2DDiffFlow)
+
+} // end of void AliFlowAnalysisWithQCumulants::AccumulateQVectors(Double_t dPhi, Double_t dPt, Double_t dEta, Double_t dWeight, Int_t typeFlag, Bool_t alsoPOI)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::BufferDiffFlowQVectors(Int_t typeFlag, Double_t dPt, Double_t dEta, const Double_t *cosMn, const Double_t *sinMn, const Double_t *wPow)
+{
+ // Buffer r_{m*n,k}, p_{m*n,k} or q_{m*n,k} and s_{p,k} of one particle in plain arrays instead of filling
+ // 4*9*2+9 e-b-e profiles per particle. The buffers are flushed into the profiles in FlushDiffFlowBuffers().
+
+ // Layout of one slot: [0] = number of entries, [1..5] = sums of x, x^2, y, y^2 and x*y (x = pt or eta in 1D,
+ // x = pt and y = eta in 2D) for the global statistics of the profiles, then for each profile index i:
+ // [6+2*i] = sum, [7+2*i] = sum of squares, with i = m*9+k for Re, 36+m*9+k for Im and 72+k for s_{p,k}
+ // (the latter only for typeFlag != 1).
+
+ const Int_t nValues = (1 == typeFlag) ? 72 : 81;
+ const Int_t slotHead = 6;
+ const Int_t slotSize = slotHead+2*81;
+ Double_t ptEta[2] = {dPt,dEta};
+
+ for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+ {
+  Int_t bin = -1;
+  if(g<2)
+  {
+   if(!fCalculateDiffFlow || (1 == g && !fCalculateDiffFlowVsEta)){continue;}
+   bin = fReRPQ1dEBE[typeFlag][g][0][0]->GetXaxis()->FindBin(ptEta[g]);
+  } else
+    {
+     if(!fCalculate2DDiffFlow){continue;}
+     TProfile2D *style = fReRPQ2dEBE[typeFlag][0][0];
+     bin = style->GetBin(style->GetXaxis()->FindBin(dPt),style->GetYaxis()->FindBin(dEta));
+    }
+  std::vector<Int_t> &slotOfBin = fDiffFlowBufferSlot[typeFlag][g];
+  std::vector<Double_t> &sums = fDiffFlowBufferSums[typeFlag][g];
+  if(slotOfBin[bin] < 0) // first entry in this bin for this event
+  {
+   slotOfBin[bin] = (Int_t)fDiffFlowBufferBins[typeFlag][g].size();
+   fDiffFlowBufferBins[typeFlag][g].push_back(bin);
+   sums.resize(sums.size()+slotSize,0.);
+  }
+  Double_t *slot = &sums[slotOfBin[bin]*slotSize];
+  Double_t x = (2 == g) ? dPt : ptEta[g];
+  Double_t y = (2 == g) ? dEta : 0.;
+  slot[0] += 1.;
+  slot[1] += x;
+  slot[2] += x*x;
+  slot[3] += y;
+  slot[4] += y*y;
+  slot[5] += x*y;
+  Double_t *values = slot+slotHead;
+  for(Int_t m=0;m<4;m++)
+  {
+   for(Int_t k=0;k<9;k++)
+   {
+    Double_t dRe = wPow[k]*cosMn[m];
+    Double_t dIm = wPow[k]*sinMn[m];
+    values[2*(m*9+k)] += dRe;
+    values[1+2*(m*9+k)] += dRe*dRe;
+    values[2*(36+m*9+k)] += dIm;
+    values[1+2*(36+m*9+k)] += dIm*dIm;
+   }
+  }
+  for(Int_t k=0;72+k<nValues;k++)
+  {
+   values[2*(72+k)] += wPow[k];
+   values[1+2*(72+k)] += wPow[k]*wPow[k];
+  }
+ } // end of for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+
+} // end of void AliFlowAnalysisWithQCumulants::BufferDiffFlowQVectors(Int_t typeFlag, Double_t dPt, Double_t dEta, const Double_t *cosMn, const Double_t *sinMn, const Double_t *wPow)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::PrepareDiffFlowBuffers()
+{
+ // Make sure the buffers for e-b-e differential quantities match the binning of the e-b-e profiles.
+
+ for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+ {
+  for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+  {
+   Int_t nCells = 0;
+   if(g<2 && fCalculateDiffFlow && (0 == g || fCalculateDiffFlowVsEta) && fReRPQ1dEBE[t][g][0][0])
+   {
+    nCells = fReRPQ1dEBE[t][g][0][0]->GetNbinsX()+2;
+   } else if(2 == g && fCalculate2DDiffFlow && fReRPQ2dEBE[t][0][0])
+     {
+      nCells = (fReRPQ2dEBE[t][0][0]->GetNbinsX()+2)*(fReRPQ2dEBE[t][0][0]->GetNbinsY()+2);
+     }
+   if((Int_t)fDiffFlowBufferSlot[t][g].size() != nCells)
+   {
+    fDiffFlowBufferSlot[t][g].assign(nCells,-1);
+    fDiffFlowBufferBins[t][g].clear();
+    fDiffFlowBufferSums[t][g].clear();
+   }
+  } // end of for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+ } // end of for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+
+} // end of void AliFlowAnalysisWithQCumulants::PrepareDiffFlowBuffers()
+
+//=======================================================================================================================
+
+static void AddBufferedProfileStats(TProfile *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+{
+ // Add to the global statistics of a TProfile what the buffered calls of Fill(x,y,1.) in one bin would have added
+ // (moments as in BufferDiffFlowQVectors(), sums[0] = sum of y and sums[1] = sum of y^2).
+
+ if((bin < 1 || bin > profile->GetNbinsX()) && !TH1::StatOverflows()){return;}
+ Double_t stats[6] = {0.};
+ profile->GetStats(stats);
+ stats[0] += moments[0];
+ stats[1] += moments[0];
+ stats[2] += moments[1];
+ stats[3] += moments[2];
+ stats[4] += sums[0];
+ stats[5] += sums[1];
+ profile->PutStats(stats);
+
+} // end of static void AddBufferedProfileStats(TProfile *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+
+//=======================================================================================================================
+
+static void AddBufferedProfileStats(TProfile2D *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+{
+ // Same for a TProfile2D filled with Fill(x,y,z,1.) (sums[0] = sum of z and sums[1] = sum of z^2).
+
+ Int_t binX = 0, binY = 0, binZ = 0;
+ profile->GetBinXYZ(bin,binX,binY,binZ);
+ if((binX < 1 || binX > profile->GetNbinsX() || binY < 1 || binY > profile->GetNbinsY()) && !TH1::StatOverflows()){return;}
+ Double_t stats[9] = {0.};
+ profile->GetStats(stats);
+ stats[0] += moments[0];
+ stats[1] += moments[0];
+ stats[2] += moments[1];
+ stats[3] += moments[2];
+ stats[4] += moments[3];
+ stats[5] += moments[4];
+ stats[6] += moments[5];
+ stats[7] += sums[0];
+ stats[8] += sums[1];
+ profile->PutStats(stats);
+
+} // end of static void AddBufferedProfileStats(TProfile2D *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+
+//=======================================================================================================================
+
+template <class P> static void FlushBufferedProfileBin(P *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+{
+ // Add to one bin of a TProfile or TProfile2D what moments[0] calls of Fill(...,y,1.) would have added, given
+ // sums[0] = sum of y and sums[1] = sum of y^2 (accumulated in the same order as the fills), including the
+ // global statistics (fTsumw, fTsumwx, ...) and the number of entries.
+
+ AddBufferedProfileStats(profile,bin,moments,sums);
+ profile->GetArray()[bin] += sums[0];
+ profile->GetSumw2()->fArray[bin] += sums[1];
+ profile->SetBinEntries(bin,profile->GetBinEntries(bin)+moments[0]);
+ if(profile->GetBinSumw2()->fN){profile->GetBinSumw2()->fArray[bin] += moments[0];}
+ profile->SetEntries(profile->GetEntries()+moments[0]);
+
+} // end of template <class P> static void FlushBufferedProfileBin(P *profile, Int_t bin, const Double_t *moments, const Double_t *sums)
+
+//=======================================================================================================================
+
+void AliFlowAnalysisWithQCumulants::FlushDiffFlowBuffers()
+{
+ // Move the buffered e-b-e differential quantities into fReRPQ1dEBE, fImRPQ1dEBE, fs1dEBE (and their 2D
+ // counterparts) and clear the buffers for the next event.
+
+ const Int_t slotHead = 6;
+ const Int_t slotSize = slotHead+2*81;
+
+ for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+ {
+  for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+  {
+   std::vector<Int_t> &bins = fDiffFlowBufferBins[t][g];
+   for(UInt_t b=0;b<bins.size();b++)
+   {
+    const Double_t *slot = &fDiffFlowBufferSums[t][g][b*slotSize];
+    const Double_t *values = slot+slotHead;
+    for(Int_t m=0;m<4;m++)
+    {
+     for(Int_t k=0;k<9;k++)
+     {
+      if(g<2)
+      {
+       FlushBufferedProfileBin(fReRPQ1dEBE[t][g][m][k],bins[b],slot,values+2*(m*9+k));
+       FlushBufferedProfileBin(fImRPQ1dEBE[t][g][m][k],bins[b],slot,values+2*(36+m*9+k));
+      } else
+        {
+         FlushBufferedProfileBin(fReRPQ2dEBE[t][m][k],bins[b],slot,values+2*(m*9+k));
+         FlushBufferedProfileBin(fImRPQ2dEBE[t][m][k],bins[b],slot,values+2*(36+m*9+k));
+        }
+     }
+    }
+    if(1 == t){continue;} // s_{p,k} is not needed for POIs
+    for(Int_t k=0;k<9;k++)
+    {
+     if(g<2)
+     {
+      FlushBufferedProfileBin(fs1dEBE[t][g][k],bins[b],slot,values+2*(72+k));
+     } else
+       {
+        FlushBufferedProfileBin(fs2dEBE[t][k],bins[b],slot,values+2*(72+k));
+       }
+    }
+   } // end of for(UInt_t b=0;b<bins.size();b++)
+   // Reset the buffer (the allocated memory is kept for the next event):
+   for(UInt_t b=0;b<bins.size();b++)
+   {
+    fDiffFlowBufferSlot[t][g][bins[b]] = -1;
+   }
+   bins.clear();
+   fDiffFlowBufferSums[t][g].clear();
+  } // end of for(Int_t g=0;g<3;g++) // 0 = pt, 1 = eta, 2 = (pt,eta)
+ } // end of for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+
+} // end of void AliFlowAnalysisWithQCumulants::FlushDiffFlowBuffers()
+
+//=======================================================================================================================
+
 void AliFlowAnalysisWithQCumulants::CalculateDiffFlowCorrectionsForNUASinTerms(TString type, TString ptOrEta)
 {
  // Calculate correction terms for non-uniform acceptance for differential flow (sin terms).
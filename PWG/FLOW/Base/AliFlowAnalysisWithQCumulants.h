@@ -14,6 +14,8 @@
 #ifndef ALIFLOWANALYSISWITHQCUMULANTS_H
 #define ALIFLOWANALYSISWITHQCUMULANTS_H
 
+#include <vector>
+
 #include "TMatrixD.h"
 #include "TH2D.h"
 #include "TRandom3.h"
@@ -82,6 +84,11 @@ class AliFlowAnalysisWithQCumulants{
     virtual void FillCommonControlHistograms(AliFlowEventSimple *anEvent);
     virtual void FillControlHistograms(AliFlowEventSimple *anEvent);
     virtual void ResetEventByEventQuantities();
+    virtual void CalculateHarmonicsAndWeightPowers(Double_t dPhi, Double_t dWeight, Double_t *cosMn, Double_t *sinMn, Double_t *wPow) const;
+    virtual void AccumulateQVectors(Double_t dPhi, Double_t dPt, Double_t dEta, Double_t dWeight, Int_t typeFlag, Bool_t alsoPOI);
+    virtual void BufferDiffFlowQVectors(Int_t typeFlag, Double_t dPt, Double_t dEta, const Double_t *cosMn, const Double_t *sinMn, const Double_t *wPow);
+    virtual void PrepareDiffFlowBuffers();
+    virtual void FlushDiffFlowBuffers();
     // 2b.) Reference flow:
     virtual void CalculateIntFlowCorrelations(); 
     virtual void CalculateIntFlowCorrelationsUsingParticleWeights();
@@ -287,6 +294,10 @@ class AliFlowAnalysisWithQCumulants{
   Bool_t GetFillProfilesVsMUsingWeights() const {return this->fFillProfilesVsMUsingWeights;};
   void SetUseQvectorTerms(Bool_t const uqvt){this->fUseQvectorTerms = uqvt;if(uqvt){this->fStoreControlHistograms = kTRUE;}};
   Bool_t GetUseQvectorTerms() const {return this->fUseQvectorTerms;};
+  void SetUseFastQVectors(Bool_t const ufqv){this->fUseFastQVectors = ufqv;};
+  Bool_t GetUseFastQVectors() const {return this->fUseFastQVectors;};
+  void SetUseQVectorRecurrence(Bool_t const uqvr){this->fUseQVectorRecurrence = uqvr;};
+  Bool_t GetUseQVectorRecurrence() const {return this->fUseQVectorRecurrence;};
 
   // Reference flow profiles:
   void SetAvMultiplicity(TProfile* const avMultiplicity) {this->fAvMultiplicity = avMultiplicity;};
@@ -627,6 +638,8 @@ class AliFlowAnalysisWithQCumulants{
   Bool_t fUse2DHistograms; // use TH2D instead of TProfile to improve numerical stability in reference flow calculation 
   Bool_t fFillProfilesVsMUsingWeights; // if the width of multiplicity bin is 1, weights are not needed  
   Bool_t fUseQvectorTerms; // use TH2D with separate Q-vector terms instead of TProfile to improve numerical stability in reference flow calculation 
+  Bool_t fUseFastQVectors; // cache cos/sin and weight powers per particle and buffer e-b-e differential fills (results identical to the standard loop)
+  Bool_t fUseQVectorRecurrence; // get cos/sin of higher harmonics and weight powers from recurrences (faster, equal only up to rounding)
 
   //  3c.) event-by-event quantities:
   TMatrixD *fReQ; //! fReQ[m][k] = sum_{i=1}^{M} w_{i}^{k} cos(m*phi_{i})
@@ -720,6 +733,10 @@ class AliFlowAnalysisWithQCumulants{
   TProfile2D *fReRPQ2dEBE[3][4][9]; // real part of r_{m*n,k}(pt,eta), p_{m*n,k}(pt,eta) and q_{m*n,k}(pt,eta)
   TProfile2D *fImRPQ2dEBE[3][4][9]; // imaginary part of r_{m*n,k}(pt,eta), p_{m*n,k}(pt,eta) and q_{m*n,k}(pt,eta)
   TProfile2D *fs2dEBE[3][9]; //! [t][k] // to be improved
+  //   Buffers used with fUseFastQVectors, flushed into the e-b-e profiles above once per event:
+  std::vector<Int_t> fDiffFlowBufferSlot[3][3]; //! [t][0=pt,1=eta,2=(pt,eta)] global bin => slot in fDiffFlowBufferSums (-1 = not filled yet)
+  std::vector<Int_t> fDiffFlowBufferBins[3][3]; //! [t][0=pt,1=eta,2=(pt,eta)] global bins filled in this event
+  std::vector<Double_t> fDiffFlowBufferSums[3][3]; //! [t][0=pt,1=eta,2=(pt,eta)] per slot: entries, moments of x and y for the global statistics, then sum and sum of squares for each profile
   //  4d.) profiles:
   //   1D:
   TProfile *fDiffFlowCorrelationsPro[2][2][4]; //! [0=RP,1=POI][0=pt,1=eta][correlation index]
@@ -847,7 +864,7 @@ class AliFlowAnalysisWithQCumulants{
   TH2D *fBootstrapCumulants; // x-axis => QC{2}, QC{4}, QC{6}, QC{8}; y-axis => subsample # 
   TH2D *fBootstrapCumulantsVsM[4]; // index => QC{2}, QC{4}, QC{6}, QC{8}; x-axis => multiplicity; y-axis => subsample # 
 
-  ClassDef(AliFlowAnalysisWithQCumulants, 4);
+  ClassDef(AliFlowAnalysisWithQCumulants, 5);
 
 };
 
@@ -84,7 +84,9 @@ AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants(const char *name, Bool_t us
  fnBinsForCorrelations(10000),
  fUseBootstrap(kFALSE),
  fUseBootstrapVsM(kFALSE),
- fnSubsamples(10)
+ fnSubsamples(10),
+ fUseFastQVectors(kFALSE),
+ fUseQVectorRecurrence(kFALSE)
 {
  // constructor
  AliDebug(2,"AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants(const char *name, Bool_t useParticleWeights)");
@@ -182,7 +184,9 @@ AliAnalysisTaskQCumulants::AliAnalysisTaskQCumulants():
  fnBinsForCorrelations(0), 
  fUseBootstrap(kFALSE),
  fUseBootstrapVsM(kFALSE),
- fnSubsamples(10)
+ fnSubsamples(10),
+ fUseFastQVectors(kFALSE),
+ fUseQVectorRecurrence(kFALSE)
 
 {
  // Dummy constructor
@@ -316,6 +320,9 @@ void AliAnalysisTaskQCumulants::UserCreateOutputObjects()
  fQC->SetUseBootstrap(fUseBootstrap);
  fQC->SetUseBootstrapVsM(fUseBootstrapVsM);
  fQC->SetnSubsamples(fnSubsamples);
+ // Fast Q-vectors:
+ fQC->SetUseFastQVectors(fUseFastQVectors);
+ fQC->SetUseQVectorRecurrence(fUseQVectorRecurrence);
 
  fQC->Init();
  
@@ -132,6 +132,11 @@ class AliAnalysisTaskQCumulants : public AliAnalysisTaskSE{
   Bool_t GetUseBootstrapVsM() const {return this->fUseBootstrapVsM;};
   void SetnSubsamples(Int_t const ns) {this->fnSubsamples = ns;};
   Int_t GetnSubsamples() const {return this->fnSubsamples;};
+  // fast Q-vectors:
+  void SetUseFastQVectors(Bool_t const ufqv) {this->fUseFastQVectors = ufqv;};
+  Bool_t GetUseFastQVectors() const {return this->fUseFastQVectors;};
+  void SetUseQVectorRecurrence(Bool_t const uqvr) {this->fUseQVectorRecurrence = uqvr;};
+  Bool_t GetUseQVectorRecurrence() const {return this->fUseQVectorRecurrence;};
 
  private:
   AliAnalysisTaskQCumulants(const AliAnalysisTaskQCumulants& aatqc);
@@ -191,8 +196,11 @@ class AliAnalysisTaskQCumulants : public AliAnalysisTaskSE{
   Bool_t fUseBootstrap; // use bootstrap to estimate statistical spread
   Bool_t fUseBootstrapVsM; // use bootstrap to estimate statistical spread for results vs M
   Int_t fnSubsamples; // number of subsamples (SS), by default 10
+  // Fast Q-vectors:
+  Bool_t fUseFastQVectors; // evaluate cos/sin and weight powers once per particle and buffer e-b-e differential fills
+  Bool_t fUseQVectorRecurrence; // get higher harmonics and weight powers from recurrences (equal only up to rounding)
   
-  ClassDef(AliAnalysisTaskQCumulants, 2); 
+  ClassDef(AliAnalysisTaskQCumulants, 3); 
 };
 
 //================================================================================================================
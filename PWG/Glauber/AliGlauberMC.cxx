@@ -28,10 +28,11 @@
 #include <TRandom.h>
 #include <TNamed.h>
 #include <TObjArray.h>
-#include <TNtuple.h>
 #include <TFile.h>
 #include <TTree.h>
 #include <TF1.h>
+#include <algorithm>
+#include <vector>
 
 #include "AliGlauberNucleon.h"
 #include "AliGlauberNucleus.h"
@@ -40,6 +41,45 @@
 using std::flush;
 ClassImp(AliGlauberMC)
 
+namespace {
+  // orders nucleon indices by their x position
+  class LessX {
+  public:
+    LessX(const std::vector<Double_t> &x) : fX(x) {}
+    Bool_t operator()(Int_t i, Int_t j) const {return fX[i]<fX[j];}
+  private:
+    const std::vector<Double_t> &fX;
+  };
+
+  // r^n, r^2 cos(n phi), r^2 sin(n phi), r^n cos(n phi) and r^n sin(n phi)
+  // of a point (x,y), n=2..5, from the powers of x+iy instead of the angle
+  class Harmonics {
+  public:
+    Harmonics(Double_t x, Double_t y) : fR2(x*x+y*y), fR3(0), fR4(0), fR5(0) {
+      for (Int_t n = 0; n<6; n++) fR2Cos[n] = fR2Sin[n] = fRnCos[n] = fRnSin[n] = 0;
+      if (fR2<=0) return;
+      Double_t r = TMath::Sqrt(fR2);
+      fR3 = fR2*r;
+      fR4 = fR3*r;
+      fR5 = fR4*r;
+      Double_t re = x, im = y; // (x+iy)^n = r^n (cos(n phi) + i sin(n phi))
+      Double_t rn = r;
+      for (Int_t n = 2; n<6; n++) {
+        Double_t tmp = re*x-im*y;
+        im = re*y+im*x;
+        re = tmp;
+        rn *= r;
+        fRnCos[n] = re;
+        fRnSin[n] = im;
+        fR2Cos[n] = re*fR2/rn;
+        fR2Sin[n] = im*fR2/rn;
+      }
+    }
+    Double_t fR2, fR3, fR4, fR5;
+    Double_t fR2Cos[6], fR2Sin[6], fRnCos[6], fRnSin[6];
+  };
+}
+
 //______________________________________________________________________________
 AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   TNamed(),
@@ -52,7 +92,7 @@ AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   fQAN(0),
   fBN(0),
   fQBN(0),
-  fnt(0),
+  fTree(0),
   fMeanX2(0),
   fMeanY2(0),
   fMeanXY(0),
@@ -188,7 +228,7 @@ AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
 AliGlauberMC::~AliGlauberMC()
 {
   //dtor
-  delete fnt;
+  delete fTree;
 }
 
 //______________________________________________________________________________
@@ -203,7 +243,7 @@ AliGlauberMC::AliGlauberMC(const AliGlauberMC& in):
   fQAN(in.fQAN),
   fBN(in.fBN),
   fQBN(in.fQBN),
-  fnt(in.fnt),
+  fTree(in.fTree),
   fMeanX2(in.fMeanX2),
   fMeanY2(in.fMeanY2),
   fMeanXY(in.fMeanXY),
@@ -342,7 +382,7 @@ AliGlauberMC& AliGlauberMC::operator=(const AliGlauberMC& in)
   fQAN=in.fQAN;
   fBN=in.fBN;
   fQBN=in.fQBN;
-  fnt=in.fnt;
+  fTree=in.fTree;
   fMeanX2=in.fMeanX2;
   fMeanY2=in.fMeanY2;
   fMeanXY=in.fMeanXY;
@@ -511,20 +551,79 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
   Double_t Nco   = 0;
   Double_t Ncohc = 0; // hard core
 
+  ResetResults();
+
+  // flat copies of the transverse positions; the nucleons of A are sorted in x,
+  // so that for each nucleon of B only the nucleons of A within the largest
+  // interaction distance in x are tested (in the original order of A).
+  // The sums over all nucleons and over the participants for the centres are
+  // accumulated in the same pass, so that afterwards only the participants
+  // are visited again for the moments about the centres
+  std::vector<Double_t> xA(fAN), yA(fAN), sigA(fAN), xASorted(fAN);
+  std::vector<Int_t> orderA(fAN), ncollA(fAN,0), partA, partB;
+  std::vector<Double_t> xB(fBN), yB(fBN);
+  std::vector<Int_t> ncollB(fBN,0);
+  partA.reserve(fAN);
+  partB.reserve(fBN);
+  Double_t maxSig = fXSect;
+  for (Int_t j = 0; j<fAN; j++)
+  {
+    AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
+    xA[j]   = nucleonA->GetX();
+    yA[j]   = nucleonA->GetY();
+    sigA[j] = nucleonA->GetSigNN();
+    orderA[j] = j;
+    if (fDoFluc) maxSig = TMath::Max(maxSig,sigA[j]);
+    fMeanOXA += xA[j];
+    fMeanOYA += yA[j];
+    fMeanXSystem += xA[j];
+    fMeanYSystem += yA[j];
+    fMeanXA += xA[j];
+    fMeanYA += yA[j];
+    fMeanX2 += xA[j]*xA[j];
+    fMeanY2 += yA[j]*yA[j];
+    fMeanXY += xA[j]*yA[j];
+  }
+  std::sort(orderA.begin(),orderA.end(),LessX(xA));
+  for (Int_t k = 0; k<fAN; k++)
+    xASorted[k] = xA[orderA[k]];
+  if (fDoFluc) {
+    for (Int_t i = 0; i<fBN; i++)
+      maxSig = TMath::Max(maxSig,((AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i)))->GetSigNN());
+  }
+  // slightly enlarged, so that rounding can not drop a pair at the limit
+  Double_t maxDist = TMath::Sqrt(maxSig/(TMath::Pi()*10))*(1+1e-9)+1e-9;
+
+  std::vector<Int_t> candidates;
+  candidates.reserve(fAN);
+
   // for each of the A nucleons in nucleus B
   for (Int_t i = 0; i<fBN; i++)
   {
     AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    for (Int_t j = 0 ; j < fAN ; j++)
+    Double_t xBB = xB[i] = nucleonB->GetX();
+    Double_t yBB = yB[i] = nucleonB->GetY();
+    fMeanXSystem += xBB;
+    fMeanYSystem += yBB;
+    fMeanXB += xBB;
+    fMeanYB += yBB;
+    fMeanX2 += xBB*xBB;
+    fMeanY2 += yBB*yBB;
+    fMeanXY += xBB*yBB;
+    std::vector<Double_t>::iterator first = std::lower_bound(xASorted.begin(),xASorted.end(),xBB-maxDist);
+    std::vector<Double_t>::iterator last  = std::upper_bound(first,xASorted.end(),xBB+maxDist);
+    candidates.assign(orderA.begin()+(first-xASorted.begin()),orderA.begin()+(last-xASorted.begin()));
+    std::sort(candidates.begin(),candidates.end());
+    for (UInt_t k = 0 ; k < candidates.size() ; k++)
     {
-      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
-      Double_t dx = nucleonB->GetX()-nucleonA->GetX();
-      Double_t dy = nucleonB->GetY()-nucleonA->GetY();
+      Int_t j = candidates[k];
+      Double_t dx = xBB-xA[j];
+      Double_t dy = yBB-yA[j];
       Double_t dij = dx*dx+dy*dy;
       if (fDoFluc) {
 	//fXSect = nucleonA->GetSigNN();
 	//fXSect = (nucleonA->GetSigNN()+nucleonB->GetSigNN())/2.;
-	fXSect = TMath::Max(nucleonA->GetSigNN(),nucleonB->GetSigNN());
+	fXSect = TMath::Max(sigA[j],nucleonB->GetSigNN());
 	d2 = (Double_t)fXSect/(TMath::Pi()*10); // in fm^2
       }
       if (dij < d2)
@@ -532,12 +631,41 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
 	bNN += dij;
 	++Nco;
         nucleonB->Collide();
-        nucleonA->Collide();
+        ((AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j)))->Collide();
 	if (dij<d2/4)
 	  ++Ncohc;
+        ++ncollB[i];
+        if (ncollA[j]++==0) {
+          // A nucleon wounded for the first time
+          partA.push_back(j);
+          fONpart++;
+          fMeanOXParts += xA[j];
+          fMeanOYParts += yA[j];
+          fONcom += (1-0.150);
+          fMeanOXCom += xA[j]*(1-0.150);
+          fMeanOYCom += xA[j]*(1-0.150); // x, as the results were always computed
+        }
       }
     }
+    if (ncollB[i]>0)
+    {
+      Int_t oNcoll = ncollB[i];
+      partB.push_back(i);
+      fONpart++;
+      fMeanOXParts += xBB;
+      fMeanOXColl += xBB*oNcoll;
+      fMeanOXCom += xBB*((1-0.150)+0.150*oNcoll);
+      fMeanOYParts += yBB;
+      fMeanOYColl += yBB*oNcoll;
+      fMeanOYCom += yBB*((1-0.150)+0.150*oNcoll);
+      fONcoll += oNcoll;
+      fONcom += ((1-0.150)+0.150*oNcoll);
+    }
   }
+  // with fluctuations the cross section of the last tested pair is kept, as
+  // when all pairs were tested
+  if (fDoFluc && fAN>0 && fBN>0)
+    fXSect = TMath::Max(sigA[fAN-1],((AliGlauberNucleon*)(fNucleonsB->UncheckedAt(fBN-1)))->GetSigNN());
 
   if (Nco>0) {
     fNcollw = Ncohc;
@@ -551,15 +679,72 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     fBNN = bNN/Nco;
   else
     fBNN = 0.;
+
+  // centres of the participants, binary collisions and combined weights
+  if (fONpart>0)
+  {
+    fMeanOXParts /= fONpart;
+    fMeanOYParts /= fONpart;
+  }
+  else
+  {
+    fMeanOXParts = 0;
+    fMeanOYParts = 0;
+  }
+
+  if (fONcoll>0)
+  {
+    fMeanOXColl /= fONcoll;
+    fMeanOYColl /= fONcoll;
+  }
+  else
+  {
+    fMeanOXColl = 0;
+    fMeanOYColl = 0;
+  }
+
+  if (fONcom>0)
+  {
+    fMeanOXCom /= fONcom;
+    fMeanOYCom /= fONcom;
+  }
+  else
+  {
+    fMeanOXCom = 0;
+    fMeanOYCom = 0;
+  }
+
+  // moments about the centres, over the participants only: the wounded
+  // nucleons of A enter the participant and combined moments, the ones of B
+  // also the binary-collision moments weighted with their number of collisions
+  std::sort(partA.begin(),partA.end());
+  for (UInt_t k = 0; k<partA.size(); k++)
+  {
+    Int_t j = partA[k];
+    fNpart++;
+    AddPartMoments(xA[j]-fMeanOXParts,yA[j]-fMeanOYParts);
+    AddComMoments(xA[j]-fMeanOXCom,yA[j]-fMeanOYCom,(1-0.150));
+    fNcom += (1-0.150);
+  }
+  for (UInt_t k = 0; k<partB.size(); k++)
+  {
+    Int_t i = partB[k];
+    Int_t ncoll = ncollB[i];
+    fNpart++;
+    AddPartMoments(xB[i]-fMeanOXParts,yB[i]-fMeanOYParts);
+    AddCollMoments(xB[i]-fMeanOXColl,yB[i]-fMeanOYColl,ncoll);
+    AddComMoments(xB[i]-fMeanOXCom,yB[i]-fMeanOYCom,((1-0.150)+0.150*ncoll));
+    fNcoll += ncoll;
+    fNcom += ((1-0.150)+0.150*ncoll);
+  }
+
   return CalcResults(bgen);
 }
 
 //______________________________________________________________________________
-Bool_t AliGlauberMC::CalcResults(Double_t bgen)
+void AliGlauberMC::ResetResults()
 {
-  // calc results for the given event
-  //return true if we have participants
-
+  // reset the sums of the current event
   fNpart=0;
   fNcoll=0;
   fNcom=0;
@@ -651,332 +836,104 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
   fMeanr4Sin4PhiCom=0.;
   fMeanr5Cos5PhiCom=0.;
   fMeanr5Sin5PhiCom=0.;
+}
 
-  for (Int_t i = 0; i<fAN; i++)
-  {
-    AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(i));
-    Double_t oXA = nucleonA->GetX();
-    Double_t oYA = nucleonA->GetY();
-    //fMeanOXSystem  += oXA;
-    //fMeanOYSystem  += oYA;
-    fMeanOXA  += oXA;
-    fMeanOYA  += oYA;
-
-    if(nucleonA->IsWounded())
-    {
-      fONpart++;
-      fMeanOXParts  += oXA;
-      fMeanOYParts  += oYA;
-      
-      fONcom += (1-0.150);
-      fMeanOXCom  += oXA*(1-0.150);
-      fMeanOYCom += oXA*(1-0.150);
-    }
-  }
+//______________________________________________________________________________
+void AliGlauberMC::AddPartMoments(Double_t x, Double_t y)
+{
+  // add a participant at (x,y) from the participant centre
+  Harmonics h(x,y);
+  fMeanXParts += x;
+  fMeanYParts += y;
+  fMeanX2Parts += x*x;
+  fMeanY2Parts += y*y;
+  fMeanXYParts += x*y;
+  fMeanr2 += h.fR2;
+  fMeanr3 += h.fR3;
+  fMeanr4 += h.fR4;
+  fMeanr5 += h.fR5;
+  fMeanr2Cos2Phi += h.fR2Cos[2];
+  fMeanr2Sin2Phi += h.fR2Sin[2];
+  fMeanr2Cos3Phi += h.fR2Cos[3];
+  fMeanr2Sin3Phi += h.fR2Sin[3];
+  fMeanr2Cos4Phi += h.fR2Cos[4];
+  fMeanr2Sin4Phi += h.fR2Sin[4];
+  fMeanr2Cos5Phi += h.fR2Cos[5];
+  fMeanr2Sin5Phi += h.fR2Sin[5];
+  fMeanr3Cos3Phi += h.fRnCos[3];
+  fMeanr3Sin3Phi += h.fRnSin[3];
+  fMeanr4Cos4Phi += h.fRnCos[4];
+  fMeanr4Sin4Phi += h.fRnSin[4];
+  fMeanr5Cos5Phi += h.fRnCos[5];
+  fMeanr5Sin5Phi += h.fRnSin[5];
+}
 
-  for (Int_t i = 0; i<fBN; i++)
-  {
-    AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    Double_t oXB=nucleonB->GetX();
-    Double_t oYB=nucleonB->GetY();
-    
-    if(nucleonB->IsWounded())
-    {
-      Int_t oNcoll = nucleonB->GetNColl();
-      fONpart++;
-      fMeanOXParts  += oXB;
-      fMeanOXColl  += oXB*oNcoll;
-      fMeanOXCom  += oXB*((1-0.150)+0.150*oNcoll);
-      fMeanOYParts  += oYB;
-      fMeanOYColl += oYB*oNcoll;
-      fMeanOYCom += oYB*((1-0.150)+0.150*oNcoll);
-      fONcoll += oNcoll;
-      fONcom += ((1-0.150)+0.150*oNcoll);
-    }
-  }
+//______________________________________________________________________________
+void AliGlauberMC::AddCollMoments(Double_t x, Double_t y, Double_t w)
+{
+  // add a participant of B at (x,y) from the binary-collision centre, weighted with its collisions
+  Harmonics h(x,y);
+  fMeanXColl += x*w;
+  fMeanYColl += y*w;
+  fMeanX2Coll += x*x*w;
+  fMeanY2Coll += y*y*w;
+  fMeanXYColl += x*y*w;
+  fMeanr2Coll += h.fR2*w;
+  fMeanr3Coll += h.fR3*w;
+  fMeanr4Coll += h.fR4*w;
+  fMeanr5Coll += h.fR5*w;
+  fMeanr2Cos2PhiColl += h.fR2Cos[2]*w;
+  fMeanr2Sin2PhiColl += h.fR2Sin[2]*w;
+  fMeanr2Cos3PhiColl += h.fR2Cos[3]*w;
+  fMeanr2Sin3PhiColl += h.fR2Sin[3]*w;
+  fMeanr2Cos4PhiColl += h.fR2Cos[4]*w;
+  fMeanr2Sin4PhiColl += h.fR2Sin[4]*w;
+  fMeanr2Cos5PhiColl += h.fR2Cos[5]*w;
+  fMeanr2Sin5PhiColl += h.fR2Sin[5]*w;
+  fMeanr3Cos3PhiColl += h.fRnCos[3]*w;
+  fMeanr3Sin3PhiColl += h.fRnSin[3]*w;
+  fMeanr4Cos4PhiColl += h.fRnCos[4]*w;
+  fMeanr4Sin4PhiColl += h.fRnSin[4]*w;
+  fMeanr5Cos5PhiColl += h.fRnCos[5]*w;
+  fMeanr5Sin5PhiColl += h.fRnSin[5]*w;
+}
 
-  if (fONpart>0)
-  {
-    fMeanOXParts /= fONpart;
-    fMeanOYParts /= fONpart;
-  }
-  else
-  {
-    fMeanOXParts = 0;
-    fMeanOYParts = 0;
-  }
+//______________________________________________________________________________
+void AliGlauberMC::AddComMoments(Double_t x, Double_t y, Double_t w)
+{
+  // add a participant at (x,y) from the combined centre, with the combined weight
+  Harmonics h(x,y);
+  fMeanXCom += x*w;
+  fMeanYCom += y*w;
+  fMeanX2Com += x*x*w;
+  fMeanY2Com += y*y*w;
+  fMeanXYCom += x*y*w;
+  fMeanr2Com += h.fR2*w;
+  fMeanr3Com += h.fR3*w;
+  fMeanr4Com += h.fR4*w;
+  fMeanr5Com += h.fR5*w;
+  fMeanr2Cos2PhiCom += h.fR2Cos[2]*w;
+  fMeanr2Sin2PhiCom += h.fR2Sin[2]*w;
+  fMeanr2Cos3PhiCom += h.fR2Cos[3]*w;
+  fMeanr2Sin3PhiCom += h.fR2Sin[3]*w;
+  fMeanr2Cos4PhiCom += h.fR2Cos[4]*w;
+  fMeanr2Sin4PhiCom += h.fR2Sin[4]*w;
+  fMeanr2Cos5PhiCom += h.fR2Cos[5]*w;
+  fMeanr2Sin5PhiCom += h.fR2Sin[5]*w;
+  fMeanr3Cos3PhiCom += h.fRnCos[3]*w;
+  fMeanr3Sin3PhiCom += h.fRnSin[3]*w;
+  fMeanr4Cos4PhiCom += h.fRnCos[4]*w;
+  fMeanr4Sin4PhiCom += h.fRnSin[4]*w;
+  fMeanr5Cos5PhiCom += h.fRnCos[5]*w;
+  fMeanr5Sin5PhiCom += h.fRnSin[5]*w;
+}
 
-  if (fONcoll>0)
-  {
-    fMeanOXColl /= fONcoll;
-    fMeanOYColl /= fONcoll;
-  }
-  else
-  {
-    fMeanOXColl = 0;
-    fMeanOYColl = 0;
-  }
+//______________________________________________________________________________
+Bool_t AliGlauberMC::CalcResults(Double_t bgen)
+{
+  // normalize the sums of the current event (see CalcEvent)
+  //return true if we have participants
 
- if (fONcom>0)
-  {
-    fMeanOXCom /= fONcom;
-    fMeanOYCom /= fONcom;
-  }
-  else
-  {
-    fMeanOXCom = 0;
-    fMeanOYCom = 0;
-  }
-  
-  //////////////////////////////////////////////////////////////////
-  for (Int_t i = 0; i<fAN; i++)
-  {
-    AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(i));
-    Double_t xAA = nucleonA->GetX(); // X
-    Double_t yAA = nucleonA->GetY(); // Y
-    Double_t xAPart = xAA - fMeanOXParts; // X'
-    Double_t yAPart = yAA - fMeanOYParts; // Y'
-    Double_t r2APart = xAPart *xAPart+yAPart*yAPart;     // r'^2
-    Double_t rAPart = TMath::Sqrt(r2APart);  // r'
-    Double_t r3APart = r2APart*rAPart;
-    Double_t r4APart = r3APart*rAPart;
-    Double_t r5APart = r4APart*rAPart;
-    Double_t phiAPart = TMath::ATan2(yAPart,xAPart);
-    Double_t sin2PhiAPart = TMath::Sin(2.*phiAPart);
-    Double_t cos2PhiAPart = TMath::Cos(2.*phiAPart);
-    Double_t sin3PhiAPart = TMath::Sin(3.*phiAPart);
-    Double_t cos3PhiAPart = TMath::Cos(3.*phiAPart);
-    Double_t sin4PhiAPart = TMath::Sin(4.*phiAPart);
-    Double_t cos4PhiAPart = TMath::Cos(4.*phiAPart);
-    Double_t sin5PhiAPart = TMath::Sin(5.*phiAPart);
-    Double_t cos5PhiAPart = TMath::Cos(5.*phiAPart);
-   
-    // for combine
-    Double_t xACom = xAA - fMeanOXCom; // X'-Combine
-    Double_t yACom = yAA - fMeanOYCom; // Y'-C
-    Double_t r2ACom = xACom *xACom+yACom*yACom;     // r'^2-C
-    Double_t rACom = TMath::Sqrt(r2ACom);  // r'-C
-    Double_t r3ACom = r2ACom*rACom;
-    Double_t r4ACom = r3ACom*rACom;
-    Double_t r5ACom = r4ACom*rACom;
-    Double_t phiACom = TMath::ATan2(yACom,xACom);
-    Double_t sin2PhiACom = TMath::Sin(2.*phiACom);
-    Double_t cos2PhiACom = TMath::Cos(2.*phiACom);
-    Double_t sin3PhiACom = TMath::Sin(3.*phiACom);
-    Double_t cos3PhiACom = TMath::Cos(3.*phiACom);
-    Double_t sin4PhiACom = TMath::Sin(4.*phiACom);
-    Double_t cos4PhiACom = TMath::Cos(4.*phiACom);
-    Double_t sin5PhiACom = TMath::Sin(5.*phiACom);
-    Double_t cos5PhiACom = TMath::Cos(5.*phiACom);   
-    
-    fMeanXSystem  += xAA;
-    fMeanYSystem  += yAA;
-    fMeanXA  += xAA;
-    fMeanYA  += yAA;
-    fMeanX2 += xAA * xAA;
-    fMeanY2 += yAA * yAA;
-    fMeanXY += xAA * yAA;
-    
-    if(nucleonA->IsWounded())
-     {
-       //Wounded
-      fNpart++;
-      fMeanXParts  += xAPart;
-      fMeanYParts  += yAPart;
-      fMeanX2Parts += xAPart * xAPart;
-      fMeanY2Parts += yAPart * yAPart;
-      fMeanXYParts += xAPart * yAPart;
-      fMeanr2 += r2APart;
-      fMeanr3 += r3APart;
-      fMeanr4 += r4APart;
-      fMeanr5 += r5APart;
-      fMeanr2Cos2Phi += r2APart*cos2PhiAPart;
-      fMeanr2Sin2Phi += r2APart*sin2PhiAPart;
-      fMeanr2Cos3Phi += r2APart*cos3PhiAPart;
-      fMeanr2Sin3Phi += r2APart*sin3PhiAPart;
-      fMeanr2Cos4Phi += r2APart*cos4PhiAPart;
-      fMeanr2Sin4Phi += r2APart*sin4PhiAPart;
-      fMeanr2Cos5Phi += r2APart*cos5PhiAPart;
-      fMeanr2Sin5Phi += r2APart*sin5PhiAPart;
-      fMeanr3Cos3Phi += r3APart*cos3PhiAPart;
-      fMeanr3Sin3Phi += r3APart*sin3PhiAPart;
-      fMeanr4Cos4Phi += r4APart*cos4PhiAPart;
-      fMeanr4Sin4Phi += r4APart*sin4PhiAPart;
-      fMeanr5Cos5Phi += r5APart*cos5PhiAPart;
-      fMeanr5Sin5Phi += r5APart*sin5PhiAPart;
-
-      // Combined
-      fMeanXCom  += xACom*(1-0.150);
-      fMeanYCom += yACom*(1-0.150);
-      fMeanX2Com += xACom*xACom*(1-0.150);
-      fMeanY2Com += yACom*yACom*(1-0.150);
-      fMeanXYCom += xACom*yACom*(1-0.150);
-      fNcom += (1-0.150);
-      fMeanr2Com += r2ACom*(1-0.150);
-      fMeanr3Com += r3ACom*(1-0.150);
-      fMeanr4Com += r4ACom*(1-0.150);
-      fMeanr5Com += r5ACom*(1-0.150);
-      fMeanr2Cos2PhiCom += r2ACom*cos2PhiACom*(1-0.150);
-      fMeanr2Sin2PhiCom += r2ACom*sin2PhiACom*(1-0.150);
-      fMeanr2Cos3PhiCom += r2ACom*cos3PhiACom*(1-0.150);
-      fMeanr2Sin3PhiCom += r2ACom*sin3PhiACom*(1-0.150);
-      fMeanr2Cos4PhiCom += r2ACom*cos4PhiACom*(1-0.150);
-      fMeanr2Sin4PhiCom += r2ACom*sin4PhiACom*(1-0.150);
-      fMeanr2Cos5PhiCom += r2ACom*cos5PhiACom*(1-0.150);
-      fMeanr2Sin5PhiCom += r2ACom*sin5PhiACom*(1-0.150);
-      fMeanr3Cos3PhiCom += r3ACom*cos3PhiACom*(1-0.150);
-      fMeanr3Sin3PhiCom += r3ACom*sin3PhiACom*(1-0.150);
-      fMeanr4Cos4PhiCom += r4ACom*cos4PhiACom*(1-0.150);
-      fMeanr4Sin4PhiCom += r4ACom*sin4PhiACom*(1-0.150);
-      fMeanr5Cos5PhiCom += r5ACom*cos5PhiACom*(1-0.150);
-      fMeanr5Sin5PhiCom += r5ACom*sin5PhiACom*(1-0.150);
-      
-    }
-  }
-  
-  for (Int_t i = 0; i<fBN; i++)
-    {
-      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-      Double_t xBB = nucleonB->GetX();
-      Double_t yBB = nucleonB->GetY();
-      // for Wounded
-      Double_t xBPart = xBB - fMeanOXParts; // X'
-      Double_t yBPart = yBB - fMeanOYParts; // Y'
-      Double_t r2BPart = xBPart*xBPart+yBPart*yBPart;     // r'^2
-      Double_t rBPart = TMath::Sqrt(r2BPart);  // r'
-      Double_t r3BPart = r2BPart*rBPart;
-      Double_t r4BPart = r3BPart*rBPart;
-      Double_t r5BPart = r4BPart*rBPart;
-      Double_t phiBPart = TMath::ATan2(yBPart,xBPart);
-      Double_t sin2PhiBPart = TMath::Sin(2.*phiBPart);
-      Double_t cos2PhiBPart = TMath::Cos(2.*phiBPart);
-      Double_t sin3PhiBPart = TMath::Sin(3.*phiBPart);
-      Double_t cos3PhiBPart = TMath::Cos(3.*phiBPart);
-      Double_t sin4PhiBPart = TMath::Sin(4.*phiBPart);
-      Double_t cos4PhiBPart = TMath::Cos(4.*phiBPart);
-      Double_t sin5PhiBPart = TMath::Sin(5.*phiBPart);
-      Double_t cos5PhiBPart = TMath::Cos(5.*phiBPart);
-      // for Binary
-      Double_t xBColl = xBB - fMeanOXColl; // X'-Binary
-      Double_t yBColl = yBB - fMeanOYColl; // Y'-B
-      Double_t r2BColl = xBColl*xBColl+yBColl*yBColl;     // r'^2-B
-      Double_t rBColl = TMath::Sqrt(r2BColl);  // r'-B
-      Double_t r3BColl = r2BColl*rBColl;
-      Double_t r4BColl = r3BColl*rBColl;
-      Double_t r5BColl = r4BColl*rBColl;
-      Double_t phiBColl = TMath::ATan2(yBColl,xBColl);
-      Double_t sin2PhiBColl = TMath::Sin(2.*phiBColl);
-      Double_t cos2PhiBColl = TMath::Cos(2.*phiBColl);
-      Double_t sin3PhiBColl = TMath::Sin(3.*phiBColl);
-      Double_t cos3PhiBColl = TMath::Cos(3.*phiBColl);
-      Double_t sin4PhiBColl = TMath::Sin(4.*phiBColl);
-      Double_t cos4PhiBColl = TMath::Cos(4.*phiBColl);
-      Double_t sin5PhiBColl = TMath::Sin(5.*phiBColl);
-      Double_t cos5PhiBColl = TMath::Cos(5.*phiBColl);
-      // for combine
-      Double_t xBCom = xBB - fMeanOXCom; // X'-Combine
-      Double_t yBCom = yBB - fMeanOYCom; // Y'-C
-      Double_t r2BCom = xBCom *xBCom+yBCom*yBCom;     // r'^2-C
-      Double_t rBCom = TMath::Sqrt(r2BCom);  // r'-C
-      Double_t r3BCom = r2BCom*rBCom;
-      Double_t r4BCom = r3BCom*rBCom;
-      Double_t r5BCom = r4BCom*rBCom;
-      Double_t phiBCom = TMath::ATan2(yBCom,xBCom);
-      Double_t sin2PhiBCom = TMath::Sin(2.*phiBCom);
-      Double_t cos2PhiBCom = TMath::Cos(2.*phiBCom);
-      Double_t sin3PhiBCom = TMath::Sin(3.*phiBCom);
-      Double_t cos3PhiBCom = TMath::Cos(3.*phiBCom);
-      Double_t sin4PhiBCom = TMath::Sin(4.*phiBCom);
-      Double_t cos4PhiBCom = TMath::Cos(4.*phiBCom);
-      Double_t sin5PhiBCom = TMath::Sin(5.*phiBCom);
-      Double_t cos5PhiBCom = TMath::Cos(5.*phiBCom);   
-      
-      fMeanXSystem  += xBB;
-      fMeanYSystem  += yBB;
-      fMeanXB  += xBB;
-      fMeanYB  += yBB;
-      fMeanX2 += xBB*xBB;
-      fMeanY2 += yBB*yBB;
-      fMeanXY += xBB*yBB;
-      
-      if(nucleonB->IsWounded())
-	{
-	  Int_t ncoll = nucleonB->GetNColl();
-	  fNpart++;
-	  fMeanXParts  += xBPart;
-	  fMeanXColl  += xBColl*ncoll;
-	  fMeanXCom  += xBCom*((1-0.150)+0.150*ncoll);
-	  fMeanYParts  += yBPart;
-	  fMeanYColl += yBColl*ncoll;
-	  fMeanYCom += yBCom*((1-0.150)+0.150*ncoll);
-	  fMeanX2Parts += xBPart * xBPart;
-	  fMeanX2Coll += xBColl*xBColl*ncoll;
-	  fMeanX2Com += xBCom*xBCom*((1-0.150)+0.150*ncoll);
-	  fMeanY2Parts += yBPart * yBPart;
-	  fMeanY2Coll += yBColl*yBColl*ncoll;
-	  fMeanY2Com += yBCom*yBCom*((1-0.150)+0.150*ncoll);
-	  fMeanXYParts += xBPart * yBPart;
-	  fMeanXYColl += xBColl*yBColl*ncoll;
-	  fMeanXYCom += xBCom*yBCom*((1-0.150)+0.150*ncoll);
-	  fNcoll += ncoll;
-	  fNcom += ((1-0.150)+0.150*ncoll);
-	  fMeanr2 += r2BPart;
-	  fMeanr3 += r3BPart;
-	  fMeanr4 += r4BPart;
-	  fMeanr5 += r5BPart;
-	  fMeanr2Cos2Phi += r2BPart*cos2PhiBPart;
-	  fMeanr2Sin2Phi += r2BPart*sin2PhiBPart;
-	  fMeanr2Cos3Phi += r2BPart*cos3PhiBPart;
-	  fMeanr2Sin3Phi += r2BPart*sin3PhiBPart;
-	  fMeanr2Cos4Phi += r2BPart*cos4PhiBPart;
-	  fMeanr2Sin4Phi += r2BPart*sin4PhiBPart;
-	  fMeanr2Cos5Phi += r2BPart*cos5PhiBPart;
-	  fMeanr2Sin5Phi += r2BPart*sin5PhiBPart;
-	  fMeanr3Cos3Phi += r3BPart*cos3PhiBPart;
-	  fMeanr3Sin3Phi += r3BPart*sin3PhiBPart;
-	  fMeanr4Cos4Phi += r4BPart*cos4PhiBPart;
-	  fMeanr4Sin4Phi += r4BPart*sin4PhiBPart;
-	  fMeanr5Cos5Phi += r5BPart*cos5PhiBPart;
-	  fMeanr5Sin5Phi += r5BPart*sin5PhiBPart;
-	  fMeanr2Coll += r2BColl*ncoll;
-	  fMeanr3Coll += r3BColl*ncoll;
-	  fMeanr4Coll += r4BColl*ncoll;
-	  fMeanr5Coll += r5BColl*ncoll;
-	  fMeanr2Cos2PhiColl += r2BColl*cos2PhiBColl*ncoll;
-	  fMeanr2Sin2PhiColl += r2BColl*sin2PhiBColl*ncoll;
-	  fMeanr2Cos3PhiColl += r2BColl*cos3PhiBColl*ncoll;
-	  fMeanr2Sin3PhiColl += r2BColl*sin3PhiBColl*ncoll;
-	  fMeanr2Cos4PhiColl += r2BColl*cos4PhiBColl*ncoll;
-	  fMeanr2Sin4PhiColl += r2BColl*sin4PhiBColl*ncoll;
-	  fMeanr2Cos5PhiColl += r2BColl*cos5PhiBColl*ncoll;
-	  fMeanr2Sin5PhiColl += r2BColl*sin5PhiBColl*ncoll;
-	  fMeanr3Cos3PhiColl += r3BColl*cos3PhiBColl*ncoll;
-	  fMeanr3Sin3PhiColl += r3BColl*sin3PhiBColl*ncoll;
-	  fMeanr4Cos4PhiColl += r4BColl*cos4PhiBColl*ncoll;
-	  fMeanr4Sin4PhiColl += r4BColl*sin4PhiBColl*ncoll;
-	  fMeanr5Cos5PhiColl += r5BColl*cos5PhiBColl*ncoll;
-	  fMeanr5Sin5PhiColl += r5BColl*sin5PhiBColl*ncoll;
-	  fMeanr2Com += r2BCom*((1-0.150)+0.150*ncoll);
-	  fMeanr3Com += r3BCom*((1-0.150)+0.150*ncoll);
-	  fMeanr4Com += r4BCom*((1-0.150)+0.150*ncoll);
-	  fMeanr5Com += r5BCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Cos2PhiCom += r2BCom*cos2PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Sin2PhiCom += r2BCom*sin2PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Cos3PhiCom += r2BCom*cos3PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Sin3PhiCom += r2BCom*sin3PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Cos4PhiCom += r2BCom*cos4PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Sin4PhiCom += r2BCom*sin4PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Cos5PhiCom += r2BCom*cos5PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr2Sin5PhiCom += r2BCom*sin5PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr3Cos3PhiCom += r3BCom*cos3PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr3Sin3PhiCom += r3BCom*sin3PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr4Cos4PhiCom += r4BCom*cos4PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr4Sin4PhiCom += r4BCom*sin4PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr5Cos5PhiCom += r5BCom*cos5PhiBCom*((1-0.150)+0.150*ncoll);
-	  fMeanr5Sin5PhiCom += r5BCom*sin5PhiBCom*((1-0.150)+0.150*ncoll);
-	}
-    }
-  
   if (fNpart>0)
     {
       fMeanXParts /= fNpart;
@@ -1688,11 +1645,32 @@ void AliGlauberMC::Run(Int_t nevents)
   cout << "Generating " << nevents << " events..." << endl;
   TString name(Form("nt_%s_%s",fANucleus.GetName(),fBNucleus.GetName()));
   TString title(Form("%s + %s (x-sect = %d mb)",fANucleus.GetName(),fBNucleus.GetName(),(Int_t) fXSect));
-  if (fnt == 0)
+  // one branch per quantity, with the names of the former ntuple columns;
+  // the counts are integers, the rest single precision as before
+  const Int_t kNVars = 48;
+  static const char *kVars[kNVars] = {
+    "Npart","Ncoll","B","MeanX","MeanY","MeanX2","MeanY2","MeanXY",
+    "VarX","VarY","VarXY","MeanXSystem","MeanYSystem","MeanXA","MeanYA","MeanXB",
+    "MeanYB","VarE","Stoa","VarEColl","VarECom","VarEPart","VarEPartColl","VarEPartCom",
+    "dNdEta","dNdEtaGBW","dNdEtaTwoNBD","xsect","tAA","Epsl2","Epsl3","Epsl4",
+    "Epsl5","E2Coll","E3Coll","E4Coll","E5Coll","E2Com","E3Com","E4Com",
+    "E5Com","Psi2","Psi3","Psi4","Psi5","BNN","signn","Ncollw"
+  };
+  Float_t v[kNVars];
+  Int_t iv[kNVars];
+  if (fTree == 0)
+  {
+    fTree = new TTree(name,title);
+    fTree->SetDirectory(0);
+  }
+  for (Int_t k = 0; k<kNVars; k++)
   {
-    fnt = new TNtuple(name,title,
-                      "Npart:Ncoll:B:MeanX:MeanY:MeanX2:MeanY2:MeanXY:VarX:VarY:VarXY:MeanXSystem:MeanYSystem:MeanXA:MeanYA:MeanXB:MeanYB:VarE:Stoa:VarEColl:VarECom:VarEPart:VarEPartColl:VarEPartCom:dNdEta:dNdEtaGBW:dNdEtaTwoNBD:xsect:tAA:Epsl2:Epsl3:Epsl4:Epsl5:E2Coll:E3Coll:E4Coll:E5Coll:E2Com:E3Com:E4Com:E5Com:Psi2:Psi3:Psi4:Psi5:BNN:signn:Ncollw");
-    fnt->SetDirectory(0);
+    Bool_t isInt = (k==0 || k==1 || k==47);
+    void *addr = isInt ? (void*)&iv[k] : (void*)&v[k];
+    if (fTree->GetBranch(kVars[k]))
+      fTree->SetBranchAddress(kVars[k],addr);
+    else
+      fTree->Branch(kVars[k],addr,Form("%s/%s",kVars[k],isInt?"I":"F"));
   }
   Int_t q = 0;
   Int_t u = 0;
@@ -1706,9 +1684,8 @@ void AliGlauberMC::Run(Int_t nevents)
     }
 
     q++;
-    Float_t v[48];
-    v[0]  = GetNpart();
-    v[1]  = GetNcoll();
+    iv[0] = GetNpart();
+    iv[1] = GetNcoll();
     v[2]  = fBMC;
     v[3]  = fMeanXParts;
     v[4]  = fMeanYParts;
@@ -1767,16 +1744,33 @@ void AliGlauberMC::Run(Int_t nevents)
     v[44] = GetPsi5();
     v[45] = fBNN;
     v[46] = fXSect;
-    v[47] = fNcollw;
+    iv[47] = fNcollw;
 
     //always at the end
-    fnt->Fill(v);
+    fTree->Fill();
 
     if ((i%100)==0) std::cout << "Generating Event # " << i << "... \r" << flush;
   }
+  // the addresses are local to this call
+  fTree->ResetBranchAddresses();
   std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
 }
 
+//---------------------------------------------------------------------------------
+UInt_t AliGlauberMC::GetStreamSeed(UInt_t seed, Int_t stream)
+{
+  // Random seed of the independent event stream with the given index: jobs
+  // seeded with GetStreamSeed(seed,0), GetStreamSeed(seed,1), ... generate
+  // uncorrelated and reproducible events, and their trees can be merged
+  // with hadd. The seed is never 0, which would make TRandom3 seed from the time.
+  ULong64_t z = (ULong64_t)seed*0x9E3779B97F4A7C15ULL + (ULong64_t)(stream+1);
+  z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+  z = (z^(z>>27))*0x94D049BB133111EBULL;
+  z = z^(z>>31);
+  UInt_t s = (UInt_t)(z^(z>>32));
+  return s ? s : 1;
+}
+
 //---------------------------------------------------------------------------------
 void AliGlauberMC::RunAndSaveNtuple( Int_t n,
                                      const Option_t *sysA,
@@ -1793,7 +1787,7 @@ void AliGlauberMC::RunAndSaveNtuple( Int_t n,
   mcg.Setr(r);
   mcg.Seta(a);
   mcg.Run(n);
-  TNtuple  *nt=mcg.GetNtuple();
+  TTree  *nt=mcg.GetTree();
   TFile out(fname,"recreate",fname,9);
   if(nt) nt->Write();
   printf("total cross section with a nucleon-nucleon cross section \t%f is \t%f",signn,mcg.GetTotXSect());
@@ -1853,7 +1847,7 @@ void AliGlauberMC::RunAndSaveNucleons( Int_t n,
 //---------------------------------------------------------------------------------
 void AliGlauberMC::Reset()
 {
-  //delete the ntuple
-  delete fnt;
-  fnt=NULL;
+  //delete the tree
+  delete fTree;
+  fTree=NULL;
 }
@@ -18,7 +18,7 @@
 #include <TNamed.h>
 
 class TObjArray;
-class TNtuple;
+class TTree;
 
 using std::cout;
 using std::endl;
@@ -78,7 +78,8 @@ public:
    Int_t        GetNcoll()           const {return fNcoll;}
    Int_t        GetNpart()           const {return fNpart;}
    Int_t        GetNpartFound()      const {return fMaxNpartFound;}
-   TNtuple*     GetNtuple()          const {return fnt;}
+   TTree*       GetTree()            const {return fTree;}
+   TTree*       GetNtuple()          const {return fTree;} // same as GetTree, for existing macros
    TObjArray   *GetNucleons();
    Double_t     GetTotXSect()        const;
    Double_t     GetTotXSectErr()     const;
@@ -102,6 +103,7 @@ public:
             {fDoFluc=on;fOmega=omega;fSig0=sig0;fLambda=lam;}
    static void       PrintVersion()         {cout << "AliGlauberMC " << Version() << endl;}
    static const char *Version()             {return "v1.2";}
+   static UInt_t     GetStreamSeed(UInt_t seed, Int_t stream);
    static void       RunAndSaveNtuple( Int_t n,
                                        const Option_t *sysA="Pb",
                                        const Option_t *sysB="Pb",
@@ -128,7 +130,7 @@ private:
    Int_t        fQAN;             //Number of nucleons in nucleus A
    Int_t        fBN;             //Number of nucleons in nucleus B
    Int_t        fQBN;             //Number of nucleons in nucleus B
-   TNtuple*     fnt;             //Ntuple for results (created, but not deleted)
+   TTree*       fTree;           //Tree for results, one branch per quantity (created, but not deleted)
    Double_t     fMeanX2;         //<x^2> of wounded nucleons
    Double_t     fMeanY2;         //<y^2> of wounded nucleons
    Double_t     fMeanXY;         //<xy> of wounded nucleons
@@ -252,8 +254,12 @@ private:
    Double_t     fLambda;         //lambda parameter
    TF1         *fSigFluc;        //!parameterization for fluctuating sigNN
    Bool_t       CalcResults(Double_t bgen);
+   void         ResetResults();
+   void         AddPartMoments(Double_t x, Double_t y);
+   void         AddCollMoments(Double_t x, Double_t y, Double_t w);
+   void         AddComMoments(Double_t x, Double_t y, Double_t w);
 
-   ClassDef(AliGlauberMC,4)
+   ClassDef(AliGlauberMC,5)
 };
 
 #endif
@@ -28,6 +28,17 @@
 // the derivation from THnSparse is obviously against many OO rules. correct would be a common baseclass of THnSparse and THn.
 //
 // Templated version allows also the use of double as storage container
+//
+// Optionally (SetFillBuffer) the filled entries are buffered per step and applied in batches sorted by
+// global bin index, which turns random writes into the (large) data container into an ordered sweep.
+// Entries falling into the same bin are applied in the order in which they were filled, therefore the
+// result is identical to the unbuffered mode. The buffers are flushed automatically when the contents
+// are accessed, merged or written.
+//
+// Optionally (SetChunkedStorage) the bins are stored in chunks which are allocated when one of their bins
+// is filled for the first time, instead of one dense array per step. The sumw2 of a chunk is only created
+// when the chunk receives a weight != 1. Only the allocated chunks are written to file. FillParent/FillContainer
+// work directly on the chunks; GetValues/GetSumw2 convert the object back to dense storage.
 // 
 // Author: Jan Fiete Grosse-Oetringhaus
 
@@ -37,11 +48,89 @@
 #include "AliLog.h"
 #include "TArrayF.h"
 #include "TArrayD.h"
+#include "TArrayI.h"
 #include "THnSparse.h"
 #include "TMath.h"
+#include "TBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
 
 templateClassImp(AliTHnT)
 
+Long64_t AliTHnBase::fgMergeChunkSize = 65536;
+
+//____________________________________________________________________
+template <class Func>
+static void RunParallel(Long64_t nTasks, Int_t nThreads, Func func)
+{
+  // calls func(task) for all tasks in [0, nTasks), distributed dynamically over nThreads threads
+
+  if (nThreads <= 1 || nTasks <= 1)
+  {
+    for (Long64_t task = 0; task < nTasks; task++)
+      func(task);
+    return;
+  }
+
+  std::atomic<Long64_t> nextTask(0);
+  std::vector<std::thread> threads;
+  for (Int_t i=0; i<TMath::Min((Long64_t) nThreads, nTasks); i++)
+    threads.push_back(std::thread([&nextTask, nTasks, &func]() {
+      Long64_t task;
+      while ((task = nextTask++) < nTasks)
+        func(task);
+    }));
+  for (UInt_t i=0; i<threads.size(); i++)
+    threads[i].join();
+}
+
+//____________________________________________________________________
+template <typename TemplateType>
+static void AddOccupiedChunks(const std::vector<std::pair<TemplateType*, const TemplateType*> >& arrays, Long64_t nBins, Long64_t chunkSize, Int_t nThreads)
+{
+  // adds each source array (second) to its target array (first)
+  // the arrays are split in chunks of chunkSize bins; first the occupancy bitmap of the source chunks is built,
+  // then only the occupied chunks are added. Both passes are distributed over nThreads threads.
+  // Each bin is only touched by a single thread, therefore the result does not depend on the number of threads.
+
+  if (arrays.empty() || nBins <= 0)
+    return;
+
+  const Long64_t nChunks = (nBins + chunkSize - 1) / chunkSize;
+  const Long64_t nTasks = nChunks * (Long64_t) arrays.size();
+  std::vector<UChar_t> occupied(nTasks, 0);
+
+  RunParallel(nTasks, nThreads, [&](Long64_t task) {
+    const TemplateType* source = arrays[task / nChunks].second;
+    const Long64_t begin = (task % nChunks) * chunkSize;
+    const Long64_t end = TMath::Min(begin + chunkSize, nBins);
+    for (Long64_t l = begin; l<end; l++)
+      if (source[l] != 0)
+      {
+        occupied[task] = 1;
+        break;
+      }
+  });
+
+  std::vector<Long64_t> tasks;
+  for (Long64_t task = 0; task < nTasks; task++)
+    if (occupied[task])
+      tasks.push_back(task);
+
+  RunParallel((Long64_t) tasks.size(), nThreads, [&](Long64_t i) {
+    const Long64_t task = tasks[i];
+    TemplateType* target = arrays[task / nChunks].first;
+    const TemplateType* source = arrays[task / nChunks].second;
+    const Long64_t begin = (task % nChunks) * chunkSize;
+    const Long64_t end = TMath::Min(begin + chunkSize, nBins);
+    for (Long64_t l = begin; l<end; l++)
+      target[l] += source[l];
+  });
+}
+
 template <class TemplateArray, typename TemplateType>
 AliTHnT<TemplateArray, TemplateType>::AliTHnT() : 
   AliTHnBase(),
@@ -53,7 +142,20 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fFillBufferSize(0),
+  fBufferBins(0),
+  fBufferWeights(0),
+  fBufferN(0),
+  fChunkSize(0),
+  fChunkIndex(0),
+  fPackedValues(0),
+  fPackedSumw2(0),
+  fValueChunks(0),
+  fSumw2Chunks(0)
 {
   // Constructor
 }
@@ -69,7 +171,20 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fFillBufferSize(0),
+  fBufferBins(0),
+  fBufferWeights(0),
+  fBufferN(0),
+  fChunkSize(0),
+  fChunkIndex(0),
+  fPackedValues(0),
+  fPackedSumw2(0),
+  fValueChunks(0),
+  fSumw2Chunks(0)
 {
   // Constructor
 
@@ -106,10 +221,24 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   axisCache(0),
   fNbinsCache(0),
   fLastVars(0),
-  fLastBins(0)
+  fLastBins(0),
+  fUniformCache(0),
+  fXminCache(0),
+  fXmaxCache(0),
+  fFillBufferSize(0),
+  fBufferBins(0),
+  fBufferWeights(0),
+  fBufferN(0),
+  fChunkSize(0),
+  fChunkIndex(0),
+  fPackedValues(0),
+  fPackedSumw2(0),
+  fValueChunks(0),
+  fSumw2Chunks(0)
 {
   //
   // AliTHnT copy constructor
+  // entries still buffered in c are applied to the copy, c keeps them
   //
 
   memset(fValues,0,fNSteps*sizeof(TemplateArray*));
@@ -120,6 +249,8 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
     if (c.fSumw2[i])  fSumw2[i]  = new TemplateArray(*(c.fSumw2[i]));
   }
 
+  CopyChunks(c);
+  AddPending(&c);
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -135,12 +266,22 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   delete[] fNbinsCache;
   delete[] fLastVars;
   delete[] fLastBins;
+  delete[] fUniformCache;
+  delete[] fXminCache;
+  delete[] fXmaxCache;
+  DeleteBuffers();
+  DeleteChunks();
+  DeletePacked();
 }
 
 template <class TemplateArray, typename TemplateType>
 void AliTHnT<TemplateArray, TemplateType>::DeleteContainers()
 {
-  // delete data containers
+  // delete data containers (pending buffered entries are discarded as well)
+  
+  if (fBufferN)
+    for (Int_t i=0; i<fNSteps; i++)
+      fBufferN[i] = 0;
   
   for (Int_t i=0; i<fNSteps; i++)
   {
@@ -155,6 +296,17 @@ void AliTHnT<TemplateArray, TemplateType>::DeleteContainers()
       delete fSumw2[i];
       fSumw2[i] = 0;
     }
+    
+    if (fValueChunks)
+    {
+      for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+      {
+        delete[] fValueChunks[i][j];
+        delete[] fSumw2Chunks[i][j];
+        fValueChunks[i][j] = 0;
+        fSumw2Chunks[i][j] = 0;
+      }
+    }
   }
 }
 
@@ -163,8 +315,12 @@ template <class TemplateArray, typename TemplateType>
 AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::operator=(const AliTHnT<TemplateArray, TemplateType> &c)
 {
   // assigment operator
+  // entries still buffered in c are applied to this, c keeps them
 
   if (this != &c) {
+    DeleteBuffers();
+    DeleteChunks();
+    DeletePacked();
     AliCFContainer::operator=(c);
     fNBins=c.fNBins;
     fNVars=c.fNVars;
@@ -191,9 +347,17 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
       fValues = 0;
       fSumw2 = 0;
     }
+    CopyChunks(c);
+    AddPending(&c);
     delete [] axisCache;
     axisCache = new TAxis*[fNVars];
     memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
+    delete [] fUniformCache;
+    delete [] fXminCache;
+    delete [] fXmaxCache;
+    fUniformCache = 0;
+    fXminCache = 0;
+    fXmaxCache = 0;
   }
   return *this;
 }
@@ -203,9 +367,14 @@ template <class TemplateArray, typename TemplateType>
 void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
 {
   // copy function
+  // entries still buffered in this are applied to the target, this keeps them
 
   AliTHnT& target = (AliTHnT &) c;
   
+  target.DeleteBuffers();
+  target.DeleteChunks();
+  target.DeletePacked();
+  
   AliCFContainer::Copy(target);
   
   target.fNSteps = fNSteps;
@@ -226,6 +395,9 @@ void AliTHnT<TemplateArray, TemplateType>::Copy(TObject& c) const
     else
       target.fSumw2[i] = 0;
   }
+  
+  target.CopyChunks(*this);
+  target.AddPending(this);
 }
 
 //____________________________________________________________________
@@ -235,6 +407,11 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
   // Merge a list of AliTHnT objects with this (needed for
   // PROOF). 
   // Returns the number of merged objects (including this).
+  // The bins are added in chunks (SetMergeChunkSize) distributed over
+  // the threads set with AliCFContainer::SetMergeThreads; all-zero chunks
+  // of the inputs are skipped.
+  // The inputs are not modified: inputs with another storage layout are read
+  // as they are and their pending buffered entries are added to this.
 
   if (!list)
     return 0;
@@ -244,6 +421,8 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
   
   AliCFContainer::Merge(list);
 
+  FlushBuffers();
+
   TIterator* iter = list->MakeIterator();
   TObject* obj;
   
@@ -254,27 +433,44 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
     if (entry == 0) 
       continue;
 
+    // entries still buffered in the input are added to this directly
+    AddPending(entry);
+    
+    if (entry->fChunkSize != fChunkSize)
+    {
+      MergeStorage(entry);
+      count++;
+      continue;
+    }
+    
+    if (fValueChunks)
+    {
+      MergeChunked(entry);
+      count++;
+      continue;
+    }
+
+    // collect the arrays of all steps, they are added chunk-wise skipping empty chunks (see AddOccupiedChunks)
+    // a missing sumw2 equals the values (all weights were 1), as in the chunked storage
+    std::vector<std::pair<TemplateType*, const TemplateType*> > arrays;
     for (Int_t i=0; i<fNSteps; i++)
     {
-      if (entry->fValues[i])
-      {
-	if (!fValues[i])
-	  fValues[i] = new TemplateArray(fNBins);
+      if (!entry->fValues[i])
+        continue;
       
-	for (Long64_t l = 0; l<fNBins; l++)
-	  fValues[i]->GetArray()[l] += entry->fValues[i]->GetArray()[l];
-      }
-
-      if (entry->fSumw2[i])
-      {
-	if (!fSumw2[i])
-	  fSumw2[i] = new TemplateArray(fNBins);
+      if (!fValues[i])
+	fValues[i] = new TemplateArray(fNBins);
       
-	for (Long64_t l = 0; l<fNBins; l++)
-	  fSumw2[i]->GetArray()[l] += entry->fSumw2[i]->GetArray()[l];
-      }
+      if (entry->fSumw2[i] && !fSumw2[i])
+	fSumw2[i] = new TemplateArray(*fValues[i]);
+      
+      arrays.push_back(std::make_pair(fValues[i]->GetArray(), (const TemplateType*) entry->fValues[i]->GetArray()));
+      if (fSumw2[i])
+	arrays.push_back(std::make_pair(fSumw2[i]->GetArray(), (const TemplateType*) ((entry->fSumw2[i]) ? entry->fSumw2[i] : entry->fValues[i])->GetArray()));
     }
     
+    AddOccupiedChunks(arrays, fNBins, fgMergeChunkSize, AliCFContainer::GetMergeThreads());
+    
     count++;
   }
 
@@ -308,6 +504,9 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
     }
   }
   
+  if (!fUniformCache)
+    InitBinningCache();
+  
   // calculate global bin index
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
@@ -319,7 +518,18 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
       tmpBin = fLastBins[i];
     else
     {
-      tmpBin = axisCache[i]->FindBin(var[i]);
+      if (fUniformCache[i])
+      {
+        // same computation as TAxis::FindBin for fixed bin width
+        if (var[i] < fXminCache[i])
+          tmpBin = 0;
+        else if (!(var[i] < fXmaxCache[i]))
+          tmpBin = fNbinsCache[i] + 1;
+        else
+          tmpBin = 1 + int (fNbinsCache[i] * (var[i] - fXminCache[i]) / (fXmaxCache[i] - fXminCache[i]));
+      }
+      else
+        tmpBin = axisCache[i]->FindBin(var[i]);
       fLastBins[i] = tmpBin;
       fLastVars[i] = var[i];
     }
@@ -334,22 +544,60 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 //     Printf("%lld", bin);
   }
 
-  if (!fValues[istep])
+  // chunked storage: chunks and their sumw2 are created on first touch in AddChunked
+  if (!fValueChunks && !fValues[istep])
   {
     fValues[istep] = new TemplateArray(fNBins);
     AliInfo(Form("Created values container for step %d", istep));
   }
 
-  if (weight != 1)
+  if (!fValueChunks && weight != 1)
   {
     // initialize with already filled entries (which have been filled with weight == 1), in this case fSumw2 := fValues
     if (!fSumw2[istep])
     {
+      // buffered entries have weight 1 and belong to fValues at this point
+      FlushBuffer(istep);
       fSumw2[istep] = new TemplateArray(*fValues[istep]);
       AliInfo(Form("Created sumw2 container for step %d", istep));
     }
   }
 
+  if (fFillBufferSize > 0)
+  {
+    if (!fBufferN)
+    {
+      fBufferBins = new Long64_t*[fNSteps];
+      fBufferWeights = new Double_t*[fNSteps];
+      fBufferN = new Int_t[fNSteps];
+      for (Int_t i=0; i<fNSteps; i++)
+      {
+        fBufferBins[i] = 0;
+        fBufferWeights[i] = 0;
+        fBufferN[i] = 0;
+      }
+    }
+    
+    if (!fBufferBins[istep])
+    {
+      fBufferBins[istep] = new Long64_t[fFillBufferSize];
+      fBufferWeights[istep] = new Double_t[fFillBufferSize];
+    }
+    
+    fBufferBins[istep][fBufferN[istep]] = bin;
+    fBufferWeights[istep][fBufferN[istep]] = weight;
+    if (++fBufferN[istep] >= fFillBufferSize)
+      FlushBuffer(istep);
+    
+    return;
+  }
+
+  if (fValueChunks)
+  {
+    AddChunked(istep, bin, weight);
+    return;
+  }
+
   fValues[istep]->GetArray()[bin] += weight;
   if (fSumw2[istep])
     fSumw2[istep]->GetArray()[bin] += weight * weight;
@@ -360,6 +608,697 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 //   AliCFContainer::Fill(var, istep, weight);
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight)
+{
+  // fills n entries in one go
+  // var contains n consecutive sets of fNVars values, weight the n weights (if 0, all weights are 1)
+
+  for (Int_t i=0; i<n; i++)
+    AliTHnT<TemplateArray, TemplateType>::Fill(var + i * fNVars, istep, (weight) ? weight[i] : 1.);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::InitBinningCache()
+{
+  // caches which axes have a fixed bin width together with their limits, for those the bin is computed in closed form in Fill
+  
+  fUniformCache = new Bool_t[fNVars];
+  fXminCache = new Double_t[fNVars];
+  fXmaxCache = new Double_t[fNVars];
+  
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    fUniformCache[i] = (axisCache[i]->GetXbins()->fN == 0);
+    fXminCache[i] = axisCache[i]->GetXmin();
+    fXmaxCache[i] = axisCache[i]->GetXmax();
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetFillBuffer(Int_t size)
+{
+  // buffers up to <size> entries per step before they are applied to the data container sorted by bin
+  // size = 0 switches buffering off
+  
+  FlushBuffers();
+  DeleteBuffers();
+  
+  fFillBufferSize = (size > 0) ? size : 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteBuffers()
+{
+  // deletes the fill buffers, pending entries are lost
+  
+  if (!fBufferN)
+    return;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    delete[] fBufferBins[i];
+    delete[] fBufferWeights[i];
+  }
+  
+  delete[] fBufferBins;
+  delete[] fBufferWeights;
+  delete[] fBufferN;
+  
+  fBufferBins = 0;
+  fBufferWeights = 0;
+  fBufferN = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FlushBuffers()
+{
+  // applies all buffered entries to the data containers
+  
+  if (!fBufferN)
+    return;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+    FlushBuffer(i);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FlushBuffer(Int_t step)
+{
+  // applies the buffered entries of step <step> in order of the global bin index
+  // the sort is on (bin, position in buffer), so that entries of the same bin are added in fill order
+  
+  if (!fBufferN || fBufferN[step] == 0)
+    return;
+  
+  const Int_t n = fBufferN[step];
+  const Long64_t* bins = fBufferBins[step];
+  const Double_t* weights = fBufferWeights[step];
+  
+  std::vector<std::pair<Long64_t, Int_t> > order(n);
+  for (Int_t i=0; i<n; i++)
+    order[i] = std::make_pair(bins[i], i);
+  std::sort(order.begin(), order.end());
+  
+  if (fValueChunks)
+  {
+    for (Int_t i=0; i<n; i++)
+      AddChunked(step, order[i].first, weights[order[i].second]);
+    fBufferN[step] = 0;
+    return;
+  }
+  
+  TemplateType* values = fValues[step]->GetArray();
+  TemplateType* sumw2 = (fSumw2[step]) ? fSumw2[step]->GetArray() : 0;
+  
+  for (Int_t i=0; i<n; i++)
+  {
+    const Double_t weight = weights[order[i].second];
+    values[order[i].first] += weight;
+    if (sumw2)
+      sumw2[order[i].first] += weight * weight;
+  }
+  
+  fBufferN[step] = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+TArray* AliTHnT<TemplateArray, TemplateType>::GetValues(Int_t step)
+{
+  // returns the values container of step <step>
+  // chunked storage is converted to dense storage before (see SetChunkedStorage)
+  
+  FlushBuffers();
+  ConvertToDense();
+  return fValues[step];
+}
+
+template <class TemplateArray, typename TemplateType>
+TArray* AliTHnT<TemplateArray, TemplateType>::GetSumw2(Int_t step)
+{
+  // returns the sumw2 container of step <step>
+  // chunked storage is converted to dense storage before (see SetChunkedStorage)
+  
+  FlushBuffers();
+  ConvertToDense();
+  return fSumw2[step];
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::SetChunkedStorage(Int_t chunkSize)
+{
+  // switches to chunked storage with <chunkSize> bins per chunk (0 = dense storage, the default)
+  // a chunk is only allocated when one of its bins is filled, its sumw2 only when it receives a weight != 1,
+  // therefore the memory usage follows the populated part of the phase space instead of the total number of bins
+  // existing content is converted
+  
+  if (chunkSize < 0)
+    chunkSize = 0;
+  if (chunkSize == fChunkSize)
+    return;
+  
+  ConvertToDense();
+  if (chunkSize > 0)
+    ConvertToChunked(chunkSize);
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::GetAllocatedBins() const
+{
+  // returns the number of allocated bins (values and sumw2) summed over all steps
+  
+  Long64_t count = 0;
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (fValueChunks)
+    {
+      for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+      {
+        if (fValueChunks[i][j])
+          count += fChunkSize;
+        if (fSumw2Chunks[i][j])
+          count += fChunkSize;
+      }
+    }
+    if (fValues[i])
+      count += fNBins;
+    if (fSumw2[i])
+      count += fNBins;
+  }
+  
+  return count;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::InitChunks()
+{
+  // creates the (empty) chunk tables of all steps
+  
+  const Long64_t nChunks = GetNChunks();
+  
+  fValueChunks = new std::vector<TemplateType*>[fNSteps];
+  fSumw2Chunks = new std::vector<TemplateType*>[fNSteps];
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    fValueChunks[i].assign(nChunks, (TemplateType*) 0);
+    fSumw2Chunks[i].assign(nChunks, (TemplateType*) 0);
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteChunks()
+{
+  // deletes all chunks and the chunk tables
+  
+  if (!fValueChunks)
+    return;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+    {
+      delete[] fValueChunks[i][j];
+      delete[] fSumw2Chunks[i][j];
+    }
+  }
+  
+  delete[] fValueChunks;
+  delete[] fSumw2Chunks;
+  fValueChunks = 0;
+  fSumw2Chunks = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::CopyChunks(const AliTHnT& c)
+{
+  // copies the storage mode and the chunks of <c>, this object must not hold chunks
+  
+  fChunkSize = c.fChunkSize;
+  if (!c.fValueChunks)
+    return;
+  
+  InitChunks();
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+    {
+      if (c.fValueChunks[i][j])
+      {
+        fValueChunks[i][j] = new TemplateType[fChunkSize];
+        memcpy(fValueChunks[i][j], c.fValueChunks[i][j], fChunkSize * sizeof(TemplateType));
+      }
+      if (c.fSumw2Chunks[i][j])
+      {
+        fSumw2Chunks[i][j] = new TemplateType[fChunkSize];
+        memcpy(fSumw2Chunks[i][j], c.fSumw2Chunks[i][j], fChunkSize * sizeof(TemplateType));
+      }
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddChunked(Int_t step, Long64_t bin, Double_t weight)
+{
+  // adds an entry to the chunked storage, the chunk is allocated on first touch
+  // the sumw2 chunk is created with the first weight != 1; as all previous entries of the chunk had weight 1, it starts as a copy of the values
+  
+  const Long64_t chunk = bin / fChunkSize;
+  const Long64_t offset = bin - chunk * fChunkSize;
+  
+  TemplateType*& values = fValueChunks[step][chunk];
+  if (!values)
+    values = new TemplateType[fChunkSize]();
+  
+  TemplateType*& sumw2 = fSumw2Chunks[step][chunk];
+  if (weight != 1 && !sumw2)
+  {
+    sumw2 = new TemplateType[fChunkSize];
+    memcpy(sumw2, values, fChunkSize * sizeof(TemplateType));
+  }
+  
+  values[offset] += weight;
+  if (sumw2)
+    sumw2[offset] += weight * weight;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::ConvertToDense()
+{
+  // converts chunked storage into dense storage (fValues, fSumw2)
+  
+  if (!fValueChunks)
+    return;
+  
+  FlushBuffers();
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    Bool_t hasSumw2 = kFALSE;
+    for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+    {
+      if (!fValueChunks[i][j])
+        continue;
+      
+      if (!fValues[i])
+        fValues[i] = new TemplateArray(fNBins);
+      
+      const Long64_t begin = j * (Long64_t) fChunkSize;
+      memcpy(fValues[i]->GetArray() + begin, fValueChunks[i][j], TMath::Min((Long64_t) fChunkSize, fNBins - begin) * sizeof(TemplateType));
+      if (fSumw2Chunks[i][j])
+        hasSumw2 = kTRUE;
+    }
+    
+    if (!hasSumw2)
+      continue;
+    
+    // chunks without sumw2 had only entries with weight 1
+    fSumw2[i] = new TemplateArray(*fValues[i]);
+    for (UInt_t j=0; j<fSumw2Chunks[i].size(); j++)
+    {
+      if (!fSumw2Chunks[i][j])
+        continue;
+      
+      const Long64_t begin = j * (Long64_t) fChunkSize;
+      memcpy(fSumw2[i]->GetArray() + begin, fSumw2Chunks[i][j], TMath::Min((Long64_t) fChunkSize, fNBins - begin) * sizeof(TemplateType));
+    }
+  }
+  
+  DeleteChunks();
+  fChunkSize = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::ConvertToChunked(Int_t chunkSize)
+{
+  // converts dense storage into chunked storage with <chunkSize> bins per chunk, all-zero chunks are not allocated
+  
+  FlushBuffers();
+  
+  fChunkSize = chunkSize;
+  InitChunks();
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (!fValues[i])
+      continue;
+    
+    const TemplateType* values = fValues[i]->GetArray();
+    const TemplateType* sumw2 = (fSumw2[i]) ? fSumw2[i]->GetArray() : 0;
+    
+    for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+    {
+      const Long64_t begin = j * (Long64_t) fChunkSize;
+      const Long64_t n = TMath::Min((Long64_t) fChunkSize, fNBins - begin);
+      
+      Bool_t occupied = kFALSE;
+      for (Long64_t l = begin; l < begin + n && !occupied; l++)
+        if (values[l] != 0 || (sumw2 && sumw2[l] != 0))
+          occupied = kTRUE;
+      if (!occupied)
+        continue;
+      
+      fValueChunks[i][j] = new TemplateType[fChunkSize]();
+      memcpy(fValueChunks[i][j], values + begin, n * sizeof(TemplateType));
+      if (sumw2)
+      {
+        fSumw2Chunks[i][j] = new TemplateType[fChunkSize]();
+        memcpy(fSumw2Chunks[i][j], sumw2 + begin, n * sizeof(TemplateType));
+      }
+    }
+    
+    delete fValues[i];
+    fValues[i] = 0;
+    delete fSumw2[i];
+    fSumw2[i] = 0;
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::PackChunks()
+{
+  // packs the allocated chunks into fPackedValues/fPackedSumw2 with their position in fChunkIndex, for writing
+  // in dense storage mode only the (empty) tables are created
+  
+  DeletePacked();
+  
+  fChunkIndex = new TArrayI*[fNSteps];
+  fPackedValues = new TemplateArray*[fNSteps];
+  fPackedSumw2 = new TemplateArray*[fNSteps];
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    fChunkIndex[i] = 0;
+    fPackedValues[i] = 0;
+    fPackedSumw2[i] = 0;
+  }
+  
+  if (!fValueChunks)
+    return;
+  
+  const Long64_t nChunks = GetNChunks();
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    Int_t nValues = 0;
+    Int_t nSumw2 = 0;
+    for (Long64_t j=0; j<nChunks; j++)
+    {
+      if (fValueChunks[i][j])
+        nValues++;
+      if (fSumw2Chunks[i][j])
+        nSumw2++;
+    }
+    if (nValues == 0)
+      continue;
+    
+    // entry j: slot of value chunk j, entry nChunks + j: slot of sumw2 chunk j
+    fChunkIndex[i] = new TArrayI(2 * nChunks);
+    fChunkIndex[i]->Reset(-1);
+    fPackedValues[i] = new TemplateArray(nValues * fChunkSize);
+    if (nSumw2 > 0)
+      fPackedSumw2[i] = new TemplateArray(nSumw2 * fChunkSize);
+    
+    nValues = 0;
+    nSumw2 = 0;
+    for (Long64_t j=0; j<nChunks; j++)
+    {
+      if (fValueChunks[i][j])
+      {
+        memcpy(fPackedValues[i]->GetArray() + (Long64_t) nValues * fChunkSize, fValueChunks[i][j], fChunkSize * sizeof(TemplateType));
+        fChunkIndex[i]->GetArray()[j] = nValues++;
+      }
+      if (fSumw2Chunks[i][j])
+      {
+        memcpy(fPackedSumw2[i]->GetArray() + (Long64_t) nSumw2 * fChunkSize, fSumw2Chunks[i][j], fChunkSize * sizeof(TemplateType));
+        fChunkIndex[i]->GetArray()[nChunks + j] = nSumw2++;
+      }
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::UnpackChunks()
+{
+  // restores the chunks from the packed arrays (see PackChunks)
+  
+  InitChunks();
+  if (!fChunkIndex)
+    return;
+  
+  const Long64_t nChunks = GetNChunks();
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    if (!fChunkIndex[i])
+      continue;
+    
+    const Int_t* index = fChunkIndex[i]->GetArray();
+    for (Long64_t j=0; j<nChunks; j++)
+    {
+      if (index[j] >= 0)
+      {
+        fValueChunks[i][j] = new TemplateType[fChunkSize];
+        memcpy(fValueChunks[i][j], fPackedValues[i]->GetArray() + (Long64_t) index[j] * fChunkSize, fChunkSize * sizeof(TemplateType));
+      }
+      if (index[nChunks + j] >= 0)
+      {
+        fSumw2Chunks[i][j] = new TemplateType[fChunkSize];
+        memcpy(fSumw2Chunks[i][j], fPackedSumw2[i]->GetArray() + (Long64_t) index[nChunks + j] * fChunkSize, fChunkSize * sizeof(TemplateType));
+      }
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeletePacked()
+{
+  // deletes the packed arrays used for streaming
+  
+  if (fChunkIndex)
+  {
+    for (Int_t i=0; i<fNSteps; i++)
+    {
+      delete fChunkIndex[i];
+      delete fPackedValues[i];
+      delete fPackedSumw2[i];
+    }
+  }
+  
+  delete[] fChunkIndex;
+  delete[] fPackedValues;
+  delete[] fPackedSumw2;
+  fChunkIndex = 0;
+  fPackedValues = 0;
+  fPackedSumw2 = 0;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::MergeChunked(const AliTHnT* entry)
+{
+  // adds the chunks of <entry> (same chunk size) to this, chunks which are not allocated in <entry> are skipped
+  // the chunks are distributed over the merge threads (see Merge)
+  
+  const Long64_t nChunks = GetNChunks();
+  
+  RunParallel(fNSteps * nChunks, AliCFContainer::GetMergeThreads(), [&](Long64_t task) {
+    const Int_t i = task / nChunks;
+    const Long64_t j = task % nChunks;
+    
+    const TemplateType* source = entry->fValueChunks[i][j];
+    if (!source)
+      return;
+    const TemplateType* sourceSumw2 = entry->fSumw2Chunks[i][j];
+    
+    TemplateType*& values = fValueChunks[i][j];
+    TemplateType*& sumw2 = fSumw2Chunks[i][j];
+    if (!values)
+      values = new TemplateType[fChunkSize]();
+    // a missing sumw2 chunk equals the values chunk (all weights were 1)
+    if (sourceSumw2 && !sumw2)
+    {
+      sumw2 = new TemplateType[fChunkSize];
+      memcpy(sumw2, values, fChunkSize * sizeof(TemplateType));
+    }
+    
+    for (Int_t l=0; l<fChunkSize; l++)
+      values[l] += source[l];
+    if (sumw2)
+      for (Int_t l=0; l<fChunkSize; l++)
+        sumw2[l] += (sourceSumw2) ? sourceSumw2[l] : source[l];
+  });
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::MergeStorage(const AliTHnT* entry)
+{
+  // adds <entry>, whose storage layout (dense or chunk size) differs from the one of this, without converting it
+  // the allocated ranges of <entry> are added with AddBins, the steps are distributed over the merge threads
+  
+  RunParallel(fNSteps, AliCFContainer::GetMergeThreads(), [&](Long64_t task) {
+    const Int_t i = task;
+    
+    if (entry->fValueChunks)
+    {
+      const Long64_t chunkSize = entry->fChunkSize;
+      for (UInt_t j=0; j<entry->fValueChunks[i].size(); j++)
+      {
+        if (!entry->fValueChunks[i][j])
+          continue;
+        const Long64_t begin = j * chunkSize;
+        AddBins(i, begin, TMath::Min(chunkSize, fNBins - begin), entry->fValueChunks[i][j], entry->fSumw2Chunks[i][j]);
+      }
+    }
+    else if (entry->fValues[i])
+      AddBins(i, 0, fNBins, entry->fValues[i]->GetArray(), (entry->fSumw2[i]) ? entry->fSumw2[i]->GetArray() : 0);
+  });
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddBins(Int_t step, Long64_t begin, Long64_t n, const TemplateType* values, const TemplateType* sumw2)
+{
+  // adds the bins [begin, begin+n) of step <step> to the storage of this, whatever its layout
+  // sumw2 = 0 means that the sumw2 of the source equal its values (all weights were 1)
+  // in chunked storage, chunks which would only receive zeros are not allocated
+  
+  if (!fValueChunks)
+  {
+    if (!fValues[step])
+      fValues[step] = new TemplateArray(fNBins);
+    // all entries so far had weight 1, the new sumw2 starts as a copy of the values
+    if (sumw2 && !fSumw2[step])
+      fSumw2[step] = new TemplateArray(*fValues[step]);
+    
+    TemplateType* targetValues = fValues[step]->GetArray() + begin;
+    for (Long64_t l=0; l<n; l++)
+      targetValues[l] += values[l];
+    if (fSumw2[step])
+    {
+      TemplateType* targetSumw2 = fSumw2[step]->GetArray() + begin;
+      for (Long64_t l=0; l<n; l++)
+        targetSumw2[l] += (sumw2) ? sumw2[l] : values[l];
+    }
+    return;
+  }
+  
+  const Long64_t end = begin + n;
+  for (Long64_t chunk = begin / fChunkSize; chunk * fChunkSize < end; chunk++)
+  {
+    const Long64_t first = TMath::Max(begin, chunk * fChunkSize);
+    const Long64_t last = TMath::Min(end, (chunk + 1) * fChunkSize);
+    
+    Bool_t occupied = kFALSE;
+    for (Long64_t l = first; l < last && !occupied; l++)
+      if (values[l - begin] != 0 || (sumw2 && sumw2[l - begin] != 0))
+        occupied = kTRUE;
+    if (!occupied)
+      continue;
+    
+    TemplateType*& targetValues = fValueChunks[step][chunk];
+    TemplateType*& targetSumw2 = fSumw2Chunks[step][chunk];
+    if (!targetValues)
+      targetValues = new TemplateType[fChunkSize]();
+    if (sumw2 && !targetSumw2)
+    {
+      targetSumw2 = new TemplateType[fChunkSize];
+      memcpy(targetSumw2, targetValues, fChunkSize * sizeof(TemplateType));
+    }
+    
+    const Long64_t offset = chunk * fChunkSize;
+    for (Long64_t l = first; l < last; l++)
+    {
+      targetValues[l - offset] += values[l - begin];
+      if (targetSumw2)
+        targetSumw2[l - offset] += (sumw2) ? sumw2[l - begin] : values[l - begin];
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddPending(const AliTHnT* entry)
+{
+  // adds the entries still buffered in <entry> (see SetFillBuffer) to the storage of this, <entry> keeps them
+  
+  if (!entry->fBufferN)
+    return;
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    for (Int_t k=0; k<entry->fBufferN[i]; k++)
+    {
+      const Long64_t bin = entry->fBufferBins[i][k];
+      const Double_t weight = entry->fBufferWeights[i][k];
+      
+      if (fValueChunks)
+      {
+        AddChunked(i, bin, weight);
+        continue;
+      }
+      
+      // same as the unbuffered Fill
+      if (!fValues[i])
+        fValues[i] = new TemplateArray(fNBins);
+      if (weight != 1 && !fSumw2[i])
+        fSumw2[i] = new TemplateArray(*fValues[i]);
+      fValues[i]->GetArray()[bin] += weight;
+      if (fSumw2[i])
+        fSumw2[i]->GetArray()[bin] += weight * weight;
+    }
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillContainerChunked(AliCFContainer* cont)
+{
+  // fills the chunked storage into the container <cont>, only allocated chunks are visited
+  
+  Int_t* binIdx = new Int_t[fNVars];
+  Int_t* nBins  = new Int_t[fNVars];
+  
+  for (Int_t i=0; i<fNSteps; i++)
+  {
+    THnSparse* target = cont->GetGrid(i)->GetGrid();
+    for (Int_t k=0; k<fNVars; k++)
+      nBins[k] = target->GetAxis(k)->GetNbins();
+    
+    Long64_t count = 0;
+    Bool_t filled = kFALSE;
+    for (UInt_t j=0; j<fValueChunks[i].size(); j++)
+    {
+      const TemplateType* source = fValueChunks[i][j];
+      if (!source)
+        continue;
+      filled = kTRUE;
+      
+      // if fSumw2 is not stored, the sqrt of the number of bin entries in source is filled below; otherwise we use fSumw2
+      const TemplateType* sourceSumw2 = (fSumw2Chunks[i][j]) ? fSumw2Chunks[i][j] : source;
+      
+      const Long64_t begin = j * (Long64_t) fChunkSize;
+      const Long64_t n = TMath::Min((Long64_t) fChunkSize, fNBins - begin);
+      for (Long64_t l=0; l<n; l++)
+      {
+        if (source[l] == 0)
+          continue;
+        
+        // inverse of GetGlobalBinIndex
+        Long64_t globalBin = begin + l;
+        for (Int_t k=fNVars-1; k>=0; k--)
+        {
+          binIdx[k] = globalBin % nBins[k] + 1;
+          globalBin /= nBins[k];
+        }
+        
+        target->SetBinContent(binIdx, source[l]);
+        target->SetBinError(binIdx, TMath::Sqrt(sourceSumw2[l]));
+        
+        count++;
+      }
+    }
+    
+    if (filled)
+      AliInfo(Form("Step %d: copied %lld entries out of %lld bins", i, count, fNBins));
+  }
+  
+  delete[] binIdx;
+  delete[] nBins;
+}
+
 template <class TemplateArray, typename TemplateType>
 Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* binIdx)
 {
@@ -382,6 +1321,14 @@ void AliTHnT<TemplateArray, TemplateType>::FillContainer(AliCFContainer* cont)
 {
   // fills the information stored in the buffer in this class into the container <cont>
   
+  FlushBuffers();
+  
+  if (fValueChunks)
+  {
+    FillContainerChunked(cont);
+    return;
+  }
+  
   for (Int_t i=0; i<fNSteps; i++)
   {
     if (!fValues[i])
@@ -456,6 +1403,12 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
 {
   // "removes" one axis by summing over the axis and putting the entry to bin 1
   // TODO presently only implemented for the last axis
+  // chunked storage is converted to dense storage for the operation and back afterwards
+  
+  FlushBuffers();
+  
+  const Int_t chunkSize = fChunkSize;
+  ConvertToDense();
   
   Int_t axis = fNVars-1;
   
@@ -529,6 +1482,35 @@ void AliTHnT<TemplateArray, TemplateType>::ReduceAxis()
     delete[] binIdx;
     delete[] nBins;
   }
+  
+  if (chunkSize > 0)
+    ConvertToChunked(chunkSize);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::Streamer(TBuffer &R__b)
+{
+  // Stream an object of class AliTHnT
+  // pending buffered entries are applied before writing
+  // chunked storage is written as the packed allocated chunks (see PackChunks)
+  
+  if (R__b.IsReading())
+  {
+    // entries still pending belong to the previous content
+    DeleteBuffers();
+    DeleteChunks();
+    R__b.ReadClassBuffer(AliTHnT<TemplateArray, TemplateType>::Class(), this);
+    if (fChunkSize > 0)
+      UnpackChunks();
+    DeletePacked();
+  }
+  else
+  {
+    FlushBuffers();
+    PackChunks();
+    R__b.WriteClassBuffer(AliTHnT<TemplateArray, TemplateType>::Class(), this);
+    DeletePacked();
+  }
 }
 
 template class AliTHnT<TArrayF, Float_t>;
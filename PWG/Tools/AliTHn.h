@@ -13,11 +13,14 @@
 #include "TObject.h"
 #include "TString.h"
 #include "AliCFContainer.h"
+#include <vector>
 
 class TArray;
 class TArrayF;
 class TArrayD;
+class TArrayI;
 class TCollection;
+class TBuffer;
 
 class AliTHnBase : public AliCFContainer
 {
@@ -26,6 +29,7 @@ public:
   AliTHnBase(const Char_t* name, const Char_t* title,const Int_t nSelStep, const Int_t nVarIn, const Int_t* nBinIn) : AliCFContainer(name, title, nSelStep, nVarIn, nBinIn) { }
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight) = 0;
   virtual void FillParent() = 0;
   virtual void FillContainer(AliCFContainer* cont) = 0;
 
@@ -34,6 +38,17 @@ public:
 
   virtual void DeleteContainers() = 0;
   virtual void ReduceAxis() = 0;  
+
+  virtual void SetFillBuffer(Int_t size) = 0;
+  virtual void FlushBuffers() = 0;
+  
+  virtual void SetChunkedStorage(Int_t chunkSize) = 0;
+  
+  static void     SetMergeChunkSize(Long64_t size) { fgMergeChunkSize = (size > 0) ? size : 1; } // number of bins per chunk in Merge (default 65536)
+  static Long64_t GetMergeChunkSize() { return fgMergeChunkSize; }
+  
+protected:
+  static Long64_t fgMergeChunkSize; // number of bins per chunk in Merge
   
   ClassDef(AliTHnBase, 1) // AliTHn base class
 };
@@ -48,15 +63,24 @@ class AliTHnT : public AliTHnBase
   virtual ~AliTHnT();
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weight);
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
-  virtual TArray* GetValues(Int_t step) { return fValues[step]; }
-  virtual TArray* GetSumw2(Int_t step)  { return fSumw2[step]; }
+  virtual TArray* GetValues(Int_t step);
+  virtual TArray* GetSumw2(Int_t step);
   
   virtual void DeleteContainers();
   virtual void ReduceAxis();
   
+  virtual void SetFillBuffer(Int_t size);
+  Int_t GetFillBuffer() const { return fFillBufferSize; }
+  virtual void FlushBuffers();
+  
+  virtual void SetChunkedStorage(Int_t chunkSize);
+  Int_t GetChunkedStorage() const { return fChunkSize; }
+  Long64_t GetAllocatedBins() const;
+  
   AliTHnT(const AliTHnT &c);
   AliTHnT& operator=(const AliTHnT& corr);
   virtual void Copy(TObject& c) const;
@@ -65,8 +89,27 @@ class AliTHnT : public AliTHnBase
   
 protected:
   void Init();
+  void InitBinningCache();
+  void DeleteBuffers();
+  void FlushBuffer(Int_t step);
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
   
+  Long64_t GetNChunks() const { return (fNBins + fChunkSize - 1) / fChunkSize; }
+  void InitChunks();
+  void DeleteChunks();
+  void CopyChunks(const AliTHnT& c);
+  void AddChunked(Int_t step, Long64_t bin, Double_t weight);
+  void ConvertToDense();
+  void ConvertToChunked(Int_t chunkSize);
+  void PackChunks();
+  void UnpackChunks();
+  void DeletePacked();
+  void MergeChunked(const AliTHnT* entry);
+  void MergeStorage(const AliTHnT* entry);
+  void AddBins(Int_t step, Long64_t begin, Long64_t n, const TemplateType* values, const TemplateType* sumw2);
+  void AddPending(const AliTHnT* entry);
+  void FillContainerChunked(AliCFContainer* cont);
+  
   Long64_t fNBins;   // number of total bins
   Int_t    fNVars;   // number of variables
   Int_t    fNSteps;  // number of selection steps
@@ -77,8 +120,23 @@ protected:
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
+  Bool_t* fUniformCache; //! axis has fixed bin width, bin is computed in closed form instead of TAxis::FindBin
+  Double_t* fXminCache; //! cache lower edge per axis
+  Double_t* fXmaxCache; //! cache upper edge per axis
+  
+  Int_t      fFillBufferSize; //! number of entries buffered per step before they are applied (0 = no buffering)
+  Long64_t** fBufferBins;     //! [fNSteps][fFillBufferSize] buffered global bin indices
+  Double_t** fBufferWeights;  //! [fNSteps][fFillBufferSize] buffered weights
+  Int_t*     fBufferN;        //! [fNSteps] number of buffered entries
+  
+  Int_t fChunkSize;                 // chunked storage: number of bins per chunk (0 = dense storage in fValues/fSumw2)
+  TArrayI** fChunkIndex;            //[fNSteps] chunked storage, only set while streaming: slot of each value and sumw2 chunk in the packed arrays (-1 = not allocated)
+  TemplateArray** fPackedValues;    //[fNSteps] chunked storage, only set while streaming: allocated value chunks
+  TemplateArray** fPackedSumw2;     //[fNSteps] chunked storage, only set while streaming: allocated sumw2 chunks
+  std::vector<TemplateType*>* fValueChunks; //! [fNSteps] chunked storage: value chunks (0 = not allocated)
+  std::vector<TemplateType*>* fSumw2Chunks; //! [fNSteps] chunked storage: sumw2 chunks (0 = not allocated, all weights in the chunk were 1)
   
-  ClassDef(AliTHnT, 5) // THn like container
+  ClassDef(AliTHnT, 6) // THn like container
 };
 
 typedef AliTHnT<TArrayF, Float_t> AliTHn;
@@ -21,6 +21,7 @@
 #include <vector>
 #include <TArrayD.h>
 #include <TAxis.h>
+#include <TExMap.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TH3.h>
@@ -42,14 +43,16 @@ ClassImp(THistManager)
 THistManager::THistManager():
 		TNamed(),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistIndex(NULL)
 {
 }
 
 THistManager::THistManager(const char *name):
 		TNamed(name, Form("Histogram container %s", name)),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistIndex(NULL)
 {
 	fHistos = new THashList();
 	fHistos->SetName(Form("histos%s", name));
@@ -58,6 +61,7 @@ THistManager::THistManager(const char *name):
 
 THistManager::~THistManager(){
 	if(fHistos && fIsOwner) delete fHistos;
+	if(fHistIndex) delete fHistIndex;
 }
 
 THashList* THistManager::CreateHistoGroup(const char *groupname) {
@@ -91,6 +95,7 @@ TH1* THistManager::CreateTH1(const char *name, const char *title, int nbins, dou
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -108,6 +113,7 @@ TH1* THistManager::CreateTH1(const char *name, const char *title, int nbins, con
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -125,6 +131,7 @@ TH1* THistManager::CreateTH1(const char *name, const char *title, const TArrayD
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -152,6 +159,7 @@ TH2* THistManager::CreateTH2(const char *name, const char *title, int nbinsx, do
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -169,6 +177,7 @@ TH2* THistManager::CreateTH2(const char *name, const char *title, int nbinsx, co
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -186,6 +195,7 @@ TH2* THistManager::CreateTH2(const char *name, const char *title, const TArrayD
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -219,6 +229,7 @@ TH3* THistManager::CreateTH3(const char* name, const char* title, int nbinsx, do
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -236,6 +247,7 @@ TH3* THistManager::CreateTH3(const char* name, const char* title, int nbinsx, co
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -253,6 +265,7 @@ TH3* THistManager::CreateTH3(const char* name, const char* title, const TArrayD&
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -291,6 +304,7 @@ THnSparse* THistManager::CreateTHnSparse(const char *name, const char *title, in
   if(optionstring.Contains("s"))
     h->Sumw2();
 	parent->Add(h);
+	RegisterObject(name, h);
 	return h;
 }
 
@@ -318,6 +332,7 @@ THnSparse* THistManager::CreateTHnSparse(const char *name, const char *title, in
   if(optionstring.Contains("s"))
     hsparse->Sumw2();
 	parent->Add(hsparse);
+	RegisterObject(name, hsparse);
 	return hsparse;
 }
 
@@ -351,6 +366,7 @@ THnSparse* THistManager::CreateTHnSparse(const char *name, const char *title, in
   if(optionstring.Contains("s"))
     hsparse->Sumw2();
   parent->Add(hsparse);
+  RegisterObject(name, hsparse);
   return hsparse;
 }
 
@@ -362,6 +378,7 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTProfile", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xmin, xmax, opt);
   parent->Add(hist);
+  RegisterObject(name, hist);
 }
 
 void THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, const double* xbins, Option_t *opt) {
@@ -372,6 +389,7 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xbins, opt);
   parent->Add(hist);
+  RegisterObject(name, hist);
 }
 
 void THistManager::CreateTProfile(const char* name, const char* title, const TArrayD& xbins, Option_t *opt){
@@ -382,6 +400,7 @@ void THistManager::CreateTProfile(const char* name, const char* title, const TAr
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname.Data(), title, xbins.GetSize()-1, xbins.GetArray(), opt);
   parent->Add(hist);
+  RegisterObject(name, hist);
 }
 
 void THistManager::CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt){
@@ -406,41 +425,22 @@ void THistManager::SetObject(TObject * const o, const char *group) {
 		return;
 	}
 	fHistos->Add(o);
+	RegisterObject(o->GetName(), o);
 }
 
 void THistManager::FillTH1(const char *name, double x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH1", "Parnt group %s does not exist", dirname.Data());
-		return;
-	}
-	TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
+	TH1 *hist = dynamic_cast<TH1 *>(FindIndexed(name));
 	if(!hist){
-		Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH1", "Histogram %s not found", name);
 		return;
 	}
-	TString optionstring(opt);
-	if(optionstring.Contains("w")){
-	  // use bin width as weight
-	  Int_t bin = hist->GetXaxis()->FindBin(x);
-	  // check if not overflow or underflow bin
-	  if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
-	    weight = 1./hist->GetXaxis()->GetBinWidth(bin);
-	}
-	hist->Fill(x, weight);
+	DoFillTH1(hist, x, weight, opt);
 }
 
 void THistManager::FillTH1(const char *name, const char *label, double weight, Option_t *opt) {
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent){
-    Fatal("THistManager::FillTH1", "Parnt group %s does not exist", dirname.Data());
-    return;
-  }
-  TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
+  TH1 *hist = dynamic_cast<TH1 *>(FindIndexed(name));
   if(!hist){
-    Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+    Fatal("THistManager::FillTH1", "Histogram %s not found", name);
     return;
   }
 	TString optionstring(opt);
@@ -456,162 +456,305 @@ void THistManager::FillTH1(const char *name, const char *label, double weight, O
 }
 
 void THistManager::FillTH2(const char *name, double x, double y, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
+	TH2 *hist = dynamic_cast<TH2 *>(FindIndexed(name));
 	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH2", "Histogram %s not found", name);
 		return;
 	}
-	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(x);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(y);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
-	hist->Fill(x, y, myweight);
+	DoFillTH2(hist, x, y, weight, opt);
 }
 
 void THistManager::FillTH2(const char *name, double *point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
+	TH2 *hist = dynamic_cast<TH2 *>(FindIndexed(name));
+	if(!hist){
+		Fatal("THistManager::FillTH2", "Histogram %s not found", name);
 		return;
 	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
+	DoFillTH2(hist, point[0], point[1], weight, opt);
+}
+
+void THistManager::FillTH3(const char* name, double x, double y, double z, double weight, Option_t *opt) {
+	TH3 *hist = dynamic_cast<TH3 *>(FindIndexed(name));
 	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH3", "Histogram %s not found", name);
 		return;
 	}
-	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(point[0]);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(point[1]);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
-	hist->Fill(point[0], point[1], weight);
+	DoFillTH3(hist, x, y, z, weight, opt);
 }
 
-void THistManager::FillTH3(const char* name, double x, double y, double z, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
+void THistManager::FillTH3(const char* name, const double* point, double weight, Option_t *opt) {
+	TH3 *hist = dynamic_cast<TH3 *>(FindIndexed(name));
+	if(!hist){
+		Fatal("THistManager::FillTH3", "Histogram %s not found", name);
 		return;
 	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
+	DoFillTH3(hist, point[0], point[1], point[2], weight, opt);
+}
+
+void THistManager::FillTHnSparse(const char *name, const double *x, double weight, Option_t *opt) {
+	THnSparseD *hist = dynamic_cast<THnSparseD *>(FindIndexed(name));
 	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTHnSparse", "Histogram %s not found", name);
 		return;
 	}
-	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(x);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
+	DoFillTHnSparse(hist, x, weight, opt);
+}
+
+void THistManager::FillProfile(const char* name, double x, double y, double weight){
+  TProfile *hist = dynamic_cast<TProfile *>(FindIndexed(name));
+  if(!hist){
+		Fatal("THistManager::FillTProfile", "Histogram %s not found", name);
+		return;
+  }
+  hist->Fill(x, y, weight);
+}
+
+THistHandle<TH1> THistManager::GetTH1Handle(const char *name) const {
+	TH1 *hist = dynamic_cast<TH1 *>(FindIndexed(name));
+	if(!hist) Fatal("THistManager::GetTH1Handle", "Histogram %s not found", name);
+	return THistHandle<TH1>(hist);
+}
+
+THistHandle<TH2> THistManager::GetTH2Handle(const char *name) const {
+	TH2 *hist = dynamic_cast<TH2 *>(FindIndexed(name));
+	if(!hist) Fatal("THistManager::GetTH2Handle", "Histogram %s not found", name);
+	return THistHandle<TH2>(hist);
+}
+
+THistHandle<TH3> THistManager::GetTH3Handle(const char *name) const {
+	TH3 *hist = dynamic_cast<TH3 *>(FindIndexed(name));
+	if(!hist) Fatal("THistManager::GetTH3Handle", "Histogram %s not found", name);
+	return THistHandle<TH3>(hist);
+}
+
+THistHandle<THnSparse> THistManager::GetTHnSparseHandle(const char *name) const {
+	THnSparse *hist = dynamic_cast<THnSparseD *>(FindIndexed(name));
+	if(!hist) Fatal("THistManager::GetTHnSparseHandle", "Histogram %s not found", name);
+	return THistHandle<THnSparse>(hist);
+}
+
+THistHandle<TProfile> THistManager::GetTProfileHandle(const char *name) const {
+	TProfile *hist = dynamic_cast<TProfile *>(FindIndexed(name));
+	if(!hist) Fatal("THistManager::GetTProfileHandle", "Histogram %s not found", name);
+	return THistHandle<TProfile>(hist);
+}
+
+void THistManager::FillTH1(const THistHandle<TH1> &hist, double x, double weight, Option_t *opt) {
+	if(!hist.IsValid()){
+		Fatal("THistManager::FillTH1", "Invalid histogram handle");
+		return;
 	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(y);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
+	DoFillTH1(hist.Get(), x, weight, opt);
+}
+
+void THistManager::FillTH2(const THistHandle<TH2> &hist, double x, double y, double weight, Option_t *opt) {
+	if(!hist.IsValid()){
+		Fatal("THistManager::FillTH2", "Invalid histogram handle");
+		return;
 	}
-	if(optstring.Contains("wz")){
-	  Int_t binz = hist->GetZaxis()->FindBin(z);
-	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
+	DoFillTH2(hist.Get(), x, y, weight, opt);
+}
+
+void THistManager::FillTH3(const THistHandle<TH3> &hist, double x, double y, double z, double weight, Option_t *opt) {
+	if(!hist.IsValid()){
+		Fatal("THistManager::FillTH3", "Invalid histogram handle");
+		return;
 	}
-	hist->Fill(x, y, z, weight);
+	DoFillTH3(hist.Get(), x, y, z, weight, opt);
 }
 
-void THistManager::FillTH3(const char* name, const double* point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
+void THistManager::FillTHnSparse(const THistHandle<THnSparse> &hist, const double *x, double weight, Option_t *opt) {
+	if(!hist.IsValid()){
+		Fatal("THistManager::FillTHnSparse", "Invalid histogram handle");
 		return;
 	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
-	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+	DoFillTHnSparse(hist.Get(), x, weight, opt);
+}
+
+void THistManager::FillProfile(const THistHandle<TProfile> &hist, double x, double y, double weight) {
+	if(!hist.IsValid()){
+		Fatal("THistManager::FillTProfile", "Invalid histogram handle");
 		return;
 	}
-	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(point[0]);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
+	hist->Fill(x, y, weight);
+}
+
+void THistManager::FillTH1(ULong64_t key, double x, double weight, Option_t *opt) {
+	TH1 *hist = dynamic_cast<TH1 *>(FindObjectByKey(key));
+	if(!hist){
+		Fatal("THistManager::FillTH1", "Histogram with key %llu not found", key);
+		return;
 	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(point[1]);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
+	DoFillTH1(hist, x, weight, opt);
+}
+
+void THistManager::FillTH2(ULong64_t key, double x, double y, double weight, Option_t *opt) {
+	TH2 *hist = dynamic_cast<TH2 *>(FindObjectByKey(key));
+	if(!hist){
+		Fatal("THistManager::FillTH2", "Histogram with key %llu not found", key);
+		return;
 	}
-	if(optstring.Contains("wz")){
-	  Int_t binz = hist->GetZaxis()->FindBin(point[2]);
-	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
+	DoFillTH2(hist, x, y, weight, opt);
+}
+
+void THistManager::FillTH3(ULong64_t key, double x, double y, double z, double weight, Option_t *opt) {
+	TH3 *hist = dynamic_cast<TH3 *>(FindObjectByKey(key));
+	if(!hist){
+		Fatal("THistManager::FillTH3", "Histogram with key %llu not found", key);
+		return;
 	}
-	hist->Fill(point[0], point[1], point[2], weight);
+	DoFillTH3(hist, x, y, z, weight, opt);
 }
 
-void THistManager::FillTHnSparse(const char *name, const double *x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTHnSparse", "Parent group %s does not exist", dirname.Data());
+void THistManager::FillTHnSparse(ULong64_t key, const double *x, double weight, Option_t *opt) {
+	THnSparseD *hist = dynamic_cast<THnSparseD *>(FindObjectByKey(key));
+	if(!hist){
+		Fatal("THistManager::FillTHnSparse", "Histogram with key %llu not found", key);
 		return;
 	}
-	THnSparseD *hist = dynamic_cast<THnSparseD *>(parent->FindObject(hname));
+	DoFillTHnSparse(hist, x, weight, opt);
+}
+
+void THistManager::FillProfile(ULong64_t key, double x, double y, double weight) {
+	TProfile *hist = dynamic_cast<TProfile *>(FindObjectByKey(key));
 	if(!hist){
-		Fatal("THistManager::FillTHnSparse", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTProfile", "Histogram with key %llu not found", key);
 		return;
 	}
-	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	for(Int_t iaxis = 0; iaxis < hist->GetNdimensions(); iaxis++){
-	  std::stringstream weighthandler;
-	  weighthandler << "w" << iaxis;
-	  if(optstring.Contains(weighthandler.str().c_str())){
-	    Int_t bin = hist->GetAxis(iaxis)->FindBin(x[iaxis]);
-	    if(bin != 0 && bin != hist->GetAxis(iaxis)->GetNbins()) myweight *= hist->GetAxis(iaxis)->GetBinWidth(bin);
+	hist->Fill(x, y, weight);
+}
+
+void THistManager::DoFillTH1(TH1 *hist, double x, double weight, Option_t *opt) {
+	if(opt && opt[0]){
+	  TString optionstring(opt);
+	  if(optionstring.Contains("w")){
+	    // use bin width as weight
+	    Int_t bin = hist->GetXaxis()->FindBin(x);
+	    // check if not overflow or underflow bin
+	    if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
+	      weight = 1./hist->GetXaxis()->GetBinWidth(bin);
 	  }
 	}
-
 	hist->Fill(x, weight);
 }
 
-void THistManager::FillProfile(const char* name, double x, double y, double weight){
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent)
-		Fatal("THistManager::FillTProfile", "Parent group %s does not exist", dirname.Data());
-  TProfile *hist = dynamic_cast<TProfile *>(parent->FindObject(hname));
-  if(!hist)
-		Fatal("THistManager::FillTProfile", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
-  hist->Fill(x, y, weight);
+void THistManager::DoFillTH2(TH2 *hist, double x, double y, double weight, Option_t *opt) {
+	Double_t myweight = weight;
+	if(opt && opt[0]){
+	  TString optstring(opt);
+	  if(optstring.Contains("w")) myweight = 1.;
+	  if(optstring.Contains("wx")){
+	    Int_t binx = hist->GetXaxis()->FindBin(x);
+	    if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
+	  }
+	  if(optstring.Contains("wy")){
+	    Int_t biny = hist->GetYaxis()->FindBin(y);
+	    if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
+	  }
+	}
+	hist->Fill(x, y, myweight);
+}
+
+void THistManager::DoFillTH3(TH3 *hist, double x, double y, double z, double weight, Option_t *opt) {
+	Double_t myweight = weight;
+	if(opt && opt[0]){
+	  TString optstring(opt);
+	  if(optstring.Contains("w")) myweight = 1.;
+	  if(optstring.Contains("wx")){
+	    Int_t binx = hist->GetXaxis()->FindBin(x);
+	    if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
+	  }
+	  if(optstring.Contains("wy")){
+	    Int_t biny = hist->GetYaxis()->FindBin(y);
+	    if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
+	  }
+	  if(optstring.Contains("wz")){
+	    Int_t binz = hist->GetZaxis()->FindBin(z);
+	    if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
+	  }
+	}
+	hist->Fill(x, y, z, myweight);
+}
+
+void THistManager::DoFillTHnSparse(THnSparse *hist, const double *x, double weight, Option_t *opt) {
+	Double_t myweight = weight;
+	if(opt && opt[0]){
+	  TString optstring(opt);
+	  if(optstring.Contains("w")) myweight = 1.;
+	  for(Int_t iaxis = 0; iaxis < hist->GetNdimensions(); iaxis++){
+	    std::stringstream weighthandler;
+	    weighthandler << "w" << iaxis;
+	    if(optstring.Contains(weighthandler.str().c_str())){
+	      Int_t bin = hist->GetAxis(iaxis)->FindBin(x[iaxis]);
+	      if(bin != 0 && bin != hist->GetAxis(iaxis)->GetNbins()) myweight *= 1./hist->GetAxis(iaxis)->GetBinWidth(bin);
+	    }
+	  }
+	}
+
+	hist->Fill(x, myweight);
 }
 
 TObject *THistManager::FindObject(const char *name) const {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent) return NULL;
-	return parent->FindObject(hname);
+	return FindIndexed(name);
 }
 
 TObject* THistManager::FindObject(const TObject* obj) const {
-	TString dirname(basename(obj->GetName())), hname(histname(obj->GetName()));
+	return FindIndexed(obj->GetName());
+}
+
+TObject *THistManager::FindObjectByKey(ULong64_t key) const {
+	if(!fHistos) return NULL;
+	if(fHistIndex){
+	  TObject *o = reinterpret_cast<TObject *>(static_cast<Long_t>(fHistIndex->GetValue(key, static_cast<Long64_t>(key))));
+	  if(o) return o;
+	}
+	// key not known (yet) - index the full content, i.e. after reading the manager from file
+	BuildIndex(fHistos, "");
+	return reinterpret_cast<TObject *>(static_cast<Long_t>(fHistIndex->GetValue(key, static_cast<Long64_t>(key))));
+}
+
+TObject *THistManager::FindIndexed(const char *name) const {
+	if(!fHistos) return NULL;
+	ULong64_t key = HashKey(name);
+	if(fHistIndex){
+	  TObject *o = reinterpret_cast<TObject *>(static_cast<Long_t>(fHistIndex->GetValue(key, static_cast<Long64_t>(key))));
+	  if(o) return o;
+	}
+	// fall back to the search in the group, index the result
+	TString dirname(basename(name)), hname(histname(name));
 	THashList *parent(FindGroup(dirname));
 	if(!parent) return NULL;
-	return parent->FindObject(hname);
+	TObject *o = parent->FindObject(hname);
+	if(o) RegisterObject(name, o);
+	return o;
+}
+
+void THistManager::RegisterObject(const char *path, TObject *o) const {
+	if(!fHistIndex) fHistIndex = new TExMap;
+	ULong64_t key = HashKey(path);
+	Long64_t value = static_cast<Long64_t>(reinterpret_cast<Long_t>(o));
+	Long64_t found = fHistIndex->GetValue(key, static_cast<Long64_t>(key));
+	if(found == value) return;
+	if(found){
+	  // same path: object was replaced in its group, otherwise two paths share the key
+	  if(histname(path) != reinterpret_cast<TObject *>(static_cast<Long_t>(found))->GetName()){
+	    Fatal("THistManager::RegisterObject", "Hash collision for object %s", path);
+	    return;
+	  }
+	  fHistIndex->Remove(key, static_cast<Long64_t>(key));
+	}
+	fHistIndex->Add(key, static_cast<Long64_t>(key), value);
+}
+
+void THistManager::BuildIndex(const THashList *group, const TString &path) const {
+	TIter next(group);
+	TObject *o(NULL);
+	while((o = next())){
+	  TString objpath = path.Length() ? TString::Format("%s/%s", path.Data(), o->GetName()) : TString(o->GetName());
+	  RegisterObject(objpath, o);
+	  THashList *subgroup = dynamic_cast<THashList *>(o);
+	  if(subgroup) BuildIndex(subgroup, objpath);
+	}
 }
 
 THashList *THistManager::FindGroup(const char *dirname) const {
@@ -1005,6 +1148,102 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandles(){
+    THistManager testmgr("testmgr");
+
+    testmgr.CreateTH1("Group1/Test1", "Test 1D via name", 1, 0., 1.);
+    testmgr.CreateTH1("Group1/Test2", "Test 1D via handle", 1, 0., 1.);
+    testmgr.CreateTH2("Group2/Test1", "Test 2D via key", 1, 0., 1., 1, 0., 1.);
+    testmgr.CreateTProfile("Group3/Subgroup1/Test1", "Test profile via handle", 1, 0., 1.);
+
+    // bin widths 0.5 in x, 0.25 in y and 0.125 in z/axis 2
+    testmgr.CreateTH2("Group4/Test1", "Test 2D bin width weights", 4, 0., 2., 4, 0., 1.);
+    testmgr.CreateTH3("Group4/Test2", "Test 3D bin width weights", 4, 0., 2., 4, 0., 1., 4, 0., 0.5);
+    const int nbinsW[3] = {4, 4, 4};
+    const double minW[3] = {0., 0., 0.}, maxW[3] = {2., 1., 0.5};
+    testmgr.CreateTHnSparse("Group4/Test3", "Test THnSparse bin width weights", 3, nbinsW, minW, maxW);
+
+    THistHandle<TH1> handle1D = testmgr.GetTH1Handle("Group1/Test2");
+    THistHandle<TProfile> handleProfile = testmgr.GetTProfileHandle("/Group3/Subgroup1/Test1");
+    const ULong64_t key2D = THistManager::HashKey("Group2/Test1");
+
+    for(int i = 0; i < 100; i++){
+      testmgr.FillTH1("Group1/Test1", 0.5);
+      testmgr.FillTH1(handle1D, 0.5);
+      testmgr.FillTH2(key2D, 0.5, 0.5);
+      testmgr.FillProfile(handleProfile, 0.5, 1);
+    }
+
+    const double pointW[3] = {0.25, 0.1, 0.1};
+    for(int i = 0; i < 10; i++){
+      // the weight argument is ignored with "w" options
+      testmgr.FillTH2(testmgr.GetTH2Handle("Group4/Test1"), 0.25, 0.1, 3., "wxwy");
+      testmgr.FillTH3(testmgr.GetTH3Handle("Group4/Test2"), 0.25, 0.1, 0.1, 3., "wxwz");
+      testmgr.FillTHnSparse(THistManager::HashKey("Group4/Test3"), pointW, 3., "w0w1w2");
+    }
+
+    // Evaluate test
+    bool success(true);
+
+    const char *names1D[2] = {"Group1/Test1", "Group1/Test2"};
+    for(int i = 0; i < 2; i++){
+      TH1 *test1 = dynamic_cast<TH1 *>(testmgr.FindObject(names1D[i]));
+      if(test1){
+        if(TMath::Abs(test1->GetBinContent(1) - 100) > DBL_EPSILON){
+          std::cout << names1D[i] << ": Value mismatch: expected 100, found " << test1->GetBinContent(1) << std::endl;
+          success = false;
+        }
+      } else {
+        std::cout << "Not found: " << names1D[i] << std::endl;
+        success = false;
+      }
+    }
+
+    TH2 *test2 = dynamic_cast<TH2 *>(testmgr.FindObjectByKey(key2D));
+    if(test2 && test2 == testmgr.FindObject("Group2/Test1")){
+      if(TMath::Abs(test2->GetBinContent(1,1) - 100) > DBL_EPSILON){
+        std::cout << "Group2/Test1: Value mismatch: expected 100, found " << test2->GetBinContent(1,1) << std::endl;
+        success = false;
+      }
+    } else {
+      std::cout << "Not found by key: Group2/Test1" << std::endl;
+      success = false;
+    }
+
+    // 10 fills with weights 1/(0.5*0.25), 1/(0.5*0.125) and 1/(0.5*0.25*0.125)
+    const char *namesW[3] = {"Group4/Test1", "Group4/Test2", "Group4/Test3"};
+    const double expectedW[3] = {80., 160., 640.};
+    for(int i = 0; i < 3; i++){
+      TObject *testW = testmgr.FindObject(namesW[i]);
+      double content = -1;
+      if(TH2 *h2 = dynamic_cast<TH2 *>(testW)) content = h2->GetBinContent(1, 1);
+      else if(TH3 *h3 = dynamic_cast<TH3 *>(testW)) content = h3->GetBinContent(1, 1, 1);
+      else if(THnSparse *hs = dynamic_cast<THnSparse *>(testW)){
+        const int bins[3] = {1, 1, 1};
+        content = hs->GetBinContent(bins);
+      } else {
+        std::cout << "Not found: " << namesW[i] << std::endl;
+        success = false;
+        continue;
+      }
+      if(TMath::Abs(content - expectedW[i]) > 1e-9){
+        std::cout << namesW[i] << ": Value mismatch: expected " << expectedW[i] << ", found " << content << std::endl;
+        success = false;
+      }
+    }
+
+    if(handleProfile.IsValid()){
+      if(TMath::Abs(handleProfile->GetBinContent(1) - 1) > DBL_EPSILON){
+        std::cout << "Group3/Subgroup1/Test1: Value mismatch: expected 1, found " << handleProfile->GetBinContent(1) << std::endl;
+        success = false;
+      }
+    } else {
+      std::cout << "Invalid handle: Group3/Subgroup1/Test1" << std::endl;
+      success = false;
+    }
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1025,6 +1264,10 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handles" << std::endl;
+    testresult += testsuite.TestFillHandles();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1047,4 +1290,9 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandles(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandles();
+  }
 }
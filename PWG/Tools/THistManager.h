@@ -11,6 +11,7 @@
 class TArrayD;
 class TAxis;
 class TBinning;
+class TExMap;
 class TList;
 class TH1;
 class TH2;
@@ -23,6 +24,30 @@ class TProfile;
  * @brief Histogram manager and components needed to make it work.
  */
 
+/**
+ * @class THistHandle
+ * @brief Lightweight typed handle to a histogram inside the THistManager
+ * @ingroup Histmanager
+ *
+ * Obtained once from the histogram manager (i.e. THistManager::GetTH1Handle)
+ * and afterwards passed to the corresponding Fill method, which then fills the
+ * histogram without any name lookup. The handle does not own the histogram,
+ * it is valid as long as the histogram manager it was obtained from.
+ */
+template<class H>
+class THistHandle {
+public:
+  THistHandle(): fHist(NULL) {}
+  explicit THistHandle(H *hist): fHist(hist) {}
+
+  bool IsValid() const { return fHist != NULL; }
+  H *Get() const { return fHist; }
+  H *operator->() const { return fHist; }
+
+private:
+  H *fHist;                             ///< Histogram the handle points to
+};
+
 /**
  * @class THistManager
  * @brief Container class for histograms
@@ -95,6 +120,27 @@ class TProfile;
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
  * the weight is calculated for all directions at the same time.
+ *
+ * ## Pre-resolved access
+ *
+ * All histograms are indexed by a 64-bit hash of their full path. For
+ * histograms filled many times per event the lookup can be done once
+ * instead of at every Fill call, either via a typed handle
+ *
+ * ~~~{.cxx}
+ * THistHandle<TH1> hpt = mgr.GetTH1Handle("hPt");   // i.e. in UserCreateOutputObjects
+ * mgr.FillTH1(hpt, pt);                            // no string handling
+ * ~~~
+ *
+ * or via the integer key of the histogram path, which can be computed at
+ * compile time:
+ *
+ * ~~~{.cxx}
+ * constexpr ULong64_t kPt = THistManager::HashKey("hPt");
+ * mgr.FillTH1(kPt, pt);
+ * ~~~
+ *
+ * The name-based Fill methods use the same index.
  */
 class THistManager : public TNamed {
 public:
@@ -621,6 +667,150 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+#if !defined(__CINT__) || defined(__CLING__)
+	/**
+	 * @brief Hash key of a histogram path.
+	 *
+	 * 64-bit FNV-1a hash of the full path of the histogram, leading
+	 * slashes are ignored. Can be evaluated at compile time and used
+	 * in the key-based Fill methods.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Key of the histogram
+	 */
+	static constexpr ULong64_t HashKey(const char *name) { return HashStep(SkipSlash(name), 14695981039346656037ULL); }
+#endif
+
+	/**
+	 * @brief Get a typed handle to a 1D histogram.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Handle to the histogram (Fatal if not found)
+	 */
+	THistHandle<TH1> GetTH1Handle(const char *name) const;
+
+	/**
+	 * @brief Get a typed handle to a 2D histogram.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Handle to the histogram (Fatal if not found)
+	 */
+	THistHandle<TH2> GetTH2Handle(const char *name) const;
+
+	/**
+	 * @brief Get a typed handle to a 3D histogram.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Handle to the histogram (Fatal if not found)
+	 */
+	THistHandle<TH3> GetTH3Handle(const char *name) const;
+
+	/**
+	 * @brief Get a typed handle to a sparse histogram.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Handle to the histogram (Fatal if not found)
+	 */
+	THistHandle<THnSparse> GetTHnSparseHandle(const char *name) const;
+
+	/**
+	 * @brief Get a typed handle to a profile histogram.
+	 * @param[in] name Name of the histogram, including parent group(s)
+	 * @return Handle to the histogram (Fatal if not found)
+	 */
+	THistHandle<TProfile> GetTProfileHandle(const char *name) const;
+
+	/**
+	 * @brief Fill a 1D histogram via its handle.
+	 * @param[in] hist Handle obtained from GetTH1Handle
+	 * @param[in] x x-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH1(const THistHandle<TH1> &hist, double x, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a 2D histogram via its handle.
+	 * @param[in] hist Handle obtained from GetTH2Handle
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH2(const THistHandle<TH2> &hist, double x, double y, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a 3D histogram via its handle.
+	 * @param[in] hist Handle obtained from GetTH3Handle
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] z z-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH3(const THistHandle<TH3> &hist, double x, double y, double z, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a sparse histogram via its handle.
+	 * @param[in] hist Handle obtained from GetTHnSparseHandle
+	 * @param[in] x coordinates of the data
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTHnSparse(const THistHandle<THnSparse> &hist, const double *x, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a profile histogram via its handle.
+	 * @param[in] hist Handle obtained from GetTProfileHandle
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 */
+	void FillProfile(const THistHandle<TProfile> &hist, double x, double y, double weight = 1.);
+
+	/**
+	 * @brief Fill a 1D histogram identified by the hash key of its path.
+	 * @param[in] key Hash key of the histogram (see HashKey)
+	 * @param[in] x x-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH1(ULong64_t key, double x, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a 2D histogram identified by the hash key of its path.
+	 * @param[in] key Hash key of the histogram (see HashKey)
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH2(ULong64_t key, double x, double y, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a 3D histogram identified by the hash key of its path.
+	 * @param[in] key Hash key of the histogram (see HashKey)
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] z z-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTH3(ULong64_t key, double x, double y, double z, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a sparse histogram identified by the hash key of its path.
+	 * @param[in] key Hash key of the histogram (see HashKey)
+	 * @param[in] x coordinates of the data
+	 * @param[in] weight optional weight of the entry (default 1)
+	 * @param[in] option Optional filling arguments
+	 */
+	void FillTHnSparse(ULong64_t key, const double *x, double weight = 1., Option_t *opt = "");
+
+	/**
+	 * @brief Fill a profile histogram identified by the hash key of its path.
+	 * @param[in] key Hash key of the histogram (see HashKey)
+	 * @param[in] x x-coordinate
+	 * @param[in] y y-coordinate
+	 * @param[in] weight optional weight of the entry (default 1)
+	 */
+	void FillProfile(ULong64_t key, double x, double y, double weight = 1.);
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -678,6 +868,16 @@ public:
 	 */
 	virtual TObject *FindObject(const TObject *obj) const;
 
+	/**
+	 * @brief Find an object inside the container by the hash key of its path.
+	 *
+	 * In case the key is not yet indexed (i.e. after the histogram manager
+	 * was read from file) the index is rebuilt.
+	 * @param[in] key Hash key of the object (see HashKey)
+	 * @return pointer to the object (NULL if not found)
+	 */
+	TObject *FindObjectByKey(ULong64_t key) const;
+
 private:
 	THistManager(const THistManager &);
 	THistManager &operator=(const THistManager &);
@@ -706,8 +906,45 @@ private:
 	 */
 	TString histname(const TString &path) const;
 
+#if !defined(__CINT__) || defined(__CLING__)
+	static constexpr const char *SkipSlash(const char *name) { return *name == '/' ? SkipSlash(name + 1) : name; }
+	static constexpr ULong64_t HashStep(const char *name, ULong64_t hash) {
+	  return *name ? HashStep(name + 1, (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ULL) : hash;
+	}
+#endif
+
+	/**
+	 * @brief Add an object to the hash index.
+	 * @param[in] path Full path of the object
+	 * @param[in] o Object to be indexed
+	 */
+	void RegisterObject(const char *path, TObject *o) const;
+
+	/**
+	 * @brief Add all objects of a group and its subgroups to the hash index.
+	 * @param[in] group Group to be indexed
+	 * @param[in] path Path of the group
+	 */
+	void BuildIndex(const THashList *group, const TString &path) const;
+
+	/**
+	 * @brief Find an object by its path using the hash index.
+	 *
+	 * Objects not yet indexed are searched in their group and
+	 * added to the index.
+	 * @param[in] name Path of the object
+	 * @return pointer to the object (NULL if not found)
+	 */
+	TObject *FindIndexed(const char *name) const;
+
+	void DoFillTH1(TH1 *hist, double x, double weight, Option_t *opt);
+	void DoFillTH2(TH2 *hist, double x, double y, double weight, Option_t *opt);
+	void DoFillTH3(TH3 *hist, double x, double y, double z, double weight, Option_t *opt);
+	void DoFillTHnSparse(THnSparse *hist, const double *x, double weight, Option_t *opt);
+
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
+	mutable TExMap *fHistIndex;           //!<! Hash index path -> object
 
   /// \cond CLASSIMP
 	ClassDef(THistManager, 1);  // Container for histograms
@@ -749,6 +986,7 @@ namespace TestTHistManager {
  * - Build histrogram in groups
  * - Simple fill
  * - Fill histograms in groups
+ * - Fill histograms via handles and hash keys
  */
 class THistManagerTestSuite {
 public:
@@ -832,6 +1070,22 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Check whether histograms are filled correctly via pre-resolved handles and hash keys
+   * Relies on: TestBuildGroupedHistograms, TestFillGroupedHistograms
+   *
+   * Fill histograms in groups 100 times for bin 1 via
+   * - name (TH1)
+   * - typed handle (TH1, TProfile in a subgroup, obtained with leading slash)
+   * - hash key (TH2)
+   *
+   * Test passed:
+   * - Histograms found by name and by key are the same objects
+   * - All Histograms have the expected value (100 for histograms, 1 for profile)
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandles();
 };
 
 /**
@@ -869,5 +1123,12 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test for filling histograms via handles and hash keys. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandles();
+
 }
 #endif
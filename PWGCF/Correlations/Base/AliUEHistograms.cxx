@@ -25,6 +25,7 @@
 #include "AliUEHistograms.h"
 
 #include "AliCFContainer.h"
+#include "AliTHn.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
 
@@ -36,6 +37,8 @@
 #include "TMath.h"
 #include "TLorentzVector.h"
 
+#include <vector>
+
 ClassImp(AliUEHistograms)
 
 const Int_t AliUEHistograms::fgkUEHists = 3;
@@ -74,6 +77,7 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   fWeightPerEvent(kFALSE),
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
+  fFlatArrayKernel(kFALSE),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -244,6 +248,7 @@ AliUEHistograms::AliUEHistograms(const AliUEHistograms &c) :
   fWeightPerEvent(kFALSE),
   fPtOrder(kTRUE),
   fTwoTrackCutMinRadius(0.8),
+  fFlatArrayKernel(kFALSE),
   fRunNumber(0),
   fMergeCount(1)
 {
@@ -606,10 +611,18 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
+    // the flat-array kernel replaces the pair loops below
+    Bool_t pairLoops = kTRUE;
+    if (fFlatArrayKernel)
+    {
+      FillCorrelationsFlat(centrality, zVtx, step, particles, mixed, eta, weight, firstTime, twoTrackEfficiencyCut, bSign, twoTrackEfficiencyCutValue, applyEfficiency, triggerWeighting);
+      pairLoops = kFALSE;
+    }
+    
     // identify K, Lambda candidates and flag those particles
     // a TObject bit is used for this
     const UInt_t kResonanceDaughterFlag = 1 << 14;
-    if (fRejectResonanceDaughters > 0)
+    if (pairLoops && fRejectResonanceDaughters > 0)
     {
       Double_t resonanceMass = -1;
       Double_t massDaughter1 = -1;
@@ -670,7 +683,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
-    for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+    for (Int_t i=0; pairLoops && i<particles->GetEntriesFast(); i++)
     {
       AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
       
@@ -919,48 +932,7 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
  
       if (firstTime)
-      {
-        // once per trigger particle
-        Double_t vars[3];
-        vars[0] = triggerParticle->Pt();
-        vars[1] = centrality;
-	vars[2] = zVtx;
-
-	Double_t useWeight = 1;
-	if (fEfficiencyCorrectionTriggers && applyEfficiency)
-	{
-	  Int_t effVars[4];
-	  
-	  // trigger particle
-	  effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
-	  effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[0]); //pt
-	  effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[1]); //centrality
-	  effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[2]); //zVtx
-	  useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
-	}
-
-	if (TMath::Abs(triggerEta) < 0.8 && triggerParticle->Pt() > 0)
-	  fInvYield2->Fill(centrality, triggerParticle->Pt(), useWeight / triggerParticle->Pt());
-
-	if (fWeightPerEvent)
-	{
-	  // leads effectively to a filling of one entry per filled trigger particle pT bin
-	  Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[0]);
-// 	  Printf("Using weight %f", triggerWeighting->GetBinContent(weightBin));
-	  useWeight /= triggerWeighting->GetBinContent(weightBin);
-	}
-	
-        fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
-
-	// QA
-        fCorrelationpT->Fill(centrality, triggerParticle->Pt());
-        fCorrelationEta->Fill(centrality, triggerEta);
-        fCorrelationPhi->Fill(centrality, triggerParticle->Phi());
-	fYields->Fill(centrality, triggerParticle->Pt(), triggerEta);
-	
-/*        if (dynamic_cast<AliAODTrack*>(triggerParticle))
-          fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerParticle->Pt());*/
-      }
+        FillTriggerParticle(centrality, zVtx, step, triggerParticle, triggerEta, applyEfficiency, triggerWeighting);
     }
     
     if (triggerWeighting)
@@ -975,6 +947,478 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   FillEvent(centrality, step);
 }
   
+//____________________________________________________________________
+void AliUEHistograms::FillTriggerParticle(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, AliVParticle* triggerParticle, Float_t triggerEta, Bool_t applyEfficiency, TH1* triggerWeighting)
+{
+  // fills the per-trigger histograms (once per trigger particle), see FillCorrelations
+  
+  Double_t vars[3];
+  vars[0] = triggerParticle->Pt();
+  vars[1] = centrality;
+  vars[2] = zVtx;
+
+  Double_t useWeight = 1;
+  if (fEfficiencyCorrectionTriggers && applyEfficiency)
+  {
+    Int_t effVars[4];
+    
+    // trigger particle
+    effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
+    effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[0]); //pt
+    effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[1]); //centrality
+    effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[2]); //zVtx
+    useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+  }
+
+  if (TMath::Abs(triggerEta) < 0.8 && triggerParticle->Pt() > 0)
+    fInvYield2->Fill(centrality, triggerParticle->Pt(), useWeight / triggerParticle->Pt());
+
+  if (fWeightPerEvent)
+  {
+    // leads effectively to a filling of one entry per filled trigger particle pT bin
+    Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[0]);
+//     Printf("Using weight %f", triggerWeighting->GetBinContent(weightBin));
+    useWeight /= triggerWeighting->GetBinContent(weightBin);
+  }
+  
+  fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
+
+  // QA
+  fCorrelationpT->Fill(centrality, triggerParticle->Pt());
+  fCorrelationEta->Fill(centrality, triggerEta);
+  fCorrelationPhi->Fill(centrality, triggerParticle->Phi());
+  fYields->Fill(centrality, triggerParticle->Pt(), triggerEta);
+  
+/*  if (dynamic_cast<AliAODTrack*>(triggerParticle))
+    fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerParticle->Pt());*/
+}
+
+//____________________________________________________________________
+static Int_t CacheBending(std::vector<Int_t>& index, std::vector<Double_t>& table, Int_t k, Float_t pt, Float_t charge, Float_t bSign, const std::vector<Float_t>& radii)
+{
+  // returns the offset of the bending terms charge * bSign * asin(0.075 * radius / pt) of particle k in table
+  // they are calculated for all radii on first use
+  
+  if (index[k] < 0)
+  {
+    index[k] = table.size();
+    for (UInt_t r=0; r<radii.size(); r++)
+      table.push_back(charge * bSign * TMath::ASin(0.075 * radii[r] / pt));
+  }
+  
+  return index[k];
+}
+
+//____________________________________________________________________
+void AliUEHistograms::FillCorrelationsFlat(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed, const TArrayF& eta, Float_t weight, Bool_t firstTime, Bool_t twoTrackEfficiencyCut, Float_t bSign, Float_t twoTrackEfficiencyCutValue, Bool_t applyEfficiency, TH1* triggerWeighting)
+{
+  // replaces the pair loops of FillCorrelations (see there for the parameters) if fFlatArrayKernel is set
+  //
+  // All particles are extracted once into flat arrays (pt, eta, phi, charge, efficiency weights, quantities for the
+  // invariant-mass pre-check), so that no virtual AliVParticle accessor and no efficiency lookup is called per pair.
+  // For each trigger particle the simple pair selections, delta eta and delta phi are evaluated for blocks of
+  // associated particles in branch-free loops. Only the surviving pairs go through the invariant-mass and two-track
+  // cuts and are then filled in bulk (AliTHnBase::FillN). The results are identical to the pair loops in FillCorrelations.
+  //
+  // For mixed events, a particle in mixed can only be equal to the trigger particle (IsEqual) if both are the same object
+  // or have the same unique ID, which holds for all particle classes used with this class.
+  
+  const Int_t kBlockSize = 256;
+  const UInt_t kResonanceDaughterFlag = 1 << 14; // same as in FillCorrelations
+  const Float_t kElectronMass = 0.510e-3;
+  const Float_t kPionMass = 0.1396;
+  const Float_t kProtonMass = 0.9383;
+  
+  Bool_t fillpT = kFALSE;
+  if (weight < 0)
+    fillpT = kTRUE;
+  
+  // flat arrays: index 0..nAssoc-1 are the associated particles, the trigger particle i has index triggerOffset+i
+  // without mixed, trigger and associated particles are the same
+  TObjArray* input = (mixed) ? mixed : particles;
+  const Int_t nAssoc = input->GetEntriesFast();
+  const Int_t nTriggers = particles->GetEntriesFast();
+  const Int_t triggerOffset = (mixed) ? nAssoc : 0;
+  const Int_t nFlat = triggerOffset + nTriggers;
+  
+  std::vector<AliVParticle*> object(nFlat);
+  std::vector<UInt_t> uniqueID(nFlat);
+  std::vector<Double_t> pt(nFlat);
+  std::vector<Double_t> phi(nFlat);
+  std::vector<Float_t> etaFlat(nFlat);
+  std::vector<Int_t> charge(nFlat);
+  std::vector<Float_t> tanTheta(nFlat);
+  std::vector<Double_t> efficiencyAssociated(nFlat, 1);
+  std::vector<Double_t> efficiencyTrigger(nFlat, 1);
+  std::vector<Double_t> triggerWeight(nFlat, 1);
+  std::vector<Char_t> resonanceDaughter(nFlat, 0);
+  
+  for (Int_t k=0; k<nFlat; k++)
+  {
+    AliVParticle* particle = (AliVParticle*) ((k < nAssoc) ? input->UncheckedAt(k) : particles->UncheckedAt(k - triggerOffset));
+    object[k] = particle;
+    uniqueID[k] = particle->GetUniqueID();
+    pt[k] = particle->Pt();
+    phi[k] = particle->Phi();
+    etaFlat[k] = (k < nAssoc) ? eta[k] : particle->Eta();
+    charge[k] = particle->Charge();
+    tanTheta[k] = GetTanThetaCheap(etaFlat[k]);
+    
+    if (applyEfficiency && fEfficiencyCorrectionAssociated && k < nAssoc)
+    {
+      Int_t effVars[4];
+      effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(etaFlat[k]);
+      effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(pt[k]); //pt
+      effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(centrality); //centrality
+      effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin((Double_t) zVtx); //zVtx
+      efficiencyAssociated[k] = fEfficiencyCorrectionAssociated->GetBinContent(effVars);
+    }
+    if (applyEfficiency && fEfficiencyCorrectionTriggers && k >= triggerOffset)
+    {
+      Int_t effVars[4];
+      effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(etaFlat[k]);
+      effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(pt[k]); //pt
+      effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(centrality); //centrality
+      effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin((Double_t) zVtx); //zVtx
+      efficiencyTrigger[k] = fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+    }
+    if (fWeightPerEvent && k >= triggerOffset)
+      triggerWeight[k] = triggerWeighting->GetBinContent(triggerWeighting->GetXaxis()->FindBin(pt[k]));
+  }
+  
+  // E^2 for the mass hypotheses of the conversion and resonance cuts
+  std::vector<Float_t> e2Electron, e2Pion, e2Proton;
+  if (fCutConversionsV > 0)
+  {
+    e2Electron.resize(nFlat);
+    for (Int_t k=0; k<nFlat; k++)
+      e2Electron[k] = GetEnergySquared(pt[k], tanTheta[k], kElectronMass);
+  }
+  if (fCutResonancesV > 0 || fRejectResonanceDaughters > 0)
+  {
+    e2Pion.resize(nFlat);
+    e2Proton.resize(nFlat);
+    for (Int_t k=0; k<nFlat; k++)
+    {
+      e2Pion[k] = GetEnergySquared(pt[k], tanTheta[k], kPionMass);
+      e2Proton[k] = GetEnergySquared(pt[k], tanTheta[k], kProtonMass);
+    }
+  }
+  
+  // identify K, Lambda candidates and flag those particles (see FillCorrelations)
+  if (fRejectResonanceDaughters > 0)
+  {
+    Double_t resonanceMass = -1;
+    Double_t massDaughter1 = -1;
+    Double_t massDaughter2 = -1;
+    const Double_t interval = 0.02;
+    
+    switch (fRejectResonanceDaughters)
+    {
+      case 1: resonanceMass = 1.2; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // method test
+      case 2: resonanceMass = 0.4976; massDaughter1 = 0.1396; massDaughter2 = massDaughter1; break; // k0
+      case 3: resonanceMass = 1.115; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // lambda
+      default: AliFatal(Form("Invalid setting %d", fRejectResonanceDaughters));
+    }
+    
+    const std::vector<Float_t>& e2Daughter1 = ((Float_t) massDaughter1 == kPionMass) ? e2Pion : e2Proton;
+    const std::vector<Float_t>& e2Daughter2 = ((Float_t) massDaughter2 == kPionMass) ? e2Pion : e2Proton;
+    
+    for (Int_t k=0; k<nFlat; k++)
+      object[k]->ResetBit(kResonanceDaughterFlag);
+    
+    for (Int_t i=0; i<nTriggers; i++)
+    {
+      const Int_t t = triggerOffset + i;
+      
+      for (Int_t j=0; j<nAssoc; j++)
+      {
+        if (!mixed && i == j)
+          continue;
+        
+        if (charge[t] * charge[j] > 0)
+          continue;
+        
+        if (mixed && (object[t] == object[j] || uniqueID[t] == uniqueID[j]) && object[t]->IsEqual(object[j]))
+          continue;
+        
+        Float_t mass = GetInvMassSquaredFromCache(pt[t], tanTheta[t], e2Daughter1[t], pt[j], tanTheta[j], e2Daughter2[j], GetCosDeltaPhiCheap(phi[t], phi[j]), massDaughter1, massDaughter2);
+        
+        if (TMath::Abs(mass - resonanceMass*resonanceMass) < interval*5)
+        {
+          mass = GetInvMassSquared(pt[t], etaFlat[t], phi[t], pt[j], etaFlat[j], phi[j], massDaughter1, massDaughter2);
+          
+          if (mass > (resonanceMass-interval)*(resonanceMass-interval) && mass < (resonanceMass+interval)*(resonanceMass+interval))
+          {
+            object[t]->SetBit(kResonanceDaughterFlag);
+            object[j]->SetBit(kResonanceDaughterFlag);
+          }
+        }
+      }
+    }
+    
+    for (Int_t k=0; k<nFlat; k++)
+      resonanceDaughter[k] = object[k]->TestBit(kResonanceDaughterFlag);
+  }
+  
+  // radii for the two-track efficiency cut
+  std::vector<Float_t> radii;
+  std::vector<Double_t> bendingMin(nFlat), bendingMax(nFlat);
+  std::vector<Int_t> bendingIndex;
+  std::vector<Double_t> bendingTable;
+  if (twoTrackEfficiencyCut)
+  {
+    for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
+      radii.push_back(rad);
+    for (Int_t k=0; k<nFlat; k++)
+    {
+      Float_t ptF = pt[k];
+      Float_t chargeF = charge[k];
+      bendingMin[k] = chargeF * bSign * TMath::ASin(0.075 * fTwoTrackCutMinRadius / ptF);
+      bendingMax[k] = chargeF * bSign * TMath::ASin(0.075 * (Float_t) 2.5 / ptF);
+    }
+    bendingIndex.resize(nFlat, -1);
+  }
+  
+  AliCFContainer* trackHist = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward);
+  AliTHnBase* trackHistTHn = dynamic_cast<AliTHnBase*> (trackHist);
+  
+  std::vector<Double_t> fillVars;
+  std::vector<Double_t> fillWeights;
+  fillVars.reserve(6 * nAssoc);
+  fillWeights.reserve(nAssoc);
+  
+  Char_t accept[kBlockSize];
+  Float_t deltaEta[kBlockSize];
+  Double_t deltaPhi[kBlockSize];
+  
+  for (Int_t i=0; i<nTriggers; i++)
+  {
+    const Int_t t = triggerOffset + i;
+    Float_t triggerEta = etaFlat[t];
+    
+    if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
+      continue;
+
+    if (fOnlyOneEtaSide != 0)
+    {
+      if (fOnlyOneEtaSide * triggerEta < 0)
+        continue;
+    }
+    
+    if (fTriggerSelectCharge != 0)
+      if (charge[t] * fTriggerSelectCharge < 0)
+        continue;
+    
+    if (fRejectResonanceDaughters > 0)
+      if (resonanceDaughter[t])
+        continue;
+    
+    const Double_t triggerPt = pt[t];
+    const Double_t triggerPhi = phi[t];
+    const Int_t triggerCharge = charge[t];
+    const Bool_t skipLikeSign = (fSelectCharge == 1);
+    const Bool_t skipUnlikeSign = (fSelectCharge == 2);
+    const Bool_t etaOrderingLow = (fEtaOrdering && triggerEta < 0);
+    const Bool_t etaOrderingHigh = (fEtaOrdering && triggerEta > 0);
+    
+    fillVars.clear();
+    fillWeights.clear();
+    
+    for (Int_t jBegin=0; jBegin<nAssoc; jBegin+=kBlockSize)
+    {
+      const Int_t n = TMath::Min(kBlockSize, nAssoc - jBegin);
+      const Double_t* ptBlock = &pt[jBegin];
+      const Double_t* phiBlock = &phi[jBegin];
+      const Float_t* etaBlock = &etaFlat[jBegin];
+      const Int_t* chargeBlock = &charge[jBegin];
+      const Char_t* resonanceBlock = &resonanceDaughter[jBegin];
+      
+      // selections without side effects, branch-free
+      for (Int_t b=0; b<n; b++)
+      {
+        const Int_t chargeProduct = chargeBlock[b] * triggerCharge;
+        Bool_t ok = (mixed != 0) | (jBegin + b != i);
+        ok &= !(fPtOrder && ptBlock[b] >= triggerPt);
+        ok &= !(chargeBlock[b] * fAssociatedSelectCharge < 0);
+        ok &= !(skipLikeSign && chargeProduct > 0);
+        ok &= !(skipUnlikeSign && chargeProduct < 0);
+        ok &= !(etaOrderingLow && etaBlock[b] < triggerEta);
+        ok &= !(etaOrderingHigh && etaBlock[b] > triggerEta);
+        ok &= !resonanceBlock[b];
+        accept[b] = ok;
+        
+        deltaEta[b] = triggerEta - etaBlock[b];
+        Double_t dphi = triggerPhi - phiBlock[b];
+        dphi = (dphi > 1.5 * TMath::Pi()) ? dphi - TMath::TwoPi() : dphi;
+        dphi = (dphi < -0.5 * TMath::Pi()) ? dphi + TMath::TwoPi() : dphi;
+        deltaPhi[b] = dphi;
+      }
+      
+      for (Int_t b=0; b<n; b++)
+      {
+        if (!accept[b])
+          continue;
+        
+        const Int_t j = jBegin + b;
+        
+        // check if both particles point to the same element (see FillCorrelations)
+        if (mixed && (object[t] == object[j] || uniqueID[t] == uniqueID[j]) && object[t]->IsEqual(object[j]))
+          continue;
+        
+        if (charge[j] * triggerCharge < 0 && (fCutConversionsV > 0 || fCutResonancesV > 0))
+        {
+          Float_t cosDeltaPhi = GetCosDeltaPhiCheap(triggerPhi, phi[j]);
+          
+          // conversions
+          if (fCutConversionsV > 0)
+          {
+            Float_t mass = GetInvMassSquaredFromCache(triggerPt, tanTheta[t], e2Electron[t], pt[j], tanTheta[j], e2Electron[j], cosDeltaPhi, kElectronMass, kElectronMass);
+            
+            if (mass < fCutConversionsV * 5)
+            {
+              mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], etaFlat[j], phi[j], kElectronMass, kElectronMass);
+              
+              fControlConvResoncances->Fill(0.0, mass);
+
+              if (mass < fCutConversionsV*fCutConversionsV) 
+                continue;
+            }
+          }
+          
+          if (fCutResonancesV > 0)
+          {
+            // K0s
+            Float_t mass = GetInvMassSquaredFromCache(triggerPt, tanTheta[t], e2Pion[t], pt[j], tanTheta[j], e2Pion[j], cosDeltaPhi, kPionMass, kPionMass);
+            
+            const Float_t kK0smass = 0.4976;
+            
+            if (TMath::Abs(mass - kK0smass*kK0smass) < fCutResonancesV * 5)
+            {
+              mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], etaFlat[j], phi[j], kPionMass, kPionMass);
+              
+              fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
+
+              if (mass > (kK0smass-fCutResonancesV)*(kK0smass-fCutResonancesV) && mass < (kK0smass+fCutResonancesV)*(kK0smass+fCutResonancesV))
+                continue;
+            }
+            
+            // Lambda
+            Float_t mass1 = GetInvMassSquaredFromCache(triggerPt, tanTheta[t], e2Pion[t], pt[j], tanTheta[j], e2Proton[j], cosDeltaPhi, kPionMass, kProtonMass);
+            Float_t mass2 = GetInvMassSquaredFromCache(triggerPt, tanTheta[t], e2Proton[t], pt[j], tanTheta[j], e2Pion[j], cosDeltaPhi, kProtonMass, kPionMass);
+            
+            const Float_t kLambdaMass = 1.115;
+
+            if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutResonancesV * 5)
+            {
+              mass1 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], etaFlat[j], phi[j], kPionMass, kProtonMass);
+
+              fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
+              
+              if (mass1 > (kLambdaMass-fCutResonancesV)*(kLambdaMass-fCutResonancesV) && mass1 < (kLambdaMass+fCutResonancesV)*(kLambdaMass+fCutResonancesV))
+                continue;
+            }
+            if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutResonancesV * 5)
+            {
+              mass2 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, pt[j], etaFlat[j], phi[j], kProtonMass, kPionMass);
+
+              fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
+
+              if (mass2 > (kLambdaMass-fCutResonancesV)*(kLambdaMass-fCutResonancesV) && mass2 < (kLambdaMass+fCutResonancesV)*(kLambdaMass+fCutResonancesV))
+                continue;
+            }
+          }
+        }
+        
+        if (twoTrackEfficiencyCut)
+        {
+          Float_t phi1 = triggerPhi;
+          Float_t pt1 = triggerPt;
+          Float_t phi2 = phi[j];
+          Float_t pt2 = pt[j];
+          
+          Float_t deta = deltaEta[b];
+          
+          // optimization
+          if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
+          {
+            // check first boundaries to see if is worth to loop and find the minimum
+            Float_t dphistar1 = GetDPhiStarFromBending(phi1, bendingMin[t], phi2, bendingMin[j]);
+            Float_t dphistar2 = GetDPhiStarFromBending(phi1, bendingMax[t], phi2, bendingMax[j]);
+            
+            const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
+
+            Float_t dphistarminabs = 1e5;
+            Float_t dphistarmin = 1e5;
+            if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
+            {
+              // offsets first, the table may grow in CacheBending
+              const Int_t offset1 = CacheBending(bendingIndex, bendingTable, t, pt1, charge[t], bSign, radii);
+              const Int_t offset2 = CacheBending(bendingIndex, bendingTable, j, pt2, charge[j], bSign, radii);
+              const Double_t* bending1 = &bendingTable[offset1];
+              const Double_t* bending2 = &bendingTable[offset2];
+              
+              for (UInt_t r=0; r<radii.size(); r++)
+              {
+                Float_t dphistar = GetDPhiStarFromBending(phi1, bending1[r], phi2, bending2[r]);
+
+                Float_t dphistarabs = TMath::Abs(dphistar);
+                
+                if (dphistarabs < dphistarminabs)
+                {
+                  dphistarmin = dphistar;
+                  dphistarminabs = dphistarabs;
+                }
+              }
+              
+              fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+              
+              if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+                continue;
+
+              fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+            }
+          }
+        }
+        
+        fillVars.push_back(deltaEta[b]);
+        fillVars.push_back(pt[j]);
+        fillVars.push_back(triggerPt);
+        fillVars.push_back(centrality);
+        fillVars.push_back(deltaPhi[b]);
+        fillVars.push_back(zVtx);
+        
+        Double_t useWeight = (fillpT) ? (Float_t) pt[j] : weight;
+        if (applyEfficiency)
+        {
+          if (fEfficiencyCorrectionAssociated)
+            useWeight *= efficiencyAssociated[j];
+          if (fEfficiencyCorrectionTriggers)
+            useWeight *= efficiencyTrigger[t];
+        }
+        if (fWeightPerEvent)
+          useWeight /= triggerWeight[t];
+        
+        fillWeights.push_back(useWeight);
+      }
+    }
+    
+    // fill all in toward region and do not use the other regions
+    const Int_t nFill = fillWeights.size();
+    if (nFill > 0)
+    {
+      if (trackHistTHn)
+        trackHistTHn->FillN(nFill, &fillVars[0], step, &fillWeights[0]);
+      else
+        for (Int_t k=0; k<nFill; k++)
+          trackHist->Fill(&fillVars[6*k], step, fillWeights[k]);
+    }
+    
+    if (firstTime)
+      FillTriggerParticle(centrality, zVtx, step, object[t], triggerEta, applyEfficiency, triggerWeighting);
+  }
+}
+  
 //____________________________________________________________________
 void AliUEHistograms::FillTrackingEfficiency(TObjArray* mc, TObjArray* recoPrim, TObjArray* recoAll, TObjArray* recoPrimPID, TObjArray* recoAllPID, TObjArray* fake, Int_t particleType, Double_t centrality, Double_t zVtx)
 {
@@ -1146,6 +1590,44 @@ void AliUEHistograms::SetWeightPerEvent(Bool_t flag)
       GetUEHist(i)->SetWeightPerEvent(fWeightPerEvent);
 }
 
+//____________________________________________________________________
+void AliUEHistograms::SetFillBuffer(Int_t size)
+{
+  // enables buffered filling (see AliTHnT::SetFillBuffer) of the track containers of all contained AliUEHist classes
+  
+  for (Int_t i=0; i<fgkUEHists; i++)
+  {
+    if (!GetUEHist(i))
+      continue;
+      
+    for (Int_t region=0; region<4; region++)
+    {
+      AliTHnBase* trackHist = dynamic_cast<AliTHnBase*> (GetUEHist(i)->GetTrackHist((AliUEHist::Region) region));
+      if (trackHist)
+        trackHist->SetFillBuffer(size);
+    }
+  }
+}
+
+//____________________________________________________________________
+void AliUEHistograms::SetChunkedStorage(Int_t chunkSize)
+{
+  // switches the track containers of all contained AliUEHist classes to chunked storage (see AliTHnT::SetChunkedStorage)
+  
+  for (Int_t i=0; i<fgkUEHists; i++)
+  {
+    if (!GetUEHist(i))
+      continue;
+      
+    for (Int_t region=0; region<4; region++)
+    {
+      AliTHnBase* trackHist = dynamic_cast<AliTHnBase*> (GetUEHist(i)->GetTrackHist((AliUEHist::Region) region));
+      if (trackHist)
+        trackHist->SetChunkedStorage(chunkSize);
+    }
+  }
+}
+
 //____________________________________________________________________
 void AliUEHistograms::Correct(AliUEHistograms* corrections)
 {
@@ -1254,6 +1736,7 @@ void AliUEHistograms::Copy(TObject& c) const
   target.fWeightPerEvent = fWeightPerEvent;
   target.fPtOrder = fPtOrder;
   target.fTwoTrackCutMinRadius = fTwoTrackCutMinRadius;
+  target.fFlatArrayKernel = fFlatArrayKernel;
 }
 
 //____________________________________________________________________
@@ -17,6 +17,8 @@ class AliVParticle;
 
 class TList;
 class TSeqCollection;
+class TArrayF;
+class TH1;
 class TObjArray;
 class TH1F;
 class TH2F;
@@ -84,6 +86,8 @@ class AliUEHistograms : public TNamed
   void SetCombineMinMax(Bool_t flag);
   void SetTrackEtaCut(Float_t value);
   void SetWeightPerEvent(Bool_t flag);
+  void SetFillBuffer(Int_t size);
+  void SetChunkedStorage(Int_t chunkSize);
   void SetSelectCharge(Int_t selectCharge) { fSelectCharge = selectCharge; }
   void SetSelectTriggerCharge(Int_t selectCharge) { fTriggerSelectCharge = selectCharge; }
   void SetSelectAssociatedCharge(Int_t selectCharge) { fAssociatedSelectCharge = selectCharge; }
@@ -94,6 +98,7 @@ class AliUEHistograms : public TNamed
   void SetOnlyOneEtaSide(Int_t flag)    { fOnlyOneEtaSide = flag; }
   void SetPtOrder(Bool_t flag) { fPtOrder = flag; }
   void SetTwoTrackCutMinRadius(Float_t min) { fTwoTrackCutMinRadius = min; }
+  void SetFlatArrayKernel(Bool_t flag) { fFlatArrayKernel = flag; }
   
   void ExtendTrackingEfficiency(Bool_t verbose = kFALSE);
   void Reset();
@@ -112,6 +117,13 @@ protected:
   inline Float_t GetInvMassSquared(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign);
+  inline Float_t GetDPhiStarFromBending(Float_t phi1, Double_t bending1, Float_t phi2, Double_t bending2);
+  inline Float_t GetTanThetaCheap(Float_t eta);
+  inline Float_t GetEnergySquared(Float_t pt, Float_t tantheta, Float_t m0);
+  inline Float_t GetCosDeltaPhiCheap(Float_t phi1, Float_t phi2);
+  inline Float_t GetInvMassSquaredFromCache(Float_t pt1, Float_t tantheta1, Float_t e1squ, Float_t pt2, Float_t tantheta2, Float_t e2squ, Float_t cosDeltaPhi, Float_t m0_1, Float_t m0_2);
+  void FillCorrelationsFlat(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed, const TArrayF& eta, Float_t weight, Bool_t firstTime, Bool_t twoTrackEfficiencyCut, Float_t bSign, Float_t twoTrackEfficiencyCutValue, Bool_t applyEfficiency, TH1* triggerWeighting);
+  void FillTriggerParticle(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, AliVParticle* triggerParticle, Float_t triggerEta, Bool_t applyEfficiency, TH1* triggerWeighting);
   
   static const Int_t fgkUEHists; // number of histograms
 
@@ -155,12 +167,13 @@ protected:
   Bool_t fWeightPerEvent;	// weight with the number of trigger particles per event
   Bool_t fPtOrder;		// apply pT,a < pT,t condition
   Float_t fTwoTrackCutMinRadius; // min radius for TTR cut
+  Bool_t fFlatArrayKernel;       // use the flat-array pair kernel in FillCorrelations (tracks extracted once per call, see FillCorrelationsFlat)
   
   Long64_t fRunNumber;           // run number that has been processed
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
-  ClassDef(AliUEHistograms, 30)  // underlying event histogram container
+  ClassDef(AliUEHistograms, 31)  // underlying event histogram container
 };
 
 Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
@@ -169,7 +182,16 @@ Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1,
   // calculates dphistar
   //
   
-  Float_t dphistar = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * radius / pt1) + charge2 * bSign * TMath::ASin(0.075 * radius / pt2);
+  return GetDPhiStarFromBending(phi1, charge1 * bSign * TMath::ASin(0.075 * radius / pt1), phi2, charge2 * bSign * TMath::ASin(0.075 * radius / pt2));
+}
+
+Float_t AliUEHistograms::GetDPhiStarFromBending(Float_t phi1, Double_t bending1, Float_t phi2, Double_t bending2)
+{
+  //
+  // calculates dphistar from the bending terms charge * bSign * asin(0.075 * radius / pt) of both particles
+  //
+  
+  Float_t dphistar = phi1 - phi2 - bending1 + bending2;
   
   static const Double_t kPi = TMath::Pi();
   
@@ -228,23 +250,40 @@ Float_t AliUEHistograms::GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float
 {
   // calculate inv mass squared approximately
   
-  Float_t tantheta1 = 1e10;
+  Float_t tantheta1 = GetTanThetaCheap(eta1);
+  Float_t tantheta2 = GetTanThetaCheap(eta2);
   
-  if (eta1 < -1e-10 || eta1 > 1e-10)
-  {
-    Float_t expTmp = 1.0-eta1+eta1*eta1/2-eta1*eta1*eta1/6+eta1*eta1*eta1*eta1/24;
-    tantheta1 = 2.0 * expTmp / ( 1.0 - expTmp*expTmp);
-  }
+  Float_t e1squ = GetEnergySquared(pt1, tantheta1, m0_1);
+  Float_t e2squ = GetEnergySquared(pt2, tantheta2, m0_2);
   
-  Float_t tantheta2 = 1e10;
-  if (eta2 < -1e-10 || eta2 > 1e-10)
+  return GetInvMassSquaredFromCache(pt1, tantheta1, e1squ, pt2, tantheta2, e2squ, GetCosDeltaPhiCheap(phi1, phi2), m0_1, m0_2);
+}
+
+Float_t AliUEHistograms::GetTanThetaCheap(Float_t eta)
+{
+  // tan(theta) from eta, with exp(-eta) approximated by its Taylor expansion
+  
+  Float_t tantheta = 1e10;
+  
+  if (eta < -1e-10 || eta > 1e-10)
   {
-    Float_t expTmp = 1.0-eta2+eta2*eta2/2-eta2*eta2*eta2/6+eta2*eta2*eta2*eta2/24;
-    tantheta2 = 2.0 * expTmp / ( 1.0 - expTmp*expTmp);
+    Float_t expTmp = 1.0-eta+eta*eta/2-eta*eta*eta/6+eta*eta*eta*eta/24;
+    tantheta = 2.0 * expTmp / ( 1.0 - expTmp*expTmp);
   }
   
-  Float_t e1squ = m0_1 * m0_1 + pt1 * pt1 * (1.0 + 1.0 / tantheta1 / tantheta1);
-  Float_t e2squ = m0_2 * m0_2 + pt2 * pt2 * (1.0 + 1.0 / tantheta2 / tantheta2);
+  return tantheta;
+}
+
+Float_t AliUEHistograms::GetEnergySquared(Float_t pt, Float_t tantheta, Float_t m0)
+{
+  // E^2 of a particle with mass m0
+  
+  return m0 * m0 + pt * pt * (1.0 + 1.0 / tantheta / tantheta);
+}
+
+Float_t AliUEHistograms::GetCosDeltaPhiCheap(Float_t phi1, Float_t phi2)
+{
+  // cos(phi1 - phi2) approximated by Taylor expansions
   
   // fold onto 0...pi
   Float_t deltaPhi = TMath::Abs(phi1 - phi2);
@@ -261,9 +300,14 @@ Float_t AliUEHistograms::GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float
   else
     cosDeltaPhi = -1.0 + 1.0/2.0*(deltaPhi - TMath::Pi())*(deltaPhi - TMath::Pi()) - 1.0/24.0 * TMath::Power(deltaPhi - TMath::Pi(), 4);
   
-  Float_t mass2 = m0_1 * m0_1 + m0_2 * m0_2 + 2 * ( TMath::Sqrt(e1squ * e2squ) - ( pt1 * pt2 * ( cosDeltaPhi + 1.0 / tantheta1 / tantheta2 ) ) );
+  return cosDeltaPhi;
+}
+
+Float_t AliUEHistograms::GetInvMassSquaredFromCache(Float_t pt1, Float_t tantheta1, Float_t e1squ, Float_t pt2, Float_t tantheta2, Float_t e2squ, Float_t cosDeltaPhi, Float_t m0_1, Float_t m0_2)
+{
+  // calculate inv mass squared approximately from per-particle quantities (see GetInvMassSquaredCheap)
   
-//   Printf(Form("%f %f %f %f %f %f %f %f %f", pt1, eta1, phi1, pt2, eta2, phi2, m0_1, m0_2, mass2));
+  Float_t mass2 = m0_1 * m0_1 + m0_2 * m0_2 + 2 * ( TMath::Sqrt(e1squ * e2squ) - ( pt1 * pt2 * ( cosDeltaPhi + 1.0 / tantheta1 / tantheta2 ) ) );
   
   return mass2;
 }
@@ -181,6 +181,9 @@ fFillYieldRapidity(kFALSE),
 fFillCorrelationsRapidity(kFALSE),
 fUseDoublePrecision(kFALSE),
 fUseNewCentralityFramework(kFALSE),
+fFlatArrayKernel(kFALSE),
+fFillBuffer(0),
+fChunkedStorage(0),
 fFillpT(kFALSE),
 fJetBranchName("clustersAOD_ANTIKT04_B1_Filter00768_Cut00150_Skip00"),
 fTrackEtaMax(.9),
@@ -337,6 +340,21 @@ void  AliAnalysisTaskPhiCorrelations::CreateOutputObjects()
   fHistos->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
   fHistosMixed->SetTwoTrackCutMinRadius(fTwoTrackCutMinRadius);
   
+  fHistos->SetFlatArrayKernel(fFlatArrayKernel);
+  fHistosMixed->SetFlatArrayKernel(fFlatArrayKernel);
+  
+  if (fFillBuffer > 0)
+  {
+    fHistos->SetFillBuffer(fFillBuffer);
+    fHistosMixed->SetFillBuffer(fFillBuffer);
+  }
+  
+  if (fChunkedStorage > 0)
+  {
+    fHistos->SetChunkedStorage(fChunkedStorage);
+    fHistosMixed->SetChunkedStorage(fChunkedStorage);
+  }
+  
   if (fEfficiencyCorrectionTriggers)
    {
     fHistos->SetEfficiencyCorrectionTriggers(fEfficiencyCorrectionTriggers);
@@ -566,6 +584,9 @@ void  AliAnalysisTaskPhiCorrelations::AddSettingsTree()
   settingsTree->Branch("fUseNewCentralityFramework", &fUseNewCentralityFramework,"fUseNewCentralityFramework/O");
   settingsTree->Branch("fTwoTrackEfficiencyCut", &fTwoTrackEfficiencyCut,"TwoTrackEfficiencyCut/D");
   settingsTree->Branch("fTwoTrackCutMinRadius", &fTwoTrackCutMinRadius,"TwoTrackCutMinRadius/D");
+  settingsTree->Branch("fFlatArrayKernel", &fFlatArrayKernel,"FlatArrayKernel/O");
+  settingsTree->Branch("fFillBuffer", &fFillBuffer,"FillBuffer/I");
+  settingsTree->Branch("fChunkedStorage", &fChunkedStorage,"ChunkedStorage/I");
   
   //fCustomBinning
   
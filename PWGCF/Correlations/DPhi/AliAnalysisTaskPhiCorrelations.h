@@ -138,6 +138,9 @@ public:
   void   SetRemoveWeakDecaysInMC(Bool_t flag) { fRemoveWeakDecaysInMC = flag; }
   void   SetFillYieldRapidity(Bool_t flag) { fFillYieldRapidity = flag; }
   void   SetFillCorrelationsRapidity(Bool_t flag) { fFillCorrelationsRapidity = flag; }
+  void   SetFlatArrayKernel(Bool_t flag = kTRUE) { fFlatArrayKernel = flag; }
+  void   SetFillBuffer(Int_t size) { fFillBuffer = size; }
+  void   SetChunkedStorage(Int_t chunkSize) { fChunkedStorage = chunkSize; }
   void   SetUseDoublePrecision(Bool_t flag) { fUseDoublePrecision = flag; }
   void   SetUseNewCentralityFramework(Bool_t flag) { fUseNewCentralityFramework = flag; }
 
@@ -295,6 +298,9 @@ private:
   Bool_t fFillCorrelationsRapidity; // fills correlation histograms with rapidity instead of pseudorapidity (default: kFALSE)
   Bool_t fUseDoublePrecision;    // use double precision for AliTHn
   Bool_t fUseNewCentralityFramework; // use the AliMultSelection framework
+  Bool_t fFlatArrayKernel;       // use the flat-array pair kernel of AliUEHistograms::FillCorrelations
+  Int_t fFillBuffer;             // number of entries buffered per step in the AliTHn track containers (0 = no buffering)
+  Int_t fChunkedStorage;         // number of bins per chunk for chunked storage of the AliTHn track containers (0 = dense storage)
 
   Bool_t fFillpT;                // fill sum pT instead of number density
 
@@ -314,7 +320,7 @@ private:
   vector<vector<Double_t> >   fEventPoolOutputList; // vector representing a list of pools (given by value range) that will be saved
   Bool_t                      fUsePtBinnedEventPool; // uses event pool in pt bins
 
-  ClassDef(AliAnalysisTaskPhiCorrelations, 61); // Analysis task for delta phi correlations
+  ClassDef(AliAnalysisTaskPhiCorrelations, 64); // Analysis task for delta phi correlations
 };
 
 #endif
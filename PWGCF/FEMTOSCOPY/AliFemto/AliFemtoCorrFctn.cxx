@@ -7,6 +7,26 @@
 void AliFemtoCorrFctn::AddRealPair(AliFemtoPair*) { cout << "Not implemented" << endl; }
 void AliFemtoCorrFctn::AddMixedPair(AliFemtoPair*) { cout << "Not implemented" << endl; }
 
+void AliFemtoCorrFctn::AddRealPairBatch(const AliFemtoPairBatch& aBatch)
+{
+  AliFemtoPair tPair;
+  for (UInt_t i = 0; i < aBatch.Size(); ++i) {
+    tPair.SetTrack1(aBatch.Track1(i));
+    tPair.SetTrack2(aBatch.Track2(i));
+    AddRealPair(&tPair);
+  }
+}
+
+void AliFemtoCorrFctn::AddMixedPairBatch(const AliFemtoPairBatch& aBatch)
+{
+  AliFemtoPair tPair;
+  for (UInt_t i = 0; i < aBatch.Size(); ++i) {
+    tPair.SetTrack1(aBatch.Track1(i));
+    tPair.SetTrack2(aBatch.Track2(i));
+    AddMixedPair(&tPair);
+  }
+}
+
 AliFemtoCorrFctn::AliFemtoCorrFctn(const AliFemtoCorrFctn& /* c */):fyAnalysis(0),fPairCut(0x0) {}
 AliFemtoCorrFctn::AliFemtoCorrFctn(): fyAnalysis(0),fPairCut(0x0) {/* no-op */}
 void AliFemtoCorrFctn::SetAnalysis(AliFemtoAnalysis* analysis) { fyAnalysis = analysis; }
@@ -9,6 +9,7 @@
 #include "AliFemtoEvent.h"
 #include "AliFemtoPair.h"
 #include "AliFemtoPairCut.h"
+#include "AliFemtoPairBatch.h"
 
 class AliFemtoCorrFctn{
 
@@ -25,6 +26,16 @@ public:
   virtual void AddRealPair(AliFemtoPair* aPair);
   virtual void AddMixedPair(AliFemtoPair* aPir);
 
+  /// Whether this correlation function can consume whole blocks of pairs
+  /// from the AliFemtoPairEngine. Functions returning false (the default)
+  /// keep receiving pairs one by one through AddRealPair/AddMixedPair.
+  virtual bool SupportsPairBatch() const { return false; }
+
+  /// Add a block of pairs. The default implementation forwards every pair
+  /// in the batch to AddRealPair/AddMixedPair.
+  virtual void AddRealPairBatch(const AliFemtoPairBatch& aBatch);
+  virtual void AddMixedPairBatch(const AliFemtoPairBatch& aBatch);
+
   virtual void EventBegin(const AliFemtoEvent* aEvent);
   virtual void EventEnd(const AliFemtoEvent* aEvent);
   virtual void Finish() = 0;
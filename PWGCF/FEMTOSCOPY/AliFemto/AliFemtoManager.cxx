@@ -13,29 +13,171 @@
 //#include "AliFemtoV0Cut.h"
 #include <cstdio>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RVersion.h"
+#include "TROOT.h"
+
 #ifdef __ROOT__
   /// \cond CLASSIMP
   ClassImp(AliFemtoManager);
   /// \endcond
 #endif
 
+/// \class AliFemtoAnalysisThreadPool
+/// \brief Worker threads calling ProcessEvent of the analyses of one event
+///
+/// Run() hands the analyses of an event to the workers and takes part in
+/// the work itself; each analysis is processed by exactly one thread. It
+/// returns once all analyses are done and all workers are idle again, so
+/// the event can be deleted and the next one dispatched.
+///
+class AliFemtoAnalysisThreadPool {
+public:
+  AliFemtoAnalysisThreadPool(int nThreads);
+  ~AliFemtoAnalysisThreadPool();
+
+  int NumberOfThreads() const { return fWorkers.size() + 1; }
+
+  void Run(const std::vector<AliFemtoAnalysis*>& analyses, const AliFemtoEvent* event);
+
+private:
+  void WorkerLoop();
+  void ProcessAnalyses();
+
+  std::vector<std::thread> fWorkers;
+  std::mutex fMutex;
+  std::condition_variable fStart;     // signals a new event (or the shutdown) to the workers
+  std::condition_variable fFinished;  // signals the caller that a worker went idle
+
+  const std::vector<AliFemtoAnalysis*>* fAnalyses;
+  const AliFemtoEvent* fEvent;
+  std::atomic<size_t> fNext;           // next analysis to be picked up
+  unsigned long fGeneration;           // number of events dispatched
+  int fBusy;                           // workers still working on the current event
+  bool fStop;
+};
+
+//____________________________
+AliFemtoAnalysisThreadPool::AliFemtoAnalysisThreadPool(int nThreads):
+  fWorkers(),
+  fMutex(),
+  fStart(),
+  fFinished(),
+  fAnalyses(NULL),
+  fEvent(NULL),
+  fNext(0),
+  fGeneration(0),
+  fBusy(0),
+  fStop(false)
+{
+  // start nThreads-1 workers, the caller of Run is the remaining thread
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+  ROOT::EnableThreadSafety();
+#endif
+
+  for (int i = 1; i < nThreads; i++) {
+    fWorkers.push_back(std::thread(&AliFemtoAnalysisThreadPool::WorkerLoop, this));
+  }
+}
+//____________________________
+AliFemtoAnalysisThreadPool::~AliFemtoAnalysisThreadPool()
+{
+  // stop and join the workers
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fStart.notify_all();
+  for (size_t i = 0; i < fWorkers.size(); i++) {
+    fWorkers[i].join();
+  }
+}
+//____________________________
+void AliFemtoAnalysisThreadPool::Run(const std::vector<AliFemtoAnalysis*>& analyses, const AliFemtoEvent* event)
+{
+  // process the event with all analyses, returns when all are done
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fAnalyses = &analyses;
+    fEvent = event;
+    fNext = 0;
+    fBusy = fWorkers.size();
+    fGeneration++;
+  }
+  fStart.notify_all();
+
+  ProcessAnalyses();
+
+  std::unique_lock<std::mutex> lock(fMutex);
+  fFinished.wait(lock, [this]() { return fBusy == 0; });
+  fAnalyses = NULL;
+  fEvent = NULL;
+}
+//____________________________
+void AliFemtoAnalysisThreadPool::WorkerLoop()
+{
+  // wait for an event, help processing it, report back idle
+  unsigned long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fStart.wait(lock, [this, seen]() { return fStop || fGeneration != seen; });
+      if (fStop) {
+        return;
+      }
+      seen = fGeneration;
+    }
+
+    ProcessAnalyses();
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fBusy--;
+    }
+    fFinished.notify_one();
+  }
+}
+//____________________________
+void AliFemtoAnalysisThreadPool::ProcessAnalyses()
+{
+  // pick analyses until none is left
+  const std::vector<AliFemtoAnalysis*>& analyses = *fAnalyses;
+  size_t i;
+  while ((i = fNext++) < analyses.size()) {
+    analyses[i]->ProcessEvent(fEvent);
+  }
+}
+
 
 
 //____________________________
 AliFemtoManager::AliFemtoManager():
   fAnalysisCollection(NULL),
   fEventReader(NULL),
-  fEventWriterCollection(NULL)
+  fEventWriterCollection(NULL),
+  fReentrantAnalyses(NULL),
+  fNumberOfThreads(1),
+  fThreadPool(NULL)
 {
   // default constructor
   fAnalysisCollection = new AliFemtoAnalysisCollection;
+  fReentrantAnalyses = new AliFemtoAnalysisCollection;
   fEventWriterCollection = new AliFemtoEventWriterCollection;
 }
 //____________________________
 AliFemtoManager::AliFemtoManager(const AliFemtoManager& aManager):
   fAnalysisCollection(new AliFemtoAnalysisCollection),
   fEventReader(aManager.fEventReader),
-  fEventWriterCollection(new AliFemtoEventWriterCollection)
+  fEventWriterCollection(new AliFemtoEventWriterCollection),
+  fReentrantAnalyses(new AliFemtoAnalysisCollection(*aManager.fReentrantAnalyses)),
+  fNumberOfThreads(aManager.fNumberOfThreads),
+  fThreadPool(NULL)
 {
   // copy constructor
   AliFemtoSimpleAnalysisIterator tAnalysisIter;
@@ -52,6 +194,7 @@ AliFemtoManager::AliFemtoManager(const AliFemtoManager& aManager):
 AliFemtoManager::~AliFemtoManager()
 {
   // destructor
+  delete fThreadPool;
   delete fEventReader;
   // now delete each Analysis in the Collection, and then the Collection itself
   AliFemtoSimpleAnalysisIterator tAnalysisIter;
@@ -59,6 +202,7 @@ AliFemtoManager::~AliFemtoManager()
     delete *tAnalysisIter;
   }
   delete fAnalysisCollection;
+  delete fReentrantAnalyses;
   // now delete each EventWriter in the Collection, and then the Collection itself
   AliFemtoEventWriterIterator tEventWriterIter;
   for (tEventWriterIter=fEventWriterCollection->begin();tEventWriterIter!=fEventWriterCollection->end();tEventWriterIter++){
@@ -75,6 +219,7 @@ AliFemtoManager& AliFemtoManager::operator=(const AliFemtoManager& aManager)
   }
 
   fEventReader = aManager.fEventReader;
+  SetNumberOfThreads(aManager.fNumberOfThreads);
   AliFemtoSimpleAnalysisIterator tAnalysisIter;
   if (fAnalysisCollection) {
     for (tAnalysisIter=fAnalysisCollection->begin();tAnalysisIter!=fAnalysisCollection->end();tAnalysisIter++){
@@ -97,6 +242,7 @@ AliFemtoManager& AliFemtoManager::operator=(const AliFemtoManager& aManager)
   for (tAnalysisIter=aManager.fAnalysisCollection->begin();tAnalysisIter!=aManager.fAnalysisCollection->end();tAnalysisIter++){
     fAnalysisCollection->push_back(*tAnalysisIter);
   }
+  *fReentrantAnalyses = *aManager.fReentrantAnalyses;
 
   fEventWriterCollection = new AliFemtoEventWriterCollection;
   for (tEventWriterIter=aManager.fEventWriterCollection->begin();tEventWriterIter!=aManager.fEventWriterCollection->end();tEventWriterIter++){
@@ -191,6 +337,16 @@ AliFemtoString AliFemtoManager::Report()
   return returnThis;
 }
 //____________________________
+void AliFemtoManager::SetNumberOfThreads(int n)
+{
+  // set the number of threads; the workers are (re)started with the next event
+  if (n != fNumberOfThreads) {
+    delete fThreadPool;
+    fThreadPool = NULL;
+  }
+  fNumberOfThreads = n;
+}
+//____________________________
 AliFemtoAnalysis* AliFemtoManager::Analysis( int n )
 {  // return pointer to n-th analysis
   if ( n < 0 || n > (int) fAnalysisCollection->size() )
@@ -241,9 +397,21 @@ int AliFemtoManager::ProcessEvent()
     (*tEventWriterIter)->WriteHbtEvent(currentHbtEvent);
   }
 
-  // loop over all the Analysis
+  // let the thread pool process the re-entrant analyses, then loop over
+  // all the other Analysis (not concurrently with the pool)
+  const bool usePool = fNumberOfThreads > 1 && fReentrantAnalyses->size() > 1;
+  if (usePool) {
+    if (!fThreadPool) {
+      fThreadPool = new AliFemtoAnalysisThreadPool(fNumberOfThreads);
+    }
+    std::vector<AliFemtoAnalysis*> analyses(fReentrantAnalyses->begin(), fReentrantAnalyses->end());
+    fThreadPool->Run(analyses, currentHbtEvent);
+  }
   AliFemtoSimpleAnalysisIterator tAnalysisIter;
   for (tAnalysisIter=fAnalysisCollection->begin();tAnalysisIter!=fAnalysisCollection->end();tAnalysisIter++){
+    if (usePool && std::find(fReentrantAnalyses->begin(), fReentrantAnalyses->end(), *tAnalysisIter) != fReentrantAnalyses->end()) {
+      continue;
+    }
     (*tAnalysisIter)->ProcessEvent(currentHbtEvent);
   }
 
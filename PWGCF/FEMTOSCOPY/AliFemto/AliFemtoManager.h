@@ -19,6 +19,7 @@
 #include "AliFemtoEventReader.h"
 #include "AliFemtoEventWriter.h"
 
+class AliFemtoAnalysisThreadPool;
 
 /// \class AliFemtoManager
 /// \brief Main class for managing femtoscopic analyses
@@ -37,6 +38,16 @@
 /// EventWriters added to them, and is responsible for deleting them
 /// upon its own destruction.
 ///
+/// With SetNumberOfThreads(n > 1) the analyses added as re-entrant
+/// (`AddAnalysis(a, true)`) are run concurrently on n threads (the calling
+/// thread and n-1 workers); the other analyses are run afterwards in the
+/// serial loop. The event is read once and shared read-only; every analysis
+/// sees the events in the same order as in the serial loop, so the output
+/// is identical. An analysis may only be added as re-entrant if it shares
+/// no cuts, correlation functions, model managers or weight generators with
+/// other analyses and does not use code with static state (e.g. the
+/// Lednicky weight generators, which use Fortran common blocks).
+///
 /// AliFemtoManager objects are not copyable, as the AliFemtoAnalysis
 /// objects they contain have no means of copying/cloning.
 /// Denying copyability by making the copy constructor and assignment
@@ -49,6 +60,9 @@ private:
   AliFemtoAnalysisCollection* fAnalysisCollection;       ///< Collection of analyzes
   AliFemtoEventReader*        fEventReader;              ///< Event reader
   AliFemtoEventWriterCollection* fEventWriterCollection; ///< Event writer collection
+  AliFemtoAnalysisCollection* fReentrantAnalyses;        ///< Analyses which may run on the thread pool (not owned)
+  int fNumberOfThreads;                                  ///< Threads running the analyses of an event (<= 1: serial)
+  AliFemtoAnalysisThreadPool* fThreadPool;               //!<! Worker threads, created on first use
 
 public:
   AliFemtoManager();
@@ -60,7 +74,7 @@ public:
   // Gets and Sets...
   AliFemtoAnalysisCollection* AnalysisCollection();
   AliFemtoAnalysis* Analysis(int n);            ///< Access to Analysis within Collection
-  void AddAnalysis(AliFemtoAnalysis* a);
+  void AddAnalysis(AliFemtoAnalysis* a, bool aReentrant=false);  ///< aReentrant: may run concurrently with other analyses
 
   AliFemtoEventWriterCollection* EventWriterCollection();
   AliFemtoEventWriter* EventWriter(int n);      ///< Access to EventWriter within Collection
@@ -70,6 +84,10 @@ public:
   AliFemtoEventReader* EventReader();
   void SetEventReader(AliFemtoEventReader* r);
 
+  /// Run the re-entrant analyses of each event on n threads (n <= 1: serial loop)
+  void SetNumberOfThreads(int n);
+  int GetNumberOfThreads() const;
+
   /// Calls `Init()` on all owned EventWriters
   ///
   /// Returns 0 for success, 1 for failure.
@@ -90,7 +108,7 @@ public:
 };
 
 inline AliFemtoAnalysisCollection* AliFemtoManager::AnalysisCollection(){return fAnalysisCollection;}
-inline void AliFemtoManager::AddAnalysis(AliFemtoAnalysis* anal){fAnalysisCollection->push_back(anal);}
+inline void AliFemtoManager::AddAnalysis(AliFemtoAnalysis* anal, bool aReentrant){fAnalysisCollection->push_back(anal); if (aReentrant) fReentrantAnalyses->push_back(anal);}
 
 inline AliFemtoEventWriterCollection* AliFemtoManager::EventWriterCollection(){return fEventWriterCollection;}
 inline void AliFemtoManager::AddEventWriter(AliFemtoEventWriter* writer){fEventWriterCollection->push_back(writer);}
@@ -99,4 +117,6 @@ inline void AliFemtoManager::SetEventWriter(AliFemtoEventWriter* writer){fEventW
 inline AliFemtoEventReader* AliFemtoManager::EventReader(){return fEventReader;}
 inline void AliFemtoManager::SetEventReader(AliFemtoEventReader* reader){fEventReader = reader;}
 
+inline int AliFemtoManager::GetNumberOfThreads() const{return fNumberOfThreads;}
+
 #endif
@@ -0,0 +1,205 @@
+///
+/// \file AliFemtoMixingGrid.cxx
+///
+
+#include "AliFemtoMixingGrid.h"
+
+#include <cmath>
+#include <limits>
+
+#include <TMath.h>
+
+// relative slack on the cell matching limit, so that rounding in the lower
+// bound can never drop a pair sitting right at the maximum qinv
+static const Double_t kMatchTolerance = 1.0e-6;
+
+//_________________________
+AliFemtoMixingGrid::AliFemtoMixingGrid(UInt_t nPt, Double_t ptMax,
+                                       UInt_t nY, Double_t yMax,
+                                       UInt_t nPhi):
+  fNPt(nPt > 0 ? nPt : 1),
+  fPtMax(ptMax > 0.0 ? ptMax : 1.0),
+  fNY(nY > 0 ? nY : 1),
+  fYMax(yMax > 0.0 ? yMax : 1.0),
+  fNPhi(nPhi > 0 ? nPhi : 1),
+  fParticles(),
+  fCells()
+{
+  // Constructor
+}
+//_________________________
+AliFemtoMixingGrid::~AliFemtoMixingGrid()
+{
+  // Destructor - the particles belong to the particle collection
+}
+//_________________________
+void AliFemtoMixingGrid::Build(const AliFemtoParticleCollection* aCollection)
+{
+  // Compute the cell of every particle, sort the particles by cell (keeping
+  // the collection order within a cell) and record the extent of each
+  // occupied cell.
+
+  fParticles.clear();
+  fCells.clear();
+
+  if (aCollection == NULL || aCollection->empty()) {
+    return;
+  }
+
+  // one extra cell for particles without a finite rapidity (E <= |pz|)
+  const UInt_t nCells = fNPt * fNY * fNPhi,
+               unboundCell = nCells;
+
+  const UInt_t n = aCollection->size();
+  std::vector<UInt_t> cellOf(n);
+  std::vector<Double_t> pt(n), mt(n), y(n), phi(n), m(n);
+
+  UInt_t i = 0;
+  for (AliFemtoParticleConstIterator iter = aCollection->begin(); iter != aCollection->end(); ++iter, ++i) {
+    const AliFemtoLorentzVector &p = (*iter)->FourMomentum();
+
+    const Double_t px = p.px(),
+                   py = p.py(),
+                   pz = p.pz(),
+                   e = p.e(),
+                   m2 = e*e - px*px - py*py - pz*pz;
+
+    pt[i] = ::sqrt(px*px + py*py);
+    m[i] = (m2 > 0.0) ? ::sqrt(m2) : 0.0;
+    mt[i] = ::sqrt(pt[i]*pt[i] + m[i]*m[i]);
+
+    phi[i] = ::atan2(py, px);
+    if (phi[i] < 0.0) {
+      phi[i] += TMath::TwoPi();
+    }
+    if (!(phi[i] < TMath::TwoPi())) {
+      phi[i] = 0.0;
+    }
+
+    if (e - pz <= 0.0 || e + pz <= 0.0) {
+      y[i] = 0.0;
+      cellOf[i] = unboundCell;
+      continue;
+    }
+    y[i] = 0.5 * ::log((e + pz) / (e - pz));
+
+    const Int_t iPt = TMath::Min(Int_t(pt[i] / fPtMax * fNPt), Int_t(fNPt) - 1),
+                iY = TMath::Max(0, TMath::Min(Int_t(::floor((y[i] + fYMax) / (2.0 * fYMax) * fNY)), Int_t(fNY) - 1)),
+                iPhi = TMath::Min(Int_t(phi[i] / TMath::TwoPi() * fNPhi), Int_t(fNPhi) - 1);
+
+    // azimuth runs fastest, so neighbouring azimuth cells end up in
+    // contiguous particle ranges
+    cellOf[i] = (iPt * fNY + iY) * fNPhi + iPhi;
+  }
+
+  // counting sort
+  std::vector<UInt_t> start(nCells + 2, 0);
+  for (i = 0; i < n; ++i) {
+    ++start[cellOf[i] + 1];
+  }
+  for (UInt_t c = 0; c <= nCells; ++c) {
+    start[c + 1] += start[c];
+  }
+
+  std::vector<UInt_t> order(n);
+  std::vector<UInt_t> next(start.begin(), start.end() - 1);
+  for (i = 0; i < n; ++i) {
+    order[next[cellOf[i]]++] = i;
+  }
+
+  fParticles.resize(n);
+  std::vector<AliFemtoParticle*> input(aCollection->begin(), aCollection->end());
+
+  for (UInt_t c = 0; c <= nCells; ++c) {
+    if (start[c] == start[c + 1]) {
+      continue;
+    }
+
+    Cell cell;
+    cell.fBegin = start[c];
+    cell.fEnd = start[c + 1];
+    cell.fPtMin = cell.fMtMin = cell.fYMin = cell.fPhiMin = cell.fMMin = std::numeric_limits<Double_t>::max();
+    cell.fYMax = cell.fPhiMax = cell.fMMax = -std::numeric_limits<Double_t>::max();
+
+    for (UInt_t k = cell.fBegin; k < cell.fEnd; ++k) {
+      const UInt_t j = order[k];
+      fParticles[k] = input[j];
+      cell.fPtMin = TMath::Min(cell.fPtMin, pt[j]);
+      cell.fMtMin = TMath::Min(cell.fMtMin, mt[j]);
+      cell.fYMin = TMath::Min(cell.fYMin, y[j]);
+      cell.fYMax = TMath::Max(cell.fYMax, y[j]);
+      cell.fPhiMin = TMath::Min(cell.fPhiMin, phi[j]);
+      cell.fPhiMax = TMath::Max(cell.fPhiMax, phi[j]);
+      cell.fMMin = TMath::Min(cell.fMMin, m[j]);
+      cell.fMMax = TMath::Max(cell.fMMax, m[j]);
+    }
+
+    if (c == unboundCell) {
+      cell.fYMin = -std::numeric_limits<Double_t>::infinity();
+      cell.fYMax = std::numeric_limits<Double_t>::infinity();
+    }
+
+    fCells.push_back(cell);
+  }
+}
+//_________________________
+Double_t AliFemtoMixingGrid::MinDistance2(const Cell& a, const Cell& b)
+{
+  // Lower limit on qinv^2 + (m1-m2)^2 for a particle of cell a and one of
+  // cell b:
+  //   -(p1-p2)^2 = 2 mT1 mT2 cosh(dy) - 2 pT1 pT2 cos(dphi) - m1^2 - m2^2
+  // and mT1 mT2 >= pT1 pT2 + m1 m2 give
+  //   qinv^2 + (m1-m2)^2 >= 2 mT1 mT2 (cosh(dy) - 1) + 4 pT1 pT2 sin^2(dphi/2)
+  // where the right hand side grows with pT, mT, |dy| and |dphi| (<= pi).
+
+  const Double_t dy = TMath::Max(0.0, TMath::Max(a.fYMin - b.fYMax, b.fYMin - a.fYMax));
+
+  // azimuthal gap of the two arcs, going around the circle either way
+  Double_t dphi = 0.0;
+  if (a.fPhiMax < b.fPhiMin) {
+    dphi = TMath::Min(b.fPhiMin - a.fPhiMax, a.fPhiMin + TMath::TwoPi() - b.fPhiMax);
+  } else if (b.fPhiMax < a.fPhiMin) {
+    dphi = TMath::Min(a.fPhiMin - b.fPhiMax, b.fPhiMin + TMath::TwoPi() - a.fPhiMax);
+  }
+
+  const Double_t sinHalf = ::sin(0.5 * dphi);
+
+  return 2.0 * a.fMtMin * b.fMtMin * (::cosh(dy) - 1.0)
+       + 4.0 * a.fPtMin * b.fPtMin * sinHalf * sinHalf;
+}
+//_________________________
+void AliFemtoMixingGrid::Match(const AliFemtoMixingGrid& other, Double_t qinvMax,
+                               std::vector<UInt_t>& offsets, std::vector<UInt_t>& ranges) const
+{
+  // Collect the partner ranges of every occupied cell of this grid
+
+  offsets.assign(1, 0);
+  ranges.clear();
+
+  const Double_t qinvMax2 = qinvMax * qinvMax;
+
+  for (UInt_t ca = 0; ca < fCells.size(); ++ca) {
+    const Cell &a = fCells[ca];
+    const UInt_t first = ranges.size();
+
+    for (UInt_t cb = 0; cb < other.fCells.size(); ++cb) {
+      const Cell &b = other.fCells[cb];
+
+      const Double_t dm = TMath::Max(0.0, TMath::Max(a.fMMax - b.fMMin, b.fMMax - a.fMMin)),
+                     limit = (qinvMax2 + dm * dm) * (1.0 + kMatchTolerance);
+
+      if (MinDistance2(a, b) > limit) {
+        continue;
+      }
+
+      if (ranges.size() > first && ranges.back() == b.fBegin) {
+        ranges.back() = b.fEnd;
+      } else {
+        ranges.push_back(b.fBegin);
+        ranges.push_back(b.fEnd);
+      }
+    }
+
+    offsets.push_back(ranges.size() / 2);
+  }
+}
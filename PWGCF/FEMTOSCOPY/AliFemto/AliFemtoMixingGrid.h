@@ -0,0 +1,100 @@
+///
+/// \file AliFemtoMixingGrid.h
+///
+
+#ifndef ALIFEMTOMIXINGGRID_H
+#define ALIFEMTOMIXINGGRID_H
+
+#include <vector>
+
+#include "AliFemtoParticleCollection.h"
+
+///
+/// \class AliFemtoMixingGrid
+/// \brief Momentum-space cells of one particle collection, used to skip
+///        hopeless pairs when mixing events
+///
+/// The particles are sorted into cells of transverse momentum, rapidity and
+/// azimuth. For every occupied cell the actual extent of its particles is
+/// kept (minimum pT and mT, rapidity, azimuth and mass range), so the
+/// binning only decides how particles are grouped, never which pairs are
+/// kept.
+///
+/// For any two particles
+///
+///   qinv^2 + (m1-m2)^2 >= 2 mT1 mT2 (cosh(dy) - 1) + 4 pT1 pT2 sin^2(dphi/2)
+///
+/// (qinv^2 = -(p1-p2)^2, as in AliFemtoPair::QInv). Evaluating the right
+/// hand side with the smallest pT, mT, |dy| and |dphi| of two cells gives a
+/// lower limit on qinv for all pairs between them. Match() lists, for every
+/// occupied cell, the cells of another grid where this limit is below the
+/// requested maximum - pairs in all other cells can not have a smaller
+/// qinv and need not be formed. For equal masses k* = qinv/2.
+///
+/// The grids are built by AliFemtoSimpleAnalysis (see SetMixingGrid) and
+/// stored with the AliFemtoPicoEvent in the mixing buffer.
+///
+class AliFemtoMixingGrid {
+public:
+
+  AliFemtoMixingGrid(UInt_t nPt, Double_t ptMax,
+                     UInt_t nY, Double_t yMax,
+                     UInt_t nPhi);
+  virtual ~AliFemtoMixingGrid();
+
+  /// Sort the particles of the collection into the cells. The grid does
+  /// not own the particles.
+  void Build(const AliFemtoParticleCollection* aCollection);
+
+  /// Cells of 'other' which may hold a partner with qinv <= qinvMax for
+  /// the particles of each occupied cell of this grid.
+  ///
+  /// For occupied cell c the partners are the particle index ranges
+  /// [ranges[2*r], ranges[2*r+1]) of 'other', r in [offsets[c], offsets[c+1]).
+  /// Neighbouring ranges are merged.
+  void Match(const AliFemtoMixingGrid& other, Double_t qinvMax,
+             std::vector<UInt_t>& offsets, std::vector<UInt_t>& ranges) const;
+
+  UInt_t NParticles() const { return fParticles.size(); }
+  AliFemtoParticle* Particle(UInt_t i) const { return fParticles[i]; }
+  const std::vector<AliFemtoParticle*>& Particles() const { return fParticles; }
+
+  UInt_t NOccupiedCells() const { return fCells.size(); }
+  UInt_t CellBegin(UInt_t c) const { return fCells[c].fBegin; }
+  UInt_t CellEnd(UInt_t c) const { return fCells[c].fEnd; }
+
+protected:
+
+  /// Extent of the particles of one occupied cell
+  struct Cell {
+    UInt_t fBegin;     ///< first particle
+    UInt_t fEnd;       ///< one past the last particle
+    Double_t fPtMin;   ///< smallest pT
+    Double_t fMtMin;   ///< smallest mT
+    Double_t fYMin;    ///< smallest rapidity
+    Double_t fYMax;    ///< largest rapidity
+    Double_t fPhiMin;  ///< smallest azimuth, in [0, 2pi)
+    Double_t fPhiMax;  ///< largest azimuth, in [0, 2pi)
+    Double_t fMMin;    ///< smallest mass
+    Double_t fMMax;    ///< largest mass
+  };
+
+  /// Lower limit on qinv^2 + (m1-m2)^2 for the pairs between two cells
+  static Double_t MinDistance2(const Cell& a, const Cell& b);
+
+  UInt_t fNPt;      ///< number of pT cells, the last one is open ended
+  Double_t fPtMax;  ///< upper edge of the last closed pT cell
+  UInt_t fNY;       ///< number of rapidity cells, first and last are open ended
+  Double_t fYMax;   ///< rapidity cells cover [-fYMax, fYMax]
+  UInt_t fNPhi;     ///< number of azimuth cells
+
+  std::vector<AliFemtoParticle*> fParticles;  ///< particles, ordered by cell
+  std::vector<Cell> fCells;                   ///< occupied cells, in cell order
+
+private:
+
+  AliFemtoMixingGrid(const AliFemtoMixingGrid& aGrid);
+  AliFemtoMixingGrid& operator=(const AliFemtoMixingGrid& aGrid);
+};
+
+#endif
@@ -0,0 +1,129 @@
+///
+/// \file AliFemtoPairBatch.h
+///
+
+#ifndef ALIFEMTOPAIRBATCH_H
+#define ALIFEMTOPAIRBATCH_H
+
+#include <vector>
+
+#include "AliFemtoParticle.h"
+
+///
+/// \class AliFemtoPairBatch
+/// \brief A block of accepted pairs, handed to correlation functions at once
+///
+/// The batch is filled by the AliFemtoPairEngine with pairs which passed
+/// every pair cut of the analysis. Next to the two particles forming each
+/// pair it stores the pair variables the engine has already computed, in
+/// contiguous arrays, so a correlation function can fill its histograms
+/// with TH1::FillN instead of one virtual call per pair.
+///
+/// Stored values follow the AliFemtoPair conventions:
+///  - QInv:  |QInv()| of the pair (always positive)
+///  - KT:    KT() of the pair
+///  - KStar: KStar() of the pair
+///
+class AliFemtoPairBatch {
+public:
+  AliFemtoPairBatch();
+
+  void Clear();
+  void Reserve(UInt_t n);
+  void Push(const AliFemtoParticle *p1, const AliFemtoParticle *p2,
+            Double_t qinv, Double_t kt, Double_t kstar);
+
+  UInt_t Size() const;
+  bool Empty() const;
+
+  AliFemtoParticle* Track1(UInt_t i) const;
+  AliFemtoParticle* Track2(UInt_t i) const;
+
+  const Double_t* QInv() const;
+  const Double_t* KT() const;
+  const Double_t* KStar() const;
+
+protected:
+  std::vector<AliFemtoParticle*> fTrack1;  ///< first particle of each pair
+  std::vector<AliFemtoParticle*> fTrack2;  ///< second particle of each pair
+  std::vector<Double_t> fQInv;             ///< |qinv| of each pair
+  std::vector<Double_t> fKT;               ///< kT of each pair
+  std::vector<Double_t> fKStar;            ///< k* of each pair
+};
+
+inline AliFemtoPairBatch::AliFemtoPairBatch():
+  fTrack1(),
+  fTrack2(),
+  fQInv(),
+  fKT(),
+  fKStar()
+{
+}
+
+inline void AliFemtoPairBatch::Clear()
+{
+  fTrack1.clear();
+  fTrack2.clear();
+  fQInv.clear();
+  fKT.clear();
+  fKStar.clear();
+}
+
+inline void AliFemtoPairBatch::Reserve(UInt_t n)
+{
+  fTrack1.reserve(n);
+  fTrack2.reserve(n);
+  fQInv.reserve(n);
+  fKT.reserve(n);
+  fKStar.reserve(n);
+}
+
+inline void AliFemtoPairBatch::Push(const AliFemtoParticle *p1,
+                                    const AliFemtoParticle *p2,
+                                    Double_t qinv,
+                                    Double_t kt,
+                                    Double_t kstar)
+{
+  fTrack1.push_back(const_cast<AliFemtoParticle*>(p1));
+  fTrack2.push_back(const_cast<AliFemtoParticle*>(p2));
+  fQInv.push_back(qinv);
+  fKT.push_back(kt);
+  fKStar.push_back(kstar);
+}
+
+inline UInt_t AliFemtoPairBatch::Size() const
+{
+  return fQInv.size();
+}
+
+inline bool AliFemtoPairBatch::Empty() const
+{
+  return fQInv.empty();
+}
+
+inline AliFemtoParticle* AliFemtoPairBatch::Track1(UInt_t i) const
+{
+  return fTrack1[i];
+}
+
+inline AliFemtoParticle* AliFemtoPairBatch::Track2(UInt_t i) const
+{
+  return fTrack2[i];
+}
+
+inline const Double_t* AliFemtoPairBatch::QInv() const
+{
+  return fQInv.empty() ? NULL : &fQInv[0];
+}
+
+inline const Double_t* AliFemtoPairBatch::KT() const
+{
+  return fKT.empty() ? NULL : &fKT[0];
+}
+
+inline const Double_t* AliFemtoPairBatch::KStar() const
+{
+  return fKStar.empty() ? NULL : &fKStar[0];
+}
+
+#endif
@@ -0,0 +1,424 @@
+///
+/// \file AliFemtoPairEngine.cxx
+///
+
+#include "AliFemtoPairEngine.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include <TList.h>
+#include <TObjString.h>
+#include <TMath.h>
+
+#ifdef __ROOT__
+  /// \cond CLASSIMP
+  ClassImp(AliFemtoPairEngine);
+  /// \endcond
+#endif
+
+// Same constant as in AliFemtoPairCutRadialDistance. As there, only the sign
+// of the field enters and its magnitude is taken to be 5 kG, so phi* on
+// low-field (2 kG) runs matches the classic cut rather than the true bending.
+static const Double_t kPhiStarConst = 0.07510020733;
+
+//_________________________
+AliFemtoPairEngine::ParticleBuffer::ParticleBuffer():
+  fParticle(),
+  fPx(),
+  fPy(),
+  fPz(),
+  fE(),
+  fM2(),
+  fEta(),
+  fPhiStar(),
+  fPhiStarOk(),
+  fEntX(),
+  fEntY(),
+  fEntZ(),
+  fEntOk(),
+  fPidWeight()
+{
+}
+//_________________________
+void AliFemtoPairEngine::ParticleBuffer::Clear()
+{
+  fParticle.clear();
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fE.clear();
+  fM2.clear();
+  fEta.clear();
+  fPhiStar.clear();
+  fPhiStarOk.clear();
+  fEntX.clear();
+  fEntY.clear();
+  fEntZ.clear();
+  fEntOk.clear();
+  fPidWeight.clear();
+}
+//_________________________
+AliFemtoPairEngine::AliFemtoPairEngine():
+  fKTMin(0.0),
+  fKTMax(1.0e6),
+  fQInvMax(-1.0),
+  fKStarMax(-1.0),
+  fDEtaMin(0.0),
+  fDPhiStarMin(-1.0),
+  fMergingRadius(1.2),
+  fMinEntranceSep(-1.0),
+  fPidSpecies(kNoPid),
+  fMinPidProduct(-1.0),
+  fPairCutHandled(kFALSE),
+  fBlockSize(256),
+  fBatchSize(1024),
+  fMagSign(1),
+  fQInv(),
+  fKT(),
+  fKStar(),
+  fPass(),
+  fAccepted(),
+  fBatch()
+{
+  // Default constructor - all engine cuts are disabled
+}
+//_________________________
+AliFemtoPairEngine::AliFemtoPairEngine(const AliFemtoPairEngine& aEngine):
+  fKTMin(aEngine.fKTMin),
+  fKTMax(aEngine.fKTMax),
+  fQInvMax(aEngine.fQInvMax),
+  fKStarMax(aEngine.fKStarMax),
+  fDEtaMin(aEngine.fDEtaMin),
+  fDPhiStarMin(aEngine.fDPhiStarMin),
+  fMergingRadius(aEngine.fMergingRadius),
+  fMinEntranceSep(aEngine.fMinEntranceSep),
+  fPidSpecies(aEngine.fPidSpecies),
+  fMinPidProduct(aEngine.fMinPidProduct),
+  fPairCutHandled(aEngine.fPairCutHandled),
+  fBlockSize(aEngine.fBlockSize),
+  fBatchSize(aEngine.fBatchSize),
+  fMagSign(1),
+  fQInv(),
+  fKT(),
+  fKStar(),
+  fPass(),
+  fAccepted(),
+  fBatch()
+{
+  // Copy constructor - only the configuration is copied, buffers start empty
+}
+//_________________________
+AliFemtoPairEngine& AliFemtoPairEngine::operator=(const AliFemtoPairEngine& aEngine)
+{
+  // Assignment operator - only the configuration is copied
+  if (this == &aEngine)
+    return *this;
+
+  fKTMin = aEngine.fKTMin;
+  fKTMax = aEngine.fKTMax;
+  fQInvMax = aEngine.fQInvMax;
+  fKStarMax = aEngine.fKStarMax;
+  fDEtaMin = aEngine.fDEtaMin;
+  fDPhiStarMin = aEngine.fDPhiStarMin;
+  fMergingRadius = aEngine.fMergingRadius;
+  fMinEntranceSep = aEngine.fMinEntranceSep;
+  fPidSpecies = aEngine.fPidSpecies;
+  fMinPidProduct = aEngine.fMinPidProduct;
+  fPairCutHandled = aEngine.fPairCutHandled;
+  fBlockSize = aEngine.fBlockSize;
+  fBatchSize = aEngine.fBatchSize;
+
+  fBuffer[0].Clear();
+  fBuffer[1].Clear();
+  fBatch.Clear();
+
+  return *this;
+}
+//_________________________
+AliFemtoPairEngine::~AliFemtoPairEngine()
+{
+  // Destructor - the packed particles are owned by the pico events
+}
+//_________________________
+void AliFemtoPairEngine::Pack(UInt_t slot, const AliFemtoParticleCollection* aCollection)
+{
+  // Copy the kinematics of every particle of the collection into the flat
+  // arrays of buffer 'slot'. Per-particle quantities the pair cuts need
+  // (phi* at the merging radius, entrance point, PID weight) are resolved
+  // here once instead of once per pair.
+
+  ParticleBuffer &buf = fBuffer[slot];
+  buf.Clear();
+
+  if (aCollection == NULL) {
+    return;
+  }
+
+  const Double_t phiStarScale = kPhiStarConst * fMagSign * fMergingRadius;
+
+  for (AliFemtoParticleConstIterator iter = aCollection->begin(); iter != aCollection->end(); ++iter) {
+    PackParticle(buf, *iter, phiStarScale);
+  }
+}
+//_________________________
+void AliFemtoPairEngine::Pack(UInt_t slot, const std::vector<AliFemtoParticle*>& aParticles)
+{
+  // Same as Pack for a particle collection, keeping the order of the vector
+
+  ParticleBuffer &buf = fBuffer[slot];
+  buf.Clear();
+
+  const Double_t phiStarScale = kPhiStarConst * fMagSign * fMergingRadius;
+
+  for (std::vector<AliFemtoParticle*>::const_iterator iter = aParticles.begin(); iter != aParticles.end(); ++iter) {
+    PackParticle(buf, *iter, phiStarScale);
+  }
+}
+//_________________________
+void AliFemtoPairEngine::PackParticle(ParticleBuffer& buf, AliFemtoParticle* particle, Double_t phiStarScale) const
+{
+  // Append one particle to a buffer
+
+  const AliFemtoLorentzVector &p = particle->FourMomentum();
+  const AliFemtoTrack *track = particle->Track();
+
+  const Double_t px = p.px(),
+                 py = p.py(),
+                 pz = p.pz(),
+                 e = p.e(),
+                 m2 = e*e - px*px - py*py - pz*pz,
+                 pt = ::sqrt(px*px + py*py);
+
+  buf.fParticle.push_back(particle);
+  buf.fPx.push_back(px);
+  buf.fPy.push_back(py);
+  buf.fPz.push_back(pz);
+  buf.fE.push_back(e);
+  buf.fM2.push_back(m2 > 0.0 ? m2 : 0.0);
+  buf.fEta.push_back(p.vect().PseudoRapidity());
+
+  const Double_t phi = p.vect().Phi();
+  const Double_t charge = track ? track->Charge() : 0.0;
+  const Double_t afsi = (pt > 0.0) ? phiStarScale * charge / pt : 0.0;
+  if (::fabs(afsi) < 1.0) {
+    buf.fPhiStar.push_back(phi + TMath::ASin(afsi));
+    buf.fPhiStarOk.push_back(1.0);
+  } else {
+    buf.fPhiStar.push_back(phi);
+    buf.fPhiStarOk.push_back(0.0);
+  }
+
+  if (track) {
+    const AliFemtoThreeVector &ent = track->NominalTpcEntrancePoint();
+    const bool isSet = ent.x() > -9999.0 && ent.y() > -9999.0 && ent.z() > -9999.0;
+    buf.fEntX.push_back(ent.x());
+    buf.fEntY.push_back(ent.y());
+    buf.fEntZ.push_back(ent.z());
+    buf.fEntOk.push_back(isSet ? 1.0 : 0.0);
+  } else {
+    buf.fEntX.push_back(0.0);
+    buf.fEntY.push_back(0.0);
+    buf.fEntZ.push_back(0.0);
+    buf.fEntOk.push_back(0.0);
+  }
+
+  Double_t weight = 1.0;
+  if (track) {
+    switch (fPidSpecies) {
+      case kElectron: weight = track->PidProbElectron(); break;
+      case kPion:     weight = track->PidProbPion(); break;
+      case kKaon:     weight = track->PidProbKaon(); break;
+      case kProton:   weight = track->PidProbProton(); break;
+      default:        break;
+    }
+  }
+  buf.fPidWeight.push_back(weight);
+}
+//_________________________
+UInt_t AliFemtoPairEngine::EvaluateBlock(const ParticleBuffer& b1, UInt_t i,
+                                         const ParticleBuffer& b2, UInt_t jBegin, UInt_t jEnd)
+{
+  // Compute the pair variables of particle i of b1 with particles
+  // [jBegin, jEnd) of b2 and apply the engine cuts. The main loop has no
+  // data dependent branches and works on contiguous arrays only.
+
+  if (jEnd <= jBegin) {
+    return 0;
+  }
+
+  const UInt_t n = jEnd - jBegin;
+  if (fPass.size() < n) {
+    fQInv.resize(n);
+    fKT.resize(n);
+    fKStar.resize(n);
+    fPass.resize(n);
+    fAccepted.resize(n);
+  }
+
+  const Double_t px1 = b1.fPx[i],
+                 py1 = b1.fPy[i],
+                 pz1 = b1.fPz[i],
+                 e1 = b1.fE[i],
+                 m21 = b1.fM2[i],
+                 eta1 = b1.fEta[i],
+                 phis1 = b1.fPhiStar[i],
+                 phisOk1 = b1.fPhiStarOk[i],
+                 entX1 = b1.fEntX[i],
+                 entY1 = b1.fEntY[i],
+                 entZ1 = b1.fEntZ[i],
+                 entOk1 = b1.fEntOk[i],
+                 pid1 = b1.fPidWeight[i];
+
+  const Double_t *px2 = &b2.fPx[jBegin],
+                 *py2 = &b2.fPy[jBegin],
+                 *pz2 = &b2.fPz[jBegin],
+                 *e2 = &b2.fE[jBegin],
+                 *m22 = &b2.fM2[jBegin],
+                 *eta2 = &b2.fEta[jBegin],
+                 *phis2 = &b2.fPhiStar[jBegin],
+                 *phisOk2 = &b2.fPhiStarOk[jBegin],
+                 *entX2 = &b2.fEntX[jBegin],
+                 *entY2 = &b2.fEntY[jBegin],
+                 *entZ2 = &b2.fEntZ[jBegin],
+                 *entOk2 = &b2.fEntOk[jBegin],
+                 *pid2 = &b2.fPidWeight[jBegin];
+
+  Double_t *qinv = &fQInv[0],
+           *kt = &fKT[0],
+           *kstar = &fKStar[0];
+  Char_t *pass = &fPass[0];
+
+  // disabled cuts are turned into limits which always pass
+  const Double_t qinvMax = (fQInvMax > 0.0) ? fQInvMax : 1.0e30,
+                 kstarMax = (fKStarMax > 0.0) ? fKStarMax : 1.0e30,
+                 detaMin = (fDPhiStarMin > 0.0) ? fDEtaMin : -1.0,
+                 dphisMin = (fDPhiStarMin > 0.0) ? fDPhiStarMin : -1.0,
+                 entSep2 = (fMinEntranceSep > 0.0) ? fMinEntranceSep*fMinEntranceSep : -1.0,
+                 pidMin = (fMinPidProduct > 0.0) ? fMinPidProduct : -1.0,
+                 ktMin = fKTMin,
+                 ktMax = fKTMax,
+                 twoPi = TMath::TwoPi(),
+                 invTwoPi = 1.0 / TMath::TwoPi();
+
+  for (UInt_t j = 0; j < n; ++j) {
+    const Double_t sx = px1 + px2[j],
+                   sy = py1 + py2[j],
+                   sz = pz1 + pz2[j],
+                   se = e1 + e2[j],
+                   dx = px1 - px2[j],
+                   dy = py1 - py2[j],
+                   dz = pz1 - pz2[j],
+                   de = e1 - e2[j];
+
+    // q^2 as AliFmLorentzVector::m2 of the momentum difference
+    const Double_t q2 = de*de - (dx*dx + dy*dy + dz*dz);
+    const Double_t minv2 = se*se - (sx*sx + sy*sy + sz*sz);
+    const Double_t dm2 = m21 - m22[j];
+    const Double_t kstar2 = (minv2 > 0.0) ? dm2*dm2/minv2 - q2 : -q2;
+
+    qinv[j] = ::sqrt(::fabs(q2));
+    kt[j] = 0.5 * ::sqrt(sx*sx + sy*sy);
+    kstar[j] = 0.5 * ::sqrt(::fabs(kstar2));
+
+    // merging: same definition as AliFemtoPairCutRadialDistance
+    Double_t dphis = phis2[j] - phis1;
+    dphis -= twoPi * ::floor(dphis * invTwoPi + 0.5);
+    const Double_t deta = eta2[j] - eta1;
+    const bool merged = (::fabs(deta) < detaMin)
+                      & (::fabs(dphis) < dphisMin)
+                      & (phisOk1 * phisOk2[j] > 0.0);
+
+    const Double_t ex = entX2[j] - entX1,
+                   ey = entY2[j] - entY1,
+                   ez = entZ2[j] - entZ1;
+    const bool tooClose = (ex*ex + ey*ey + ez*ez < entSep2)
+                        & (entOk1 * entOk2[j] > 0.0);
+
+    pass[j] = (kt[j] >= ktMin)
+            & (kt[j] <= ktMax)
+            & (qinv[j] < qinvMax)
+            & (kstar[j] < kstarMax)
+            & (pid1 * pid2[j] >= pidMin)
+            & !merged
+            & !tooClose;
+  }
+
+  // compact the accepted pairs to the front of the scratch arrays
+  UInt_t nAccepted = 0;
+  for (UInt_t j = 0; j < n; ++j) {
+    if (pass[j]) {
+      fAccepted[nAccepted] = jBegin + j;
+      qinv[nAccepted] = qinv[j];
+      kt[nAccepted] = kt[j];
+      kstar[nAccepted] = kstar[j];
+      ++nAccepted;
+    }
+  }
+
+  return nAccepted;
+}
+//_________________________
+AliFemtoString AliFemtoPairEngine::Report()
+{
+  // Prepare a report of the engine settings
+  AliFemtoString report = "AliFemtoPairEngine\n";
+  char ctemp[200];
+  snprintf(ctemp, 200, "Accept pairs with kT in range %f , %f\n", fKTMin, fKTMax);
+  report += ctemp;
+  if (fQInvMax > 0.0) {
+    snprintf(ctemp, 200, "Accept pairs with qinv < %f\n", fQInvMax);
+    report += ctemp;
+  }
+  if (fKStarMax > 0.0) {
+    snprintf(ctemp, 200, "Accept pairs with k* < %f\n", fKStarMax);
+    report += ctemp;
+  }
+  if (fDPhiStarMin > 0.0) {
+    snprintf(ctemp, 200, "Reject pairs with |deta| < %f and |dphi*(%f m)| < %f\n",
+             fDEtaMin, fMergingRadius, fDPhiStarMin);
+    report += ctemp;
+  }
+  if (fMinEntranceSep > 0.0) {
+    snprintf(ctemp, 200, "Reject pairs with entrance separation < %f\n", fMinEntranceSep);
+    report += ctemp;
+  }
+  if (fMinPidProduct > 0.0) {
+    snprintf(ctemp, 200, "Accept pairs with PID probability product (species %d) >= %f\n",
+             fPidSpecies, fMinPidProduct);
+    report += ctemp;
+  }
+  snprintf(ctemp, 200, "Analysis pair cut %s\n", fPairCutHandled ? "skipped" : "applied");
+  report += ctemp;
+  return report;
+}
+//_________________________
+TList* AliFemtoPairEngine::ListSettings()
+{
+  // return a list of settings in a writable form
+  TList *tListSettings = new TList();
+  char buf[200];
+  snprintf(buf, 200, "AliFemtoPairEngine.ktmin=%f", fKTMin);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.ktmax=%f", fKTMax);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.qinvmax=%f", fQInvMax);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.kstarmax=%f", fKStarMax);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.detamin=%f", fDEtaMin);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.dphistarmin=%f", fDPhiStarMin);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.mergingradius=%f", fMergingRadius);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.minentrancesep=%f", fMinEntranceSep);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.pidspecies=%d", fPidSpecies);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.minpidproduct=%f", fMinPidProduct);
+  tListSettings->AddLast(new TObjString(buf));
+  snprintf(buf, 200, "AliFemtoPairEngine.paircuthandled=%d", fPairCutHandled ? 1 : 0);
+  tListSettings->AddLast(new TObjString(buf));
+  return tListSettings;
+}
@@ -0,0 +1,222 @@
+///
+/// \file AliFemtoPairEngine.h
+///
+
+#ifndef ALIFEMTOPAIRENGINE_H
+#define ALIFEMTOPAIRENGINE_H
+
+#include <vector>
+
+#include "AliFemtoString.h"
+#include "AliFemtoEvent.h"
+#include "AliFemtoParticleCollection.h"
+#include "AliFemtoPairBatch.h"
+
+class TList;
+
+///
+/// \class AliFemtoPairEngine
+/// \brief Structure-of-arrays pair builder used by AliFemtoSimpleAnalysis
+///
+/// When an engine is attached to an analysis (AliFemtoSimpleAnalysis::SetPairEngine)
+/// the particle collections are packed into flat arrays (four-momenta,
+/// pT/eta/phi, charge, nominal TPC entrance point, PID probability and the
+/// azimuth phi* at the configured merging radius) once per MakePairs call.
+/// The most common pair cuts are then evaluated for a whole block of
+/// candidate partners at a time in branch-free loops the compiler can
+/// vectorize:
+///
+///  - kT window (SetKTRange)
+///  - upper limit on qinv and k* (SetQInvMax, SetKStarMax)
+///  - two-track merging, using the same dEta/dPhi* definition as
+///    AliFemtoPairCutRadialDistance at a single radius (SetMergingCut),
+///    including its use of the field sign only (phi* always assumes 5 kG)
+///  - minimum nominal TPC entrance separation (SetMinEntranceSeparation)
+///  - minimum product of the PID probabilities (SetPidWeight)
+///
+/// Only pairs surviving these cuts are turned into AliFemtoPair objects and
+/// sent through the analysis pair cut. If the engine cuts are a full
+/// replacement for the analysis pair cut, call SetPairCutHandled(kTRUE) and
+/// the virtual AliFemtoPairCut::Pass is skipped altogether.
+///
+/// Correlation functions reporting SupportsPairBatch() receive the accepted
+/// pairs in AliFemtoPairBatch blocks with qinv, kT and k* precomputed; all
+/// other correlation functions still get every pair through the classic
+/// AddRealPair/AddMixedPair path.
+///
+/// The engine cuts are applied on top of the analysis pair cut, so they
+/// must be looser or equal to it to leave the results unchanged. Pair cut
+/// monitors are only filled for pairs surviving the engine cuts.
+///
+class AliFemtoPairEngine {
+public:
+
+  /// Which PID probability of AliFemtoTrack is packed as particle weight
+  enum PidSpecies {kNoPid=0, kElectron=1, kPion=2, kKaon=3, kProton=4};
+
+  ///
+  /// \class ParticleBuffer
+  /// \brief Flat copy of one particle collection
+  ///
+  class ParticleBuffer {
+  public:
+    ParticleBuffer();
+    void Clear();
+    UInt_t Size() const { return fParticle.size(); }
+    AliFemtoParticle* Particle(UInt_t i) const { return fParticle[i]; }
+
+    std::vector<AliFemtoParticle*> fParticle;  ///< the packed particles
+    std::vector<Double_t> fPx;          ///< momentum x
+    std::vector<Double_t> fPy;          ///< momentum y
+    std::vector<Double_t> fPz;          ///< momentum z
+    std::vector<Double_t> fE;           ///< energy
+    std::vector<Double_t> fM2;          ///< mass squared (clamped to >= 0)
+    std::vector<Double_t> fEta;         ///< pseudorapidity
+    std::vector<Double_t> fPhiStar;     ///< azimuth at the merging radius
+    std::vector<Double_t> fPhiStarOk;   ///< 1 if fPhiStar is defined (track reaches the radius), else 0
+    std::vector<Double_t> fEntX;        ///< nominal TPC entrance point x
+    std::vector<Double_t> fEntY;        ///< nominal TPC entrance point y
+    std::vector<Double_t> fEntZ;        ///< nominal TPC entrance point z
+    std::vector<Double_t> fEntOk;       ///< 1 if the entrance point is set, else 0
+    std::vector<Double_t> fPidWeight;   ///< PID probability of the configured species
+  };
+
+  AliFemtoPairEngine();
+  AliFemtoPairEngine(const AliFemtoPairEngine& aEngine);
+  AliFemtoPairEngine& operator=(const AliFemtoPairEngine& aEngine);
+  virtual ~AliFemtoPairEngine();
+
+  virtual AliFemtoPairEngine* Clone() const { return new AliFemtoPairEngine(*this); }
+
+  void SetKTRange(Double_t ktmin, Double_t ktmax);
+  void SetQInvMax(Double_t qmax);
+  void SetKStarMax(Double_t kmax);
+  void SetMergingCut(Double_t detamin, Double_t dphistarmin, Double_t radius=1.2);
+  void SetMinEntranceSeparation(Double_t sep);
+  void SetPidWeight(PidSpecies species, Double_t minProduct);
+  void SetPairCutHandled(Bool_t handled);
+  void SetBlockSize(UInt_t size);
+  void SetBatchSize(UInt_t size);
+
+  Bool_t PairCutHandled() const { return fPairCutHandled; }
+  UInt_t BlockSize() const { return fBlockSize; }
+  UInt_t BatchSize() const { return fBatchSize; }
+
+  /// Pick up the magnetic field of the event, needed for phi*
+  void EventBegin(const AliFemtoEvent* aEvent);
+
+  /// Pack a particle collection into buffer 0 or 1
+  void Pack(UInt_t slot, const AliFemtoParticleCollection* aCollection);
+  void Pack(UInt_t slot, const std::vector<AliFemtoParticle*>& aParticles);
+  const ParticleBuffer& Buffer(UInt_t slot) const { return fBuffer[slot]; }
+
+  /// Evaluate the engine cuts for the pairs (i, j) with j in [jBegin, jEnd)
+  /// and compact the accepted ones. Returns the number of accepted pairs,
+  /// which are accessed through AcceptedIndex/AcceptedQInv/AcceptedKT/AcceptedKStar.
+  UInt_t EvaluateBlock(const ParticleBuffer& b1, UInt_t i,
+                       const ParticleBuffer& b2, UInt_t jBegin, UInt_t jEnd);
+
+  UInt_t AcceptedIndex(UInt_t k) const { return fAccepted[k]; }
+  Double_t AcceptedQInv(UInt_t k) const { return fQInv[k]; }
+  Double_t AcceptedKT(UInt_t k) const { return fKT[k]; }
+  Double_t AcceptedKStar(UInt_t k) const { return fKStar[k]; }
+
+  /// Batch handed to the batch-capable correlation functions
+  AliFemtoPairBatch& Batch() { return fBatch; }
+
+  virtual AliFemtoString Report();
+  virtual TList* ListSettings();
+
+protected:
+
+  /// Append the packed quantities of one particle to a buffer
+  void PackParticle(ParticleBuffer& buf, AliFemtoParticle* particle, Double_t phiStarScale) const;
+
+  Double_t fKTMin;               ///< minimum pair kT
+  Double_t fKTMax;               ///< maximum pair kT
+  Double_t fQInvMax;             ///< maximum |qinv|, <= 0 disables
+  Double_t fKStarMax;            ///< maximum k*, <= 0 disables
+  Double_t fDEtaMin;             ///< merging cut: pairs with |deta| < fDEtaMin ...
+  Double_t fDPhiStarMin;         ///< ... and |dphi*| < fDPhiStarMin are rejected, <= 0 disables
+  Double_t fMergingRadius;       ///< radius (m) at which phi* is evaluated
+  Double_t fMinEntranceSep;      ///< minimum nominal TPC entrance separation, <= 0 disables
+  PidSpecies fPidSpecies;        ///< species whose PID probability is packed
+  Double_t fMinPidProduct;       ///< minimum product of PID probabilities, <= 0 disables
+  Bool_t fPairCutHandled;        ///< engine cuts replace the analysis pair cut
+  UInt_t fBlockSize;             ///< number of partners evaluated per block
+  UInt_t fBatchSize;             ///< number of pairs collected before a batch flush
+
+  Int_t fMagSign;                //!<! sign of the field of the current event
+
+  ParticleBuffer fBuffer[2];     //!<! packed particle collections
+  std::vector<Double_t> fQInv;   //!<! scratch: qinv of block pairs (compacted)
+  std::vector<Double_t> fKT;     //!<! scratch: kT of block pairs (compacted)
+  std::vector<Double_t> fKStar;  //!<! scratch: k* of block pairs (compacted)
+  std::vector<Char_t> fPass;     //!<! scratch: accept flag of block pairs
+  std::vector<UInt_t> fAccepted; //!<! scratch: accepted partner indices
+  AliFemtoPairBatch fBatch;      //!<! batch for the correlation functions
+
+#ifdef __ROOT__
+  /// \cond CLASSIMP
+  ClassDef(AliFemtoPairEngine, 1);
+  /// \endcond
+#endif
+};
+
+inline void AliFemtoPairEngine::SetKTRange(Double_t ktmin, Double_t ktmax)
+{
+  fKTMin = ktmin;
+  fKTMax = ktmax;
+}
+
+inline void AliFemtoPairEngine::SetQInvMax(Double_t qmax)
+{
+  fQInvMax = qmax;
+}
+
+inline void AliFemtoPairEngine::SetKStarMax(Double_t kmax)
+{
+  fKStarMax = kmax;
+}
+
+inline void AliFemtoPairEngine::SetMergingCut(Double_t detamin, Double_t dphistarmin, Double_t radius)
+{
+  fDEtaMin = detamin;
+  fDPhiStarMin = dphistarmin;
+  fMergingRadius = radius;
+}
+
+inline void AliFemtoPairEngine::SetMinEntranceSeparation(Double_t sep)
+{
+  fMinEntranceSep = sep;
+}
+
+inline void AliFemtoPairEngine::SetPidWeight(PidSpecies species, Double_t minProduct)
+{
+  fPidSpecies = species;
+  fMinPidProduct = minProduct;
+}
+
+inline void AliFemtoPairEngine::SetPairCutHandled(Bool_t handled)
+{
+  fPairCutHandled = handled;
+}
+
+inline void AliFemtoPairEngine::SetBlockSize(UInt_t size)
+{
+  fBlockSize = (size > 0) ? size : 1;
+}
+
+inline void AliFemtoPairEngine::SetBatchSize(UInt_t size)
+{
+  fBatchSize = (size > 0) ? size : 1;
+}
+
+inline void AliFemtoPairEngine::EventBegin(const AliFemtoEvent* aEvent)
+{
+  // same sign convention as AliFemtoPairCutRadialDistance::Pass
+  const Double_t field = aEvent->MagneticField();
+  fMagSign = (field < 1) ? -1 : 1;
+}
+
+#endif
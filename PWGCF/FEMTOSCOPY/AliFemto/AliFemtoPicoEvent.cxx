@@ -62,12 +62,15 @@
 
 #include "AliFemtoPicoEvent.h"
 #include "AliFemtoParticleCollection.h"
+#include "AliFemtoMixingGrid.h"
 
 //________________
 AliFemtoPicoEvent::AliFemtoPicoEvent() :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstMixingGrid(0),
+  fSecondMixingGrid(0)
 {
   // Default constructor
   fFirstParticleCollection = new AliFemtoParticleCollection;
@@ -78,7 +81,9 @@ AliFemtoPicoEvent::AliFemtoPicoEvent() :
 AliFemtoPicoEvent::AliFemtoPicoEvent(const AliFemtoPicoEvent& aPicoEvent) :
   fFirstParticleCollection(0),
   fSecondParticleCollection(0),
-  fThirdParticleCollection(0)
+  fThirdParticleCollection(0),
+  fFirstMixingGrid(0),
+  fSecondMixingGrid(0)
 {
   // Copy constructor
   AliFemtoParticleIterator iter;
@@ -106,6 +111,10 @@ AliFemtoPicoEvent::AliFemtoPicoEvent(const AliFemtoPicoEvent& aPicoEvent) :
 AliFemtoPicoEvent::~AliFemtoPicoEvent(){
   // Destructor
   AliFemtoParticleIterator iter;
+
+  // the grids only point to the particles
+  delete fFirstMixingGrid;
+  delete fSecondMixingGrid;
   
   if (fFirstParticleCollection){
     for (iter=fFirstParticleCollection->begin();iter!=fFirstParticleCollection->end();iter++){
@@ -144,6 +153,12 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
     return *this;
 
   AliFemtoParticleIterator iter;
+
+  // grids are not copied, they are rebuilt when needed
+  delete fFirstMixingGrid;
+  delete fSecondMixingGrid;
+  fFirstMixingGrid = 0;
+  fSecondMixingGrid = 0;
    
   if (fFirstParticleCollection){
       for (iter=fFirstParticleCollection->begin();iter!=fFirstParticleCollection->end();iter++){
@@ -195,4 +210,17 @@ AliFemtoPicoEvent& AliFemtoPicoEvent::operator=(const AliFemtoPicoEvent& aPicoEv
 
   return *this;
 }
-
+//_________________
+void AliFemtoPicoEvent::SetFirstMixingGrid(AliFemtoMixingGrid* aGrid)
+{
+  // Set the grid of the first particle collection, taking ownership
+  if (aGrid != fFirstMixingGrid) delete fFirstMixingGrid;
+  fFirstMixingGrid = aGrid;
+}
+//_________________
+void AliFemtoPicoEvent::SetSecondMixingGrid(AliFemtoMixingGrid* aGrid)
+{
+  // Set the grid of the second particle collection, taking ownership
+  if (aGrid != fSecondMixingGrid) delete fSecondMixingGrid;
+  fSecondMixingGrid = aGrid;
+}
@@ -44,6 +44,8 @@
 
 #include "AliFemtoParticleCollection.h"
 
+class AliFemtoMixingGrid;
+
 class AliFemtoPicoEvent{
 public:
   AliFemtoPicoEvent();
@@ -58,14 +60,25 @@ public:
   AliFemtoParticleCollection* SecondParticleCollection();
   AliFemtoParticleCollection* ThirdParticleCollection();
 
+  /* momentum-space grids of the first and second collection, used for mixing;
+     the pico event takes ownership */
+  AliFemtoMixingGrid* FirstMixingGrid();
+  AliFemtoMixingGrid* SecondMixingGrid();
+  void SetFirstMixingGrid(AliFemtoMixingGrid* aGrid);
+  void SetSecondMixingGrid(AliFemtoMixingGrid* aGrid);
+
 private:
   AliFemtoParticleCollection* fFirstParticleCollection;  // Collection of particles of type 1
   AliFemtoParticleCollection* fSecondParticleCollection; // Collection of particles of type 2
   AliFemtoParticleCollection* fThirdParticleCollection;  // Collection of particles of type 3
+  AliFemtoMixingGrid* fFirstMixingGrid;                  // Mixing grid of the particles of type 1 (0 if not built)
+  AliFemtoMixingGrid* fSecondMixingGrid;                 // Mixing grid of the particles of type 2 (0 if not built)
 };
 
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::FirstParticleCollection(){return fFirstParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::SecondParticleCollection(){return fSecondParticleCollection;}
 inline AliFemtoParticleCollection* AliFemtoPicoEvent::ThirdParticleCollection(){return fThirdParticleCollection;}
+inline AliFemtoMixingGrid* AliFemtoPicoEvent::FirstMixingGrid(){return fFirstMixingGrid;}
+inline AliFemtoMixingGrid* AliFemtoPicoEvent::SecondMixingGrid(){return fSecondMixingGrid;}
 
 #endif
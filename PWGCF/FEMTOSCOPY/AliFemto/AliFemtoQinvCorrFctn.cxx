@@ -253,6 +253,36 @@ void AliFemtoQinvCorrFctn::AddRealPair(AliFemtoPair* pair){
   //" " << pair->track1().FourMomentum() << " " << pair->track2().FourMomentum() << endl;
 }
 
+//____________________________
+bool AliFemtoQinvCorrFctn::SupportsPairBatch() const
+{
+  // Only the plain qinv/kT histograms can be filled from the precomputed
+  // batch values; every optional extra needs the full pair
+  return (fPairCut == NULL) && !fDetaDphiscal && !fPairKinematics;
+}
+//____________________________
+void AliFemtoQinvCorrFctn::AddRealPairBatch(const AliFemtoPairBatch& batch)
+{
+  // add a block of true pairs
+  if (!SupportsPairBatch()) {
+    AliFemtoCorrFctn::AddRealPairBatch(batch);
+    return;
+  }
+
+  fNumerator->FillN(batch.Size(), batch.QInv(), NULL);
+  fkTMonitor->FillN(batch.Size(), batch.KT(), NULL);
+}
+//____________________________
+void AliFemtoQinvCorrFctn::AddMixedPairBatch(const AliFemtoPairBatch& batch)
+{
+  // add a block of mixed (background) pairs
+  if (!SupportsPairBatch()) {
+    AliFemtoCorrFctn::AddMixedPairBatch(batch);
+    return;
+  }
+
+  fDenominator->FillN(batch.Size(), batch.QInv(), NULL);
+}
 //____________________________
 void AliFemtoQinvCorrFctn::AddMixedPair(AliFemtoPair* pair){
   // add mixed (background) pair
@@ -68,6 +68,10 @@ public:
   virtual void AddRealPair(AliFemtoPair* aPair);
   virtual void AddMixedPair(AliFemtoPair* aPair);
 
+  virtual bool SupportsPairBatch() const;
+  virtual void AddRealPairBatch(const AliFemtoPairBatch& aBatch);
+  virtual void AddMixedPairBatch(const AliFemtoPairBatch& aBatch);
+
   virtual void Finish();
 
   void CalculateDetaDphis(Bool_t, Double_t);
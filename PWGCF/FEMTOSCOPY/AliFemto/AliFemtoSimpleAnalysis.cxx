@@ -13,6 +13,8 @@
 #include <string>
 #include <iostream>
 #include <iterator>
+#include <vector>
+#include <algorithm>
 
 #ifdef __ROOT__
   /// \cond CLASSIMP
@@ -156,12 +158,21 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fSecondParticleCut(NULL),
   fMixingBuffer(NULL),
   fPicoEvent(NULL),
+  fPairEngine(NULL),
   fNumEventsToMix(0),
   fNeventsProcessed(0),
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fMixingGridQInvMax(0.0),
+  fMixingGridNPt(8),
+  fMixingGridPtMax(2.0),
+  fMixingGridNY(8),
+  fMixingGridYMax(1.0),
+  fMixingGridNPhi(18),
+  fGridOffsets(),
+  fGridRanges()
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -178,12 +189,21 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fSecondParticleCut(NULL),
   fMixingBuffer(NULL),
   fPicoEvent(NULL),
+  fPairEngine(NULL),
   fNumEventsToMix(a.fNumEventsToMix),
   fNeventsProcessed(0),
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fMixingGridQInvMax(a.fMixingGridQInvMax),
+  fMixingGridNPt(a.fMixingGridNPt),
+  fMixingGridPtMax(a.fMixingGridPtMax),
+  fMixingGridNY(a.fMixingGridNY),
+  fMixingGridYMax(a.fMixingGridYMax),
+  fMixingGridNPhi(a.fMixingGridNPhi),
+  fGridOffsets(),
+  fGridRanges()
 {
   /// Copy constructor
 
@@ -243,6 +263,10 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
     // TODO: handle uncloned track cut
   }
 
+  if (a.fPairEngine) {
+    fPairEngine = a.fPairEngine->Clone();
+  }
+
   AliFemtoCorrFctnIterator iter;
   if (fVerbose) {
     cout << TString::Format(msg_template, "looking for correlation functions") << endl;
@@ -278,6 +302,7 @@ AliFemtoSimpleAnalysis::~AliFemtoSimpleAnalysis()
   delete fEventCut;
   delete fFirstParticleCut;
   delete fSecondParticleCut;
+  delete fPairEngine;
 
   // delete every CorrFunction in the collection, then the collection
   if (fCorrFctnCollection) {
@@ -313,6 +338,7 @@ AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAn
   delete fEventCut;
   delete fFirstParticleCut;
   delete fSecondParticleCut;
+  delete fPairEngine;
 
   // clear correlation functions out of fCorrFctnCollection
   if (fCorrFctnCollection) {
@@ -343,6 +369,7 @@ AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAn
   fSecondParticleCut = (aAna.fFirstParticleCut == aAna.fSecondParticleCut)
                      ? fFirstParticleCut
                      : aAna.fSecondParticleCut->Clone();
+  fPairEngine = aAna.fPairEngine ? aAna.fPairEngine->Clone() : NULL;
 
   if (fPairCut) {
     SetPairCut(fPairCut);
@@ -379,6 +406,12 @@ AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAn
   fVerbose = aAna.fVerbose;
   fPerformSharedDaughterCut = aAna.fPerformSharedDaughterCut;
   fEnablePairMonitors = aAna.fEnablePairMonitors;
+  fMixingGridQInvMax = aAna.fMixingGridQInvMax;
+  fMixingGridNPt = aAna.fMixingGridNPt;
+  fMixingGridPtMax = aAna.fMixingGridPtMax;
+  fMixingGridNY = aAna.fMixingGridNY;
+  fMixingGridYMax = aAna.fMixingGridYMax;
+  fMixingGridNPhi = aAna.fMixingGridNPhi;
 
   return *this;
 }
@@ -520,14 +553,29 @@ void AliFemtoSimpleAnalysis::ProcessEvent(const AliFemtoEvent* hbtEvent)
   }
 
   //---- Make pairs for mixed events, looping over events in mixingBuffer ----//
+  const bool useMixingGrid = (fMixingGridQInvMax > 0.0);
+
   for (AliFemtoPicoEventIterator fPicoEventIter = MixingBuffer()->begin();
                                  fPicoEventIter != MixingBuffer()->end();
                                ++fPicoEventIter) {
 
     AliFemtoPicoEvent *storedEvent = *fPicoEventIter;
 
+    // With the grid - same combinations as below, restricted to matching cells
+    if (useMixingGrid) {
+      if (AnalyzeIdenticalParticles()) {
+        MakePairsOnGrid("mixed", *MixingGrid(fPicoEvent, true),
+                                 *MixingGrid(storedEvent, true));
+      } else {
+        MakePairsOnGrid("mixed", *MixingGrid(fPicoEvent, true),
+                                 *MixingGrid(storedEvent, false));
+
+        MakePairsOnGrid("mixed", *MixingGrid(storedEvent, true),
+                                 *MixingGrid(fPicoEvent, false));
+      }
+
     // If identical - only mix the first particle collections
-    if (AnalyzeIdenticalParticles()) {
+    } else if (AnalyzeIdenticalParticles()) {
       MakePairs("mixed", collection1, storedEvent->FirstParticleCollection());
 
     // If non-identical - mix both combinations of first and second particles
@@ -569,6 +617,18 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
 
   const string type = typeIn;
 
+  // resolve the pair type once, not for every pair and correlation function
+  const bool is_real = (type == "real");
+  if (!is_real && type != "mixed") {
+    cout << "Problem with pair type, type = " << type << endl;
+    return;
+  }
+
+  if (fPairEngine) {
+    MakePairsWithEngine(is_real, partCollection1, partCollection2, enablePairMonitors);
+    return;
+  }
+
   //  int swpart = ((long int) partCollection1) % 2;
 
   // Used to swap particle 1 & 2 in identical-particle analysis
@@ -649,12 +709,10 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
 
           AliFemtoCorrFctn* tCorrFctn = *tCorrFctnIter;
 
-          if (type == "real")
+          if (is_real)
             tCorrFctn->AddRealPair(tPair);
-          else if(type == "mixed")
-            tCorrFctn->AddMixedPair(tPair);
           else
-            cout << "Problem with pair type, type = " << type << endl;
+            tCorrFctn->AddMixedPair(tPair);
         } // loop over corellatoin functions
       }
     }    // loop over second particle
@@ -664,6 +722,261 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   delete tPair;
 }
 //_________________________
+void AliFemtoSimpleAnalysis::MakePairsWithEngine(bool is_real,
+                                                 AliFemtoParticleCollection *partCollection1,
+                                                 AliFemtoParticleCollection *partCollection2,
+                                                 Bool_t enablePairMonitors,
+                                                 const AliFemtoMixingGrid *grid1,
+                                                 const AliFemtoMixingGrid *grid2)
+{
+/// Same as MakePairs, but the particle collections are packed into the
+/// pair engine first. Candidate partners are evaluated in blocks and only
+/// pairs surviving the engine cuts reach the pair cut and the correlation
+/// functions. Batch-capable correlation functions are filled from the
+/// engine's AliFemtoPairBatch, all others pair by pair.
+
+  const bool onGrid = (grid1 != NULL && grid2 != NULL),
+             identical = !onGrid && (partCollection2 == NULL);
+
+  // same "seed" for the swapping of identical particles as in MakePairs
+  const bool swpart = fNeventsProcessed % 2;
+
+  if (onGrid) {
+    fPairEngine->Pack(0, grid1->Particles());
+    fPairEngine->Pack(1, grid2->Particles());
+  } else {
+    fPairEngine->Pack(0, partCollection1);
+    if (!identical) {
+      fPairEngine->Pack(1, partCollection2);
+    }
+  }
+
+  const AliFemtoPairEngine::ParticleBuffer &buffer1 = fPairEngine->Buffer(0),
+                                           &buffer2 = identical ? buffer1 : fPairEngine->Buffer(1);
+
+  // split the correlation functions by the way they accept pairs
+  std::vector<AliFemtoCorrFctn*> batchFctns,
+                                 pairFctns;
+  for (AliFemtoCorrFctnIterator tCorrFctnIter = fCorrFctnCollection->begin();
+                                tCorrFctnIter != fCorrFctnCollection->end();
+                              ++tCorrFctnIter) {
+    if ((*tCorrFctnIter)->SupportsPairBatch()) {
+      batchFctns.push_back(*tCorrFctnIter);
+    } else {
+      pairFctns.push_back(*tCorrFctnIter);
+    }
+  }
+
+  // the pair cut is still needed for the monitors
+  const bool checkPairCut = !fPairEngine->PairCutHandled() || enablePairMonitors;
+
+  AliFemtoPairBatch &batch = fPairEngine->Batch();
+  batch.Clear();
+  batch.Reserve(fPairEngine->BatchSize());
+
+  AliFemtoPair tPair;
+
+  const UInt_t n1 = buffer1.Size(),
+               n2 = buffer2.Size(),
+               blockSize = fPairEngine->BlockSize();
+
+  // number of inner-loop iterations done so far; its parity reproduces the
+  // particle swapping of the classic loop for identical particles
+  ULong64_t nIterations = 0;
+
+  // with a grid the particles of buffer1 are ordered by cell, and each
+  // cell has its own partner ranges in buffer2
+  UInt_t cell = 0;
+
+  for (UInt_t i = 0; i < n1; ++i) {
+    const UInt_t jFirst = identical ? i + 1 : 0;
+
+    if (onGrid) {
+      while (i >= grid1->CellEnd(cell)) {
+        ++cell;
+      }
+    }
+
+    const UInt_t rBegin = onGrid ? fGridOffsets[cell] : 0,
+                 rEnd = onGrid ? fGridOffsets[cell + 1] : 1;
+
+    for (UInt_t r = rBegin; r < rEnd; ++r) {
+      const UInt_t jRangeBegin = onGrid ? fGridRanges[2 * r] : jFirst,
+                   jRangeEnd = onGrid ? fGridRanges[2 * r + 1] : n2;
+
+      for (UInt_t jBegin = jRangeBegin; jBegin < jRangeEnd; jBegin += blockSize) {
+        const UInt_t jEnd = (jBegin + blockSize < jRangeEnd) ? jBegin + blockSize : jRangeEnd;
+        const UInt_t nAccepted = fPairEngine->EvaluateBlock(buffer1, i, buffer2, jBegin, jEnd);
+
+        for (UInt_t k = 0; k < nAccepted; ++k) {
+          const UInt_t j = fPairEngine->AcceptedIndex(k);
+
+          AliFemtoParticle *p1 = buffer1.Particle(i),
+                           *p2 = buffer2.Particle(j);
+
+          if (identical && (swpart != bool((nIterations + (j - jFirst)) % 2))) {
+            std::swap(p1, p2);
+          }
+
+          tPair.SetTrack1(p1);
+          tPair.SetTrack2(p2);
+
+          if (checkPairCut) {
+            const bool tmpPassPair = fPairCut->Pass(&tPair);
+
+            if (enablePairMonitors) {
+              fPairCut->FillCutMonitor(&tPair, tmpPassPair);
+            }
+
+            if (!tmpPassPair && !fPairEngine->PairCutHandled()) {
+              continue;
+            }
+          }
+
+          for (std::vector<AliFemtoCorrFctn*>::iterator tCorrFctnIter = pairFctns.begin();
+                                                        tCorrFctnIter != pairFctns.end();
+                                                      ++tCorrFctnIter) {
+            if (is_real)
+              (*tCorrFctnIter)->AddRealPair(&tPair);
+            else
+              (*tCorrFctnIter)->AddMixedPair(&tPair);
+          }
+
+          if (batchFctns.empty()) {
+            continue;
+          }
+
+          batch.Push(p1, p2,
+                     fPairEngine->AcceptedQInv(k),
+                     fPairEngine->AcceptedKT(k),
+                     fPairEngine->AcceptedKStar(k));
+
+          if (batch.Size() >= fPairEngine->BatchSize()) {
+            FlushPairBatch(is_real, batch, batchFctns);
+          }
+        }
+      }
+    }
+
+    if (n2 > jFirst) {
+      nIterations += n2 - jFirst;
+    }
+  }
+
+  FlushPairBatch(is_real, batch, batchFctns);
+}
+//_________________________
+void AliFemtoSimpleAnalysis::MakePairsOnGrid(const char* typeIn,
+                                             const AliFemtoMixingGrid& grid1,
+                                             const AliFemtoMixingGrid& grid2,
+                                             Bool_t enablePairMonitors)
+{
+/// Pair the particles of grid1 with those of grid2, visiting only the cells
+/// of grid2 which can give qinv <= fMixingGridQInvMax. Pair cut and
+/// correlation functions are called as in MakePairs; pairs are formed cell
+/// by cell instead of in collection order.
+
+  const string type = typeIn;
+
+  const bool is_real = (type == "real");
+  if (!is_real && type != "mixed") {
+    cout << "Problem with pair type, type = " << type << endl;
+    return;
+  }
+
+  if (grid1.NParticles() == 0 || grid2.NParticles() == 0) {
+    return;
+  }
+
+  grid1.Match(grid2, fMixingGridQInvMax, fGridOffsets, fGridRanges);
+
+  if (fPairEngine) {
+    MakePairsWithEngine(is_real, NULL, NULL, enablePairMonitors, &grid1, &grid2);
+    return;
+  }
+
+  AliFemtoPair tPair;
+
+  for (UInt_t cell = 0; cell < grid1.NOccupiedCells(); ++cell) {
+    for (UInt_t i = grid1.CellBegin(cell); i < grid1.CellEnd(cell); ++i) {
+      tPair.SetTrack1(grid1.Particle(i));
+
+      for (UInt_t r = fGridOffsets[cell]; r < fGridOffsets[cell + 1]; ++r) {
+        for (UInt_t j = fGridRanges[2 * r]; j < fGridRanges[2 * r + 1]; ++j) {
+          tPair.SetTrack2(grid2.Particle(j));
+
+          const bool tmpPassPair = fPairCut->Pass(&tPair);
+
+          if (enablePairMonitors) {
+            fPairCut->FillCutMonitor(&tPair, tmpPassPair);
+          }
+
+          if (!tmpPassPair) {
+            continue;
+          }
+
+          for (AliFemtoCorrFctnIterator tCorrFctnIter = fCorrFctnCollection->begin();
+                                        tCorrFctnIter != fCorrFctnCollection->end();
+                                      ++tCorrFctnIter) {
+            if (is_real)
+              (*tCorrFctnIter)->AddRealPair(&tPair);
+            else
+              (*tCorrFctnIter)->AddMixedPair(&tPair);
+          }
+        }
+      }
+    }
+  }
+}
+//_________________________
+AliFemtoMixingGrid* AliFemtoSimpleAnalysis::MixingGrid(AliFemtoPicoEvent* picoEvent, bool first)
+{
+  // Return the grid of the first or second particle collection of the pico
+  // event. Events which entered the mixing buffer before the grid was
+  // enabled get theirs here.
+
+  AliFemtoMixingGrid *grid = first ? picoEvent->FirstMixingGrid()
+                                   : picoEvent->SecondMixingGrid();
+  if (grid) {
+    return grid;
+  }
+
+  grid = new AliFemtoMixingGrid(fMixingGridNPt, fMixingGridPtMax,
+                                fMixingGridNY, fMixingGridYMax,
+                                fMixingGridNPhi);
+  if (first) {
+    grid->Build(picoEvent->FirstParticleCollection());
+    picoEvent->SetFirstMixingGrid(grid);
+  } else {
+    grid->Build(picoEvent->SecondParticleCollection());
+    picoEvent->SetSecondMixingGrid(grid);
+  }
+
+  return grid;
+}
+//_________________________
+void AliFemtoSimpleAnalysis::FlushPairBatch(bool is_real,
+                                            AliFemtoPairBatch &batch,
+                                            std::vector<AliFemtoCorrFctn*> &fctns)
+{
+  // Hand the collected pairs to the batch-capable correlation functions
+
+  if (batch.Empty()) {
+    return;
+  }
+
+  for (std::vector<AliFemtoCorrFctn*>::iterator tCorrFctnIter = fctns.begin();
+                                                tCorrFctnIter != fctns.end();
+                                              ++tCorrFctnIter) {
+    if (is_real)
+      (*tCorrFctnIter)->AddRealPairBatch(batch);
+    else
+      (*tCorrFctnIter)->AddMixedPairBatch(batch);
+  }
+
+  batch.Clear();
+}
+//_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
 {
   /// Perform initialization operations at the beginning of the event processing
@@ -672,6 +985,9 @@ void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
   fFirstParticleCut->EventBegin(ev);
   fSecondParticleCut->EventBegin(ev);
   fPairCut->EventBegin(ev);
+  if (fPairEngine) {
+    fPairEngine->EventBegin(ev);
+  }
   for (AliFemtoCorrFctnIterator iter = fCorrFctnCollection->begin();
                                 iter != fCorrFctnCollection->end();
                                 ++iter) {
@@ -14,6 +14,10 @@
 #include "AliFemtoPicoEventCollection.h"
 #include "AliFemtoParticleCollection.h"
 #include "AliFemtoV0SharedDaughterCut.h"
+#include "AliFemtoPairEngine.h"
+#include "AliFemtoMixingGrid.h"
+
+#include <vector>
 
 class AliFemtoPicoEventCollectionVectorHideAway;
 class AliFemtoPicoEvent;
@@ -98,6 +102,29 @@ public:
   void SetEnablePairMonitors(Bool_t aEnable);
   Bool_t EnablePairMonitors();
 
+  /// Use the structure-of-arrays pair engine in MakePairs.
+  ///
+  /// The analysis takes ownership of the engine. Passing NULL restores the
+  /// classic pair loop. See AliFemtoPairEngine for the cuts it evaluates.
+  void SetPairEngine(AliFemtoPairEngine* aEngine);
+  AliFemtoPairEngine* PairEngine();
+
+  /// Only form mixed pairs which can have qinv <= qinvMax.
+  ///
+  /// The particles of every event are sorted into an AliFemtoMixingGrid of
+  /// nPt x nY x nPhi cells in pT (last cell open above ptMax), rapidity
+  /// (first and last cells open beyond +-yMax) and azimuth. The grid is
+  /// stored with the event in the mixing buffer, and only cell pairs whose
+  /// lower limit on qinv is below qinvMax are mixed. All mixed pairs with
+  /// qinv <= qinvMax are still formed (for equal masses k* = qinv/2), only
+  /// their order changes. Real pairs are not affected. qinvMax <= 0
+  /// disables the grid.
+  void SetMixingGrid(Double_t qinvMax,
+                     UInt_t nPt=8, Double_t ptMax=2.0,
+                     UInt_t nY=8, Double_t yMax=1.0,
+                     UInt_t nPhi=18);
+  Double_t MixingGridQInvMax() const;
+
   unsigned int NumEventsToMix() const;
   void SetNumEventsToMix(const unsigned int& NumberOfEventsToMix);
   AliFemtoPicoEvent* CurrentPicoEvent();
@@ -158,6 +185,36 @@ protected:
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
                  Bool_t enablePairMonitors=kFALSE);
 
+  /// Implementation of MakePairs with the AliFemtoPairEngine, called by
+  /// MakePairs when an engine has been set.
+  ///
+  /// If grids are given, the particles are taken from the grids and only
+  /// the partners in the cells matched by MakePairsOnGrid are evaluated.
+  void MakePairsWithEngine(bool isReal,
+                           AliFemtoParticleCollection* ParticlesPassingCut1,
+                           AliFemtoParticleCollection* ParticlesPssingCut2,
+                           Bool_t enablePairMonitors,
+                           const AliFemtoMixingGrid* grid1=NULL,
+                           const AliFemtoMixingGrid* grid2=NULL);
+
+  /// Same as MakePairs for two collections, but only the cells of grid2
+  /// which may give qinv <= fMixingGridQInvMax are paired with each cell
+  /// of grid1.
+  void MakePairsOnGrid(const char* type,
+                       const AliFemtoMixingGrid& grid1,
+                       const AliFemtoMixingGrid& grid2,
+                       Bool_t enablePairMonitors=kFALSE);
+
+  /// Mixing grid of the first or second particle collection of a pico
+  /// event, built on first use
+  AliFemtoMixingGrid* MixingGrid(AliFemtoPicoEvent* picoEvent, bool first);
+
+  /// Send the pairs collected by the engine to the batch-capable
+  /// correlation functions and empty the batch
+  void FlushPairBatch(bool isReal,
+                      AliFemtoPairBatch& batch,
+                      std::vector<AliFemtoCorrFctn*>& fctns);
+
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
   AliFemtoPairCut*             fPairCut;             ///< cut applied to pairs
@@ -167,6 +224,7 @@ protected:
   AliFemtoParticleCut*         fSecondParticleCut;   ///< select particles of type #2
   AliFemtoPicoEventCollection* fMixingBuffer;        ///< mixing buffer used in this simplest analysis
   AliFemtoPicoEvent*           fPicoEvent;           //!<! The current event, in the small (pico) form
+  AliFemtoPairEngine*          fPairEngine;          ///< optional vectorized pair builder (NULL: classic pair loop)
 
   unsigned int fNumEventsToMix;                      ///< How many "previous" events get mixed with this one, to make background
   unsigned int fNeventsProcessed;                    ///< How many events processed so far
@@ -177,6 +235,16 @@ protected:
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
 
+  Double_t fMixingGridQInvMax;                       ///< mixing grid: maximum qinv of the mixed pairs, <= 0 disables the grid
+  UInt_t fMixingGridNPt;                             ///< mixing grid: number of pT cells
+  Double_t fMixingGridPtMax;                         ///< mixing grid: upper edge of the last closed pT cell
+  UInt_t fMixingGridNY;                              ///< mixing grid: number of rapidity cells
+  Double_t fMixingGridYMax;                          ///< mixing grid: rapidity cells cover [-fMixingGridYMax, fMixingGridYMax]
+  UInt_t fMixingGridNPhi;                            ///< mixing grid: number of azimuth cells
+
+  std::vector<UInt_t> fGridOffsets;                  //!<! scratch: first partner range of each occupied cell
+  std::vector<UInt_t> fGridRanges;                   //!<! scratch: partner ranges of the matched cells
+
 #ifdef __ROOT__
   /// \cond CLASSIMP
   ClassDef(AliFemtoSimpleAnalysis, 0);
@@ -241,6 +309,16 @@ inline bool AliFemtoSimpleAnalysis::EnablePairMonitors()
   return fEnablePairMonitors;
 }
 
+inline AliFemtoPairEngine* AliFemtoSimpleAnalysis::PairEngine()
+{
+  return fPairEngine;
+}
+
+inline Double_t AliFemtoSimpleAnalysis::MixingGridQInvMax() const
+{
+  return fMixingGridQInvMax;
+}
+
 // Sets
 inline void AliFemtoSimpleAnalysis::SetPairCut(AliFemtoPairCut* x)
 {
@@ -304,4 +382,25 @@ inline void AliFemtoSimpleAnalysis::SetEnablePairMonitors(Bool_t aEnable)
   fEnablePairMonitors = aEnable;
 }
 
+inline void AliFemtoSimpleAnalysis::SetPairEngine(AliFemtoPairEngine* aEngine)
+{
+  if (fPairEngine != aEngine) {
+    delete fPairEngine;
+  }
+  fPairEngine = aEngine;
+}
+
+inline void AliFemtoSimpleAnalysis::SetMixingGrid(Double_t qinvMax,
+                                                  UInt_t nPt, Double_t ptMax,
+                                                  UInt_t nY, Double_t yMax,
+                                                  UInt_t nPhi)
+{
+  fMixingGridQInvMax = qinvMax;
+  fMixingGridNPt = nPt;
+  fMixingGridPtMax = ptMax;
+  fMixingGridNY = nY;
+  fMixingGridYMax = yMax;
+  fMixingGridNPhi = nPhi;
+}
+
 #endif
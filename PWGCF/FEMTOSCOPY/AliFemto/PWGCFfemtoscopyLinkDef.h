@@ -19,6 +19,7 @@
 #pragma link C++ class AliFemtoKinkCut+;
 #pragma link C++ class AliFemtoPairCut+;
 #pragma link C++ class AliFemtoKTPairCut+;
+#pragma link C++ class AliFemtoPairEngine+;
 #pragma link C++ class AliFemtoParticleCut+;
 #pragma link C++ class AliFemtoTrackCut+;
 #pragma link C++ class AliFemtoV0Cut+;
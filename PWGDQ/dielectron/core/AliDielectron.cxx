@@ -47,6 +47,7 @@ The names are available via the function PairClassName(Int_t i)
 #include <TMath.h>
 #include <TObject.h>
 #include <TGrid.h>
+#include <TDatabasePDG.h>
 
 #include <AliKFParticle.h>
 
@@ -156,6 +157,13 @@ AliDielectron::AliDielectron() :
   fDontClearArrays(kFALSE),
   fEventProcess(kTRUE),
   fUseGammaTracks(kTRUE),
+  fUsePairPreCut(kFALSE),
+  fPairPreCutMassMin(0.),
+  fPairPreCutMassMax(1.e30),
+  fPairPreCutPtMin(0.),
+  fPairPreCutPtMax(1.e30),
+  fPairPool("AliDielectronPair"),
+  fNPairPool(0),
   fEstimatorFilename(""),
   fEstimatorObjArray(0x0),
   fTRDpidCorrectionFilename(""),
@@ -229,6 +237,13 @@ AliDielectron::AliDielectron(const char* name, const char* title) :
   fDontClearArrays(kFALSE),
   fEventProcess(kTRUE),
   fUseGammaTracks(kTRUE),
+  fUsePairPreCut(kFALSE),
+  fPairPreCutMassMin(0.),
+  fPairPreCutMassMax(1.e30),
+  fPairPreCutPtMin(0.),
+  fPairPreCutPtMax(1.e30),
+  fPairPool("AliDielectronPair"),
+  fNPairPool(0),
   fEstimatorFilename(""),
   fEstimatorObjArray(0x0),
   fTRDpidCorrectionFilename(""),
@@ -259,7 +274,11 @@ AliDielectron::~AliDielectron()
   if (fPairEffMap) delete fPairEffMap;
   if (fHistos) delete fHistos;
   if (fUsedVars) delete fUsedVars;
-  if (fPairCandidates && fEventProcess) delete fPairCandidates;
+  if (fPairCandidates && fEventProcess) {
+    // detach the pool pairs from the owner arrays first
+    ClearArrays();
+    delete fPairCandidates;
+  }
   if (fDebugTree) delete fDebugTree;
   if (fMixing) delete fMixing;
   if (fSignalsMC) delete fSignalsMC;
@@ -1377,21 +1396,41 @@ void AliDielectron::FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev)
   // select pairs and fill pair candidate arrays
   //
 
-  TObjArray arrTracks1=fTracks[arr1];
-  TObjArray arrTracks2=fTracks[arr2];
+  const Bool_t preFilter1=(!fPreFilterAllSigns1) && (!fPreFilterUnlikeOnly1) && (!fPreFilterLikeOnly1) && ( fPairPreFilter1.GetCuts()->GetEntries()>0 );
+  const Bool_t preFilter2=(!fPreFilterAllSigns2) && (!fPreFilterUnlikeOnly2) && (!fPreFilterLikeOnly2) && ( fPairPreFilter2.GetCuts()->GetEntries()>0 );
 
-  //process pre filter if set
-  if ((!fPreFilterAllSigns1) && (!fPreFilterUnlikeOnly1) && (!fPreFilterLikeOnly1) && ( fPairPreFilter1.GetCuts()->GetEntries()>0 ))  PairPreFilter(arr1, arr2, arrTracks1, arrTracks2, ev, 1);
+  TObjArray *arrTracks1=&fTracks[arr1];
+  TObjArray *arrTracks2=&fTracks[arr2];
 
-  if ((!fPreFilterAllSigns2) && (!fPreFilterUnlikeOnly2) && (!fPreFilterLikeOnly2) && ( fPairPreFilter2.GetCuts()->GetEntries()>0 ))  PairPreFilter(arr1, arr2, arrTracks1, arrTracks2, ev, 2);
+  //process pre filter if set
+  //the pre filter removes tracks only for this combination, so it works on copies of the track arrays
+  if (preFilter1 || preFilter2){
+    for (Int_t i=0; i<2; ++i){
+      const TObjArray &arrTracks=fTracks[i==0 ? arr1 : arr2];
+      fPairTracks[i].Clear();
+      for (Int_t itrack=0; itrack<arrTracks.GetEntriesFast(); ++itrack) fPairTracks[i].AddLast(arrTracks.UncheckedAt(itrack));
+    }
+    arrTracks1=&fPairTracks[0];
+    arrTracks2=&fPairTracks[1];
+    if (preFilter1) PairPreFilter(arr1, arr2, *arrTracks1, *arrTracks2, ev, 1);
+    if (preFilter2) PairPreFilter(arr1, arr2, *arrTracks1, *arrTracks2, ev, 2);
+  }
 
   Int_t pairIndex=GetPairIndex(arr1,arr2);
 
-  Int_t ntrack1=arrTracks1.GetEntriesFast();
-  Int_t ntrack2=arrTracks2.GetEntriesFast();
+  Int_t ntrack1=arrTracks1->GetEntriesFast();
+  Int_t ntrack2=arrTracks2->GetEntriesFast();
 
-  AliDielectronPair *candidate=new AliDielectronPair;
-  candidate->SetKFUsage(fUseKF);
+  //leg 4-vectors for the kinematic pre-cut
+  if (fUsePairPreCut){
+    FillLegKinematics(*arrTracks1, fPdgLeg1, fLegKinematics[0]);
+    FillLegKinematics(*arrTracks2, fPdgLeg2, fLegKinematics[1]);
+  }
+
+  //the MC mother lookup can only find something if an MC event is connected
+  const Bool_t hasMC=AliDielectronMC::Instance()->HasMCEvent();
+
+  AliDielectronPair *candidate=NewPoolPair();
 
   UInt_t selectedMask=(1<<fPairFilter.GetCuts()->GetEntries())-1;
 
@@ -1399,22 +1438,38 @@ void AliDielectron::FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev)
     Int_t end=ntrack2;
     if (arr1==arr2) end=itrack1;
     for (Int_t itrack2=0; itrack2<end; ++itrack2){
+      //kinematic pre-cut, before the (KF) pair construction
+      if (fUsePairPreCut){
+        const Double_t *leg1=&fLegKinematics[0][4*itrack1];
+        const Double_t *leg2=&fLegKinematics[1][4*itrack2];
+        const Double_t px=leg1[0]+leg2[0];
+        const Double_t py=leg1[1]+leg2[1];
+        const Double_t pz=leg1[2]+leg2[2];
+        const Double_t e =leg1[3]+leg2[3];
+        const Double_t pt=TMath::Sqrt(px*px+py*py);
+        const Double_t m2=e*e-pt*pt-pz*pz;
+        const Double_t mass=m2>0. ? TMath::Sqrt(m2) : 0.;
+        if (mass<fPairPreCutMassMin || mass>fPairPreCutMassMax || pt<fPairPreCutPtMin || pt>fPairPreCutPtMax) continue;
+      }
+
       //create the pair (direct pointer to the memory by this daughter reference are kept also for ME)
-      candidate->SetTracks(&(*static_cast<AliVTrack*>(arrTracks1.UncheckedAt(itrack1))), fPdgLeg1,
-                           &(*static_cast<AliVTrack*>(arrTracks2.UncheckedAt(itrack2))), fPdgLeg2);
+      candidate->SetTracks(&(*static_cast<AliVTrack*>(arrTracks1->UncheckedAt(itrack1))), fPdgLeg1,
+                           &(*static_cast<AliVTrack*>(arrTracks2->UncheckedAt(itrack2))), fPdgLeg2);
       candidate->SetType(pairIndex);
 
-      Int_t label=AliDielectronMC::Instance()->GetLabelMotherWithPdg(candidate,fPdgMother);
-      candidate->SetLabel(label);
-      if (label>-1) candidate->SetPdgCode(fPdgMother);
-      else candidate->SetPdgCode(0);
-
-      // check for gamma kf particle
-      label=AliDielectronMC::Instance()->GetLabelMotherWithPdg(candidate,22);
-      if (label>-1 && fUseGammaTracks) {
-        candidate->SetGammaTracks(static_cast<AliVTrack*>(arrTracks1.UncheckedAt(itrack1)), fPdgLeg1,
-                                  static_cast<AliVTrack*>(arrTracks2.UncheckedAt(itrack2)), fPdgLeg2);
-      // should we set the pdgmothercode and the label
+      if (hasMC){
+        Int_t label=AliDielectronMC::Instance()->GetLabelMotherWithPdg(candidate,fPdgMother);
+        candidate->SetLabel(label);
+        if (label>-1) candidate->SetPdgCode(fPdgMother);
+        else candidate->SetPdgCode(0);
+
+        // check for gamma kf particle
+        label=AliDielectronMC::Instance()->GetLabelMotherWithPdg(candidate,22);
+        if (label>-1 && fUseGammaTracks) {
+          candidate->SetGammaTracks(static_cast<AliVTrack*>(arrTracks1->UncheckedAt(itrack1)), fPdgLeg1,
+                                    static_cast<AliVTrack*>(arrTracks2->UncheckedAt(itrack2)), fPdgLeg2);
+        // should we set the pdgmothercode and the label
+        }
       }
 
       //pair cuts
@@ -1435,15 +1490,46 @@ void AliDielectron::FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev)
       //histogram array for the pair
       if (fHistoArray) fHistoArray->Fill(pairIndex,candidate);
 
-      //add the candidate to the candidate array
+      //add the candidate to the candidate array and keep it in the pool
       PairArray(pairIndex)->Add(candidate);
+      ++fNPairPool;
       //get a new candidate
-      candidate=new AliDielectronPair;
-      candidate->SetKFUsage(fUseKF);
+      candidate=NewPoolPair();
     }
   }
-  //delete the surplus candidate
-  delete candidate;
+  //the surplus candidate is not counted in the pool and will be constructed again
+}
+
+//________________________________________________________________
+AliDielectronPair* AliDielectron::NewPoolPair()
+{
+  //
+  // construct a new pair candidate in the first free slot of the pair pool
+  // the candidate only stays in the pool if fNPairPool is incremented afterwards
+  //
+  AliDielectronPair *candidate=new(fPairPool[fNPairPool]) AliDielectronPair;
+  candidate->SetKFUsage(fUseKF);
+  return candidate;
+}
+
+//________________________________________________________________
+void AliDielectron::FillLegKinematics(const TObjArray &arrTracks, Int_t pdg, std::vector<Double_t> &kinematics) const
+{
+  //
+  // fill (px,py,pz,E) of the tracks, using the mass of the leg pdg code
+  //
+  TParticlePDG *particle=TDatabasePDG::Instance()->GetParticle(pdg);
+  const Double_t mass=particle ? particle->Mass() : 0.;
+  const Int_t ntracks=arrTracks.GetEntriesFast();
+  kinematics.resize(4*ntracks);
+  for (Int_t itrack=0; itrack<ntracks; ++itrack){
+    const AliVParticle *track=static_cast<const AliVParticle*>(arrTracks.UncheckedAt(itrack));
+    const Double_t p=track->P();
+    kinematics[4*itrack]  =track->Px();
+    kinematics[4*itrack+1]=track->Py();
+    kinematics[4*itrack+2]=track->Pz();
+    kinematics[4*itrack+3]=TMath::Sqrt(p*p+mass*mass);
+  }
 }
 
 //________________________________________________________________
@@ -1475,7 +1561,7 @@ void AliDielectron::FillPairArrayTR()
       if (fHistoArray) fHistoArray->Fill((Int_t)kEv1PMRot,&candidate);
 
       if(fHistos) FillHistogramsPair(&candidate);
-      if(fStoreRotatedPairs) PairArray(kEv1PMRot)->Add(new AliDielectronPair(candidate));
+      if(fStoreRotatedPairs) PairArray(kEv1PMRot)->Add(new(fPairPool[fNPairPool++]) AliDielectronPair(candidate));
     }
   }
 }
@@ -16,8 +16,11 @@
 //#####################################################
 
 
+#include <vector>
+
 #include <TNamed.h>
 #include <TObjArray.h>
+#include <TClonesArray.h>
 #include <THnBase.h>
 #include <TSpline.h>
 
@@ -85,6 +88,9 @@ public:
   void SetNoPairing(Bool_t noPairing=kTRUE) { fNoPairing=noPairing; }
   void SetProcessLS(Bool_t doLS=kTRUE) { fProcessLS=doLS; }
   void SetUseKF(Bool_t useKF=kTRUE) { fUseKF=useKF; }
+  void SetPairPreCut(Double_t massMin, Double_t massMax, Double_t ptMin=0., Double_t ptMax=1.e30)
+    { fUsePairPreCut=kTRUE; fPairPreCutMassMin=massMin; fPairPreCutMassMax=massMax; fPairPreCutPtMin=ptMin; fPairPreCutPtMax=ptMax; }
+  void SetUsePairPreCut(Bool_t use=kTRUE) { fUsePairPreCut=use; }
   const TObjArray* GetTrackArray(Int_t i) const {return (i>=0&&i<4)?&fTracks[i]:0;}
   const TObjArray* GetPairArray(Int_t i)  const {return (i>=0&&i<11)?
       static_cast<TObjArray*>(fPairCandidates->UncheckedAt(i)):0;}
@@ -258,12 +264,24 @@ private:
   Bool_t fDontClearArrays;      //Don't clear the arrays at the end of the Process function, needed for external use of pair and tracks
   Bool_t fEventProcess;         //Process event (or pair array)
   Bool_t fUseGammaTracks;       // use function SetGammaTracks for MCtruth photons
+  Bool_t fUsePairPreCut;        // reject pairs outside the mass/pt window before building the candidate
+  Double_t fPairPreCutMassMin;  // lower mass of the pair pre-cut
+  Double_t fPairPreCutMassMax;  // upper mass of the pair pre-cut
+  Double_t fPairPreCutPtMin;    // lower pt of the pair pre-cut
+  Double_t fPairPreCutPtMax;    // upper pt of the pair pre-cut
+
+  TClonesArray fPairPool;       //! pair candidates of the current event, the memory is reused for every event
+  Int_t fNPairPool;             //! number of candidates in use in fPairPool
+  TObjArray fPairTracks[2];     //! track arrays after the pair prefilter in FillPairArrays
+  std::vector<Double_t> fLegKinematics[2]; //! (px,py,pz,E) of the tracks paired in FillPairArrays, for the pair pre-cut
 
   void FillTrackArrays(AliVEvent * const ev, Int_t eventNr=0);
   void EventPlanePreFilter(Int_t arr1, Int_t arr2, TObjArray arrTracks1, TObjArray arrTracks2, const AliVEvent *ev);
   void PairPreFilter(Int_t arr1, Int_t arr2, TObjArray &arrTracks1, TObjArray &arrTracks2, const AliVEvent *ev, Int_t prefilterN);
   void FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev = 0x0);
   void FillPairArrayTR();
+  AliDielectronPair* NewPoolPair();
+  void FillLegKinematics(const TObjArray &arrTracks, Int_t pdg, std::vector<Double_t> &kinematics) const;
 
   Int_t GetPairIndex(Int_t arr1, Int_t arr2) const {return arr1>=arr2?arr1*(arr1+1)/2+arr2:arr2*(arr2+1)/2+arr1;}
 
@@ -297,7 +315,7 @@ private:
   AliDielectron(const AliDielectron &c);
   AliDielectron &operator=(const AliDielectron &c);
 
-  ClassDef(AliDielectron,17);
+  ClassDef(AliDielectron,18);
 };
 
 inline void AliDielectron::InitPairCandidateArrays()
@@ -305,6 +323,8 @@ inline void AliDielectron::InitPairCandidateArrays()
   //
   // initialise all pair candidate arrays
   //
+  // the arrays are owners, as for the readers of the persisted arrays,
+  // but the pairs filled here belong to fPairPool (see ClearArrays)
   fPairCandidates->SetOwner();
   for (Int_t i=0;i<11;++i){
     TObjArray *arr=new TObjArray;
@@ -329,9 +349,17 @@ inline void AliDielectron::ClearArrays()
   for (Int_t i=0;i<4;++i){
     fTracks[i].Clear();
   }
+  // the pairs are released with fPairPool, not by their owner arrays
   for (Int_t i=0;i<11;++i){
-    if (PairArray(i)) PairArray(i)->Delete();
+    TObjArray *arr=PairArray(i);
+    if (!arr) continue;
+    Bool_t owner=arr->IsOwner();
+    arr->SetOwner(kFALSE);
+    arr->Clear();
+    arr->SetOwner(owner);
   }
+  fPairPool.Clear();
+  fNPairPool=0;
 }
 
 #endif
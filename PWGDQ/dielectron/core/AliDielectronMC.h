@@ -40,6 +40,7 @@ public:
 
   void SetHasMC(Bool_t hasMC) { fHasMC=hasMC; }
   Bool_t HasMC() const { return fHasMC; }
+  Bool_t HasMCEvent() const { return (fAnaType==kESD && fMCEvent) || (fAnaType==kAOD && fMcArray); } // MC truth connected for the current event
   
   static AliDielectronMC* Instance();
   
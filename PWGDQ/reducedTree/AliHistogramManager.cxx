@@ -48,7 +48,8 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlans()
 {
   //
   // Constructor
@@ -70,7 +71,8 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlans()
 {
   //
   // Constructor
@@ -130,6 +132,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  GetHistClassHandle(histClass);
 }
 
 //_________________________________________________________________
@@ -599,31 +602,43 @@ THnF* AliHistogramManager::CreateHistogram( const Char_t* name, const Char_t* ti
 
 
 //__________________________________________________________________
-void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values) {
+Int_t AliHistogramManager::GetHistClassHandle(const Char_t* className) {
   //
-  //  fill a class of histograms
+  //  get the handle of a histogram class, to be used with FillHistClass(Int_t, Float_t*)
+  //  The handle is kept in the unique ID of the histogram list (handle+1).
   //
   THashList* hList = (THashList*)fMainList.FindObject(className);
-  if(!hList) {
-    /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
-    cout << "         Histogram list not filled" << endl; */
-    return;
-  }
-  if(!hList) {
-    return;
+  if(!hList) return -1;
+  
+  Int_t handle = Int_t(hList->GetUniqueID())-1;
+  if(handle<0 || handle>=(Int_t)fFillPlans.size() || fFillPlans[handle].fList!=hList) {
+    FillPlan plan;
+    plan.fList = hList;
+    plan.fNHistograms = -1;
+    fFillPlans.push_back(plan);
+    handle = fFillPlans.size()-1;
+    hList->SetUniqueID(UInt_t(handle+1));
   }
-    
-  TIter next(hList);
+  return handle;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::CompileFillPlan(FillPlan& plan) {
+  //
+  //  decode the type and the variables of all histograms of a class from their unique IDs
+  //
+  plan.fEntries.clear();
+  plan.fNHistograms = plan.fList->GetEntries();
+  
+  TIter next(plan.fList);
   TObject* h=0x0;
   Bool_t isProfile;
   Bool_t isTHn;
   Int_t thnDim=0;
-  Double_t fillValues[20]={0.0};
   Int_t uid = 0;
   Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
   Int_t dimension=0;
   while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
     uid = h->GetUniqueID();
     isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
     isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
@@ -632,9 +647,6 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
     if(!isTHn) dimension = ((TH1*)h)->GetDimension();
         
     uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
     varT = -1;
     varW = -1;
     if(uid>0) {
@@ -642,97 +654,118 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
       if(varW==0) varW=AliReducedVarManager::kNothing;
       uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
       if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
     }
-        
+    
+    FillPlanEntry entry;
+    entry.fHist = h;
+    entry.fKind = kFillNone;
+    entry.fNVars = 0;
+    entry.fVarW = (varW>AliReducedVarManager::kNothing ? varW : AliReducedVarManager::kNothing);
+    
     if(!isTHn) {
       varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
-        switch(dimension) {
-          case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
-          break;
-          case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
-          break;
-          case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
-          break;
-          default:
-          break;
-        }  // end switch
-      }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-        fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-      }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW])
-            ((THnF*)h)->Fill(fillValues,values[varW]);
-        }
-        else
-          ((THnF*)h)->Fill(fillValues);
+      varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
+      varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
+      switch(dimension) {
+        case 1:
+          entry.fKind = (isProfile ? kFillTProfile : kFillTH1);
+          entry.fVars[entry.fNVars++] = varX;
+          if(isProfile) entry.fVars[entry.fNVars++] = varY;
+        break;
+        case 2:
+          entry.fKind = (isProfile ? kFillTProfile2D : kFillTH2);
+          entry.fVars[entry.fNVars++] = varX;
+          entry.fVars[entry.fNVars++] = varY;
+          if(isProfile) entry.fVars[entry.fNVars++] = varZ;
+        break;
+        case 3:
+          entry.fKind = (isProfile ? kFillTProfile3D : kFillTH3);
+          entry.fVars[entry.fNVars++] = varX;
+          entry.fVars[entry.fNVars++] = varY;
+          entry.fVars[entry.fNVars++] = varZ;
+          if(isProfile) entry.fVars[entry.fNVars++] = varT;
+        break;
+        default:
+        break;
       }
     }
+    else if(thnDim<=kMaxFillVars) {
+      entry.fKind = kFillTHn;
+      for(Int_t idim=0;idim<thnDim;++idim)
+        entry.fVars[entry.fNVars++] = ((THnF*)h)->GetAxis(idim)->GetUniqueID();
+    }
+    plan.fEntries.push_back(entry);
+  }
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values) {
+  //
+  //  fill a class of histograms
+  //
+  Int_t handle = GetHistClassHandle(className);
+  if(handle<0) {
+    /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
+    cout << "         Histogram list not filled" << endl; */
+    return;
+  }
+  FillHistClass(handle, values);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t handle, Float_t* values) {
+  //
+  //  fill a class of histograms, using the fill plan of the class
+  //  A histogram is only filled if all its variables are used.
+  //
+  if(handle<0 || handle>=(Int_t)fFillPlans.size()) return;
+  FillPlan& plan = fFillPlans[handle];
+  if(plan.fNHistograms!=plan.fList->GetEntries()) CompileFillPlan(plan);
+  
+  Double_t fillValues[kMaxFillVars]={0.0};
+  for(std::vector<FillPlanEntry>::const_iterator it=plan.fEntries.begin(); it!=plan.fEntries.end(); ++it) {
+    const FillPlanEntry& entry = *it;
+    const Int_t* v = entry.fVars;
+    
+    Bool_t allVarsGood = kTRUE;
+    for(Int_t i=0;i<entry.fNVars;++i) allVarsGood &= fUsedVars[v[i]];
+    if(entry.fVarW>AliReducedVarManager::kNothing) allVarsGood &= fUsedVars[entry.fVarW];
+    if(!allVarsGood) continue;
+    
+    Bool_t weighted = (entry.fVarW>AliReducedVarManager::kNothing);
+    switch(entry.fKind) {
+      case kFillTH1:
+        if(weighted) ((TH1F*)entry.fHist)->Fill(values[v[0]],values[entry.fVarW]);
+        else ((TH1F*)entry.fHist)->Fill(values[v[0]]);
+      break;
+      case kFillTProfile:
+        if(weighted) ((TProfile*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[entry.fVarW]);
+        else ((TProfile*)entry.fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillTH2:
+        if(weighted) ((TH2F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[entry.fVarW]);
+        else ((TH2F*)entry.fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillTProfile2D:
+        if(weighted) ((TProfile2D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[entry.fVarW]);
+        else ((TProfile2D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillTH3:
+        if(weighted) ((TH3F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[entry.fVarW]);
+        else ((TH3F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillTProfile3D:
+        if(weighted) ((TProfile3D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]],values[entry.fVarW]);
+        else ((TProfile3D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]]);
+      break;
+      case kFillTHn:
+        for(Int_t idim=0;idim<entry.fNVars;++idim) fillValues[idim] = values[v[idim]];
+        if(weighted) ((THnF*)entry.fHist)->Fill(fillValues,values[entry.fVarW]);
+        else ((THnF*)entry.fHist)->Fill(fillValues);
+      break;
+      default:
+      break;
+    }
   }
 }
 
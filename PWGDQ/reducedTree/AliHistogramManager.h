@@ -14,6 +14,8 @@
 #include <TList.h>
 #include <THashList.h>
 
+#include <vector>
+
 #include "AliReducedVarManager.h"
 
 class TAxis;
@@ -64,7 +66,9 @@ class AliHistogramManager : public TObject {
                         Int_t nDimensions,
                         TAxis* axis);
   
+  Int_t GetHistClassHandle(const Char_t* className);     // handle for FillHistClass(Int_t, Float_t*), -1 if the class does not exist
   void FillHistClass(const Char_t* className, Float_t* values);
+  void FillHistClass(Int_t handle, Float_t* values);
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -101,6 +105,27 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Fill plan of a histogram class: for each histogram the type and the variables,
+  // decoded once from the unique IDs instead of on every FillHistClass() call
+  enum FillKind {
+    kFillNone=0, kFillTH1, kFillTProfile, kFillTH2, kFillTProfile2D, kFillTH3, kFillTProfile3D, kFillTHn
+  };
+  static const Int_t kMaxFillVars = 20;  // maximum number of variables of a histogram
+  struct FillPlanEntry {
+    TObject* fHist;                      // histogram
+    Int_t fKind;                         // histogram type (FillKind)
+    Int_t fNVars;                        // number of variables
+    Int_t fVars[kMaxFillVars];           // variables, in the order of the Fill() arguments
+    Int_t fVarW;                         // weight variable, kNothing if not weighted
+  };
+  struct FillPlan {
+    THashList* fList;                    // histogram class
+    Int_t fNHistograms;                  // number of histograms when the plan was compiled
+    std::vector<FillPlanEntry> fEntries; // one entry per histogram, in the order of the class
+  };
+  std::vector<FillPlan> fFillPlans;      //! fill plans, indexed by the histogram class handle
+  
+  void CompileFillPlan(FillPlan& plan);
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
   
   ClassDef(AliHistogramManager, 3)
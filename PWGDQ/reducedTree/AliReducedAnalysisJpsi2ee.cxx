@@ -379,24 +379,29 @@ void AliReducedAnalysisJpsi2ee::RunTrackSelection() {
    TClonesArray* trackList = fEvent->GetTracks();
    TIter nextTrack(trackList);
    Float_t nsigma = 0.;
+   // histogram class handles, to avoid the lookups by name for every track
+   Int_t trackHistos = fHistosManager->GetHistClassHandle("Track_BeforeCuts");
+   Int_t statusHistos = fHistosManager->GetHistClassHandle("TrackStatusFlags_BeforeCuts");
+   Int_t itsHistos = fHistosManager->GetHistClassHandle("TrackITSclusterMap_BeforeCuts");
+   Int_t tpcHistos = fHistosManager->GetHistClassHandle("TrackTPCclusterMap_BeforeCuts");
    for(Int_t it=0; it<fEvent->NTracks(); ++it) {
       track = (AliReducedTrackInfo*)nextTrack();
       if(fOptionRunOverMC && track->IsMCTruth()) continue;
       //cout << "track " << it << ": "; AliReducedVarManager::PrintBits(track->Status()); cout << endl;
       AliReducedVarManager::FillTrackInfo(track, fValues);
-      fHistosManager->FillHistClass("Track_BeforeCuts", fValues);
+      fHistosManager->FillHistClass(trackHistos, fValues);
       for(UInt_t iflag=0; iflag<AliReducedVarManager::kNTrackingStatus; ++iflag) {
          //cout << "track / tracking flags :: " << track << " / "; AliReducedVarManager::PrintBits(track->Status()); cout << endl;
          AliReducedVarManager::FillTrackingFlag(track, iflag, fValues);
-         fHistosManager->FillHistClass("TrackStatusFlags_BeforeCuts", fValues);
+         fHistosManager->FillHistClass(statusHistos, fValues);
       }
       for(Int_t iLayer=0; iLayer<6; ++iLayer) {
          AliReducedVarManager::FillITSlayerFlag(track, iLayer, fValues);
-         fHistosManager->FillHistClass("TrackITSclusterMap_BeforeCuts", fValues);
+         fHistosManager->FillHistClass(itsHistos, fValues);
       }
       for(Int_t iLayer=0; iLayer<8; ++iLayer) {
          AliReducedVarManager::FillTPCclusterBitFlag(track, iLayer, fValues);
-         fHistosManager->FillHistClass("TrackTPCclusterMap_BeforeCuts", fValues);
+         fHistosManager->FillHistClass(tpcHistos, fValues);
       }
       if(IsTrackSelected(track, fValues)) {
          fValues[AliReducedVarManager::kEvAverageTPCchi2] += track->TPCchi2();
@@ -131,6 +131,21 @@ TProfile2D* AliReducedVarManager::fgAvgVZEROChannelMult[64] = {0x0};
 TProfile2D* AliReducedVarManager::fgVZEROqVecRecentering[4] = {0x0};
 Bool_t AliReducedVarManager::fgOptionCalibrateVZEROqVec = kFALSE;
 Bool_t AliReducedVarManager::fgOptionRecenterVZEROqVec = kFALSE;
+Int_t AliReducedVarManager::fgNTrackHarmonics = 0;
+Int_t AliReducedVarManager::fgTrackHarmonics[6] = {0};
+Int_t AliReducedVarManager::fgNVZEROFlowTerms = 0;
+Int_t AliReducedVarManager::fgVZEROFlowTerms[18] = {0};
+Int_t AliReducedVarManager::fgNTPCFlowHarmonics = 0;
+Int_t AliReducedVarManager::fgTPCFlowHarmonics[6] = {0};
+Bool_t AliReducedVarManager::fgUseTrackingStatus = kFALSE;
+Bool_t AliReducedVarManager::fgUseTrackingFlags = kFALSE;
+Int_t AliReducedVarManager::fgNPhiHarmonics = 0;
+Int_t AliReducedVarManager::fgPhiHarmonics[6] = {0};
+Bool_t AliReducedVarManager::fgVZEROCacheValid[18] = {kFALSE};
+Float_t AliReducedVarManager::fgVZEROCacheInput[18][3] = {{0.0}};
+Double_t AliReducedVarManager::fgVZEROCosNRP[18] = {0.0};
+Double_t AliReducedVarManager::fgVZEROSinNRP[18] = {0.0};
+Double_t AliReducedVarManager::fgVZEROQvecNorm[12] = {0.0};
 
 //__________________________________________________________________
 AliReducedVarManager::AliReducedVarManager() :
@@ -282,6 +297,70 @@ void AliReducedVarManager::SetVariableDependencies() {
     fgUsedVars[kPt]               = kTRUE;
     fgUsedVars[kPairDcaXYSqrt]    = kTRUE;
   }
+  
+  BuildEvaluationLists();
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::BuildEvaluationLists() {
+  //
+  // Resolve the used track variables into the lists of terms evaluated in FillTrackInfo(),
+  //   such that the per track loops run only over the harmonics and VZERO sides actually needed.
+  // Called whenever the used variables change, i.e. once per configured cut, histogram or mixing variable.
+  //
+  fgNTrackHarmonics = 0;
+  fgNVZEROFlowTerms = 0;
+  fgNTPCFlowHarmonics = 0;
+  for(Int_t ih=0; ih<6; ++ih) {
+    if(fgUsedVars[kCosNPhi+ih] || fgUsedVars[kSinNPhi+ih])
+      fgTrackHarmonics[fgNTrackHarmonics++] = ih+1;
+    if(fgUsedVars[kTPCFlowVn+ih] || fgUsedVars[kTPCFlowSine+ih] || fgUsedVars[kTPCuQ+ih] || fgUsedVars[kTPCuQsine+ih])
+      fgTPCFlowHarmonics[fgNTPCFlowHarmonics++] = ih;
+  }
+  for(Int_t iterm=0; iterm<18; ++iterm) {
+    if(fgUsedVars[kVZEROFlowVn+iterm] || fgUsedVars[kVZEROFlowSine+iterm] ||
+       (iterm<12 && (fgUsedVars[kVZEROuQ+iterm] || fgUsedVars[kVZEROuQsine+iterm])))
+      fgVZEROFlowTerms[fgNVZEROFlowTerms++] = iterm;
+  }
+  
+  // harmonics for which cos(n phi) and sin(n phi) of the track are needed, by any of the lists above
+  fgNPhiHarmonics = 0;
+  for(Int_t ih=1; ih<=6; ++ih) {
+    Bool_t used = kFALSE;
+    for(Int_t i=0; i<fgNTrackHarmonics; ++i) if(fgTrackHarmonics[i]==ih) used = kTRUE;
+    for(Int_t i=0; i<fgNVZEROFlowTerms; ++i) if(fgVZEROFlowTerms[i]%6+1==ih) used = kTRUE;
+    for(Int_t i=0; i<fgNTPCFlowHarmonics; ++i) if(fgTPCFlowHarmonics[i]+1==ih) used = kTRUE;
+    if(used) fgPhiHarmonics[fgNPhiHarmonics++] = ih;
+  }
+  
+  fgUseTrackingStatus = kFALSE;
+  for(Int_t i=0; i<kNTrackingStatus; ++i)
+    if(fgUsedVars[kTrackingStatus+i]) {fgUseTrackingStatus = kTRUE; break;}
+  fgUseTrackingFlags = kFALSE;
+  for(Int_t i=0; i<kNTrackingFlags; ++i)
+    if(fgUsedVars[kTrackingFlags+i]) {fgUseTrackingFlags = kTRUE; break;}
+}
+
+//__________________________________________________________________
+void AliReducedVarManager::CacheVZEROTerm(Int_t iterm, const Float_t* values) {
+  //
+  // Cache cos(n Psi), sin(n Psi) and |Q| of a VZERO flow term, computed once per event instead of for every track.
+  // The entry keeps the event plane and q-vector it was computed from, and FillTrackInfo() recomputes it
+  //   whenever these differ in the values array it is called with. The cache is therefore valid for any
+  //   values array, also when the event plane or the q-vector are modified after FillEventInfo().
+  //
+  Int_t ih = iterm%6;
+  Double_t nPsi = values[kVZERORP+iterm]*(ih+1);
+  fgVZEROCosNRP[iterm] = TMath::Cos(nPsi);
+  fgVZEROSinNRP[iterm] = TMath::Sin(nPsi);
+  fgVZEROCacheInput[iterm][0] = values[kVZERORP+iterm];
+  if(iterm<12) {
+    fgVZEROCacheInput[iterm][1] = values[kVZEROQvecX+iterm];
+    fgVZEROCacheInput[iterm][2] = values[kVZEROQvecY+iterm];
+    fgVZEROQvecNorm[iterm] = TMath::Sqrt(values[kVZEROQvecX+iterm]*values[kVZEROQvecX+iterm] +
+                                         values[kVZEROQvecY+iterm]*values[kVZEROQvecY+iterm]);
+  }
+  fgVZEROCacheValid[iterm] = kTRUE;
 }
 
 //__________________________________________________________________
@@ -730,7 +809,6 @@ void AliReducedVarManager::FillEventInfo(BASEEVENT* baseEvent, Float_t* values,
   values[kMultEstimatorPercentileSPDTracklets] = event->MultEstimatorPercentileSPDTracklets();
   values[kMultEstimatorPercentileRefMult05]    = event->MultEstimatorPercentileRefMult05();
   values[kMultEstimatorPercentileRefMult08]    = event->MultEstimatorPercentileRefMult08();
-
 }
 
 //_________________________________________________________________
@@ -915,44 +993,39 @@ void AliReducedVarManager::FillTrackInfo(BASETRACK* p, Float_t* values) {
   if(fgUsedVars[kTheta])     values[kTheta]     = p->Theta();
   if(fgUsedVars[kPhi])       values[kPhi]       = p->Phi();
   if(fgUsedVars[kEta])       values[kEta]       = p->Eta();
-  for(Int_t ih=1; ih<=6; ++ih) {
-     if(fgUsedVars[kCosNPhi+ih-1]) values[kCosNPhi+ih-1] = TMath::Cos(p->Phi()*ih);
-     if(fgUsedVars[kSinNPhi+ih-1]) values[kSinNPhi+ih-1] = TMath::Sin(p->Phi()*ih);
+  // cos(n phi) and sin(n phi) of the track, computed once for all the variables below which need them
+  Double_t cosNPhi[7] = {0.0}, sinNPhi[7] = {0.0};
+  for(Int_t i=0; i<fgNPhiHarmonics; ++i) {
+     Int_t ih = fgPhiHarmonics[i];
+     cosNPhi[ih] = TMath::Cos(p->Phi()*ih);
+     sinNPhi[ih] = TMath::Sin(p->Phi()*ih);
+  }
+  for(Int_t i=0; i<fgNTrackHarmonics; ++i) {
+     Int_t ih = fgTrackHarmonics[i];
+     if(fgUsedVars[kCosNPhi+ih-1]) values[kCosNPhi+ih-1] = cosNPhi[ih];
+     if(fgUsedVars[kSinNPhi+ih-1]) values[kSinNPhi+ih-1] = sinNPhi[ih];
   }
   
-  // Fill VZERO flow variables
-  for(Int_t iVZEROside=0; iVZEROside<3; ++iVZEROside) {
-     for(Int_t ih=0; ih<6; ++ih) {
-        if(fgUsedVars[kVZEROFlowVn+iVZEROside*6+ih])
-           values[kVZEROFlowVn+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-        if(fgUsedVars[kVZEROFlowSine+iVZEROside*6+ih])
-           values[kVZEROFlowSine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-        if(iVZEROside<2) {
-           if(fgUsedVars[kVZEROuQ+iVZEROside*6+ih]) {
-              values[kVZEROuQ+iVZEROside*6+ih] = TMath::Cos((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-              values[kVZEROuQ+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
-              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
-           }
-           if(fgUsedVars[kVZEROuQsine+iVZEROside*6+ih]) {
-              values[kVZEROuQsine+iVZEROside*6+ih] = TMath::Sin((values[kPhi]-values[kVZERORP+iVZEROside*6+ih])*(ih+1));
-              values[kVZEROuQsine+iVZEROside*6+ih] *= TMath::Sqrt(values[kVZEROQvecX+iVZEROside*6+ih]*values[kVZEROQvecX+iVZEROside*6+ih] +
-              values[kVZEROQvecY+iVZEROside*6+ih]*values[kVZEROQvecY+iVZEROside*6+ih]); 
-           }	    
-        }
-     }  // end loop over harmonics
-  }  // end loop over VZERO sides
+  // Fill VZERO flow variables, only for the (VZERO side, harmonic) terms in use
+  // cos(n(phi-Psi)) and sin(n(phi-Psi)) are expanded with the cos(n Psi), sin(n Psi) and |Q| of the event cache
+  for(Int_t i=0; i<fgNVZEROFlowTerms; ++i) {
+     Int_t iterm = fgVZEROFlowTerms[i];
+     Int_t ih = iterm%6;
+     if(!fgVZEROCacheValid[iterm] || fgVZEROCacheInput[iterm][0]!=values[kVZERORP+iterm] ||
+        (iterm<12 && (fgVZEROCacheInput[iterm][1]!=values[kVZEROQvecX+iterm] ||
+                      fgVZEROCacheInput[iterm][2]!=values[kVZEROQvecY+iterm])))
+        CacheVZEROTerm(iterm, values);
+     Double_t cosDeltaPhi = cosNPhi[ih+1]*fgVZEROCosNRP[iterm] + sinNPhi[ih+1]*fgVZEROSinNRP[iterm];
+     Double_t sinDeltaPhi = sinNPhi[ih+1]*fgVZEROCosNRP[iterm] - cosNPhi[ih+1]*fgVZEROSinNRP[iterm];
+     if(fgUsedVars[kVZEROFlowVn+iterm])   values[kVZEROFlowVn+iterm]   = cosDeltaPhi;
+     if(fgUsedVars[kVZEROFlowSine+iterm]) values[kVZEROFlowSine+iterm] = sinDeltaPhi;
+     if(iterm<12 && fgUsedVars[kVZEROuQ+iterm])     values[kVZEROuQ+iterm]     = cosDeltaPhi*fgVZEROQvecNorm[iterm];
+     if(iterm<12 && fgUsedVars[kVZEROuQsine+iterm]) values[kVZEROuQsine+iterm] = sinDeltaPhi*fgVZEROQvecNorm[iterm];
+  }  // end loop over VZERO flow terms
   
   // Fill TPC flow variables
   // Subtract the q vector of the track or of the pair legs from the event q-vector 
-  Bool_t tpcEPUsed = kFALSE;
-  for(Int_t ih=0; ih<6; ++ih) {
-     if(fgUsedVars[kTPCFlowVn+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCFlowSine+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCuQ+ih]) {tpcEPUsed = kTRUE; break;}
-     if(fgUsedVars[kTPCuQsine+ih]) {tpcEPUsed = kTRUE; break;}
-  }
-  if(tpcEPUsed) {
-     Float_t tpcEPsubtracted[6] = {0.0};
+  if(fgNTPCFlowHarmonics>0) {
      Double_t qVec[6][2] = {{0.0}};
      for(Int_t ih=0; ih<6; ++ih) {qVec[ih][0]=values[kTPCQvecXtotal+ih]; qVec[ih][1]=values[kTPCQvecYtotal+ih];}
      EVENT* eventInfo = NULL;
@@ -970,24 +1043,20 @@ void AliReducedVarManager::FillTrackInfo(BASETRACK* p, Float_t* values) {
         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,-0.8,-0.5*fgkTPCQvecRapGap);
         eventInfo->SubtractParticleFromQvector((AliReducedTrackInfo*)eventInfo->GetTrack(((AliReducedPairInfo*)p)->LegId(1)),qVec,EVENTPLANE::kTPC,0.5*fgkTPCQvecRapGap,0.8);
      }  */
-     // recalculate the TPC event plane
-     for(Int_t ih=0; ih<6;++ih) 
-        tpcEPsubtracted[ih] = TMath::ATan2(qVec[ih][1], qVec[ih][0])/Double_t(ih+1);
      
-     for(Int_t ih=0; ih<6; ++ih) {
+     for(Int_t i=0; i<fgNTPCFlowHarmonics; ++i) {
+        Int_t ih = fgTPCFlowHarmonics[i];
+        // the subtracted TPC event plane enters only through cos(n Psi) = Qx/|Q| and sin(n Psi) = Qy/|Q|
+        Double_t qNorm = TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
+        Double_t cosNPsi = (qNorm>0. ? qVec[ih][0]/qNorm : 1.0);
+        Double_t sinNPsi = (qNorm>0. ? qVec[ih][1]/qNorm : 0.0);
+        Double_t cosDeltaPhi = cosNPhi[ih+1]*cosNPsi + sinNPhi[ih+1]*sinNPsi;
+        Double_t sinDeltaPhi = sinNPhi[ih+1]*cosNPsi - cosNPhi[ih+1]*sinNPsi;
         // vn using Psi_n
-        if(fgUsedVars[kTPCFlowVn+ih])
-           values[kTPCFlowVn+ih] = TMath::Cos(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
-        if(fgUsedVars[kTPCFlowSine+ih]) 
-           values[kTPCFlowSine+ih] = TMath::Sin(DeltaPhi(values[kPhi],tpcEPsubtracted[ih])*(ih+1));
-        if(fgUsedVars[kTPCuQ+ih]) {
-           values[kTPCuQ+ih] = TMath::Cos((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
-           values[kTPCuQ+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
-        }
-        if(fgUsedVars[kTPCuQsine+ih]) {
-           values[kTPCuQsine+ih] = TMath::Sin((values[kPhi]-tpcEPsubtracted[ih])*(ih+1));
-           values[kTPCuQsine+ih] *= TMath::Sqrt(qVec[ih][0]*qVec[ih][0] + qVec[ih][1]*qVec[ih][1]);
-        }
+        if(fgUsedVars[kTPCFlowVn+ih])   values[kTPCFlowVn+ih]   = cosDeltaPhi;
+        if(fgUsedVars[kTPCFlowSine+ih]) values[kTPCFlowSine+ih] = sinDeltaPhi;
+        if(fgUsedVars[kTPCuQ+ih])       values[kTPCuQ+ih]       = cosDeltaPhi*qNorm;
+        if(fgUsedVars[kTPCuQsine+ih])   values[kTPCuQsine+ih]   = sinDeltaPhi*qNorm;
      }
   }
   
@@ -1093,8 +1162,8 @@ void AliReducedVarManager::FillTrackInfo(BASETRACK* p, Float_t* values) {
     }
   }  
 
-  FillTrackingStatus(pinfo,values);
-  FillTrackingFlags(pinfo,values);
+  if(fgUseTrackingStatus) FillTrackingStatus(pinfo,values);
+  if(fgUseTrackingFlags) FillTrackingFlags(pinfo,values);
   
   if(pinfo->HasMCTruthInfo()) {
      if(fgUsedVars[kPtMC]) values[kPtMC] = pinfo->PtMC();
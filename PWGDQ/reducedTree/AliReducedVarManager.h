@@ -566,6 +566,24 @@ class AliReducedVarManager : public TObject {
   static Bool_t fgUsedVars[kNVars];              // array of flags toggled when the corresponding variable is required (e.g., in the histogram manager, in cuts, mixing handler, etc.) 
                                                  //   when a variable is used
   static void SetVariableDependencies();       // toggle those variables on which other used variables might depend 
+  static void BuildEvaluationLists();          // resolve the used track variables into the evaluation lists below
+  static void CacheVZEROTerm(Int_t iterm, const Float_t* values); // cache the event wise quantities of a VZERO flow term
+  
+  static Int_t fgNTrackHarmonics;               // number of harmonics with cos(n phi) or sin(n phi) in use
+  static Int_t fgTrackHarmonics[6];             // harmonics (1-6) with cos(n phi) or sin(n phi) in use
+  static Int_t fgNVZEROFlowTerms;               // number of VZERO flow terms in use
+  static Int_t fgVZEROFlowTerms[18];            // VZERO flow terms in use, iVZEROside*6+ih
+  static Int_t fgNTPCFlowHarmonics;             // number of harmonics with TPC flow variables in use
+  static Int_t fgTPCFlowHarmonics[6];           // harmonics (0-5) with TPC flow variables in use
+  static Bool_t fgUseTrackingStatus;            // at least one of the kTrackingStatus variables is used
+  static Bool_t fgUseTrackingFlags;             // at least one of the kTrackingFlags variables is used
+  static Int_t fgNPhiHarmonics;                 // number of harmonics with cos(n phi), sin(n phi) of the track needed
+  static Int_t fgPhiHarmonics[6];               // harmonics (1-6) with cos(n phi), sin(n phi) of the track needed
+  static Bool_t fgVZEROCacheValid[18];          // event cache: entry of the VZERO flow term filled
+  static Float_t fgVZEROCacheInput[18][3];      // event cache: Psi, Qx and Qy from which the entry was computed
+  static Double_t fgVZEROCosNRP[18];            // event cache: cos(n Psi) of the VZERO event planes, iVZEROside*6+ih
+  static Double_t fgVZEROSinNRP[18];            // event cache: sin(n Psi) of the VZERO event planes, iVZEROside*6+ih
+  static Double_t fgVZEROQvecNorm[12];          // event cache: |Q| of the VZERO-A and C q-vectors, iVZEROside*6+ih
   
 
   static Double_t DeltaPhi(Double_t phi1, Double_t phi2);  
@@ -240,10 +240,22 @@ Bool_t AliAODConversionMother::IsTrueMeson(AliStack *fMCStack,Int_t pdgcode){
 
 Float_t AliAODConversionMother::CalculateDistanceBetweenPhotons(AliAODConversionPhoton* y1, AliAODConversionPhoton* y2 , Double_t prodPoint[3]){
 
-   TVector3 a(y1->GetConversionX(),y1->GetConversionY(),y1->GetConversionZ());
-   TVector3 b(y1->GetPx(),y1->GetPy(),y1->GetPz());
-   TVector3 c(y2->GetConversionX(),y2->GetConversionY(),y2->GetConversionZ());
-   TVector3 d(y2->GetPx(),y2->GetPy(),y2->GetPz());
+   Double_t conv1[3] = {y1->GetConversionX(),y1->GetConversionY(),y1->GetConversionZ()};
+   Double_t p1[3] = {y1->GetPx(),y1->GetPy(),y1->GetPz()};
+   Double_t conv2[3] = {y2->GetConversionX(),y2->GetConversionY(),y2->GetConversionZ()};
+   Double_t p2[3] = {y2->GetPx(),y2->GetPy(),y2->GetPz()};
+   return CalculateDistanceBetweenPhotons(conv1,p1,conv2,p2,prodPoint);
+}
+
+///________________________________________________________________________
+Float_t AliAODConversionMother::CalculateDistanceBetweenPhotons(const Double_t conv1[3], const Double_t p1[3], const Double_t conv2[3], const Double_t p2[3], Double_t prodPoint[3]){
+
+   // distance between the two photon lines given by their conversion points and momenta,
+   // prodPoint is set to the production vertex of the mother
+   TVector3 a(conv1[0],conv1[1],conv1[2]);
+   TVector3 b(p1[0],p1[1],p1[2]);
+   TVector3 c(conv2[0],conv2[1],conv2[2]);
+   TVector3 d(p2[0],p2[1],p2[2]);
    
    TVector3 n = b.Cross(d);
    TVector3 nn = n.Unit();
@@ -278,24 +290,34 @@ Float_t AliAODConversionMother::CalculateDistanceBetweenPhotons(AliAODConversion
 void AliAODConversionMother::CalculateDistanceOfClossetApproachToPrimVtx(const AliVVertex* primVertex){
 
    Double_t primCo[3] = {primVertex->GetX(),primVertex->GetY(),primVertex->GetZ()};
+   Double_t mom[3] = {Px(),Py(),Pz()};
+   CalculateDistanceOfClossetApproachToPrimVtx(mom,fProductionVtx,primCo,fdcaRPrimVtx,fdcaZPrimVtx);
+   
+   return;
+}
+
+///________________________________________________________________________
+void AliAODConversionMother::CalculateDistanceOfClossetApproachToPrimVtx(const Double_t mom[3], const Double_t prodVtx[3], const Double_t primCo[3],
+                                                                          Float_t &dcaRPrimVtx, Float_t &dcaZPrimVtx){
 
-   Double_t absoluteP = TMath::Sqrt(TMath::Power(Px(),2) + TMath::Power(Py(),2) + TMath::Power(Pz(),2));   
-   Double_t p[3] = {Px()/absoluteP,Py()/absoluteP,Pz()/absoluteP};
+   // dca in r and z to the primary vertex of a mother with momentum mom produced at prodVtx
+   Double_t absoluteP = TMath::Sqrt(TMath::Power(mom[0],2) + TMath::Power(mom[1],2) + TMath::Power(mom[2],2));   
+   Double_t p[3] = {mom[0]/absoluteP,mom[1]/absoluteP,mom[2]/absoluteP};
    Double_t CP[3];
    
-   CP[0] =  fProductionVtx[0] - primCo[0];
-   CP[1] =  fProductionVtx[1] - primCo[1];
-   CP[2] =  fProductionVtx[2] - primCo[2];
+   CP[0] =  prodVtx[0] - primCo[0];
+   CP[1] =  prodVtx[1] - primCo[1];
+   CP[2] =  prodVtx[2] - primCo[2];
    
    Double_t Lambda = - (CP[0]*p[0]+CP[1]*p[1]+CP[2]*p[2])/(p[0]*p[0]+p[1]*p[1]+p[2]*p[2]);
    
    Double_t S[3];
-   S[0] = fProductionVtx[0] + p[0]*Lambda;
-   S[1] = fProductionVtx[1] + p[1]*Lambda;
-   S[2] = fProductionVtx[2] + p[2]*Lambda;
+   S[0] = prodVtx[0] + p[0]*Lambda;
+   S[1] = prodVtx[1] + p[1]*Lambda;
+   S[2] = prodVtx[2] + p[2]*Lambda;
    
-   fdcaRPrimVtx = TMath::Sqrt( TMath::Power(primCo[0]-S[0],2) + TMath::Power(primCo[1]-S[1],2));
-   fdcaZPrimVtx = primCo[2]-S[2];
+   dcaRPrimVtx = TMath::Sqrt( TMath::Power(primCo[0]-S[0],2) + TMath::Power(primCo[1]-S[1],2));
+   dcaZPrimVtx = primCo[2]-S[2];
    
    
 //    cout << "DCA z: " << dca[1] << "\t DCA r: " << dca[0] << "\t DCA 3d: " << TMath::Sqrt(dca[1]*dca[1] + dca[0]*dca[0]) << endl;
@@ -92,7 +92,9 @@ class AliAODConversionMother : public AliAODConversionParticle{
 		Double_t GetWeight() const {return fWeight;}
 
 		Float_t CalculateDistanceBetweenPhotons(AliAODConversionPhoton* y1, AliAODConversionPhoton* y2 , Double_t prodPoint[3]);
+		static Float_t CalculateDistanceBetweenPhotons(const Double_t conv1[3], const Double_t p1[3], const Double_t conv2[3], const Double_t p2[3], Double_t prodPoint[3]);
 		void CalculateDistanceOfClossetApproachToPrimVtx(const AliVVertex* primVertex);
+		static void CalculateDistanceOfClossetApproachToPrimVtx(const Double_t mom[3], const Double_t prodVtx[3], const Double_t primCo[3], Float_t &dcaRPrimVtx, Float_t &dcaZPrimVtx);
 		void DetermineMesonQuality(AliAODConversionPhoton* y1, AliAODConversionPhoton* y2);
 		
 		void SetTrueMesonValue(Int_t trueMeson) {fTrueMeson = trueMeson;}
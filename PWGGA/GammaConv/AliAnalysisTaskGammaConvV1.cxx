@@ -240,6 +240,18 @@ AliAnalysisTaskGammaConvV1::AliAnalysisTaskGammaConvV1(): AliAnalysisTaskSE(),
   fEventPlaneAngle(-100),
   fRandom(0),
   fnGammaCandidates(0),
+  fReaderPairs(),
+  fReaderPairsFilled(),
+  fNReaderPairGammas(0),
+  fNMaskWords(0),
+  fReaderPhotonMask(),
+  fReaderPairMask(),
+  fReaderPhotonsOfCut(),
+  fUsePairMaskOfCut(),
+  fWeightJetJetMCOfCut(),
+  fCurrentPackedGammas(),
+  fPreviousPackedGammas(),
+  fMixedPairKinematics(),
   fUnsmearedPx(NULL),
   fUnsmearedPy(NULL),
   fUnsmearedPz(NULL),
@@ -448,6 +460,18 @@ AliAnalysisTaskGammaConvV1::AliAnalysisTaskGammaConvV1(const char *name):
   fEventPlaneAngle(-100),
   fRandom(0),
   fnGammaCandidates(0),
+  fReaderPairs(),
+  fReaderPairsFilled(),
+  fNReaderPairGammas(0),
+  fNMaskWords(0),
+  fReaderPhotonMask(),
+  fReaderPairMask(),
+  fReaderPhotonsOfCut(),
+  fUsePairMaskOfCut(),
+  fWeightJetJetMCOfCut(),
+  fCurrentPackedGammas(),
+  fPreviousPackedGammas(),
+  fMixedPairKinematics(),
   fUnsmearedPx(NULL),
   fUnsmearedPy(NULL),
   fUnsmearedPz(NULL),
@@ -495,7 +519,7 @@ AliAnalysisTaskGammaConvV1::~AliAnalysisTaskGammaConvV1()
     delete[] fWeightCentrality; 
     fWeightCentrality = 0x0; 
   }
-    
+  ClearReaderPairs();
 }
 //___________________________________________________________
 void AliAnalysisTaskGammaConvV1::InitBack(){
@@ -571,6 +595,7 @@ void AliAnalysisTaskGammaConvV1::InitBack(){
                                   ((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->GetNumberOfBGEvents(),
                                   ((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->UseTrackMultiplicity(),
                                   0,8,5);
+        fBGHandler[iCut]->SetUsePackedPool(kTRUE); // event mixing runs on the packed photons, see FillMixedEventPairs
         fBGHandlerRP[iCut] = NULL;
       } else {
         fBGHandlerRP[iCut] = new AliConversionAODBGHandlerRP(
@@ -1627,6 +1652,13 @@ void AliAnalysisTaskGammaConvV1::UserExec(Option_t *)
   }
 
   fReaderGammas = fV0Reader->GetReconstructedGammas(); // Gammas from default Cut
+  ClearReaderPairs();
+  fNReaderPairGammas = fReaderGammas->GetEntriesFast();
+  fNMaskWords = (fnCuts+63)/64;
+  fReaderPhotonMask.assign(fNReaderPairGammas*fNMaskWords,0);
+  fReaderPhotonsOfCut.resize(fnCuts);
+  fUsePairMaskOfCut.assign(fnCuts,kFALSE);
+  fWeightJetJetMCOfCut.assign(fnCuts,1.);
   
   // ------------------- BeginEvent ----------------------------
 
@@ -1762,49 +1794,13 @@ void AliAnalysisTaskGammaConvV1::UserExec(Option_t *)
     }
     
     if(fDoMesonAnalysis){ // Meson Analysis
-      if(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->UseMCPSmearing() && fIsMC > 0 ){
-        fUnsmearedPx = new Double_t[fGammaCandidates->GetEntries()]; // Store unsmeared Momenta
-        fUnsmearedPy = new Double_t[fGammaCandidates->GetEntries()];
-        fUnsmearedPz = new Double_t[fGammaCandidates->GetEntries()];
-        fUnsmearedE =  new Double_t[fGammaCandidates->GetEntries()];
-
-        for(Int_t gamma=0;gamma<fGammaCandidates->GetEntries();gamma++){ // Smear the AODPhotons in MC
-          fUnsmearedPx[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Px();
-          fUnsmearedPy[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Py();
-          fUnsmearedPz[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Pz();
-          fUnsmearedE[gamma] =  ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->E();
-          ((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->SmearParticle(dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(gamma)));
-        }
-      }
-
-      CalculatePi0Candidates(); // Combine Gammas
-      if(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->DoBGCalculation()){
-        if(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->BackgroundHandlerType() == 0){
-          CalculateBackground(); // Combinatorial Background
-          UpdateEventByEventData(); // Store Event for mixed Events
-        } else {
-          CalculateBackgroundRP(); // Combinatorial Background
-          fBGHandlerRP[iCut]->AddEvent(fGammaCandidates,fInputEvent); // Store Event for mixed Events
-        }
-      }
-      if(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->UseMCPSmearing() && fIsMC > 0 ){
-        for(Int_t gamma=0;gamma<fGammaCandidates->GetEntries();gamma++){ // Smear the AODPhotons in MC
-          ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPx(fUnsmearedPx[gamma]); // Reset Unsmeared Momenta
-          ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPy(fUnsmearedPy[gamma]);
-          ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPz(fUnsmearedPz[gamma]);
-          ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetE(fUnsmearedE[gamma]);
-        }
-        delete[] fUnsmearedPx; fUnsmearedPx = 0x0;
-        delete[] fUnsmearedPy; fUnsmearedPy = 0x0;
-        delete[] fUnsmearedPz; fUnsmearedPz = 0x0;
-        delete[] fUnsmearedE;  fUnsmearedE  = 0x0;
-      }
-
-      if( fIsMC > 0 ){
-        vecDoubleCountTruePi0s.clear();
-        vecDoubleCountTrueEtas.clear();
-        FillMultipleCountHistoAndClear(mapMultipleCountTruePi0s,fHistoMultipleCountTruePi0[iCut]);
-        FillMultipleCountHistoAndClear(mapMultipleCountTrueEtas,fHistoMultipleCountTrueEta[iCut]);
+      // unless the momenta are smeared for this cut set, the meson candidates of all cut sets are selected
+      // together from the pairs of V0 reader photons, after the loop over the cut sets
+      if(!(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->UseMCPSmearing() && fIsMC > 0) && SetReaderPhotonMask()){
+        fUsePairMaskOfCut[iCut] = kTRUE;
+        fWeightJetJetMCOfCut[iCut] = fWeightJetJetMC;
+      } else {
+        ProcessMesonCandidates();
       }
     }
 
@@ -1816,14 +1812,79 @@ void AliAnalysisTaskGammaConvV1::UserExec(Option_t *)
     fGammaCandidates->Clear(); // delete this cuts good gammas
   }
 
+  if(fDoMesonAnalysis){
+    // The pairs of V0 reader photons are built and selected once for all cut sets which use them,
+    // then each of these cut sets fills its histograms from its bit in the pair masks
+    FillReaderPairMasks();
+    for(Int_t iCut = 0; iCut<fnCuts; iCut++){
+      if(!fUsePairMaskOfCut[iCut]) continue;
+      fiCut = iCut;
+      fWeightJetJetMC = fWeightJetJetMCOfCut[iCut];
+      for(UInt_t k = 0; k < fReaderPhotonsOfCut[iCut].size(); k++) fGammaCandidates->Add(fReaderGammas->At(fReaderPhotonsOfCut[iCut][k]));
+      ProcessMesonCandidates();
+      fGammaCandidates->Clear();
+    }
+  }
+
   if( fIsMC > 0 && fInputEvent->IsA()==AliAODEvent::Class() && !(fV0Reader->AreAODsRelabeled())){
     RelabelAODPhotonCandidates(kFALSE); // Back to ESDMC Label
     fV0Reader->RelabelAODs(kFALSE);
   }
+  ClearReaderPairs();
   
   PostData(1, fOutputContainer);
 }
 //________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::ProcessMesonCandidates()
+{
+  // Meson analysis of the cut set fiCut from its photon candidates fGammaCandidates
+  if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseMCPSmearing() && fIsMC > 0 ){
+    fUnsmearedPx = new Double_t[fGammaCandidates->GetEntries()]; // Store unsmeared Momenta
+    fUnsmearedPy = new Double_t[fGammaCandidates->GetEntries()];
+    fUnsmearedPz = new Double_t[fGammaCandidates->GetEntries()];
+    fUnsmearedE =  new Double_t[fGammaCandidates->GetEntries()];
+
+    for(Int_t gamma=0;gamma<fGammaCandidates->GetEntries();gamma++){ // Smear the AODPhotons in MC
+      fUnsmearedPx[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Px();
+      fUnsmearedPy[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Py();
+      fUnsmearedPz[gamma] = ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->Pz();
+      fUnsmearedE[gamma] =  ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->E();
+      ((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->SmearParticle(dynamic_cast<AliAODConversionPhoton*>(fGammaCandidates->At(gamma)));
+    }
+  }
+
+  if(fUsePairMaskOfCut[fiCut]) CalculatePi0CandidatesFromPairMask(); // Combine Gammas
+  else CalculatePi0Candidates(); // Combine Gammas
+  if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->DoBGCalculation()){
+    if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->BackgroundHandlerType() == 0){
+      CalculateBackground(); // Combinatorial Background
+      UpdateEventByEventData(); // Store Event for mixed Events
+    } else {
+      CalculateBackgroundRP(); // Combinatorial Background
+      fBGHandlerRP[fiCut]->AddEvent(fGammaCandidates,fInputEvent); // Store Event for mixed Events
+    }
+  }
+  if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseMCPSmearing() && fIsMC > 0 ){
+    for(Int_t gamma=0;gamma<fGammaCandidates->GetEntries();gamma++){ // Smear the AODPhotons in MC
+      ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPx(fUnsmearedPx[gamma]); // Reset Unsmeared Momenta
+      ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPy(fUnsmearedPy[gamma]);
+      ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetPz(fUnsmearedPz[gamma]);
+      ((AliAODConversionPhoton*)fGammaCandidates->At(gamma))->SetE(fUnsmearedE[gamma]);
+    }
+    delete[] fUnsmearedPx; fUnsmearedPx = 0x0;
+    delete[] fUnsmearedPy; fUnsmearedPy = 0x0;
+    delete[] fUnsmearedPz; fUnsmearedPz = 0x0;
+    delete[] fUnsmearedE;  fUnsmearedE  = 0x0;
+  }
+
+  if( fIsMC > 0 ){
+    vecDoubleCountTruePi0s.clear();
+    vecDoubleCountTrueEtas.clear();
+    FillMultipleCountHistoAndClear(mapMultipleCountTruePi0s,fHistoMultipleCountTruePi0[fiCut]);
+    FillMultipleCountHistoAndClear(mapMultipleCountTrueEtas,fHistoMultipleCountTrueEta[fiCut]);
+  }
+}
+//________________________________________________________________________
 void AliAnalysisTaskGammaConvV1::ProcessPhotonCandidates()
 {
   Int_t nV0 = 0;
@@ -2863,108 +2924,217 @@ void AliAnalysisTaskGammaConvV1::CalculatePi0Candidates(){
         pi0cand->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
         
         if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->MesonIsSelected(pi0cand,kTRUE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
-          if(fDoCentralityFlat > 0){
-            fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(), fWeightCentrality[fiCut]*fWeightJetJetMC);
-            if(TMath::Abs(pi0cand->GetAlpha())<0.1) fHistoMotherInvMassEalpha[fiCut]->Fill(pi0cand->M(),pi0cand->E(), fWeightCentrality[fiCut]*fWeightJetJetMC);
-          } else {
-            fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(),fWeightJetJetMC);
-            if(TMath::Abs(pi0cand->GetAlpha())<0.1) fHistoMotherInvMassEalpha[fiCut]->Fill(pi0cand->M(),pi0cand->E(),fWeightJetJetMC);
-          }
-          
-          if (fDoMesonQA > 0){
+          FillPi0Candidate(pi0cand,gamma0,gamma1);
+        }
+        delete pi0cand;
+        pi0cand=0x0;
+      }
+    }
+  }
+}
 
-            if(fDoMesonQA == 3 && TMath::Abs(gamma0->GetConversionRadius()-gamma1->GetConversionRadius())<10 && pi0cand->GetOpeningAngle()<0.1){
-                    Double_t sparesFill[4] = {gamma0->GetPhotonPt(),gamma0->GetConversionRadius(),TMath::Abs(gamma0->GetConversionRadius()-gamma1->GetConversionRadius()),pi0cand->GetOpeningAngle()};
-                    sPtRDeltaROpenAngle[fiCut]->Fill(sparesFill, 1);
-            }
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::CalculatePi0CandidatesFromPairMask(){
+  // Meson candidates of the cut set fiCut from the shared pairs of V0 reader photons,
+  // which were selected for it in FillReaderPairMasks
+  vector<Int_t> candidateIndex(fNReaderPairGammas,-1);
+  for(UInt_t k = 0; k < fReaderPhotonsOfCut[fiCut].size(); k++) candidateIndex[fReaderPhotonsOfCut[fiCut][k]] = k;
+
+  ULong64_t bit = 1ULL << (fiCut%64);
+  Int_t word = fiCut/64;
+  for(UInt_t k = 0; k < fReaderPairsFilled.size(); k++){
+    Int_t pairIndex = fReaderPairsFilled[k];
+    if(!(fReaderPairMask[pairIndex*fNMaskWords+word] & bit)) continue;
+    Int_t firstGammaIndex = candidateIndex[pairIndex/fNReaderPairGammas];
+    Int_t secondGammaIndex = candidateIndex[pairIndex%fNReaderPairGammas];
+    AliAODConversionMother *pi0cand = fReaderPairs[pairIndex];
+    pi0cand->SetLabels(firstGammaIndex,secondGammaIndex);
+    FillPi0Candidate(pi0cand,(AliAODConversionPhoton*)fGammaCandidates->At(firstGammaIndex),(AliAODConversionPhoton*)fGammaCandidates->At(secondGammaIndex));
+  }
+}
 
-            if ( pi0cand->M() > 0.05 && pi0cand->M() < 0.17){
-              if (fIsMC < 2){
-                fHistoMotherPi0PtY[fiCut]->Fill(pi0cand->Pt(),pi0cand->Rapidity()-((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift());
-                fHistoMotherPi0PtOpenAngle[fiCut]->Fill(pi0cand->Pt(),pi0cand->GetOpeningAngle());
-              }
-              fHistoMotherPi0PtAlpha[fiCut]->Fill(pi0cand->Pt(),TMath::Abs(pi0cand->GetAlpha()),fWeightJetJetMC);
-              
-            } 
-            if ( pi0cand->M() > 0.45 && pi0cand->M() < 0.65){
-              if (fIsMC < 2){
-                fHistoMotherEtaPtY[fiCut]->Fill(pi0cand->Pt(),pi0cand->Rapidity()-((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift());
-                fHistoMotherEtaPtOpenAngle[fiCut]->Fill(pi0cand->Pt(),pi0cand->GetOpeningAngle());
-              } 
-              fHistoMotherEtaPtAlpha[fiCut]->Fill(pi0cand->Pt(),TMath::Abs(pi0cand->GetAlpha()),fWeightJetJetMC);
-            }
-          }   
-          if(fDoTHnSparse && ((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->DoBGCalculation()){
-            Int_t psibin = 0;
-            Int_t zbin = 0;
-            Int_t mbin = 0;
-
-            Double_t sparesFill[4];
-            if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->BackgroundHandlerType() == 0){
-              zbin = fBGHandler[fiCut]->GetZBinIndex(fInputEvent->GetPrimaryVertex()->GetZ());
-              if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
-                mbin = fBGHandler[fiCut]->GetMultiplicityBinIndex(fV0Reader->GetNumberOfPrimaryTracks());
-              } else {
-                mbin = fBGHandler[fiCut]->GetMultiplicityBinIndex(fGammaCandidates->GetEntries());
-              }
-              sparesFill[0] = pi0cand->M();
-              sparesFill[1] = pi0cand->Pt();
-              sparesFill[2] = (Double_t)zbin; 
-              sparesFill[3] = (Double_t)mbin;
-            } else {
-              psibin = fBGHandlerRP[fiCut]->GetRPBinIndex(TMath::Abs(fEventPlaneAngle));
-              zbin = fBGHandlerRP[fiCut]->GetZBinIndex(fInputEvent->GetPrimaryVertex()->GetZ());
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::FillPi0Candidate(AliAODConversionMother *pi0cand, AliAODConversionPhoton *gamma0, AliAODConversionPhoton *gamma1){
+  // Fill the histograms of the cut set fiCut for the selected meson candidate pi0cand
+  if(fDoCentralityFlat > 0){
+    fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(), fWeightCentrality[fiCut]*fWeightJetJetMC);
+    if(TMath::Abs(pi0cand->GetAlpha())<0.1) fHistoMotherInvMassEalpha[fiCut]->Fill(pi0cand->M(),pi0cand->E(), fWeightCentrality[fiCut]*fWeightJetJetMC);
+  } else {
+    fHistoMotherInvMassPt[fiCut]->Fill(pi0cand->M(),pi0cand->Pt(),fWeightJetJetMC);
+    if(TMath::Abs(pi0cand->GetAlpha())<0.1) fHistoMotherInvMassEalpha[fiCut]->Fill(pi0cand->M(),pi0cand->E(),fWeightJetJetMC);
+  }
+  
+  if (fDoMesonQA > 0){
+
+    if(fDoMesonQA == 3 && TMath::Abs(gamma0->GetConversionRadius()-gamma1->GetConversionRadius())<10 && pi0cand->GetOpeningAngle()<0.1){
+            Double_t sparesFill[4] = {gamma0->GetPhotonPt(),gamma0->GetConversionRadius(),TMath::Abs(gamma0->GetConversionRadius()-gamma1->GetConversionRadius()),pi0cand->GetOpeningAngle()};
+            sPtRDeltaROpenAngle[fiCut]->Fill(sparesFill, 1);
+    }
+
+    if ( pi0cand->M() > 0.05 && pi0cand->M() < 0.17){
+      if (fIsMC < 2){
+        fHistoMotherPi0PtY[fiCut]->Fill(pi0cand->Pt(),pi0cand->Rapidity()-((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift());
+        fHistoMotherPi0PtOpenAngle[fiCut]->Fill(pi0cand->Pt(),pi0cand->GetOpeningAngle());
+      }
+      fHistoMotherPi0PtAlpha[fiCut]->Fill(pi0cand->Pt(),TMath::Abs(pi0cand->GetAlpha()),fWeightJetJetMC);
+      
+    } 
+    if ( pi0cand->M() > 0.45 && pi0cand->M() < 0.65){
+      if (fIsMC < 2){
+        fHistoMotherEtaPtY[fiCut]->Fill(pi0cand->Pt(),pi0cand->Rapidity()-((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift());
+        fHistoMotherEtaPtOpenAngle[fiCut]->Fill(pi0cand->Pt(),pi0cand->GetOpeningAngle());
+      } 
+      fHistoMotherEtaPtAlpha[fiCut]->Fill(pi0cand->Pt(),TMath::Abs(pi0cand->GetAlpha()),fWeightJetJetMC);
+    }
+  }   
+  if(fDoTHnSparse && ((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->DoBGCalculation()){
+    Int_t psibin = 0;
+    Int_t zbin = 0;
+    Int_t mbin = 0;
+
+    Double_t sparesFill[4];
+    if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->BackgroundHandlerType() == 0){
+      zbin = fBGHandler[fiCut]->GetZBinIndex(fInputEvent->GetPrimaryVertex()->GetZ());
+      if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
+        mbin = fBGHandler[fiCut]->GetMultiplicityBinIndex(fV0Reader->GetNumberOfPrimaryTracks());
+      } else {
+        mbin = fBGHandler[fiCut]->GetMultiplicityBinIndex(fGammaCandidates->GetEntries());
+      }
+      sparesFill[0] = pi0cand->M();
+      sparesFill[1] = pi0cand->Pt();
+      sparesFill[2] = (Double_t)zbin; 
+      sparesFill[3] = (Double_t)mbin;
+    } else {
+      psibin = fBGHandlerRP[fiCut]->GetRPBinIndex(TMath::Abs(fEventPlaneAngle));
+      zbin = fBGHandlerRP[fiCut]->GetZBinIndex(fInputEvent->GetPrimaryVertex()->GetZ());
 //               if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
 //                 mbin = fBGHandlerRP[fiCut]->GetMultiplicityBinIndex(fV0Reader->GetNumberOfPrimaryTracks());
 //               } else {
 //                 mbin = fBGHandlerRP[fiCut]->GetMultiplicityBinIndex(fGammaCandidates->GetEntries());
 //               }
-              sparesFill[0] = pi0cand->M();
-              sparesFill[1] = pi0cand->Pt();
-              sparesFill[2] = (Double_t)zbin; 
-              sparesFill[3] = (Double_t)psibin;              
-            }
+      sparesFill[0] = pi0cand->M();
+      sparesFill[1] = pi0cand->Pt();
+      sparesFill[2] = (Double_t)zbin; 
+      sparesFill[3] = (Double_t)psibin;              
+    }
 //             Double_t sparesFill[4] = {pi0cand->M(),pi0cand->Pt(),(Double_t)zbin,(Double_t)mbin};
-            if(fDoCentralityFlat > 0) sESDMotherInvMassPtZM[fiCut]->Fill(sparesFill, fWeightCentrality[fiCut]*fWeightJetJetMC); //instead of weight 1
-            else  sESDMotherInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
-          }
-          
+    if(fDoCentralityFlat > 0) sESDMotherInvMassPtZM[fiCut]->Fill(sparesFill, fWeightCentrality[fiCut]*fWeightJetJetMC); //instead of weight 1
+    else  sESDMotherInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
+  }
+  
 
-          if( fIsMC > 0 ){
-            if(fInputEvent->IsA()==AliESDEvent::Class())
-              ProcessTrueMesonCandidates(pi0cand,gamma0,gamma1);
-            if(fInputEvent->IsA()==AliAODEvent::Class())
-              ProcessTrueMesonCandidatesAOD(pi0cand,gamma0,gamma1);
-          }
-          if (fDoMesonQA == 2){
-            fInvMass = pi0cand->M();
-            fPt  = pi0cand->Pt();
-            if (TMath::Abs(gamma0->GetDCAzToPrimVtx()) < TMath::Abs(gamma1->GetDCAzToPrimVtx())){
-              fDCAzGammaMin = gamma0->GetDCAzToPrimVtx();
-              fDCAzGammaMax = gamma1->GetDCAzToPrimVtx();
-            } else {
-              fDCAzGammaMin = gamma1->GetDCAzToPrimVtx();
-              fDCAzGammaMax = gamma0->GetDCAzToPrimVtx();
-            }
-            iFlag = pi0cand->GetMesonQuality();
+  if( fIsMC > 0 ){
+    if(fInputEvent->IsA()==AliESDEvent::Class())
+      ProcessTrueMesonCandidates(pi0cand,gamma0,gamma1);
+    if(fInputEvent->IsA()==AliAODEvent::Class())
+      ProcessTrueMesonCandidatesAOD(pi0cand,gamma0,gamma1);
+  }
+  if (fDoMesonQA == 2){
+    fInvMass = pi0cand->M();
+    fPt  = pi0cand->Pt();
+    if (TMath::Abs(gamma0->GetDCAzToPrimVtx()) < TMath::Abs(gamma1->GetDCAzToPrimVtx())){
+      fDCAzGammaMin = gamma0->GetDCAzToPrimVtx();
+      fDCAzGammaMax = gamma1->GetDCAzToPrimVtx();
+    } else {
+      fDCAzGammaMin = gamma1->GetDCAzToPrimVtx();
+      fDCAzGammaMax = gamma0->GetDCAzToPrimVtx();
+    }
+    iFlag = pi0cand->GetMesonQuality();
     //                   cout << "gamma 0: " << gamma0->GetV0Index()<< "\t" << gamma0->GetPx() << "\t" << gamma0->GetPy() << "\t" <<  gamma0->GetPz() << "\t" << endl; 
     //                   cout << "gamma 1: " << gamma1->GetV0Index()<< "\t"<< gamma1->GetPx() << "\t" << gamma1->GetPy() << "\t" <<  gamma1->GetPz() << "\t" << endl; 
     //                    cout << "pi0: "<<fInvMass << "\t" << fPt <<"\t" << fDCAzGammaMin << "\t" << fDCAzGammaMax << "\t" << (Int_t)iFlag << "\t" << (Int_t)iMesonMCInfo <<endl;
-            if (fIsHeavyIon == 1 && fPt > 0.399 && fPt < 20. ) {
-              if (fInvMass > 0.08 && fInvMass < 0.2) tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
-              if ((fInvMass > 0.45 && fInvMass < 0.6) &&  (fPt > 0.999 && fPt < 20.) )tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
-            } else if (fPt > 0.299 && fPt < 20. )  {
-              if ( (fInvMass > 0.08 && fInvMass < 0.6) ) tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
-            }   
-          }
+    if (fIsHeavyIon == 1 && fPt > 0.399 && fPt < 20. ) {
+      if (fInvMass > 0.08 && fInvMass < 0.2) tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
+      if ((fInvMass > 0.45 && fInvMass < 0.6) &&  (fPt > 0.999 && fPt < 20.) )tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
+    } else if (fPt > 0.299 && fPt < 20. )  {
+      if ( (fInvMass > 0.08 && fInvMass < 0.6) ) tESDMesonsInvMassPtDcazMinDcazMaxFlag[fiCut]->Fill();
+    }   
+  }
+}
+
+//______________________________________________________________________
+Bool_t AliAnalysisTaskGammaConvV1::SetReaderPhotonMask(){
+  // Mark the photon candidates of the cut set fiCut in the masks of the V0 reader photons.
+  // The candidates keep the order of the reader, kFALSE if one of them is not a reader photon.
+  vector<Int_t> &photons = fReaderPhotonsOfCut[fiCut];
+  photons.clear();
+  Int_t readerIndex = 0;
+  for(Int_t gamma = 0; gamma < fGammaCandidates->GetEntries(); gamma++){
+    while(readerIndex < fNReaderPairGammas && fReaderGammas->At(readerIndex) != fGammaCandidates->At(gamma)) readerIndex++;
+    if(readerIndex == fNReaderPairGammas) return kFALSE;
+    photons.push_back(readerIndex++);
+  }
+  for(UInt_t k = 0; k < photons.size(); k++) fReaderPhotonMask[photons[k]*fNMaskWords+fiCut/64] |= 1ULL << (fiCut%64);
+  return kTRUE;
+}
+
+//______________________________________________________________________
+void AliAnalysisTaskGammaConvV1::FillReaderPairMasks(){
+  // Build each pair of V0 reader photons which is a candidate of at least one cut set once
+  // and run the meson selection of these cut sets on it
+  if(fNReaderPairGammas < 2) return;
+  if((Int_t)fReaderPairMask.size() < fNReaderPairGammas*fNReaderPairGammas*fNMaskWords) fReaderPairMask.resize(fNReaderPairGammas*fNReaderPairGammas*fNMaskWords,0);
+  vector<ULong64_t> common(fNMaskWords);
+  for(Int_t i = 0; i < fNReaderPairGammas-1; i++){
+    AliAODConversionPhoton *gamma0 = (AliAODConversionPhoton*)fReaderGammas->At(i);
+    if(!gamma0) continue;
+    for(Int_t j = i+1; j < fNReaderPairGammas; j++){
+      Bool_t shared = kFALSE;
+      for(Int_t w = 0; w < fNMaskWords; w++){
+        common[w] = fReaderPhotonMask[i*fNMaskWords+w] & fReaderPhotonMask[j*fNMaskWords+w];
+        if(common[w]) shared = kTRUE;
+      }
+      if(!shared) continue;
+      AliAODConversionPhoton *gamma1 = (AliAODConversionPhoton*)fReaderGammas->At(j);
+      //Check for same Electron ID
+      if(!gamma1) continue;
+      if(gamma0->GetTrackLabelPositive() == gamma1->GetTrackLabelPositive() ||
+      gamma0->GetTrackLabelNegative() == gamma1->GetTrackLabelNegative() ||
+      gamma0->GetTrackLabelNegative() == gamma1->GetTrackLabelPositive() ||
+      gamma0->GetTrackLabelPositive() == gamma1->GetTrackLabelNegative() ) continue;
+
+      AliAODConversionMother *pi0cand = GetReaderPair(i,j);
+      Int_t pairIndex = i*fNReaderPairGammas+j;
+      for(Int_t w = 0; w < fNMaskWords; w++){
+        for(Int_t b = 0; b < 64 && common[w]; b++){
+          if(!(common[w] & (1ULL << b))) continue;
+          common[w] &= ~(1ULL << b);
+          Int_t iCut = w*64+b;
+          if(((AliConversionMesonCuts*)fMesonCutArray->At(iCut))->MesonIsSelected(pi0cand,kTRUE,((AliConvEventCuts*)fEventCutArray->At(iCut))->GetEtaShift()))
+            fReaderPairMask[pairIndex*fNMaskWords+w] |= 1ULL << b;
         }
-        delete pi0cand;
-        pi0cand=0x0;
       }
     }
   }
 }
 
+//______________________________________________________________________
+AliAODConversionMother* AliAnalysisTaskGammaConvV1::GetReaderPair(Int_t readerIndex0, Int_t readerIndex1){
+  // Pair of the V0 reader photons readerIndex0 and readerIndex1 (in this order) of the
+  // current event, built with its DCA to the primary vertex on first use
+  Int_t pairIndex = readerIndex0*fNReaderPairGammas+readerIndex1;
+  if((Int_t)fReaderPairs.size() < fNReaderPairGammas*fNReaderPairGammas) fReaderPairs.resize(fNReaderPairGammas*fNReaderPairGammas,NULL);
+  if(!fReaderPairs[pairIndex]){
+    AliAODConversionMother *pair = new AliAODConversionMother((AliAODConversionPhoton*)fReaderGammas->At(readerIndex0),(AliAODConversionPhoton*)fReaderGammas->At(readerIndex1));
+    pair->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
+    fReaderPairs[pairIndex] = pair;
+    fReaderPairsFilled.push_back(pairIndex);
+  }
+  return fReaderPairs[pairIndex];
+}
+
+//______________________________________________________________________
+void AliAnalysisTaskGammaConvV1::ClearReaderPairs(){
+  // Delete the pairs of V0 reader photons of the current event
+  for(UInt_t i = 0; i < fReaderPairsFilled.size(); i++){
+    delete fReaderPairs[fReaderPairsFilled[i]];
+    fReaderPairs[fReaderPairsFilled[i]] = NULL;
+    for(Int_t w = 0; w < fNMaskWords && (Int_t)fReaderPairMask.size() > fReaderPairsFilled[i]*fNMaskWords; w++) fReaderPairMask[fReaderPairsFilled[i]*fNMaskWords+w] = 0;
+  }
+  fReaderPairsFilled.clear();
+  fNReaderPairGammas = 0;
+}
+
 //______________________________________________________________________
 void AliAnalysisTaskGammaConvV1::ProcessTrueMesonCandidates(AliAODConversionMother *Pi0Candidate, AliAODConversionPhoton *TrueGammaCandidate0, AliAODConversionPhoton *TrueGammaCandidate1)
 {
@@ -3433,81 +3603,30 @@ void AliAnalysisTaskGammaConvV1::CalculateBackground(){
     }
   } else {
     AliGammaConversionAODBGHandler::GammaConversionVertex *bgEventVertex = NULL;
+    Bool_t doInPlaneOutOfPlane = ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0;
+    // the photon candidates are mixed with the packed photons of the pool, see FillMixedEventPairs
+    fCurrentPackedGammas.Clear();
+    for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
+      fCurrentPackedGammas.AddPhoton((AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent)));
+    }
 
-    if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))->UseTrackMultiplicity()){
-      for(Int_t nEventsInBG=0;nEventsInBG<fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
-        if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-          bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
-        }
-
-        for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
-        AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
-        for(Int_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-          AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-          if(fMoveParticleAccordingToVertex == kTRUE){
-            MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-          }
-          if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-            RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-          }
-          
-          AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
-          backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
-          if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
-            ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
-            if(fDoCentralityFlat > 0) fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(), fWeightCentrality[fiCut]*fWeightJetJetMC);
-            else fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(),fWeightJetJetMC);
-            if(fDoTHnSparse){
-              Double_t sparesFill[4] = {backgroundCandidate->M(),backgroundCandidate->Pt(),(Double_t)zbin,(Double_t)mbin};
-              if(fDoCentralityFlat > 0) sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightCentrality[fiCut]*fWeightJetJetMC); //instead of weight 1
-              else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
-            }
-          }
-          delete backgroundCandidate;
-          backgroundCandidate = 0x0;
-        }
-        }
-      }
-    } else {
-      for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
-        AliGammaConversionAODVector *previousEventV0s = fBGHandler[fiCut]->GetBGGoodV0s(zbin,mbin,nEventsInBG);
-        if(previousEventV0s){
-        if(fMoveParticleAccordingToVertex == kTRUE || ((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-          bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
-        }
-        for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
-          AliAODConversionPhoton currentEventGoodV0 = *(AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
-          for(Int_t iPrevious=0;iPrevious<previousEventV0s->size();iPrevious++){
-
-            AliAODConversionPhoton previousGoodV0 = (AliAODConversionPhoton)(*(previousEventV0s->at(iPrevious)));
-
-            if(fMoveParticleAccordingToVertex == kTRUE){
-              MoveParticleAccordingToVertex(&previousGoodV0,bgEventVertex);
-            }
-            if(((AliConversionPhotonCuts*)fCutArray->At(fiCut))->GetInPlaneOutOfPlaneCut() != 0){
-              RotateParticleAccordingToEP(&previousGoodV0,bgEventVertex->fEP,fEventPlaneAngle);
-            }
-
-
-            AliAODConversionMother *backgroundCandidate = new AliAODConversionMother(&currentEventGoodV0,&previousGoodV0);
-            backgroundCandidate->CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
-            if((((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
-              ->MesonIsSelected(backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift()))){
-              if(fDoCentralityFlat > 0) fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(), fWeightCentrality[fiCut]*fWeightJetJetMC);
-              else fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate->M(),backgroundCandidate->Pt(),fWeightJetJetMC);
-              if(fDoTHnSparse){
-                Double_t sparesFill[4] = {backgroundCandidate->M(),backgroundCandidate->Pt(),(Double_t)zbin,(Double_t)mbin};
-                if(fDoCentralityFlat > 0) sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightCentrality[fiCut]*fWeightJetJetMC); //instead of weight 1
-                else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill, fWeightJetJetMC);
-              }
-            }
-            delete backgroundCandidate;
-            backgroundCandidate = 0x0;
-          }
+    for(Int_t nEventsInBG=0;nEventsInBG <fBGHandler[fiCut]->GetNBGEvents();nEventsInBG++){
+      AliGammaConversionAODBGHandler::GammaConversionPackedEvent *previousEventV0s = fBGHandler[fiCut]->GetBGPackedEvent(zbin,mbin,nEventsInBG);
+      if(previousEventV0s->GetEntries() == 0) continue;
+      if(fMoveParticleAccordingToVertex == kTRUE || doInPlaneOutOfPlane){
+        bgEventVertex = fBGHandler[fiCut]->GetBGEventVertex(zbin,mbin,nEventsInBG);
+        // photons of the pool event moved to the current vertex and rotated to the current event plane,
+        // once per pool event instead of once per pair
+        fPreviousPackedGammas = *previousEventV0s;
+        if(fMoveParticleAccordingToVertex == kTRUE){
+          MoveParticleAccordingToVertex(fPreviousPackedGammas,bgEventVertex);
         }
+        if(doInPlaneOutOfPlane){
+          RotateParticleAccordingToEP(fPreviousPackedGammas,bgEventVertex->fEP,fEventPlaneAngle);
         }
+        previousEventV0s = &fPreviousPackedGammas;
       }
+      FillMixedEventPairs(fCurrentPackedGammas,*previousEventV0s,zbin,mbin,1.);
     }
   }
 }
@@ -3562,6 +3681,11 @@ void AliAnalysisTaskGammaConvV1::CalculateBackgroundRP(){
     
   } else {
     // Do Event Mixing
+    fCurrentPackedGammas.Clear();
+    for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
+      fCurrentPackedGammas.AddPhoton((AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent)));
+    }
+
     for(Int_t nEventsInBG=0;nEventsInBG <fBGHandlerRP[fiCut]->GetNBGEvents(fGammaCandidates,fInputEvent);nEventsInBG++){
 
       AliGammaConversionPhotonVector *previousEventGammas = fBGHandlerRP[fiCut]->GetBGGoodGammas(fGammaCandidates,fInputEvent,nEventsInBG);
@@ -3575,29 +3699,91 @@ void AliAnalysisTaskGammaConvV1::CalculateBackgroundRP(){
         // but BG leads to N_{a}*N_{b} combinations
         weight*=0.5*(Double_t(fGammaCandidates->GetEntries()-1))/Double_t(previousEventGammas->size());
 
-        for(Int_t iCurrent=0;iCurrent<fGammaCandidates->GetEntries();iCurrent++){
-
-                    AliAODConversionPhoton *gamma0 = (AliAODConversionPhoton*)(fGammaCandidates->At(iCurrent));
-
-                    for(Int_t iPrevious=0;iPrevious<previousEventGammas->size();iPrevious++){
+        // the pool of AliConversionAODBGHandlerRP keeps photon objects, they are packed once per pool event
+        fPreviousPackedGammas.Clear();
+        for(UInt_t iPrevious=0;iPrevious<previousEventGammas->size();iPrevious++){
+          fPreviousPackedGammas.AddPhoton(previousEventGammas->at(iPrevious));
+        }
+        FillMixedEventPairs(fCurrentPackedGammas,fPreviousPackedGammas,zbin,psibin,weight);
+      }
+    }
+  }
+}
 
-                        AliAODConversionPhoton *gamma1 = (AliAODConversionPhoton*)(previousEventGammas->at(iPrevious));
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::FillMixedEventPairs(const AliGammaConversionAODBGHandler::GammaConversionPackedEvent &currentEvent,
+                                                     const AliGammaConversionAODBGHandler::GammaConversionPackedEvent &previousEvent,
+                                                     Int_t zbin, Int_t sparseBin, Double_t sparseWeight){
+  // Mixed-event pairs of the photon candidates of the current event with the photons of one pool event,
+  // selected and filled as an AliAODConversionMother of the two photons would be. The kinematics of all
+  // pairs of one current photon are computed in a loop over the packed arrays, the DCAs only for the pairs
+  // which pass the kinematic cuts, and no photon or mother objects are built.
+  Int_t nPrevious = previousEvent.GetEntries();
+  if(nPrevious == 0) return;
+  AliConversionMesonCuts *mesonCuts = (AliConversionMesonCuts*)fMesonCutArray->At(fiCut);
+  Double_t etaShift = ((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift();
+  Double_t primVtx[3] = {fInputEvent->GetPrimaryVertex()->GetX(),fInputEvent->GetPrimaryVertex()->GetY(),fInputEvent->GetPrimaryVertex()->GetZ()};
+
+  if((Int_t)fMixedPairKinematics.size() < 6*nPrevious) fMixedPairKinematics.resize(6*nPrevious);
+  Double_t *pairPt    = &fMixedPairKinematics[0];
+  Double_t *pairM     = pairPt+nPrevious;
+  Double_t *pairE     = pairM+nPrevious;
+  Double_t *pairPz    = pairE+nPrevious;
+  Double_t *pairCosOA = pairPz+nPrevious;
+  Double_t *pairAlpha = pairCosOA+nPrevious;
+  const Double_t *px1 = &previousEvent.fPx[0];
+  const Double_t *py1 = &previousEvent.fPy[0];
+  const Double_t *pz1 = &previousEvent.fPz[0];
+  const Double_t *e1  = &previousEvent.fE[0];
+
+  for(Int_t iCurrent=0;iCurrent<currentEvent.GetEntries();iCurrent++){
+    Double_t px0 = currentEvent.fPx[iCurrent];
+    Double_t py0 = currentEvent.fPy[iCurrent];
+    Double_t pz0 = currentEvent.fPz[iCurrent];
+    Double_t e0  = currentEvent.fE[iCurrent];
+    Double_t mag0 = px0*px0 + py0*py0 + pz0*pz0;
+
+    // same arithmetic as TLorentzVector::Pt and M and TVector3::Angle of the mother
+    for(Int_t iPrevious=0;iPrevious<nPrevious;iPrevious++){
+      Double_t px = px0+px1[iPrevious];
+      Double_t py = py0+py1[iPrevious];
+      Double_t pz = pz0+pz1[iPrevious];
+      Double_t e  = e0+e1[iPrevious];
+      Double_t mm = e*e - (px*px + py*py + pz*pz);
+      Double_t ptot2 = mag0*(px1[iPrevious]*px1[iPrevious] + py1[iPrevious]*py1[iPrevious] + pz1[iPrevious]*pz1[iPrevious]);
+      pairPt[iPrevious]    = TMath::Sqrt(px*px + py*py);
+      pairM[iPrevious]     = mm < 0.0 ? -TMath::Sqrt(-mm) : TMath::Sqrt(mm);
+      pairE[iPrevious]     = e;
+      pairPz[iPrevious]    = pz;
+      pairCosOA[iPrevious] = ptot2 <= 0 ? 1. : (px0*px1[iPrevious] + py0*py1[iPrevious] + pz0*pz1[iPrevious])/TMath::Sqrt(ptot2);
+      pairAlpha[iPrevious] = e != 0 ? (e0-e1[iPrevious])/e : -1;
+    }
 
-                        AliAODConversionMother backgroundCandidate(gamma0,gamma1);
-                        backgroundCandidate.CalculateDistanceOfClossetApproachToPrimVtx(fInputEvent->GetPrimaryVertex());
-                        if(((AliConversionMesonCuts*)fMesonCutArray->At(fiCut))
-                            ->MesonIsSelected(&backgroundCandidate,kFALSE,((AliConvEventCuts*)fEventCutArray->At(fiCut))->GetEtaShift())){
-                            if(fDoCentralityFlat > 0) fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate.M(),backgroundCandidate.Pt(), fWeightCentrality[fiCut]*fWeightJetJetMC);
-              else fHistoMotherBackInvMassPt[fiCut]->Fill(backgroundCandidate.M(),backgroundCandidate.Pt(),fWeightJetJetMC);
-                            if(fDoTHnSparse){
-//                              Double_t sparesFill[4] = {backgroundCandidate.M(),backgroundCandidate.Pt(),(Double_t)zbin,(Double_t)mbin};
-                                Double_t sparesFill[4] = {backgroundCandidate.M(),backgroundCandidate.Pt(),(Double_t)zbin,(Double_t)psibin};
-                                if(fDoCentralityFlat > 0) sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill,weight*fWeightCentrality[fiCut]*fWeightJetJetMC);
-                                else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill,weight*fWeightJetJetMC);   
-                            }
-                        }
-                    }
-        }
+    Double_t conv0[3] = {currentEvent.fConvX[iCurrent],currentEvent.fConvY[iCurrent],currentEvent.fConvZ[iCurrent]};
+    Double_t p0[3] = {px0,py0,pz0};
+    for(Int_t iPrevious=0;iPrevious<nPrevious;iPrevious++){
+      Double_t cosOA = pairCosOA[iPrevious];
+      if(cosOA > 1.0) cosOA = 1.0;
+      if(cosOA < -1.0) cosOA = -1.0;
+      Int_t cutIndex = 0;
+      if(!mesonCuts->MesonKinematicsIsSelected(pairPt[iPrevious],pairE[iPrevious],pairPz[iPrevious],pairM[iPrevious],TMath::ACos(cosOA),pairAlpha[iPrevious],cutIndex,kFALSE,etaShift)) continue;
+
+      Double_t conv1[3] = {previousEvent.fConvX[iPrevious],previousEvent.fConvY[iPrevious],previousEvent.fConvZ[iPrevious]};
+      Double_t p1[3] = {px1[iPrevious],py1[iPrevious],pz1[iPrevious]};
+      Double_t productionVtx[3];
+      Float_t dcaBetweenPhotons = AliAODConversionMother::CalculateDistanceBetweenPhotons(conv0,p0,conv1,p1,productionVtx);
+      Double_t mom[3] = {px0+px1[iPrevious],py0+py1[iPrevious],pz0+pz1[iPrevious]};
+      Float_t dcaRPrimVtx = 100;
+      Float_t dcaZPrimVtx = 100;
+      AliAODConversionMother::CalculateDistanceOfClossetApproachToPrimVtx(mom,productionVtx,primVtx,dcaRPrimVtx,dcaZPrimVtx);
+      if(!mesonCuts->MesonDCAIsSelected(pairPt[iPrevious],pairM[iPrevious],dcaBetweenPhotons,dcaRPrimVtx,dcaZPrimVtx,cutIndex,kFALSE)) continue;
+
+      if(fDoCentralityFlat > 0) fHistoMotherBackInvMassPt[fiCut]->Fill(pairM[iPrevious],pairPt[iPrevious], fWeightCentrality[fiCut]*fWeightJetJetMC);
+      else fHistoMotherBackInvMassPt[fiCut]->Fill(pairM[iPrevious],pairPt[iPrevious],fWeightJetJetMC);
+      if(fDoTHnSparse){
+        Double_t sparesFill[4] = {pairM[iPrevious],pairPt[iPrevious],(Double_t)zbin,(Double_t)sparseBin};
+        if(fDoCentralityFlat > 0) sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill,sparseWeight*fWeightCentrality[fiCut]*fWeightJetJetMC);
+        else sESDMotherBackInvMassPtZM[fiCut]->Fill(sparesFill,sparseWeight*fWeightJetJetMC);
       }
     }
   }
@@ -3620,6 +3806,22 @@ void AliAnalysisTaskGammaConvV1::RotateParticleAccordingToEP(AliAODConversionPho
   gamma->RotateZ(rotationValue);
 }
 
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::RotateParticleAccordingToEP(AliGammaConversionAODBGHandler::GammaConversionPackedEvent &gammas, Double_t previousEventEP, Double_t thisEventEP){
+
+  previousEventEP=previousEventEP+TMath::Pi();
+  thisEventEP=thisEventEP+TMath::Pi();
+  Double_t rotationValue= thisEventEP-previousEventEP;
+  // as TVector3::RotateZ
+  Double_t s = TMath::Sin(rotationValue);
+  Double_t c = TMath::Cos(rotationValue);
+  for(Int_t i=0;i<gammas.GetEntries();i++){
+    Double_t px = gammas.fPx[i];
+    gammas.fPx[i] = c*px - s*gammas.fPy[i];
+    gammas.fPy[i] = s*px + c*gammas.fPy[i];
+  }
+}
+
 //________________________________________________________________________
 void AliAnalysisTaskGammaConvV1::MoveParticleAccordingToVertex(AliAODConversionPhoton* particle,const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex){
   //see header file for documentation
@@ -3632,6 +3834,21 @@ void AliAnalysisTaskGammaConvV1::MoveParticleAccordingToVertex(AliAODConversionP
   particle->SetConversionPoint(movedPlace);
 }
 
+//________________________________________________________________________
+void AliAnalysisTaskGammaConvV1::MoveParticleAccordingToVertex(AliGammaConversionAODBGHandler::GammaConversionPackedEvent &particles,const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex){
+  // packed version of MoveParticleAccordingToVertex for all photons of a pool event
+
+  Double_t dx = vertex->fX - fInputEvent->GetPrimaryVertex()->GetX();
+  Double_t dy = vertex->fY - fInputEvent->GetPrimaryVertex()->GetY();
+  Double_t dz = vertex->fZ - fInputEvent->GetPrimaryVertex()->GetZ();
+
+  for(Int_t i=0;i<particles.GetEntries();i++){
+    particles.fConvX[i] -= dx;
+    particles.fConvY[i] -= dy;
+    particles.fConvZ[i] -= dz;
+  }
+}
+
 //________________________________________________________________________
 void AliAnalysisTaskGammaConvV1::UpdateEventByEventData(){
   //see header file for documentation
@@ -46,8 +46,12 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     void ProcessPhotonCandidates();
     void ProcessClusters();
     void CalculatePi0Candidates();
+    void CalculatePi0CandidatesFromPairMask();
+    void FillPi0Candidate(AliAODConversionMother *pi0cand, AliAODConversionPhoton *gamma0, AliAODConversionPhoton *gamma1);
+    void ProcessMesonCandidates();
     void CalculateBackground();
     void CalculateBackgroundRP();
+    void FillMixedEventPairs(const AliGammaConversionAODBGHandler::GammaConversionPackedEvent &currentEvent, const AliGammaConversionAODBGHandler::GammaConversionPackedEvent &previousEvent, Int_t zbin, Int_t sparseBin, Double_t sparseWeight);
     void ProcessMCParticles();
     void ProcessAODMCParticles();
     void RelabelAODPhotonCandidates(Bool_t mode);
@@ -57,6 +61,7 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     void ProcessTrueMesonCandidatesAOD(AliAODConversionMother *Pi0Candidate, AliAODConversionPhoton *TrueGammaCandidate0, AliAODConversionPhoton *TrueGammaCandidate1);
     void RotateParticle(AliAODConversionPhoton *gamma);
     void RotateParticleAccordingToEP(AliAODConversionPhoton *gamma, Double_t previousEventEP, Double_t thisEventEP);
+    void RotateParticleAccordingToEP(AliGammaConversionAODBGHandler::GammaConversionPackedEvent &gammas, Double_t previousEventEP, Double_t thisEventEP);
     void SetEventCutList(Int_t nCuts, TList *CutArray)          { fnCuts                        = nCuts     ;
                                                                   fEventCutArray                = CutArray  ;}
     void SetConversionCutList(Int_t nCuts, TList *CutArray)     { fnCuts                        = nCuts     ;
@@ -75,6 +80,7 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     void FillPhotonCombinatorialMothersHistESD(TParticle *daughter,TParticle *mother);
     void FillPhotonCombinatorialMothersHistAOD(AliAODMCParticle *daughter, AliAODMCParticle* motherCombPart);
     void MoveParticleAccordingToVertex(AliAODConversionPhoton* particle,const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex);
+    void MoveParticleAccordingToVertex(AliGammaConversionAODBGHandler::GammaConversionPackedEvent &particles,const AliGammaConversionAODBGHandler::GammaConversionVertex *vertex);
     void UpdateEventByEventData();
     void SetLogBinningXTH2(TH2* histoRebin);
     Int_t GetSourceClassification(Int_t daughter, Int_t pdgCode);
@@ -83,6 +89,10 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     Bool_t CheckVectorForDoubleCount(vector<Int_t> &vec, Int_t tobechecked);
     void FillMultipleCountMap(map<Int_t,Int_t> &ma, Int_t tobechecked);
     void FillMultipleCountHistoAndClear(map<Int_t,Int_t> &ma, TH1F* hist);
+    AliAODConversionMother* GetReaderPair(Int_t readerIndex0, Int_t readerIndex1);
+    void ClearReaderPairs();
+    Bool_t SetReaderPhotonMask();
+    void FillReaderPairMasks();
     
   protected:
     AliV0ReaderV1*                    fV0Reader;                                  //
@@ -275,6 +285,18 @@ class AliAnalysisTaskGammaConvV1 : public AliAnalysisTaskSE {
     Double_t                          fEventPlaneAngle;                           // EventPlaneAngle
     TRandom3                          fRandom;                                    //
     Int_t                             fnGammaCandidates;                          //
+    vector<AliAODConversionMother*>   fReaderPairs;                               //! pairs of V0 reader photons of the current event, shared by all cut sets, at i*n+j
+    vector<Int_t>                     fReaderPairsFilled;                         //! entries of fReaderPairs filled in the current event
+    Int_t                             fNReaderPairGammas;                         //! number of V0 reader photons n used for the indices of fReaderPairs
+    Int_t                             fNMaskWords;                                //! number of 64 bit words of the cut-set masks
+    vector<ULong64_t>                 fReaderPhotonMask;                          //! cut sets which selected the V0 reader photon i, at i*fNMaskWords
+    vector<ULong64_t>                 fReaderPairMask;                            //! cut sets which selected the pair i*n+j of fReaderPairs, at (i*n+j)*fNMaskWords
+    vector< vector<Int_t> >           fReaderPhotonsOfCut;                        //! V0 reader indices of the photon candidates of each cut set which uses the pair masks
+    vector<Bool_t>                    fUsePairMaskOfCut;                          //! meson analysis of the cut set is done from the pair masks after all cut sets selected their photons
+    vector<Double_t>                  fWeightJetJetMCOfCut;                       //! fWeightJetJetMC of the cut set, for its meson analysis from the pair masks
+    AliGammaConversionAODBGHandler::GammaConversionPackedEvent fCurrentPackedGammas;  //! photon candidates of the current event, packed for the event mixing
+    AliGammaConversionAODBGHandler::GammaConversionPackedEvent fPreviousPackedGammas; //! photons of a pool event, moved to the current vertex and event plane
+    vector<Double_t>                  fMixedPairKinematics;                       //! pt, m, E, pz, cos(opening angle) and alpha of the mixed pairs of one current photon
     Double_t*                         fUnsmearedPx;                               //[fnGammaCandidates]
     Double_t*                         fUnsmearedPy;                               //[fnGammaCandidates]
     Double_t*                         fUnsmearedPz;                               //[fnGammaCandidates]
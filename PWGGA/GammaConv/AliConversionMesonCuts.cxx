@@ -797,19 +797,31 @@ Bool_t AliConversionMesonCuts::MesonIsSelected(AliAODConversionMother *pi0,Bool_
   // Selection of reconstructed Meson candidates
   // Use flag IsSignal in order to fill Fill different
   // histograms for Signal and Background
+  Int_t cutIndex=0;
+  if (!MesonKinematicsIsSelected(pi0->Pt(),pi0->E(),pi0->Pz(),pi0->M(),pi0->GetOpeningAngle(),pi0->GetAlpha(),cutIndex,IsSignal,fRapidityShift)) return kFALSE;
+  return MesonDCAIsSelected(pi0->Pt(),pi0->M(),pi0->GetDCABetweenPhotons(),pi0->GetDCARMotherPrimVtx(),pi0->GetDCAZMotherPrimVtx(),cutIndex,IsSignal);
+}
+
+//________________________________________________________________________
+Bool_t AliConversionMesonCuts::MesonKinematicsIsSelected(Double_t pt, Double_t e, Double_t pz, Double_t m, Double_t openingAngle, Double_t alpha,
+                                                         Int_t &cutIndex, Bool_t IsSignal, Double_t fRapidityShift)
+{
+  // Rapidity, mass, opening angle and alpha cuts of MesonIsSelected on the kinematics of a
+  // meson candidate, so that pairs can be selected without building an AliAODConversionMother.
+  // cutIndex is the cut histogram bin reached, MesonDCAIsSelected continues from it.
   TH2 *hist=0x0;
 
   if(IsSignal){hist=fHistoMesonCuts;}
   else{hist=fHistoMesonBGCuts;}
 
-  Int_t cutIndex=0;
+  cutIndex=0;
 
-  if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if(hist)hist->Fill(cutIndex, pt);
   cutIndex++;
 
   // Undefined Rapidity -> Floating Point exception
-  if((pi0->E()+pi0->Pz())/(pi0->E()-pi0->Pz())<=0){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if((e+pz)/(e-pz)<=0){
+    if(hist)hist->Fill(cutIndex, pt);
     cutIndex++;
     if (!IsSignal)cout << "undefined rapidity" << endl;
     return kFALSE;
@@ -817,22 +829,22 @@ Bool_t AliConversionMesonCuts::MesonIsSelected(AliAODConversionMother *pi0,Bool_
   else{
     // PseudoRapidity Cut --> But we cut on Rapidity !!!
     cutIndex++;
-    if(TMath::Abs(pi0->Rapidity()-fRapidityShift)>fRapidityCutMeson){
-      if(hist)hist->Fill(cutIndex, pi0->Pt());
+    if(TMath::Abs(0.5*TMath::Log((e+pz)/(e-pz))-fRapidityShift)>fRapidityCutMeson){
+      if(hist)hist->Fill(cutIndex, pt);
       return kFALSE;
     }
   }
   cutIndex++;
 
-  if (fHistoInvMassBefore) fHistoInvMassBefore->Fill(pi0->M());
+  if (fHistoInvMassBefore) fHistoInvMassBefore->Fill(m);
   // Mass cut
   if (fIsMergedClusterCut == 1 ){
     if (fEnableMassCut){
-      Double_t massMin = FunctionMinMassCut(pi0->E());
-      Double_t massMax = FunctionMaxMassCut(pi0->E());
-  //     cout << "Min mass: " << massMin << "\t max Mass: " << massMax << "\t mass current: " <<  pi0->M()<< "\t E current: " << pi0->E() << endl;
-      if (pi0->M() > massMax || pi0->M() < massMin ){
-        if(hist)hist->Fill(cutIndex, pi0->Pt());
+      Double_t massMin = FunctionMinMassCut(e);
+      Double_t massMax = FunctionMaxMassCut(e);
+  //     cout << "Min mass: " << massMin << "\t max Mass: " << massMax << "\t mass current: " <<  m<< "\t E current: " << e << endl;
+      if (m > massMax || m < massMin ){
+        if(hist)hist->Fill(cutIndex, pt);
         return kFALSE;
       }
     }  
@@ -841,83 +853,96 @@ Bool_t AliConversionMesonCuts::MesonIsSelected(AliAODConversionMother *pi0,Bool_
   
   // Opening Angle Cut
   //fOpeningAngle=2*TMath::ATan(0.134/pi0->P());// physical minimum opening angle
-  if( fEnableMinOpeningAngleCut && pi0->GetOpeningAngle() < fOpeningAngle){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if( fEnableMinOpeningAngleCut && openingAngle < fOpeningAngle){
+    if(hist)hist->Fill(cutIndex, pt);
     return kFALSE;
   }
 
   // Min Opening Angle
-  if (fMinOpanPtDepCut == kTRUE) fMinOpanCutMeson = fFMinOpanCut->Eval(pi0->Pt());
+  if (fMinOpanPtDepCut == kTRUE) fMinOpanCutMeson = fFMinOpanCut->Eval(pt);
 
-  if (pi0->GetOpeningAngle() < fMinOpanCutMeson){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if (openingAngle < fMinOpanCutMeson){
+    if(hist)hist->Fill(cutIndex, pt);
     return kFALSE;
   }
 
   // Max Opening Angle
-  if (fMaxOpanPtDepCut == kTRUE) fMaxOpanCutMeson = fFMaxOpanCut->Eval(pi0->Pt());
+  if (fMaxOpanPtDepCut == kTRUE) fMaxOpanCutMeson = fFMaxOpanCut->Eval(pt);
 
-  if( pi0->GetOpeningAngle() > fMaxOpanCutMeson){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if( openingAngle > fMaxOpanCutMeson){
+    if(hist)hist->Fill(cutIndex, pt);
     return kFALSE;
   }
   cutIndex++;
   
   // Alpha Max Cut
-  if (fIsMergedClusterCut == 1 && fAlphaPtDepCut) fAlphaCutMeson = fFAlphaCut->Eval(pi0->E());
-  else if (fAlphaPtDepCut == kTRUE) fAlphaCutMeson = fFAlphaCut->Eval(pi0->Pt());
+  if (fIsMergedClusterCut == 1 && fAlphaPtDepCut) fAlphaCutMeson = fFAlphaCut->Eval(e);
+  else if (fAlphaPtDepCut == kTRUE) fAlphaCutMeson = fFAlphaCut->Eval(pt);
   
-  if(TMath::Abs(pi0->GetAlpha())>fAlphaCutMeson){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if(TMath::Abs(alpha)>fAlphaCutMeson){
+    if(hist)hist->Fill(cutIndex, pt);
     return kFALSE;
   }
   cutIndex++;
 
   // Alpha Min Cut
-  if(TMath::Abs(pi0->GetAlpha())<fAlphaMinCutMeson){
-    if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if(TMath::Abs(alpha)<fAlphaMinCutMeson){
+    if(hist)hist->Fill(cutIndex, pt);
     return kFALSE;
   }
   cutIndex++;
 
-  if (fHistoInvMassAfter) fHistoInvMassAfter->Fill(pi0->M());
-  
+  if (fHistoInvMassAfter) fHistoInvMassAfter->Fill(m);
+  return kTRUE;
+}
+
+//________________________________________________________________________
+Bool_t AliConversionMesonCuts::MesonDCAIsSelected(Double_t pt, Double_t m, Float_t dcaBetweenPhotons, Float_t dcaRPrimVtx, Float_t dcaZPrimVtx,
+                                                  Int_t cutIndex, Bool_t IsSignal)
+{
+  // DCA cuts of MesonIsSelected for a candidate which passed MesonKinematicsIsSelected,
+  // the DCAs are only used for fIsMergedClusterCut == 0
+  TH2 *hist=0x0;
+
+  if(IsSignal){hist=fHistoMesonCuts;}
+  else{hist=fHistoMesonBGCuts;}
+
   if (fIsMergedClusterCut == 0){ 
-    if (fHistoDCAGGMesonBefore)fHistoDCAGGMesonBefore->Fill(pi0->GetDCABetweenPhotons());
-    if (fHistoDCARMesonPrimVtxBefore)fHistoDCARMesonPrimVtxBefore->Fill(pi0->GetDCARMotherPrimVtx());
+    if (fHistoDCAGGMesonBefore)fHistoDCAGGMesonBefore->Fill(dcaBetweenPhotons);
+    if (fHistoDCARMesonPrimVtxBefore)fHistoDCARMesonPrimVtxBefore->Fill(dcaRPrimVtx);
 
     if (fDCAGammaGammaCutOn){
-      if (pi0->GetDCABetweenPhotons() > fDCAGammaGammaCut){
-        if(hist)hist->Fill(cutIndex, pi0->Pt());
+      if (dcaBetweenPhotons > fDCAGammaGammaCut){
+        if(hist)hist->Fill(cutIndex, pt);
         return kFALSE;
       }
     }  
     cutIndex++;
 
     if (fDCARMesonPrimVtxCutOn){
-      if (pi0->GetDCARMotherPrimVtx() > fDCARMesonPrimVtxCut){
-        if(hist)hist->Fill(cutIndex, pi0->Pt());
+      if (dcaRPrimVtx > fDCARMesonPrimVtxCut){
+        if(hist)hist->Fill(cutIndex, pt);
         return kFALSE;
       }
     }  
     cutIndex++;
 
-    if (fHistoDCAZMesonPrimVtxBefore)fHistoDCAZMesonPrimVtxBefore->Fill(pi0->GetDCAZMotherPrimVtx());
+    if (fHistoDCAZMesonPrimVtxBefore)fHistoDCAZMesonPrimVtxBefore->Fill(dcaZPrimVtx);
 
     if (fDCAZMesonPrimVtxCutOn){
-      if (TMath::Abs(pi0->GetDCAZMotherPrimVtx()) > fDCAZMesonPrimVtxCut){
-        if(hist)hist->Fill(cutIndex, pi0->Pt());
+      if (TMath::Abs(dcaZPrimVtx) > fDCAZMesonPrimVtxCut){
+        if(hist)hist->Fill(cutIndex, pt);
         return kFALSE;
       }
     }
     cutIndex++;
 
-    if (fHistoDCAGGMesonAfter)fHistoDCAGGMesonAfter->Fill(pi0->GetDCABetweenPhotons());
-    if (fHistoDCARMesonPrimVtxAfter)fHistoDCARMesonPrimVtxAfter->Fill(pi0->GetDCARMotherPrimVtx());
-    if (fHistoDCAZMesonPrimVtxAfter)fHistoDCAZMesonPrimVtxAfter->Fill(pi0->M(),pi0->GetDCAZMotherPrimVtx());
+    if (fHistoDCAGGMesonAfter)fHistoDCAGGMesonAfter->Fill(dcaBetweenPhotons);
+    if (fHistoDCARMesonPrimVtxAfter)fHistoDCARMesonPrimVtxAfter->Fill(dcaRPrimVtx);
+    if (fHistoDCAZMesonPrimVtxAfter)fHistoDCAZMesonPrimVtxAfter->Fill(m,dcaZPrimVtx);
   } 
   
-  if(hist)hist->Fill(cutIndex, pi0->Pt());
+  if(hist)hist->Fill(cutIndex, pt);
   return kTRUE;
 }
 
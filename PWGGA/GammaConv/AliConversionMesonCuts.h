@@ -79,6 +79,8 @@ class AliConversionMesonCuts : public AliAnalysisCuts {
 
     // Cut Selection
     Bool_t MesonIsSelected(AliAODConversionMother *pi0,Bool_t IsSignal=kTRUE, Double_t fRapidityShift=0.);
+    Bool_t MesonKinematicsIsSelected(Double_t pt, Double_t e, Double_t pz, Double_t m, Double_t openingAngle, Double_t alpha, Int_t &cutIndex, Bool_t IsSignal=kTRUE, Double_t fRapidityShift=0.);
+    Bool_t MesonDCAIsSelected(Double_t pt, Double_t m, Float_t dcaBetweenPhotons, Float_t dcaRPrimVtx, Float_t dcaZPrimVtx, Int_t cutIndex, Bool_t IsSignal=kTRUE);
     Bool_t MesonIsSelectedMC(TParticle *fMCMother,AliStack *fMCStack, Double_t fRapidityShift=0.);
     Bool_t MesonIsSelectedAODMC(AliAODMCParticle *MCMother,TClonesArray *AODMCArray, Double_t fRapidityShift=0.);
     Bool_t MesonIsSelectedMCDalitz(TParticle *fMCMother,AliStack *fMCStack, Int_t &labelelectron, Int_t &labelpositron, Int_t &labelgamma,Double_t fRapidityShift=0.);
@@ -44,7 +44,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler() :
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(),
 	fBGEventsENeg(),
-	fBGEventsMeson()
+	fBGEventsMeson(),
+	fUsePackedPool(kFALSE),
+	fBGPackedEvents()
 {
 	// constructor
 }
@@ -64,7 +66,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t binsZ,Int_t
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
-	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents)))
+	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
+	fUsePackedPool(kFALSE),
+	fBGPackedEvents(binsZ,AliGammaConversionPackedMultipicityVector(binsMultiplicity,AliGammaConversionPackedBGEventVector(nEvents)))
 {
 	// constructor
 }
@@ -86,7 +90,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(Int_t collisionSy
 	fBinLimitsArrayMultiplicity(NULL),
 	fBGEvents(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
 	fBGEventsENeg(binsZ,AliGammaConversionMultipicityVector(binsMultiplicity,AliGammaConversionBGEventVector(nEvents))),
-	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents)))
+	fBGEventsMeson(binsZ,AliGammaConversionMotherMultipicityVector(binsMultiplicity,AliGammaConversionMotherBGEventVector(nEvents))),
+	fUsePackedPool(kFALSE),
+	fBGPackedEvents(binsZ,AliGammaConversionPackedMultipicityVector(binsMultiplicity,AliGammaConversionPackedBGEventVector(nEvents)))
 {
 	// constructor
     if(fNBinsZ>8) fNBinsZ = 8;
@@ -357,7 +363,9 @@ AliGammaConversionAODBGHandler::AliGammaConversionAODBGHandler(const AliGammaCon
 	fBinLimitsArrayMultiplicity(original.fBinLimitsArrayMultiplicity),
 	fBGEvents(original.fBGEvents),
 	fBGEventsENeg(original.fBGEventsENeg),
-	fBGEventsMeson(original.fBGEventsMeson)
+	fBGEventsMeson(original.fBGEventsMeson),
+	fUsePackedPool(original.fUsePackedPool),
+	fBGPackedEvents(original.fBGPackedEvents)
 {
 	//copy constructor	
 }
@@ -594,9 +602,18 @@ void AliGammaConversionAODBGHandler::AddEvent(TList* const eventGammas,Double_t
 	fBGEvents[z][m][eventCounter].clear();
 	
 	// add the gammas to the vector
-	for(Int_t i=0; i< eventGammas->GetEntries();i++){
-		//    AliKFParticle *t = new AliKFParticle(*(AliKFParticle*)(eventGammas->At(i)));
-		fBGEvents[z][m][eventCounter].push_back(new AliAODConversionPhoton(*(AliAODConversionPhoton*)(eventGammas->At(i))));
+	if(fUsePackedPool){
+		// overwrite the oldest slot of the ring of packed events of this bin
+		GammaConversionPackedEvent &packedEvent = fBGPackedEvents[z][m][eventCounter];
+		packedEvent.Clear();
+		for(Int_t i=0; i< eventGammas->GetEntries();i++){
+			packedEvent.AddPhoton((AliAODConversionPhoton*)(eventGammas->At(i)));
+		}
+	} else {
+		for(Int_t i=0; i< eventGammas->GetEntries();i++){
+			//    AliKFParticle *t = new AliKFParticle(*(AliKFParticle*)(eventGammas->At(i)));
+			fBGEvents[z][m][eventCounter].push_back(new AliAODConversionPhoton(*(AliAODConversionPhoton*)(eventGammas->At(i))));
+		}
 	}
 	fBGEventCounter[z][m]++;
 }
@@ -40,6 +40,31 @@ class AliGammaConversionAODBGHandler : public TObject {
 	
 	typedef struct GammaConversionVertex GammaConversionVertex; 																//!
 
+	// Photons of one pool event packed into contiguous arrays: momentum, energy, conversion point
+	// and photon quality, which is all the pair building needs. The arrays keep their capacity
+	// when the slot of the ring is overwritten by a new event.
+	struct GammaConversionPackedEvent{
+		vector<Double_t> fPx;
+		vector<Double_t> fPy;
+		vector<Double_t> fPz;
+		vector<Double_t> fE;
+		vector<Double_t> fConvX;
+		vector<Double_t> fConvY;
+		vector<Double_t> fConvZ;
+		vector<UChar_t>  fQuality;
+
+		Int_t GetEntries() const {return fPx.size();}
+		void Clear(){fPx.clear(); fPy.clear(); fPz.clear(); fE.clear(); fConvX.clear(); fConvY.clear(); fConvZ.clear(); fQuality.clear();}
+		void AddPhoton(const AliAODConversionPhoton *gamma){
+			fPx.push_back(gamma->Px()); fPy.push_back(gamma->Py()); fPz.push_back(gamma->Pz()); fE.push_back(gamma->E());
+			fConvX.push_back(gamma->GetConversionX()); fConvY.push_back(gamma->GetConversionY()); fConvZ.push_back(gamma->GetConversionZ());
+			fQuality.push_back(gamma->GetPhotonQuality());
+		}
+	};
+	typedef vector<GammaConversionPackedEvent> AliGammaConversionPackedBGEventVector;
+	typedef vector<AliGammaConversionPackedBGEventVector> AliGammaConversionPackedMultipicityVector;
+	typedef vector<AliGammaConversionPackedMultipicityVector> AliGammaConversionPackedBGVector;
+
 	typedef vector<AliGammaConversionAODVector> AliGammaConversionBGEventVector;
 	typedef vector<AliGammaConversionBGEventVector> AliGammaConversionMultipicityVector;
 	typedef vector<AliGammaConversionMultipicityVector> AliGammaConversionBGVector;
@@ -67,8 +92,14 @@ class AliGammaConversionAODBGHandler : public TObject {
 
 	Int_t GetNBGEvents()const {return fNEvents;}
 
+	// Keep the photons of AddEvent only as packed events (GetBGPackedEvent) instead of photon copies (GetBGGoodV0s)
+	void SetUsePackedPool(Bool_t usePackedPool){fUsePackedPool = usePackedPool;}
+	Bool_t GetUsePackedPool() const {return fUsePackedPool;}
+
 	// Get BG photons
 	AliGammaConversionAODVector* GetBGGoodV0s(Int_t zbin, Int_t mbin, Int_t event);
+	// Get BG photons of the packed pool
+	GammaConversionPackedEvent* GetBGPackedEvent(Int_t zbin, Int_t mbin, Int_t event){return &fBGPackedEvents[zbin][mbin][event];}
 	// Get BG mesons
 	AliGammaConversionMotherAODVector* GetBGGoodMesons(Int_t zbin, Int_t mbin, Int_t event);
 	// Get BG electron
@@ -95,7 +126,9 @@ class AliGammaConversionAODBGHandler : public TObject {
 		AliGammaConversionBGVector 			fBGEvents; 						// photon background events
 		AliGammaConversionBGVector 			fBGEventsENeg; 					// electron background electron events
 		AliGammaConversionMotherBGVector 	fBGEventsMeson; 				// neutral meson background events
+		Bool_t								fUsePackedPool;					// photon background events stored in fBGPackedEvents
+		AliGammaConversionPackedBGVector	fBGPackedEvents;				//! packed photon background events
 		
-	ClassDef(AliGammaConversionAODBGHandler,5)
+	ClassDef(AliGammaConversionAODBGHandler,6)
 };
 #endif
@@ -64,12 +64,14 @@
 #include "AliRDHFCutsDStartoKpipi.h"
 #include "AliAnalysisFilter.h"
 #include "AliAnalysisVertexingHF.h"
+#include "AliHFPrimaryVertexSums.h"
 #include "AliMixedEvent.h"
 #include "AliESDv0.h"
 #include "AliAODv0.h"
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
 #include <cstring>
+#include <vector>
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
@@ -86,6 +88,8 @@ fSecVtxWithKF(kFALSE),
 fRecoPrimVtxSkippingTrks(kFALSE),
 fRmTrksFromPrimVtx(kFALSE),
 fV1(0x0),
+fPrimVtxSums(0x0),
+fPrimVtxSumsValidation(0),
 fD0toKpi(kTRUE),
 fJPSItoEle(kTRUE),
 f3Prong(kTRUE),
@@ -181,6 +185,8 @@ fSecVtxWithKF(source.fSecVtxWithKF),
 fRecoPrimVtxSkippingTrks(source.fRecoPrimVtxSkippingTrks),
 fRmTrksFromPrimVtx(source.fRmTrksFromPrimVtx),
 fV1(source.fV1),
+fPrimVtxSums(0x0),
+fPrimVtxSumsValidation(source.fPrimVtxSumsValidation),
 fD0toKpi(source.fD0toKpi),
 fJPSItoEle(source.fJPSItoEle),
 f3Prong(source.f3Prong),
@@ -273,6 +279,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fRecoPrimVtxSkippingTrks = source.fRecoPrimVtxSkippingTrks;
   fRmTrksFromPrimVtx = source.fRmTrksFromPrimVtx;
   fV1 = source.fV1;
+  fPrimVtxSumsValidation = source.fPrimVtxSumsValidation;
   fD0toKpi = source.fD0toKpi;
   fJPSItoEle = source.fJPSItoEle;
   f3Prong = source.f3Prong;
@@ -351,6 +358,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
 AliAnalysisVertexingHF::~AliAnalysisVertexingHF() {
   /// Destructor
   if(fV1) { delete fV1; fV1=0; }
+  if(fPrimVtxSums) { delete fPrimVtxSums; fPrimVtxSums=0; }
   delete fVertexerTracks;
   if(fTrackFilter) { delete fTrackFilter; fTrackFilter=0; }
   if(fTrackFilter2prongCentral) { delete fTrackFilter2prongCentral; fTrackFilter2prongCentral=0; }
@@ -431,6 +439,59 @@ TList *AliAnalysisVertexingHF::FillListOfCuts() {
   return list;
 }
 //----------------------------------------------------------------------------
+static const Int_t kPairDCACacheBits=20; // the track-pair DCA cache has at most 2^20 slots (16 MB)
+//----------------------------------------------------------------------------
+namespace {
+/// Per-event cache of the track-pair DCAs of FindCandidates, see GetPairDCAAtVertex
+struct PairDCACache {
+  std::vector<Long64_t> fPair; ///< ordered pair index iTrk1*nSeleTrks+iTrk2 held by each slot, -1: empty
+  std::vector<Double_t> fDCA;  ///< DCA of the pair held by each slot
+  Int_t fHashShift;            ///< 0: the pair index is the slot, otherwise the slot is the hashed pair index shifted by fHashShift
+
+  void Reset(Int_t nSeleTrks) {
+    /// All nSeleTrks^2 ordered pairs get their own slot if they fit in the
+    /// 2^kPairDCACacheBits slots. In larger events the pair indices are
+    /// hashed onto the slots, a pair overwritten by another one is
+    /// recomputed when it is needed again.
+    Long64_t nPairs=(Long64_t)nSeleTrks*nSeleTrks;
+    Long64_t nSlots=nPairs;
+    fHashShift=0;
+    if(nPairs>(1LL<<kPairDCACacheBits)) {
+      nSlots=1LL<<kPairDCACacheBits;
+      fHashShift=64-kPairDCACacheBits;
+    }
+    fPair.assign(nSlots,-1);
+    fDCA.resize(nSlots);
+  }
+  Long64_t Slot(Long64_t pair) const {
+    if(fHashShift==0) return pair;
+    // Fibonacci hashing: neighbouring pairs end up in distant slots
+    return (Long64_t)(((ULong64_t)pair*11400714819323198485ULL)>>fHashShift);
+  }
+};
+}
+//----------------------------------------------------------------------------
+static Double_t GetPairDCAAtVertex(AliESDtrack *trk1,Int_t iTrk1,
+				   AliESDtrack *trk2,Int_t iTrk2,
+				   Int_t nSeleTrks,Double_t bzkG,
+				   PairDCACache &cache)
+{
+  /// DCA between two selected tracks, both set to their parameters at the
+  /// primary vertex. The value only depends on the (ordered) pair, so it is
+  /// computed once per event: FindCandidates asks again for p2-n1 for every
+  /// p1, for p1-p2 for every n1 and for n1-n2 for every p1.
+  /// The cache memory is bounded (see PairDCACache::Reset), in large events
+  /// a pair may be computed more than once, always with the same result
+  Long64_t pair=(Long64_t)iTrk1*nSeleTrks+iTrk2;
+  Long64_t slot=cache.Slot(pair);
+  if(cache.fPair[slot]==pair) return cache.fDCA[slot];
+  Double_t xdummy,ydummy;
+  Double_t dca=trk1->GetDCA(trk2,bzkG,xdummy,ydummy);
+  cache.fPair[slot]=pair;
+  cache.fDCA[slot]=dca;
+  return dca;
+}
+//----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 					    TClonesArray *aodVerticesHFTClArr,
 					    TClonesArray *aodD0toKpiTClArr,
@@ -618,6 +679,21 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   AliDebug(1,Form(" Selected tracks: %d",nSeleTrks));
   fnSeleTrksTotal += nSeleTrks;
 
+  // primary vertex fit of the event, from which the daughters of the
+  // candidates are removed
+  if(fRecoPrimVtxSkippingTrks) FillPrimaryVertexSums(event);
+
+  // momenta at the primary vertex, packed for the invariant-mass
+  // pre-selections, and the track-pair DCAs computed so far in this event
+  std::vector<Double_t> pxAtVtx(nSeleTrks),pyAtVtx(nSeleTrks),pzAtVtx(nSeleTrks);
+  for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) {
+    Double_t momAtVtx[3];
+    ((AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrk))->GetPxPyPz(momAtVtx);
+    pxAtVtx[iTrk]=momAtVtx[0]; pyAtVtx[iTrk]=momAtVtx[1]; pzAtVtx[iTrk]=momAtVtx[2];
+  }
+  PairDCACache pairDCA;
+  pairDCA.Reset(nSeleTrks);
+
 
   TObjArray *twoTrackArray1    = new TObjArray(2);
   TObjArray *twoTrackArray2    = new TObjArray(2);
@@ -864,10 +940,10 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       //      negtrack1->PropagateToDCA(fV1,fBzkG,kVeryBig);
       SetParametersAtVertex(postrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP1));
       SetParametersAtVertex(negtrack1,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN1));
-      negtrack1->GetPxPyPz(momneg1);
+      momneg1[0]=pxAtVtx[iTrkN1]; momneg1[1]=pyAtVtx[iTrkN1]; momneg1[2]=pzAtVtx[iTrkN1];
 
       // DCA between the two tracks
-      dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      dcap1n1 = GetPairDCAAtVertex(postrack1,iTrkP1,negtrack1,iTrkN1,nSeleTrks,fBzkG,pairDCA);
       if(dcap1n1>dcaMax) { negtrack1=0; continue; }
 
       // Vertexing
@@ -1131,9 +1207,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
-	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+	dcap2n1 = GetPairDCAAtVertex(postrack2,iTrkP2,negtrack1,iTrkN1,nSeleTrks,fBzkG,pairDCA);
 	if(dcap2n1>dcaMax) { postrack2=0; continue; }
-	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+	dcap1p2 = GetPairDCAAtVertex(postrack2,iTrkP2,postrack1,iTrkP1,nSeleTrks,fBzkG,pairDCA);
 	if(dcap1p2>dcaMax) { postrack2=0; continue; }
 
 	// check invariant mass cuts for D+,Ds,Lc
@@ -1149,7 +1225,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    threeTrackArray->AddAt(postrack2,2);
 	  }
 	  if(fMassCutBeforeVertexing){
-	    postrack2->GetPxPyPz(mompos2);
+	    mompos2[0]=pxAtVtx[iTrkP2]; mompos2[1]=pyAtVtx[iTrkP2]; mompos2[2]=pzAtVtx[iTrkP2];
 	    Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
 	    Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
 	    Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
@@ -1275,9 +1351,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 
-	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	    dcap1n2 = GetPairDCAAtVertex(postrack1,iTrkP1,negtrack2,iTrkN2,nSeleTrks,fBzkG,pairDCA);
 	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-            dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+            dcap2n2 = GetPairDCAAtVertex(postrack2,iTrkP2,negtrack2,iTrkN2,nSeleTrks,fBzkG,pairDCA);
             if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
 
 
@@ -1288,8 +1364,12 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	    // check invariant mass cuts for D0
 	    massCutOK=kTRUE;
-	    if(fMassCutBeforeVertexing)
-	      massCutOK = SelectInvMassAndPt4prong(fourTrackArray);
+	    if(fMassCutBeforeVertexing){
+	      Double_t pxDau[4]={pxAtVtx[iTrkP1],pxAtVtx[iTrkN1],pxAtVtx[iTrkP2],pxAtVtx[iTrkN2]};
+	      Double_t pyDau[4]={pyAtVtx[iTrkP1],pyAtVtx[iTrkN1],pyAtVtx[iTrkP2],pyAtVtx[iTrkN2]};
+	      Double_t pzDau[4]={pzAtVtx[iTrkP1],pzAtVtx[iTrkN1],pzAtVtx[iTrkP2],pzAtVtx[iTrkN2]};
+	      massCutOK = SelectInvMassAndPt4prong(pxDau,pyDau,pzDau);
+	    }
 
 	    if(!massCutOK) {
 	      fourTrackArray->Clear();
@@ -1409,9 +1489,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcap1n2 = GetPairDCAAtVertex(postrack1,iTrkP1,negtrack2,iTrkN2,nSeleTrks,fBzkG,pairDCA);
 	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcan1n2 = GetPairDCAAtVertex(negtrack1,iTrkN1,negtrack2,iTrkN2,nSeleTrks,fBzkG,pairDCA);
 	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
 
 	threeTrackArray->AddAt(negtrack1,0);
@@ -1421,7 +1501,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	// check invariant mass cuts for D+,Ds,Lc
         massCutOK=kTRUE;
 	if(fMassCutBeforeVertexing && f3Prong){
-	  negtrack2->GetPxPyPz(momneg2);
+	  momneg2[0]=pxAtVtx[iTrkN2]; momneg2[1]=pyAtVtx[iTrkN2]; momneg2[2]=pzAtVtx[iTrkN2];
 	  Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
 	  Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
 	  Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
@@ -1547,6 +1627,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   delete [] seleFlags; seleFlags=NULL;
   if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
   tracksAtVertex.Delete();
+  if(fPrimVtxSums) fPrimVtxSums->Clear();
 
   if(fInputAOD) {
     seleTrksArray.Delete();
@@ -2795,48 +2876,24 @@ AliAODVertex* AliAnalysisVertexingHF::PrimaryVertex(const TObjArray *trkArray,
     // primary vertex specific to this candidate
 
     Int_t nTrks = trkArray->GetEntriesFast();
-    AliVertexerTracks *vertexer = new AliVertexerTracks(event->GetMagneticField());
 
     if(fRecoPrimVtxSkippingTrks) {
-      // recalculating the vertex
-
-      if(strstr(fV1->GetTitle(),"VertexerTracksWithConstraint")) {
-	Float_t diamondcovxy[3];
-	event->GetDiamondCovXY(diamondcovxy);
-	Double_t pos[3]={event->GetDiamondX(),event->GetDiamondY(),0.};
-	Double_t cov[6]={diamondcovxy[0],diamondcovxy[1],diamondcovxy[2],0.,0.,10.*10.};
-	AliESDVertex *diamond = new AliESDVertex(pos,cov,1.,1);
-	vertexer->SetVtxStart(diamond);
-	delete diamond; diamond=NULL;
-	if(strstr(fV1->GetTitle(),"VertexerTracksWithConstraintOnlyFitter"))
-	  vertexer->SetOnlyFitter();
-      }
-      Int_t skipped[1000];
-      Int_t nTrksToSkip=0,id;
-      AliExternalTrackParam *t = 0;
-      for(Int_t i=0; i<nTrks; i++) {
-	t = (AliExternalTrackParam*)trkArray->UncheckedAt(i);
-	id = (Int_t)t->GetID();
-	if(id<0) continue;
-	skipped[nTrksToSkip++] = id;
-      }
-      // TEMPORARY FIX
-      // For AOD, skip also tracks without covariance matrix
-      if(fInputAOD) {
-	Double_t covtest[21];
-	for(Int_t j=0; j<event->GetNumberOfTracks(); j++) {
-	  AliVTrack *vtrack = (AliVTrack*)event->GetTrack(j);
-	  if(!vtrack->GetCovarianceXYZPxPyPz(covtest)) {
-	    id = (Int_t)vtrack->GetID();
-	    if(id<0) continue;
-	    skipped[nTrksToSkip++] = id;
-	  }
+      // recalculating the vertex: remove the daughters from the sums of
+      // the event vertex fit if possible, otherwise refit all the tracks
+
+      if(fPrimVtxSums && fPrimVtxSums->IsValid() && nTrks<=1000) {
+	Int_t ids[1000];
+	for(Int_t i=0; i<nTrks; i++) ids[i] = (Int_t)((AliExternalTrackParam*)trkArray->UncheckedAt(i))->GetID();
+	vertexESD = fPrimVtxSums->RemoveTracks(nTrks,ids);
+	if(vertexESD && fPrimVtxSums->SampleForValidation(fPrimVtxSumsValidation)) {
+	  // validation: compare with the full refit of this candidate
+	  AliESDVertex *vertexRefit = RecoPrimaryVertexSkippingTrks(trkArray,event);
+	  fPrimVtxSums->Validate(vertexESD,vertexRefit);
+	  delete vertexRefit; vertexRefit=NULL;
+	  if(fPrimVtxSums->GetNValidated()%1000==1) PrintPrimVtxSumsValidation();
 	}
       }
-      for(Int_t ijk=nTrksToSkip; ijk<1000; ijk++) skipped[ijk]=-1;
-      //
-      vertexer->SetSkipTracks(nTrksToSkip,skipped);
-      vertexESD = (AliESDVertex*)vertexer->FindPrimaryVertex(event);
+      if(!vertexESD) vertexESD = RecoPrimaryVertexSkippingTrks(trkArray,event);
 
     } else if(fRmTrksFromPrimVtx && nTrks>0) {
       // removing the prongs tracks
@@ -2856,7 +2913,9 @@ AliAODVertex* AliAnalysisVertexingHF::PrimaryVertex(const TObjArray *trkArray,
 	}
       }
       Float_t diamondxy[2]={static_cast<Float_t>(event->GetDiamondX()),static_cast<Float_t>(event->GetDiamondY())};
+      AliVertexerTracks *vertexer = new AliVertexerTracks(event->GetMagneticField());
       vertexESD = vertexer->RemoveTracksFromVertex(fV1,&rmArray,rmId,diamondxy);
+      delete vertexer; vertexer=NULL;
       delete [] rmId; rmId=NULL;
       rmArray.Delete();
 
@@ -2869,8 +2928,6 @@ AliAODVertex* AliAnalysisVertexingHF::PrimaryVertex(const TObjArray *trkArray,
       return vertexAOD;
     }
 
-    delete vertexer; vertexer=NULL;
-
   }
 
   // convert to AliAODVertex
@@ -2885,6 +2942,98 @@ AliAODVertex* AliAnalysisVertexingHF::PrimaryVertex(const TObjArray *trkArray,
   return vertexAOD;
 }
 //-----------------------------------------------------------------------------
+AliESDVertex* AliAnalysisVertexingHF::RecoPrimaryVertexSkippingTrks(const TObjArray *trkArray,
+								    AliVEvent *event) const
+{
+  /// Primary vertex reconstructed without the tracks in trkArray (if any)
+  /// and, for AOD, without the tracks that have no covariance matrix
+
+  AliVertexerTracks *vertexer = new AliVertexerTracks(event->GetMagneticField());
+  if(strstr(fV1->GetTitle(),"VertexerTracksWithConstraint")) {
+    Float_t diamondcovxy[3];
+    event->GetDiamondCovXY(diamondcovxy);
+    Double_t pos[3]={event->GetDiamondX(),event->GetDiamondY(),0.};
+    Double_t cov[6]={diamondcovxy[0],diamondcovxy[1],diamondcovxy[2],0.,0.,10.*10.};
+    AliESDVertex *diamond = new AliESDVertex(pos,cov,1.,1);
+    vertexer->SetVtxStart(diamond);
+    delete diamond; diamond=NULL;
+    if(strstr(fV1->GetTitle(),"VertexerTracksWithConstraintOnlyFitter"))
+      vertexer->SetOnlyFitter();
+  }
+  Int_t skipped[1000];
+  Int_t nTrksToSkip=0,id;
+  Int_t nTrks = (trkArray ? trkArray->GetEntriesFast() : 0);
+  AliExternalTrackParam *t = 0;
+  for(Int_t i=0; i<nTrks; i++) {
+    t = (AliExternalTrackParam*)trkArray->UncheckedAt(i);
+    id = (Int_t)t->GetID();
+    if(id<0) continue;
+    skipped[nTrksToSkip++] = id;
+  }
+  // TEMPORARY FIX
+  // For AOD, skip also tracks without covariance matrix
+  if(fInputAOD) {
+    Double_t covtest[21];
+    for(Int_t j=0; j<event->GetNumberOfTracks(); j++) {
+      AliVTrack *vtrack = (AliVTrack*)event->GetTrack(j);
+      if(!vtrack->GetCovarianceXYZPxPyPz(covtest)) {
+	id = (Int_t)vtrack->GetID();
+	if(id<0) continue;
+	skipped[nTrksToSkip++] = id;
+      }
+    }
+  }
+  for(Int_t ijk=nTrksToSkip; ijk<1000; ijk++) skipped[ijk]=-1;
+  //
+  vertexer->SetSkipTracks(nTrksToSkip,skipped);
+  AliESDVertex *vertexESD = (AliESDVertex*)vertexer->FindPrimaryVertex(event);
+  delete vertexer; vertexer=NULL;
+
+  return vertexESD;
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FillPrimaryVertexSums(AliVEvent *event)
+{
+  /// Fit the primary vertex of the event once, with the same settings as
+  /// RecoPrimaryVertexSkippingTrks, and keep the weighted sums of the fit,
+  /// from which PrimaryVertex removes the daughters of each candidate
+
+  if(!fPrimVtxSums) fPrimVtxSums = new AliHFPrimaryVertexSums();
+  fPrimVtxSums->Clear();
+
+  AliESDVertex *vertexESD = RecoPrimaryVertexSkippingTrks(0x0,event);
+  if(!vertexESD) return;
+  if(vertexESD->GetNContributors()>0) {
+    if(strstr(fV1->GetTitle(),"VertexerTracksWithConstraint")) {
+      // the diamond set as start point is also used as constraint in the fit
+      Float_t diamondcovxy[3];
+      event->GetDiamondCovXY(diamondcovxy);
+      Double_t pos[3]={event->GetDiamondX(),event->GetDiamondY(),0.};
+      Double_t cov[6]={diamondcovxy[0],diamondcovxy[1],diamondcovxy[2],0.,0.,10.*10.};
+      fPrimVtxSums->Init(vertexESD,event,fBzkG,pos,cov);
+    } else {
+      fPrimVtxSums->Init(vertexESD,event,fBzkG);
+    }
+  }
+  delete vertexESD; vertexESD=NULL;
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::PrintPrimVtxSumsValidation() const
+{
+  /// Largest deviations between the primary vertices from the sums and the
+  /// full refits, over the candidates compared so far
+  /// (SetPrimVtxSumsValidation)
+
+  if(!fPrimVtxSums || fPrimVtxSums->GetNValidated()==0) {
+    AliInfo("Primary vertex sums validation: no candidate compared");
+    return;
+  }
+  AliInfo(Form("Primary vertex sums validation: %lld candidates compared, %lld with a different number of contributors; max deviation: position %g cm (%g sigma), covariance %g (relative)",
+	       fPrimVtxSums->GetNValidated(),fPrimVtxSums->GetNValidatedNContribMismatch(),
+	       fPrimVtxSums->GetMaxPosDeviation(),fPrimVtxSums->GetMaxPosPull(),
+	       fPrimVtxSums->GetMaxCovDeviation()));
+}
+//-----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::PrintStatus() const {
   /// Print parameters being used
 
@@ -2896,6 +3045,10 @@ void AliAnalysisVertexingHF::PrintStatus() const {
     printf("Secondary vertex with AliVertexerTracks\n");
   }
   if(fRecoPrimVtxSkippingTrks) printf("RecoPrimVtxSkippingTrks\n");
+  if(fRecoPrimVtxSkippingTrks && fPrimVtxSumsValidation>0) {
+    printf("  compare every %d-th primary vertex from the fit sums with the full refit\n",fPrimVtxSumsValidation);
+    PrintPrimVtxSumsValidation();
+  }
   if(fRmTrksFromPrimVtx) printf("RmTrksFromPrimVtx\n");
   if(fD0toKpi) {
     printf("Reconstruct D0->Kpi candidates with cuts:\n");
@@ -21,6 +21,7 @@
 
 class AliPIDResponse;
 class AliESDVertex;
+class AliHFPrimaryVertexSums;
 class AliAODRecoDecay;
 class AliAODRecoDecayHF;
 class AliAODRecoDecayHF2Prong;
@@ -119,6 +120,9 @@ class AliAnalysisVertexingHF : public TNamed {
     { fRecoPrimVtxSkippingTrks=kFALSE; fRmTrksFromPrimVtx=kFALSE;}
   void SetRmTrksFromPrimVtx()
     {fRmTrksFromPrimVtx=kTRUE; fRecoPrimVtxSkippingTrks=kFALSE; }
+  void SetPrimVtxSumsValidation(Int_t every=100) {fPrimVtxSumsValidation=every;}
+  Int_t GetPrimVtxSumsValidation() const {return fPrimVtxSumsValidation;}
+  void PrintPrimVtxSumsValidation() const;
   void SetTrackFilter(AliAnalysisFilter* trackF) {
     /// switch off the TOF selection that cannot be applied with AODTracks
     TList *l = (TList*)trackF->GetCuts();
@@ -264,6 +268,8 @@ class AliAnalysisVertexingHF : public TNamed {
                              /// the primary vertex
 
   AliESDVertex *fV1; /// primary vertex
+  AliHFPrimaryVertexSums *fPrimVtxSums; //!<! sums of the event primary vertex fit, to remove the daughters of each candidate
+  Int_t fPrimVtxSumsValidation; /// compare every n-th vertex from fPrimVtxSums with the full refit (0: off)
 
   /// flag to enable candidates production
   Bool_t fD0toKpi;   /// D0->Kpi
@@ -392,6 +398,8 @@ class AliAnalysisVertexingHF : public TNamed {
 
   void MapAODtracks(AliVEvent *aod);
   AliAODVertex* PrimaryVertex(const TObjArray *trkArray=0x0,AliVEvent *event=0x0) const;
+  AliESDVertex* RecoPrimaryVertexSkippingTrks(const TObjArray *trkArray,AliVEvent *event) const;
+  void FillPrimaryVertexSums(AliVEvent *event);
   AliAODVertex* ReconstructSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,Bool_t useTRefArray=kTRUE) const;
 
   Bool_t SelectInvMassAndPt3prong(Double_t *px,Double_t *py,Double_t *pz, Int_t pidLcStatus=3);
@@ -420,7 +428,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,27);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,28);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
@@ -0,0 +1,253 @@
+/**************************************************************************
+ * Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//----------------------------------------------------------------------------
+//    Implementation of the class to remove tracks from a primary vertex
+//    by downdating the weighted sums of its fit
+//----------------------------------------------------------------------------
+
+#include <TMath.h>
+#include "AliVEvent.h"
+#include "AliVTrack.h"
+#include "AliESDtrack.h"
+#include "AliESDVertex.h"
+#include "AliExternalTrackParam.h"
+#include "AliHFPrimaryVertexSums.h"
+
+//----------------------------------------------------------------------------
+AliHFPrimaryVertexSums::AliHFPrimaryVertexSums():
+fValid(kFALSE),
+fNContributors(0),
+fSumRWr(0.),
+fSlotOfId(),
+fTrackW(),
+fTrackWr(),
+fTrackRWr(),
+fNSampled(0),
+fNValidated(0),
+fNContribMismatch(0),
+fMaxPosDev(0.),
+fMaxPosPull(0.),
+fMaxCovDev(0.)
+{
+  /// Default constructor
+  Clear();
+}
+//----------------------------------------------------------------------------
+void AliHFPrimaryVertexSums::Clear()
+{
+  /// Forget the sums of the previous event
+  fValid=kFALSE;
+  fNContributors=0;
+  for(Int_t i=0; i<3; i++) { fOrigin[i]=0.; fSumWr[i]=0.; }
+  for(Int_t i=0; i<6; i++) fSumW[i]=0.;
+  fSumRWr=0.;
+  fSlotOfId.clear();
+  fTrackW.clear();
+  fTrackWr.clear();
+  fTrackRWr.clear();
+}
+//----------------------------------------------------------------------------
+Bool_t AliHFPrimaryVertexSums::Init(const AliESDVertex *vtx,const AliVEvent *event,
+				   Double_t bzkG,const Double_t *diamondPos,
+				   const Double_t *diamondCov)
+{
+  /// Fill the sums with the contributors of vtx (track IDs from
+  /// AliESDVertex::GetIndices) and the diamond constraint, if given.
+  /// Returns kFALSE if some contributor can not be used, in which case
+  /// RemoveTracks always returns 0x0
+  Clear();
+  if(!vtx || !event) return kFALSE;
+  Int_t nIndices=vtx->GetNIndices();
+  UShort_t *indices=vtx->GetIndices();
+  if(nIndices<=0 || !indices) return kFALSE;
+  vtx->GetXYZ(fOrigin);
+
+  // event tracks by ID
+  std::vector<Int_t> indexOfId;
+  Int_t nTracks=event->GetNumberOfTracks();
+  for(Int_t j=0; j<nTracks; j++) {
+    AliVTrack *vtrack=(AliVTrack*)event->GetTrack(j);
+    if(!vtrack) continue;
+    Int_t id=vtrack->GetID();
+    if(id<0) continue;
+    if(id>=(Int_t)indexOfId.size()) indexOfId.resize(id+1,-1);
+    indexOfId[id]=j;
+  }
+
+  fTrackW.reserve(6*nIndices);
+  fTrackWr.reserve(3*nIndices);
+  fTrackRWr.reserve(nIndices);
+
+  for(Int_t k=0; k<nIndices; k++) {
+    Int_t id=indices[k];
+    if(id>=(Int_t)indexOfId.size() || indexOfId[id]<0) { Clear(); return kFALSE; }
+    if(id<(Int_t)fSlotOfId.size() && fSlotOfId[id]>=0) continue;
+    AliVTrack *vtrack=(AliVTrack*)event->GetTrack(indexOfId[id]);
+    AliExternalTrackParam t;
+    AliESDtrack *esdt=dynamic_cast<AliESDtrack*>(vtrack);
+    if(esdt) t=*esdt;
+    else t.CopyFromVTrack(vtrack);
+
+    // space point and weight of the track at the vertex, as in
+    // AliVertexerTracks::TrackToPoint
+    Double_t alpha=t.GetAlpha();
+    Double_t cs=TMath::Cos(alpha),sn=TMath::Sin(alpha);
+    Double_t xl=fOrigin[0]*cs+fOrigin[1]*sn;
+    if(!t.PropagateTo(xl,bzkG)) { Clear(); return kFALSE; }
+    Double_t r[3]={t.GetX()*cs-t.GetY()*sn-fOrigin[0],
+		   t.GetX()*sn+t.GetY()*cs-fOrigin[1],
+		   t.GetZ()-fOrigin[2]};
+    Double_t sy2=t.GetSigmaY2(),szy=t.GetSigmaZY(),sz2=t.GetSigmaZ2();
+    Double_t det=sy2*sz2-szy*szy;
+    if(det<=0.) { Clear(); return kFALSE; }
+    Double_t a=sz2/det,b=-szy/det,d=sy2/det;
+    Double_t w[6]={a*sn*sn,-a*sn*cs,a*cs*cs,-b*sn,b*cs,d};
+    Double_t wr[3]={w[0]*r[0]+w[1]*r[1]+w[3]*r[2],
+		    w[1]*r[0]+w[2]*r[1]+w[4]*r[2],
+		    w[3]*r[0]+w[4]*r[1]+w[5]*r[2]};
+    Double_t rwr=r[0]*wr[0]+r[1]*wr[1]+r[2]*wr[2];
+
+    if(id>=(Int_t)fSlotOfId.size()) fSlotOfId.resize(id+1,-1);
+    fSlotOfId[id]=fNContributors++;
+    for(Int_t i=0; i<6; i++) { fTrackW.push_back(w[i]); fSumW[i]+=w[i]; }
+    for(Int_t i=0; i<3; i++) { fTrackWr.push_back(wr[i]); fSumWr[i]+=wr[i]; }
+    fTrackRWr.push_back(rwr); fSumRWr+=rwr;
+  }
+
+  if(diamondPos && diamondCov) {
+    Double_t w[6];
+    if(!InvertSym3(diamondCov,w)) { Clear(); return kFALSE; }
+    Double_t r[3]={diamondPos[0]-fOrigin[0],diamondPos[1]-fOrigin[1],diamondPos[2]-fOrigin[2]};
+    Double_t wr[3]={w[0]*r[0]+w[1]*r[1]+w[3]*r[2],
+		    w[1]*r[0]+w[2]*r[1]+w[4]*r[2],
+		    w[3]*r[0]+w[4]*r[1]+w[5]*r[2]};
+    for(Int_t i=0; i<6; i++) fSumW[i]+=w[i];
+    for(Int_t i=0; i<3; i++) fSumWr[i]+=wr[i];
+    fSumRWr+=r[0]*wr[0]+r[1]*wr[1]+r[2]*wr[2];
+  }
+
+  fValid=kTRUE;
+  return kTRUE;
+}
+//----------------------------------------------------------------------------
+AliESDVertex* AliHFPrimaryVertexSums::RemoveTracks(Int_t nIds,const Int_t *ids) const
+{
+  /// Vertex without the tracks with the given IDs (IDs that are negative or
+  /// not among the contributors are ignored). The caller owns the vertex.
+  /// Returns 0x0 if the sums are not valid or fewer than two tracks are
+  /// left: the vertex has to be refitted in that case
+  if(!fValid) return 0x0;
+
+  Double_t sumW[6],sumWr[3],sumRWr=fSumRWr;
+  for(Int_t i=0; i<6; i++) sumW[i]=fSumW[i];
+  for(Int_t i=0; i<3; i++) sumWr[i]=fSumWr[i];
+
+  Int_t nRemoved=0;
+  for(Int_t k=0; k<nIds; k++) {
+    Int_t id=ids[k];
+    if(id<0 || id>=(Int_t)fSlotOfId.size() || fSlotOfId[id]<0) continue;
+    Bool_t duplicate=kFALSE;
+    for(Int_t kk=0; kk<k; kk++) if(ids[kk]==id) duplicate=kTRUE;
+    if(duplicate) continue;
+    Int_t slot=fSlotOfId[id];
+    for(Int_t i=0; i<6; i++) sumW[i]-=fTrackW[6*slot+i];
+    for(Int_t i=0; i<3; i++) sumWr[i]-=fTrackWr[3*slot+i];
+    sumRWr-=fTrackRWr[slot];
+    nRemoved++;
+  }
+
+  Int_t nLeft=fNContributors-nRemoved;
+  if(nLeft<2) return 0x0;
+
+  Double_t cov[6];
+  if(!InvertSym3(sumW,cov)) return 0x0;
+  Double_t dx[3]={cov[0]*sumWr[0]+cov[1]*sumWr[1]+cov[3]*sumWr[2],
+		  cov[1]*sumWr[0]+cov[2]*sumWr[1]+cov[4]*sumWr[2],
+		  cov[3]*sumWr[0]+cov[4]*sumWr[1]+cov[5]*sumWr[2]};
+  // sum of (r_i-x)^T W_i (r_i-x) at the minimum
+  Double_t chi2=sumRWr-(dx[0]*sumWr[0]+dx[1]*sumWr[1]+dx[2]*sumWr[2]);
+  if(chi2<0.) chi2=0.;
+  Double_t pos[3]={fOrigin[0]+dx[0],fOrigin[1]+dx[1],fOrigin[2]+dx[2]};
+
+  return new AliESDVertex(pos,cov,chi2,nLeft);
+}
+//----------------------------------------------------------------------------
+void AliHFPrimaryVertexSums::ResetValidation()
+{
+  /// Forget the deviations collected by Validate
+  fNSampled=0;
+  fNValidated=0;
+  fNContribMismatch=0;
+  fMaxPosDev=0.;
+  fMaxPosPull=0.;
+  fMaxCovDev=0.;
+}
+//----------------------------------------------------------------------------
+void AliHFPrimaryVertexSums::Validate(const AliESDVertex *vtxSums,const AliESDVertex *vtxRefit)
+{
+  /// Compare the vertex obtained from the sums with the full refit of the
+  /// same candidate (AliVertexerTracks without the daughters) and update
+  /// the largest position and covariance deviations. Candidates for which
+  /// the refit keeps another set of tracks are counted separately, the
+  /// sums can not agree with the refit for them
+  if(!vtxSums || !vtxRefit || vtxRefit->GetNContributors()<=0) return;
+  fNValidated++;
+  if(vtxSums->GetNContributors()!=vtxRefit->GetNContributors()) {
+    fNContribMismatch++;
+    return;
+  }
+
+  Double_t posSums[3],posRefit[3],covSums[6],covRefit[6];
+  vtxSums->GetXYZ(posSums);
+  vtxRefit->GetXYZ(posRefit);
+  vtxSums->GetCovMatrix(covSums);
+  vtxRefit->GetCovMatrix(covRefit);
+
+  // diagonal elements of the (xx,xy,yy,xz,yz,zz) storage
+  const Int_t diag[3]={0,2,5};
+  for(Int_t i=0; i<3; i++) {
+    Double_t dev=TMath::Abs(posSums[i]-posRefit[i]);
+    if(dev>fMaxPosDev) fMaxPosDev=dev;
+    Double_t sigma2=covRefit[diag[i]];
+    if(sigma2>0. && dev/TMath::Sqrt(sigma2)>fMaxPosPull) fMaxPosPull=dev/TMath::Sqrt(sigma2);
+  }
+  Int_t k=0;
+  for(Int_t i=0; i<3; i++) {
+    for(Int_t j=0; j<=i; j++,k++) {
+      Double_t norm=TMath::Sqrt(TMath::Abs(covRefit[diag[i]]*covRefit[diag[j]]));
+      if(norm<=0.) continue;
+      Double_t dev=TMath::Abs(covSums[k]-covRefit[k])/norm;
+      if(dev>fMaxCovDev) fMaxCovDev=dev;
+    }
+  }
+}
+//----------------------------------------------------------------------------
+Bool_t AliHFPrimaryVertexSums::InvertSym3(const Double_t *m,Double_t *inv)
+{
+  /// Inverse of a positive definite symmetric 3x3 matrix, both stored as
+  /// (xx,xy,yy,xz,yz,zz)
+  Double_t c00=m[2]*m[5]-m[4]*m[4];
+  Double_t c01=m[3]*m[4]-m[1]*m[5];
+  Double_t c02=m[1]*m[4]-m[2]*m[3];
+  Double_t c11=m[0]*m[5]-m[3]*m[3];
+  Double_t c12=m[1]*m[3]-m[0]*m[4];
+  Double_t c22=m[0]*m[2]-m[1]*m[1];
+  Double_t det=m[0]*c00+m[1]*c01+m[3]*c02;
+  if(!(det>0.)) return kFALSE;
+  inv[0]=c00/det; inv[1]=c01/det; inv[2]=c11/det;
+  inv[3]=c02/det; inv[4]=c12/det; inv[5]=c22/det;
+  return kTRUE;
+}
@@ -0,0 +1,81 @@
+#ifndef ALIHFPRIMARYVERTEXSUMS_H
+#define ALIHFPRIMARYVERTEXSUMS_H
+/* Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+//-------------------------------------------------------------------------
+/// \class AliHFPrimaryVertexSums
+/// \brief Weighted sums of a primary-vertex fit, to remove tracks from it
+///
+/// The contributors of a vertex found by AliVertexerTracks are propagated
+/// to the vertex and turned into space points r_i with weight matrices W_i,
+/// as in the vertex fitter. Keeping sum(W_i), sum(W_i r_i) and
+/// sum(r_i^T W_i r_i), together with the terms of every track, the vertex
+/// without k of its tracks is obtained by subtracting their terms and
+/// solving the 3x3 system again, instead of refitting all the tracks.
+/// The diamond constraint, if any, is a term that is never removed.
+/// Coordinates are taken relative to the input vertex, to keep the chi2
+/// sums small.
+///
+/// Used by AliAnalysisVertexingHF to recompute the primary vertex of each
+/// candidate without its daughters (SetRecoPrimVtxSkippingTrks). The result
+/// agrees with the full refit as long as the tracks used by the refit are
+/// the ones of the event vertex, which is the case unless the removed
+/// daughters change the outlier rejection of the fitter.
+///
+/// Validate compares a vertex from the sums with the full refit of the
+/// same candidate and keeps the largest deviations over all the compared
+/// candidates (AliAnalysisVertexingHF::SetPrimVtxSumsValidation).
+//-------------------------------------------------------------------------
+
+#include <Rtypes.h>
+#include <vector>
+
+class AliVEvent;
+class AliESDVertex;
+
+class AliHFPrimaryVertexSums {
+ public:
+  AliHFPrimaryVertexSums();
+  virtual ~AliHFPrimaryVertexSums() {}
+
+  void Clear();
+  Bool_t Init(const AliESDVertex *vtx,const AliVEvent *event,Double_t bzkG,
+	      const Double_t *diamondPos=0x0,const Double_t *diamondCov=0x0);
+  AliESDVertex* RemoveTracks(Int_t nIds,const Int_t *ids) const;
+
+  Bool_t IsValid() const { return fValid; }
+  Int_t  GetNContributors() const { return fNContributors; }
+
+  void     ResetValidation();
+  Bool_t   SampleForValidation(Int_t every) { return every>0 && (fNSampled++)%every==0; }
+  void     Validate(const AliESDVertex *vtxSums,const AliESDVertex *vtxRefit);
+  Long64_t GetNValidated() const { return fNValidated; }
+  Long64_t GetNValidatedNContribMismatch() const { return fNContribMismatch; }
+  Double_t GetMaxPosDeviation() const { return fMaxPosDev; }
+  Double_t GetMaxPosPull() const { return fMaxPosPull; }
+  Double_t GetMaxCovDeviation() const { return fMaxCovDev; }
+
+ private:
+  static Bool_t InvertSym3(const Double_t *m,Double_t *inv);
+
+  Bool_t   fValid;         /// sums filled for the current event
+  Int_t    fNContributors; /// number of tracks in the sums
+  Double_t fOrigin[3];     /// vertex used as origin of the coordinates
+  Double_t fSumW[6];       /// sum of the weight matrices (xx,xy,yy,xz,yz,zz)
+  Double_t fSumWr[3];      /// sum of W_i r_i
+  Double_t fSumRWr;        /// sum of r_i^T W_i r_i
+  std::vector<Int_t>    fSlotOfId; /// position in the track terms for each track ID, -1 if not a contributor
+  std::vector<Double_t> fTrackW;   /// W_i of each contributor, 6 values each
+  std::vector<Double_t> fTrackWr;  /// W_i r_i of each contributor, 3 values each
+  std::vector<Double_t> fTrackRWr; /// r_i^T W_i r_i of each contributor
+
+  Long64_t fNSampled;         /// number of calls of SampleForValidation (not reset by Clear)
+  Long64_t fNValidated;       /// number of vertices compared with the refit (not reset by Clear)
+  Long64_t fNContribMismatch; /// compared vertices with a different number of contributors than the refit
+  Double_t fMaxPosDev;        /// largest position difference (cm) to the refit, on any axis
+  Double_t fMaxPosPull;       /// largest position difference in units of the refit uncertainty
+  Double_t fMaxCovDev;        /// largest covariance difference, relative to sqrt(cov_ii cov_jj) of the refit
+};
+
+#endif
@@ -13,6 +13,8 @@
  * provided "as is" without express or implied warranty.                  *
  **************************************************************************/
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include <TClonesArray.h>
@@ -48,6 +50,38 @@ ClassImp(AliEmcalJetTask);
 
 const Int_t AliEmcalJetTask::fgkConstIndexShift = 100000;
 
+/**
+ * Runs the jet finder of all wrappers, distributed dynamically over nThreads threads.
+ * The wrappers are run serially (in a fixed order, hence reproducibly) if any of them
+ * uses the random generator of fastjet, see AliFJWrapper::IsRunThreadSafe().
+ * @param wrappers FastJet wrappers with their input vectors
+ * @param nThreads Number of threads
+ */
+static void RunWrappers(const std::vector<AliFJWrapper*>& wrappers, Int_t nThreads)
+{
+  const Int_t n = wrappers.size();
+
+  Bool_t threadSafe = kTRUE;
+  for (Int_t i = 0; i < n; i++) {
+    if (!wrappers[i]->IsRunThreadSafe()) threadSafe = kFALSE;
+  }
+
+  if (nThreads <= 1 || n <= 1 || !threadSafe) {
+    for (Int_t i = 0; i < n; i++) wrappers[i]->Run();
+    return;
+  }
+
+  std::atomic<Int_t> next(0);
+  std::vector<std::thread> threads;
+  for (Int_t i = 0; i < TMath::Min(nThreads, n); i++) {
+    threads.push_back(std::thread([&next, n, &wrappers]() {
+      Int_t iwrapper;
+      while ((iwrapper = next++) < n) wrappers[iwrapper]->Run();
+    }));
+  }
+  for (UInt_t i = 0; i < threads.size(); i++) threads[i].join();
+}
+
 /**
  * Default constructor. This constructor is only for ROOT I/O and
  * not to be used by users.
@@ -69,6 +103,10 @@ AliEmcalJetTask::AliEmcalJetTask() :
   fTrackEfficiency(1.),
   fUtilities(0),
   fLocked(0),
+  fExtraJetAlgos(),
+  fExtraRadii(),
+  fExtraRecombSchemes(),
+  fNumberOfThreads(1),
   fJetsName(),
   fIsInit(0),
   fIsPSelSet(0),
@@ -76,7 +114,10 @@ AliEmcalJetTask::AliEmcalJetTask() :
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
   fJets(0),
-  fFastJetWrapper("AliEmcalJetTask","AliEmcalJetTask")
+  fFastJetWrapper("AliEmcalJetTask","AliEmcalJetTask"),
+  fExtraFastJetWrappers(),
+  fExtraJets(),
+  fGhosts()
 {
 }
 
@@ -101,6 +142,10 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
   fTrackEfficiency(1.),
   fUtilities(0),
   fLocked(0),
+  fExtraJetAlgos(),
+  fExtraRadii(),
+  fExtraRecombSchemes(),
+  fNumberOfThreads(1),
   fJetsName(),
   fIsInit(0),
   fIsPSelSet(0),
@@ -108,7 +153,10 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
   fLegacyMode(kFALSE),
   fFillGhost(kFALSE),
   fJets(0),
-  fFastJetWrapper(name,name)
+  fFastJetWrapper(name,name),
+  fExtraFastJetWrappers(),
+  fExtraJets(),
+  fGhosts()
 {
 }
 
@@ -117,6 +165,47 @@ AliEmcalJetTask::AliEmcalJetTask(const char *name) :
  */
 AliEmcalJetTask::~AliEmcalJetTask()
 {
+  for (UInt_t i = 0; i < fExtraFastJetWrappers.size(); i++) delete fExtraFastJetWrappers[i];
+}
+
+/**
+ * Add a jet definition, which is clustered in addition to the main one
+ * from the same constituents and written into its own jet collection.
+ * @param algo Jet algorithm
+ * @param radius Jet radius
+ * @param reco Recombination scheme
+ */
+void AliEmcalJetTask::AddJetDefinition(EJetAlgo_t algo, Double_t radius, ERecoScheme_t reco)
+{
+  if (IsLocked()) return;
+
+  fExtraJetAlgos.push_back(algo);
+  fExtraRadii.push_back(radius);
+  fExtraRecombSchemes.push_back(reco);
+}
+
+/**
+ * Set the number of threads for the clustering of the jet definitions.
+ * It has to be set before the task is initialized. The clustering runs
+ * serially if the jet finding uses the random generator of fastjet
+ * (e.g. event-wise constituent subtraction).
+ * @param n Number of threads (>= 1)
+ */
+void AliEmcalJetTask::SetNumberOfThreads(Int_t n)
+{
+  if (IsLocked()) return;
+
+  if (fLocalInitialized) {
+    AliError(Form("%s: the number of threads cannot be changed after the initialization of the task", GetName()));
+    return;
+  }
+
+  if (n < 1) {
+    AliWarning(Form("%s: invalid number of threads %d, using 1", GetName(), n));
+    n = 1;
+  }
+
+  fNumberOfThreads = n;
 }
 
 /**
@@ -200,6 +289,7 @@ Bool_t AliEmcalJetTask::Run()
   InitEvent();
   // clear the jet array (normally a null operation)
   fJets->Delete();
+  for (UInt_t i = 0; i < fExtraJets.size(); i++) fExtraJets[i]->Delete();
   Int_t n = FindJets();
 
   if (n == 0) return kFALSE;
@@ -213,7 +303,7 @@ Bool_t AliEmcalJetTask::Run()
  * This method steers the jet finding. It first loops over all particle and cluster containers
  * that were provided when the task was initialized. All accepted objects (tracks, particle, clusters)
  * are added as input vectors to the FastJet wrapper. Then the jet finding is launched
- * in the wrapper.
+ * in the wrapper (in the wrappers of all jet definitions, see RunJetDefinitions()).
  * @return Total number of jets found.
  */
 Int_t AliEmcalJetTask::FindJets()
@@ -266,23 +356,75 @@ Int_t AliEmcalJetTask::FindJets()
 
   if (fFastJetWrapper.GetInputVectors().size() == 0) return 0;
 
+  if (!fExtraFastJetWrappers.empty()) return RunJetDefinitions();
+
   // run jet finder
   fFastJetWrapper.Run();
 
   return fFastJetWrapper.GetInclusiveJets().size();
 }
 
+/**
+ * This method runs the jet finding for the main and the additional jet definitions.
+ * The input vectors of the main wrapper are copied to the other wrappers and
+ * the ghosts are generated once for all of them. The clustering is distributed
+ * over fNumberOfThreads threads; each wrapper is only used by a single thread.
+ * @return Total number of jets found.
+ */
+Int_t AliEmcalJetTask::RunJetDefinitions()
+{
+  // the ghosts have to be generated on this thread (fastjet random generator)
+  Double_t ghostArea = fFastJetWrapper.GenerateGhosts(fGhosts);
+
+  std::vector<AliFJWrapper*> wrappers(1, &fFastJetWrapper);
+  wrappers.insert(wrappers.end(), fExtraFastJetWrappers.begin(), fExtraFastJetWrappers.end());
+
+  for (UInt_t i = 0; i < wrappers.size(); i++) {
+    if (wrappers[i] != &fFastJetWrapper) {
+      wrappers[i]->Clear();
+      wrappers[i]->AddInputVectors(fFastJetWrapper.GetInputVectors());
+    }
+    wrappers[i]->SetExternalGhosts(&fGhosts, ghostArea);
+  }
+
+  RunWrappers(wrappers, fNumberOfThreads);
+
+  Int_t n = 0;
+  for (UInt_t i = 0; i < wrappers.size(); i++) n += wrappers[i]->GetInclusiveJets().size();
+
+  return n;
+}
+
 /**
  * This method fills the jet output branch (TClonesArray) with the jet found by the FastJet
  * wrapper. Before filling the jet branch, the utilities are prepared. Then the utilities are
  * called for each jet and finally after jet finding the terminate method of all utilities is called.
+ * The jet branches of the additional jet definitions are filled afterwards.
  */
 void AliEmcalJetTask::FillJetBranch()
 {
   PrepareUtilities();
 
+  FillJetBranch(fFastJetWrapper, fJets, fRadius, kTRUE);
+
+  TerminateUtilities();
+
+  for (UInt_t i = 0; i < fExtraJets.size(); i++) {
+    FillJetBranch(*fExtraFastJetWrappers[i], fExtraJets[i], fExtraRadii[i], kFALSE);
+  }
+}
+
+/**
+ * This method fills a jet output branch with the jets found by a FastJet wrapper.
+ * @param fjw FastJet wrapper
+ * @param jets Jet output branch
+ * @param radius Jet radius, used for the acceptance type
+ * @param utilities If kTRUE the utilities are executed for each jet
+ */
+void AliEmcalJetTask::FillJetBranch(AliFJWrapper& fjw, TClonesArray *jets, Double_t radius, Bool_t utilities)
+{
   // loop over fastjet jets
-  std::vector<fastjet::PseudoJet> jets_incl = fFastJetWrapper.GetInclusiveJets();
+  std::vector<fastjet::PseudoJet> jets_incl = fjw.GetInclusiveJets();
   // sort jets according to jet pt
   static Int_t indexes[9999] = {-1};
   GetSortedArray(indexes, jets_incl);
@@ -290,27 +432,27 @@ void AliEmcalJetTask::FillJetBranch()
   AliDebug(1,Form("%d jets found", (Int_t)jets_incl.size()));
   for (UInt_t ijet = 0, jetCount = 0; ijet < jets_incl.size(); ++ijet) {
     Int_t ij = indexes[ijet];
-    AliDebug(3,Form("Jet pt = %f, area = %f", jets_incl[ij].perp(), fFastJetWrapper.GetJetArea(ij)));
+    AliDebug(3,Form("Jet pt = %f, area = %f", jets_incl[ij].perp(), fjw.GetJetArea(ij)));
 
     if (jets_incl[ij].perp() < fMinJetPt) continue;
-    if (fFastJetWrapper.GetJetArea(ij) < fMinJetArea) continue;
+    if (fjw.GetJetArea(ij) < fMinJetArea) continue;
     if ((jets_incl[ij].eta() < fJetEtaMin) || (jets_incl[ij].eta() > fJetEtaMax) ||
         (jets_incl[ij].phi() < fJetPhiMin) || (jets_incl[ij].phi() > fJetPhiMax))
       continue;
 
-    AliEmcalJet *jet = new ((*fJets)[jetCount])
+    AliEmcalJet *jet = new ((*jets)[jetCount])
     		          AliEmcalJet(jets_incl[ij].perp(), jets_incl[ij].eta(), jets_incl[ij].phi(), jets_incl[ij].m());
     jet->SetLabel(ij);
 
-    fastjet::PseudoJet area(fFastJetWrapper.GetJetAreaVector(ij));
+    fastjet::PseudoJet area(fjw.GetJetAreaVector(ij));
     jet->SetArea(area.perp());
     jet->SetAreaEta(area.eta());
     jet->SetAreaPhi(area.phi());
     jet->SetAreaE(area.E());
-    jet->SetJetAcceptanceType(FindJetAcceptanceType(jet->Eta(), jet->Phi_0_2pi(), fRadius));
+    jet->SetJetAcceptanceType(FindJetAcceptanceType(jet->Eta(), jet->Phi_0_2pi(), radius));
 
     // Fill constituent info
-    std::vector<fastjet::PseudoJet> constituents(fFastJetWrapper.GetJetConstituents(ij));
+    std::vector<fastjet::PseudoJet> constituents(fjw.GetJetConstituents(ij));
     FillJetConstituents(jet, constituents, constituents);
 
     if (fGeom) {
@@ -321,13 +463,11 @@ void AliEmcalJetTask::FillJetBranch()
         jet->SetAxisInEmcal(kTRUE);
     }
 
-    ExecuteUtilities(jet, ij);
+    if (utilities) ExecuteUtilities(jet, ij);
 
     AliDebug(2,Form("Added jet n. %d, pt = %f, area = %f, constituents = %d", jetCount, jet->Pt(), jet->Area(), jet->GetNumberOfConstituents()));
     jetCount++;
   }
-
-  TerminateUtilities();
 }
 
 /**
@@ -393,6 +533,31 @@ void AliEmcalJetTask::ExecOnce()
     fFastJetWrapper.SetLegacyMode(kTRUE);
   }
 
+  // additional jet definitions
+  for (UInt_t i = 0; i < fExtraJetAlgos.size(); i++) {
+    EJetAlgo_t algo = static_cast<EJetAlgo_t>(fExtraJetAlgos[i]);
+    ERecoScheme_t reco = static_cast<ERecoScheme_t>(fExtraRecombSchemes[i]);
+    TString jetsName = AliJetContainer::GenerateJetName(fJetType, algo, reco, fExtraRadii[i], GetParticleContainer(0), GetClusterContainer(0), fJetsTag);
+
+    if (InputEvent()->FindListObject(jetsName)) {
+      AliError(Form("%s: Object with name %s already in event! Returning", GetName(), jetsName.Data()));
+      return;
+    }
+
+    TClonesArray *jets = new TClonesArray("AliEmcalJet");
+    jets->SetName(jetsName);
+    ::Info("AliEmcalJetTask::ExecOnce", "Jet collection with name '%s' has been added to the event.", jetsName.Data());
+    InputEvent()->AddObject(jets);
+    fExtraJets.push_back(jets);
+
+    AliFJWrapper *fjw = new AliFJWrapper(jetsName, jetsName);
+    fjw->CopySettingsFrom(fFastJetWrapper);
+    fjw->SetR(fExtraRadii[i]);
+    fjw->SetAlgorithm(ConvertToFJAlgo(algo));
+    fjw->SetRecombScheme(ConvertToFJRecoScheme(reco));
+    fExtraFastJetWrappers.push_back(fjw);
+  }
+
   InitUtilities();
 
 
@@ -9,6 +9,8 @@ class TObjArray;
 class AliVEvent;
 class AliEmcalJetUtility;
 
+#include <vector>
+
 #include <AliLog.h>
 
 #include "AliAnalysisTaskEmcal.h"
@@ -41,6 +43,16 @@ namespace fastjet {
  * and its derived classes. Utilities can be added via the AddUtility(AliEmcalJetUtility*) method.
  * All the utilities added in the list will be executed. Users can implement new utilities
  * deriving a new class from AliEmcalJetUtility to interface functionalities of the FastJet contribs.
+ *
+ * Additional jet definitions (jet algorithm, radius, recombination scheme) can be added
+ * via AddJetDefinition(). They are clustered from the same input vectors and the same ghosts,
+ * which are built only once per event, and each of them is written into its own jet collection,
+ * named as if it had been produced by a separate jet finder task. The jet type, the constituents,
+ * the ghost area and the jet cuts are shared by all definitions; the utilities are only applied to
+ * the main definition. The clustering of the definitions can be distributed over several threads
+ * via SetNumberOfThreads(); the output does not depend on the number of threads. If the jet finding
+ * draws from the random generator of fastjet (event-wise constituent subtraction, plugins), the
+ * definitions are clustered serially.
  */
 class AliEmcalJetTask : public AliAnalysisTaskEmcal {
  public:
@@ -80,6 +92,8 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   void                   SetMinJetClusE(Double_t min);
   void                   SetMinJetTrackPt(Double_t min);
   void                   SetPhiRange(Double_t pmi, Double_t pma);
+  void                   AddJetDefinition(EJetAlgo_t algo, Double_t radius, ERecoScheme_t reco);
+  void                   SetNumberOfThreads(Int_t n);
 
   AliEmcalJetUtility*    AddUtility(AliEmcalJetUtility* utility);
 
@@ -98,8 +112,11 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Double_t               GetRadius()                      { return fRadius            ; }
   Int_t                  GetRecombScheme()                { return fRecombScheme      ; }
   Double_t               GetTrackEfficiency()             { return fTrackEfficiency   ; }
+  Int_t                  GetNumberOfThreads()             { return fNumberOfThreads   ; }
+  Int_t                  GetNumberOfExtraJetDefinitions() { return fExtraJetAlgos.size(); }
 
   TClonesArray*          GetJets()                        { return fJets              ; }
+  TClonesArray*          GetExtraJets(UInt_t i)           { return i < fExtraJets.size() ? fExtraJets[i] : 0; }
   TObjArray*             GetUtilities()                   { return fUtilities         ; }
 
   void                   FillJetConstituents(AliEmcalJet *jet, std::vector<fastjet::PseudoJet>& constituents,
@@ -136,7 +153,9 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
  protected:
 
   Int_t                  FindJets();
+  Int_t                  RunJetDefinitions();
   void                   FillJetBranch();
+  void                   FillJetBranch(AliFJWrapper& fjw, TClonesArray *jets, Double_t radius, Bool_t utilities);
   void                   ExecOnce();
   void                   InitEvent();
   void                   InitUtilities();
@@ -165,6 +184,10 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   Double_t               fTrackEfficiency;        // artificial tracking inefficiency (0...1)
   TObjArray             *fUtilities;              // jet utilities (gen subtractor, constituent subtractor etc.)
   Bool_t                 fLocked;                 // true if lock is set
+  std::vector<Int_t>     fExtraJetAlgos;          // jet algorithms of the additional jet definitions
+  std::vector<Double_t>  fExtraRadii;             // radii of the additional jet definitions
+  std::vector<Int_t>     fExtraRecombSchemes;     // recombination schemes of the additional jet definitions
+  Int_t                  fNumberOfThreads;        // number of threads for the clustering of the jet definitions
 
   TString                fJetsName;               //!name of jet collection
   Bool_t                 fIsInit;                 //!=true if already initialized
@@ -175,6 +198,9 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
 
   TClonesArray          *fJets;                   //!jet collection
   AliFJWrapper           fFastJetWrapper;         //!fastjet wrapper
+  std::vector<AliFJWrapper*> fExtraFastJetWrappers; //!fastjet wrappers of the additional jet definitions
+  std::vector<TClonesArray*> fExtraJets;          //!jet collections of the additional jet definitions
+  std::vector<fastjet::PseudoJet> fGhosts;        //!ghosts shared by all jet definitions
 
   static const Int_t     fgkConstIndexShift;      //!contituent index shift
 
@@ -183,7 +209,7 @@ class AliEmcalJetTask : public AliAnalysisTaskEmcal {
   AliEmcalJetTask &operator=(const AliEmcalJetTask&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalJetTask, 23);
+  ClassDef(AliEmcalJetTask, 24);
   /// \endcond
 };
 #endif
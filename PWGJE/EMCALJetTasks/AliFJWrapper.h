@@ -25,6 +25,8 @@ class AliFJWrapper
   virtual void  ClearMemory();
   virtual void  CopySettingsFrom (const AliFJWrapper& wrapper);
   virtual void  GetMedianAndSigma(Double_t& median, Double_t& sigma, Int_t remove = 0) const;
+  Double_t      GenerateGhosts(std::vector<fastjet::PseudoJet>& ghosts) const;
+  Bool_t        IsRunThreadSafe() const;
   fastjet::ClusterSequenceArea*           GetClusterSequence() const   { return fClustSeq;                 }
   fastjet::ClusterSequence*               GetClusterSequenceSA() const { return fClustSeqSA;               }
   fastjet::ClusterSequenceActiveAreaExplicitGhosts* GetClusterSequenceGhosts() const { return fClustSeqActGhosts; }
@@ -123,6 +125,7 @@ class AliFJWrapper
   void SetMinJetPt(Double_t MinPt) {fMinJetPt=MinPt;}
   void SetEventSub(Bool_t b) {fEventSub = b;}
   void SetMaxDelR(Double_t r)  {fUseMaxDelR = kTRUE; fMaxDelR = r;}
+  void SetExternalGhosts(const std::vector<fastjet::PseudoJet>* ghosts, Double_t ghostArea) { fExternalGhosts = ghosts; fExternalGhostArea = ghostArea; }
 
  protected:
   TString                                fName;               //!
@@ -151,6 +154,9 @@ class AliFJWrapper
   fastjet::ClusterSequenceArea          *fClustSeqES;           //!
   fastjet::ClusterSequence              *fClustSeqSA;                //!
   fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqActGhosts; //!
+  fastjet::ClusterSequenceActiveAreaExplicitGhosts *fClustSeqExtGhosts; //! cluster sequence with the external ghosts
+  const std::vector<fastjet::PseudoJet>  *fExternalGhosts;    //! ghosts shared with other wrappers (not owned)
+  Double_t                               fExternalGhostArea;  //! area of the external ghosts
   fastjet::Strategy                      fStrategy;           //!
   fastjet::JetAlgorithm                  fAlgor;              //!
   fastjet::RecombinationScheme           fScheme;             //!
@@ -208,6 +214,7 @@ class AliFJWrapper
   std::vector<double>                      fGRDenominatorSub; //!
 
   virtual void   SubtractBackground(const Double_t median_pt = -1);
+  const fastjet::ClusterSequenceAreaBase* GetAreaSequence() const;
 
  private:
   AliFJWrapper();
@@ -251,6 +258,9 @@ AliFJWrapper::AliFJWrapper(const char *name, const char *title)
   , fClustSeqES        (0)
   , fClustSeqSA        (0)
   , fClustSeqActGhosts (0)
+  , fClustSeqExtGhosts (0)
+  , fExternalGhosts    (0)
+  , fExternalGhostArea (0)
   , fStrategy          (fj::Best)
   , fAlgor             (fj::kt_algorithm)
   , fScheme            (fj::BIpt_scheme)
@@ -325,6 +335,7 @@ void AliFJWrapper::ClearMemory()
   if (fClustSeqES)          { delete fClustSeqES;        fClustSeqES        = NULL; }
   if (fClustSeqSA)        { delete fClustSeqSA;        fClustSeqSA        = NULL; }
   if (fClustSeqActGhosts) { delete fClustSeqActGhosts; fClustSeqActGhosts = NULL; }
+  if (fClustSeqExtGhosts) { delete fClustSeqExtGhosts; fClustSeqExtGhosts = NULL; }
   #ifdef FASTJET_VERSION
   if (fBkrdEstimator)          { delete fBkrdEstimator; fBkrdEstimator = NULL; }
   if (fGenSubtractor)          { delete fGenSubtractor; fGenSubtractor = NULL; }
@@ -474,7 +485,7 @@ Double_t AliFJWrapper::GetJetArea(UInt_t idx) const
 
   Double_t retval = -1; // really wrong area..
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->area(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -514,7 +525,7 @@ fastjet::PseudoJet AliFJWrapper::GetJetAreaVector(UInt_t idx) const
   // Get the jet area as vector.
   fastjet::PseudoJet retval;
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->area_4vector(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->area_4vector(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetArea wrong index: %d",idx));
   }
@@ -581,7 +592,7 @@ AliFJWrapper::GetJetConstituents(UInt_t idx) const
   std::vector<fastjet::PseudoJet> retval;
 
   if ( idx < fInclusiveJets.size() ) {
-    retval = fClustSeq->constituents(fInclusiveJets[idx]);
+    retval = GetAreaSequence()->constituents(fInclusiveJets[idx]);
   } else {
     AliError(Form("[e] ::GetJetConstituents wrong index: %d",idx));
   }
@@ -630,7 +641,8 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   // Get the median and sigma from fastjet.
   // User can also do it on his own because the cluster sequence is exposed (via a getter)
 
-  if (!fClustSeq) {
+  const fj::ClusterSequenceAreaBase *clustSeq = GetAreaSequence();
+  if (!clustSeq) {
     AliError("[e] Run the jfinder first.");
     return;
   }
@@ -638,11 +650,11 @@ void AliFJWrapper::GetMedianAndSigma(Double_t &median, Double_t &sigma, Int_t re
   Double_t mean_area = 0;
   try {
     if(0 == remove) {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      clustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }  else {
-      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(fClustSeq->inclusive_jets());
+      std::vector<fastjet::PseudoJet> input_jets = sorted_by_pt(clustSeq->inclusive_jets());
       input_jets.erase(input_jets.begin(), input_jets.begin() + remove);
-      fClustSeq->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
+      clustSeq->get_median_rho_and_sigma(input_jets, *fRange, fUseArea4Vector, median, sigma, mean_area);
       input_jets.clear();
     }
   } catch (fj::Error) {
@@ -707,7 +719,12 @@ Int_t AliFJWrapper::Run()
   }
 
   try {
-    fClustSeq = new fj::ClusterSequenceArea(fInputVectors, *fJetDef, *fAreaDef);
+    if (fExternalGhosts && fAreaType == fj::active_area_explicit_ghosts) {
+      // same ghosts as the other wrappers sharing them, see GenerateGhosts
+      fClustSeqExtGhosts = new fj::ClusterSequenceActiveAreaExplicitGhosts(fInputVectors, *fJetDef, *fExternalGhosts, fExternalGhostArea);
+    } else {
+      fClustSeq = new fj::ClusterSequenceArea(fInputVectors, *fJetDef, *fAreaDef);
+    }
     if(fEventSub){
       DoEventConstituentSubtraction();
       fClustSeqES = new fj::ClusterSequenceArea(fEventSubCorrectedVectors, *fJetDef, *fAreaDef);
@@ -727,12 +744,59 @@ Int_t AliFJWrapper::Run()
   // inclusive jets:
   fInclusiveJets.clear();
   fEventSubJets.clear();
-  fInclusiveJets = fClustSeq->inclusive_jets(0.0);
+  fInclusiveJets = GetAreaSequence()->inclusive_jets(0.0);
   if(fEventSub) fEventSubJets  = fClustSeqES->inclusive_jets(0.0);
 
   return 0;
 }
 
+//_________________________________________________________________________________________________
+Double_t AliFJWrapper::GenerateGhosts(std::vector<fastjet::PseudoJet>& ghosts) const
+{
+  // Generate the ghosts of the active area with the current settings and
+  // return the area of a ghost.
+  // Several wrappers can share the same ghosts (see SetExternalGhosts), so that
+  // they are placed only once per event. The ghosts are drawn from the
+  // random generator of fastjet, which is not thread safe.
+
+  fj::GhostedAreaSpec ghostSpec(fMaxRap,
+                                fNGhostRepeats,
+                                fGhostArea,
+                                fGridScatter,
+                                fKtScatter,
+                                fMeanGhostKt);
+
+  ghosts.clear();
+  ghostSpec.add_ghosts(ghosts);
+
+  return ghostSpec.actual_ghost_area();
+}
+
+//_________________________________________________________________________________________________
+Bool_t AliFJWrapper::IsRunThreadSafe() const
+{
+  // Whether Run() can be called concurrently with the Run() of other wrappers.
+  // This is only the case if it does not draw from the (global) random
+  // generator of fastjet, i.e. with external explicit ghosts or Voronoi areas,
+  // without event-wise constituent subtraction (which clusters with ghosts
+  // generated by fastjet) and without plugins.
+
+  if (fEventSub) return kFALSE;
+  if (fAlgor == fj::plugin_algorithm) return kFALSE;
+  if (fAreaType == fj::voronoi_area) return kTRUE;
+  return (fExternalGhosts && fAreaType == fj::active_area_explicit_ghosts);
+}
+
+//_________________________________________________________________________________________________
+const fastjet::ClusterSequenceAreaBase* AliFJWrapper::GetAreaSequence() const
+{
+  // Cluster sequence of the last Run(), with the ghosts generated by fastjet
+  // or the external ghosts.
+
+  if (fClustSeqExtGhosts) return fClustSeqExtGhosts;
+  return fClustSeq;
+}
+
 //_________________________________________________________________________________________________
 Int_t AliFJWrapper::Filter()
 {
@@ -806,7 +870,7 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   // check what was specified (default is -1)
   if (median_pt < 0) {
     try {
-      fClustSeq->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
+      GetAreaSequence()->get_median_rho_and_sigma(*fRange, fUseArea4Vector, median, sigma, mean_area);
     }
 
     catch (fj::Error) {
@@ -832,13 +896,13 @@ void AliFJWrapper::SubtractBackground(Double_t median_pt)
   for (unsigned i = 0; i < fInclusiveJets.size(); i++) {
     if ( fUseArea4Vector ) {
       // subtract the background using the area4vector
-      fj::PseudoJet area4v = fClustSeq->area_4vector(fInclusiveJets[i]);
+      fj::PseudoJet area4v = GetAreaSequence()->area_4vector(fInclusiveJets[i]);
       fj::PseudoJet jet_sub = fInclusiveJets[i] - area4v * fMedUsedForBgSub;
       fSubtractedJetsPt.push_back(jet_sub.perp()); // here we put only the pt of the jet - note: this can be negative
     } else {
       // subtract the background using scalars
       // fj::PseudoJet jet_sub = fInclusiveJets[i] - area * fMedUsedForBgSub_;
-      Double_t area = fClustSeq->area(fInclusiveJets[i]);
+      Double_t area = GetAreaSequence()->area(fInclusiveJets[i]);
       // standard subtraction
       Double_t pt_sub = fInclusiveJets[i].perp() - fMedUsedForBgSub * area;
       fSubtractedJetsPt.push_back(pt_sub); // here we put only the pt of the jet - note: this can be negative
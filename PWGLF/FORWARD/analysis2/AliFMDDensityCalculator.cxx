@@ -60,7 +60,14 @@ AliFMDDensityCalculator::AliFMDDensityCalculator()
     fDoTiming(false),
     fHTiming(0), 
     fMaxOutliers(0.05),
-    fOutlierCut(0.50)
+    fOutlierCut(0.50),
+    fAccILookup(),
+    fAccOLookup(),
+    fLowCutLookup(),
+    fFitLookup(),
+    fMaxWeightLookup(),
+    fNLookupEta(0),
+    fLookupELossFit(0)
 {
   // 
   // Constructor 
@@ -98,7 +105,14 @@ AliFMDDensityCalculator::AliFMDDensityCalculator(const char* title)
     fDoTiming(false),
     fHTiming(0), 
     fMaxOutliers(0.05),
-    fOutlierCut(0.50)
+    fOutlierCut(0.50),
+    fAccILookup(),
+    fAccOLookup(),
+    fLowCutLookup(),
+    fFitLookup(),
+    fMaxWeightLookup(),
+    fNLookupEta(0),
+    fLookupELossFit(0)
 {
   // 
   // Constructor 
@@ -167,7 +181,14 @@ AliFMDDensityCalculator::AliFMDDensityCalculator(const
     fDoTiming(o.fDoTiming),
     fHTiming(o.fHTiming), 
   fMaxOutliers(o.fMaxOutliers),
-  fOutlierCut(o.fOutlierCut)
+  fOutlierCut(o.fOutlierCut),
+  fAccILookup(),
+  fAccOLookup(),
+  fLowCutLookup(),
+  fFitLookup(),
+  fMaxWeightLookup(),
+  fNLookupEta(0),
+  fLookupELossFit(0)
 {
   // 
   // Copy constructor 
@@ -251,6 +272,7 @@ AliFMDDensityCalculator::SetupForData(const TAxis& axis)
   //   etaAxis   Eta axis
   DGUARD(fDebug, 1, "Initialize FMD density calculator");
   CacheMaxWeights(axis);
+  FillLookups();
  
   fCache.Init(axis);
 
@@ -292,6 +314,15 @@ AliFMDDensityCalculator::GetRingHistos(UShort_t d, Char_t r) const
 }
 
 namespace {
+  Int_t RingIndex(UShort_t d, Char_t r)
+  {
+    switch (d) {
+    case 1: return 0;
+    case 2: return (r=='i' || r=='I') ? 1 : 2;
+    case 3: return (r=='i' || r=='I') ? 3 : 4;
+    }
+    return -1;
+  }
   Double_t Rng2Cut(UShort_t d, Char_t r, Int_t xbin, TH2* h) 
   {
     Double_t ret = 1024;
@@ -411,6 +442,11 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
       UShort_t    nt= (q == 0 ? 512 : 256);
       TH2D*       h = hists.Get(d,r);
       RingHistos* rh= GetRingHistos(d,r);
+      // Per-ring look-ups (see FillLookups)
+      const Float_t*  acc  = (q == 0 ? fAccILookup : fAccOLookup).GetArray();
+      const Double_t* cuts = (fLowCutLookup.GetArray() + 
+			      RingIndex(d,r) * (fLowCuts->GetNbinsX()+2));
+      TAxis*          cutAxis = fLowCuts->GetXaxis();
       if (!rh) { 
 	AliError(Form("No ring histogram found for FMD%d%c", d, r));
 	fRingHistos.ls();
@@ -485,11 +521,11 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 
 	  // --- Apply phi corner correction to eloss ----------------
 	  if (fUsePhiAcceptance == kPhiCorrectELoss) 
-	    mult *= AcceptanceCorrection(r,t);
+	    mult *= acc[t];
 
 	  // --- Get the low multiplicity cut ------------------------
 	  Double_t cut  = 1024;
-	  if (eta != AliESDFMD::kInvalidEta) cut = GetMultCut(d, r, eta,false);
+	  if (eta != AliESDFMD::kInvalidEta) cut = cuts[cutAxis->FindBin(eta)];
 	  else AliWarningF("Eta for FMD%d%c[%02d,%03d] is invalid: %f", 
 			   d, r, s, t, eta);
 
@@ -507,7 +543,7 @@ AliFMDDensityCalculator::Calculate(const AliESDFMD&        fmd,
 	  // Temporary stuff - remove Correction call 
 	  Double_t c = 1;
 	  if (fUsePhiAcceptance == kPhiCorrectNch) 
-	    c = AcceptanceCorrection(r,t);
+	    c = acc[t];
 	  // Double_t c = Correction(d,r,t,eta,lowFlux);
 	  ADD_TIMER(timer,corrTime);
 	  fCorrections->Fill(c);
@@ -773,6 +809,52 @@ AliFMDDensityCalculator::CacheMaxWeights(const TAxis& axis)
   fCuts.FillHistogram(fLowCuts);
 }
 
+//_____________________________________________________________________
+void
+AliFMDDensityCalculator::FillLookups()
+{
+  // 
+  // Fill the per-ring look-up tables used for every strip in
+  // Calculate.  The tables hold exactly what AcceptanceCorrection,
+  // GetMultCut, and the fit and maximum weight searches of NParticles
+  // return, so the per-strip work is reduced to finding the eta bins. 
+  // 
+  DGUARD(fDebug, 2, "Fill look-up tables in FMD density calculator");
+  const UShort_t ds[] = { 1, 2, 2, 3, 3 };
+  const Char_t   rs[] = { 'I', 'I', 'O', 'I', 'O' };
+
+  // Phi acceptance per strip 
+  fAccILookup.Set(512);
+  fAccOLookup.Set(256);
+  for (UShort_t t = 0; t < 512; t++) fAccILookup[t] = AcceptanceCorrection('I',t);
+  for (UShort_t t = 0; t < 256; t++) fAccOLookup[t] = AcceptanceCorrection('O',t);
+
+  // Low cuts, including under- and overflow bins 
+  Int_t nCut = fLowCuts->GetNbinsX()+2;
+  fLowCutLookup.Set(5*nCut);
+  for (Int_t i = 0; i < 5; i++) 
+    for (Int_t b = 0; b < nCut; b++) 
+      fLowCutLookup[i*nCut+b] = Rng2Cut(ds[i], rs[i], b, fLowCuts);
+
+  // Energy loss fits and maximum weights, by AliFMDCorrELossFit::FindEtaBin
+  AliForwardCorrectionManager&  fcm = AliForwardCorrectionManager::Instance();
+  const AliFMDCorrELossFit*     cor = fcm.GetELossFit();
+  fLookupELossFit = cor;
+  fNLookupEta     = 0;
+  if (!cor) return;
+  fNLookupEta     = cor->GetEtaAxis().GetNbins();
+  Int_t nFit      = fNLookupEta+1;
+  fFitLookup.Clear();
+  fFitLookup.Expand(5*nFit);
+  fMaxWeightLookup.Set(5*nFit);
+  for (Int_t i = 0; i < 5; i++) { 
+    for (Int_t b = 0; b < nFit; b++) { 
+      fFitLookup.AddAt(cor->FindFit(ds[i], rs[i], b, -1), i*nFit+b);
+      fMaxWeightLookup[i*nFit+b] = GetMaxWeight(ds[i], rs[i], b-1);
+    }
+  }
+}
+
 //_____________________________________________________________________
 Int_t
 AliFMDDensityCalculator::GetMaxWeight(UShort_t d, Char_t r, Int_t iEta) const
@@ -864,14 +946,29 @@ AliFMDDensityCalculator::NParticles(Float_t  mult,
   if (lowFlux) return 1;
   
   AliForwardCorrectionManager&  fcm = AliForwardCorrectionManager::Instance();
-  AliFMDCorrELossFit::ELossFit* fit = fcm.GetELossFit()->FindFit(d,r,eta, -1);
+  const AliFMDCorrELossFit*     cor = fcm.GetELossFit();
+  AliFMDCorrELossFit::ELossFit* fit = 0;
+  Int_t                         m   = -1;
+  Int_t                         iR  = RingIndex(d,r);
+  if (cor == fLookupELossFit && fNLookupEta > 0 && iR >= 0) {
+    // Fit and maximum weight from the look-ups (see FillLookups)
+    Int_t bin = cor->FindEtaBin(eta);
+    if (bin >= 0) { 
+      Int_t idx = iR * (fNLookupEta+1) + bin;
+      fit = static_cast<AliFMDCorrELossFit::ELossFit*>(fFitLookup.UncheckedAt(idx));
+      m   = fMaxWeightLookup[idx];
+    }
+  }
+  else { 
+    fit = cor->FindFit(d,r,eta, -1);
+    if (fit) m = GetMaxWeight(d,r,eta); // fit->FindMaxWeight();
+  }
   if (!fit) { 
     AliWarning(Form("No energy loss fit for FMD%d%c at eta=%f qual=%d", 
 		    d, r, eta, fMinQuality));
     return 0;
   }
   
-  Int_t    m   = GetMaxWeight(d,r,eta); // fit->FindMaxWeight();
   if (m < 1) { 
     AliWarning(Form("No good fits for FMD%d%c at eta=%f", d, r, eta));
     return 0;
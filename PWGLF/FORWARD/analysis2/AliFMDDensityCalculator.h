@@ -16,6 +16,9 @@
 #include <TNamed.h>
 #include <TList.h>
 #include <TArrayI.h>
+#include <TArrayF.h>
+#include <TArrayD.h>
+#include <TObjArray.h>
 #include <TVector3.h>
 #include "AliForwardUtil.h"
 #include "AliFMDMultCuts.h"
@@ -297,6 +300,14 @@ protected:
    * @param axis Default @f$\eta@f$ axis from parent task 
    */  
   void CacheMaxWeights(const TAxis& axis);
+  /** 
+   * Fill the per-ring look-up tables used for each strip in
+   * Calculate: the @f$\varphi@f$ acceptance per strip, the low cut
+   * per @f$\eta@f$ bin of the low cut histogram, and the energy loss
+   * fit and maximum weight per @f$\eta@f$ bin of the energy loss fits.
+   * Must be called after CacheMaxWeights.
+   */
+  void FillLookups();
   /** 
    * Find the (cached) maximum weight for FMD<i>dr</i> in 
    * @f$\eta@f$ bin @a iEta
@@ -504,6 +515,13 @@ protected:
   TProfile*              fHTiming;
   Double_t               fMaxOutliers; // Maximum ratio of outlier bins 
   Double_t               fOutlierCut;  // Maximum relative diviation 
+  TArrayF    fAccILookup;      //! Phi acceptance per strip, inner rings
+  TArrayF    fAccOLookup;      //! Phi acceptance per strip, outer rings
+  TArrayD    fLowCutLookup;    //! Low cut per ring and low cut eta bin
+  TObjArray  fFitLookup;       //! Energy loss fit per ring and eta bin
+  TArrayI    fMaxWeightLookup; //! Maximum weight per ring and eta bin
+  Int_t      fNLookupEta;      //! Number of energy loss fit eta bins
+  const AliFMDCorrELossFit* fLookupELossFit; //! Fits of the look-ups
 
   ClassDef(AliFMDDensityCalculator,16); // Calculate Nch density 
 };
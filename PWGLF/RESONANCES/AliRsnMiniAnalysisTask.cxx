@@ -14,6 +14,10 @@
 //
 
 #include <Riostream.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <vector>
 
 #include <TH1.h>
 #include <TList.h>
@@ -51,6 +55,134 @@
 
 ClassImp(AliRsnMiniAnalysisTask)
 
+namespace {
+//
+// Index of the buffered mini-events for the search of mixing partners.
+// Events are grouped in cells of (vz, mult, angle) such that all partners
+// of an event are in its own cell (binned mixing) or in the neighbouring
+// cells (continuous mixing, cells slightly larger than the max differences).
+// In continuous mixing, events with non-finite values are candidates for all
+// events. The events of each cell are sorted by ID, and the candidates are
+// returned in the same cyclic order (ievt+1, ..., nEvents-1, 0, ..., ievt-1)
+// as a scan of the whole buffer, so that the matches do not change.
+//
+class AliRsnMixingIndex {
+public:
+   typedef std::array<Long64_t, 3> CellKey_t;
+
+   AliRsnMixingIndex(Int_t nEvents, const Float_t *values[3], const Double_t maxDiff[3], Bool_t continuous) :
+      fN(nEvents), fContinuous(continuous), fCellOf(nEvents), fWildEvent(nEvents, kFALSE), fCells(), fWild(),
+      fCurrent(-1), fScanAll(kFALSE), fNext(0), fLists(), fStart(), fCount()
+   {
+      Bool_t useDim[3];
+      Double_t width[3];
+      for (Int_t d = 0; d < 3; d++) {
+         width[d] = maxDiff[d] * (1.0 + 1E-6);
+         Double_t min = 0.0, max = 0.0;
+         Bool_t first = kTRUE;
+         for (Int_t i = 0; i < fN; i++) {
+            if (!TMath::Finite(values[d][i])) continue;
+            if (first || values[d][i] < min) min = values[d][i];
+            if (first || values[d][i] > max) max = values[d][i];
+            first = kFALSE;
+         }
+         useDim[d] = (maxDiff[d] > 0.0 && TMath::Finite(width[d]) && (max - min) / width[d] < 1E8);
+      }
+      for (Int_t i = 0; i < fN; i++) {
+         CellKey_t key = {{0, 0, 0}};
+         for (Int_t d = 0; d < 3; d++) {
+            if (!fContinuous) {
+               // same bin definition as in EventsMatch
+               key[d] = (Int_t)(values[d][i] / maxDiff[d]);
+            } else if (!TMath::Finite(values[d][i])) {
+               fWildEvent[i] = kTRUE;
+            } else if (useDim[d]) {
+               key[d] = (Long64_t)TMath::Floor(values[d][i] / width[d]);
+            }
+         }
+         fCellOf[i] = key;
+         if (fWildEvent[i]) fWild.push_back(i);
+         else fCells[key].push_back(i);
+      }
+      for (Int_t d = 0; d < 3; d++) fUseDim[d] = fContinuous && useDim[d];
+   }
+
+   // start the list of candidates for event ievt
+   void Begin(Int_t ievt)
+   {
+      fCurrent = ievt;
+      fScanAll = fWildEvent[ievt];
+      fNext = 1;
+      fLists.clear();
+      fStart.clear();
+      fCount.clear();
+      if (fScanAll) return;
+      const CellKey_t &key = fCellOf[ievt];
+      Int_t lo[3], hi[3];
+      for (Int_t d = 0; d < 3; d++) {
+         lo[d] = fUseDim[d] ? -1 : 0;
+         hi[d] = fUseDim[d] ? 1 : 0;
+      }
+      for (Int_t i0 = lo[0]; i0 <= hi[0]; i0++) {
+         for (Int_t i1 = lo[1]; i1 <= hi[1]; i1++) {
+            for (Int_t i2 = lo[2]; i2 <= hi[2]; i2++) {
+               CellKey_t cell = {{key[0] + i0, key[1] + i1, key[2] + i2}};
+               std::map<CellKey_t, std::vector<Int_t> >::const_iterator it = fCells.find(cell);
+               if (it != fCells.end()) AddList(&(it->second));
+            }
+         }
+      }
+      if (!fWild.empty()) AddList(&fWild);
+   }
+
+   // next candidate in cyclic order, -1 when all were returned
+   Int_t Next()
+   {
+      if (fScanAll) {
+         if (fNext >= fN) return -1;
+         return (fCurrent + fNext++) % fN;
+      }
+      Int_t best = -1, bestDist = fN, bestID = -1;
+      for (UInt_t l = 0; l < fLists.size(); l++) {
+         const std::vector<Int_t> &list = *fLists[l];
+         if (fCount[l] >= (Int_t)list.size()) continue;
+         Int_t id = list[(fStart[l] + fCount[l]) % list.size()];
+         Int_t dist = (id - fCurrent - 1 + fN) % fN;
+         if (dist < bestDist) {
+            best = l;
+            bestDist = dist;
+            bestID = id;
+         }
+      }
+      if (best < 0) return -1;
+      fCount[best]++;
+      return bestID;
+   }
+
+private:
+   void AddList(const std::vector<Int_t> *list)
+   {
+      fLists.push_back(list);
+      fStart.push_back(std::lower_bound(list->begin(), list->end(), fCurrent + 1) - list->begin());
+      fCount.push_back(0);
+   }
+
+   Int_t                                      fN;           // number of events
+   Bool_t                                     fContinuous;  // continuous or binned mixing
+   Bool_t                                     fUseDim[3];   // dimensions split in cells (continuous mixing)
+   std::vector<CellKey_t>                     fCellOf;      // cell of each event
+   std::vector<Bool_t>                        fWildEvent;   // event with non-finite values (continuous mixing)
+   std::map<CellKey_t, std::vector<Int_t> >   fCells;       // events of each cell, by ID
+   std::vector<Int_t>                         fWild;        // events with non-finite values, by ID
+   Int_t                                      fCurrent;     // event whose candidates are returned
+   Bool_t                                     fScanAll;     // all events are candidates
+   Int_t                                      fNext;        // cyclic distance of next candidate (fScanAll)
+   std::vector<const std::vector<Int_t> *>    fLists;       // cells with candidates
+   std::vector<Int_t>                         fStart;       // first candidate after the current event in each cell
+   std::vector<Int_t>                         fCount;       // candidates already returned from each cell
+};
+}
+
 //__________________________________________________________________________________________________
 AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
    AliAnalysisTaskSE(),
@@ -480,7 +612,7 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // prepare variables
    Int_t ievt, nEvents = (Int_t)fEvBuffer->GetEntries();
    Int_t idef, nDefs   = fHistograms.GetEntries();
-   Int_t imix, iloop, ifill;
+   Int_t imix, ifill;
    AliRsnMiniOutput *def = 0x0;
    AliRsnMiniOutput::EComputation compType;
 
@@ -495,10 +627,16 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // using the appropriate procedure depending on its type
    // only mother-related histograms are filled in UserExec,
    // since they require direct access to MC event
+   // the values used for the mixing are kept, to search for the
+   // matchings without reading the events again
+   std::vector<Float_t> evVz(nEvents + 1), evMult(nEvents + 1), evAngle(nEvents + 1);
    timer.Start();
    for (ievt = 0; ievt < nEvents; ievt++) {
       // get next entry
       fEvBuffer->GetEntry(ievt);
+      evVz[ievt] = fMiniEvent->Vz();
+      evMult[ievt] = fMiniEvent->Mult();
+      evAngle[ievt] = fMiniEvent->Angle();
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] Std.Event %d/%d",GetName(), ievt,nEvents));
          timer.Stop(); timer.Print(); fflush(stdout); timer.Start(kFALSE);
@@ -548,82 +686,95 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       return;
    }
 
-   // initialize mixing counter
-   Int_t    nmatched[nEvents];
-   TString *smatched = new TString[nEvents];
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      smatched[ievt] = "|";
-      nmatched[ievt] = 0;
-   }
-
+   // initialize mixing counter and table of matches
+   std::vector<Int_t> nmatched(nEvents, 0);
+   std::vector< std::vector<Int_t> > matches(nEvents);
 
    AliInfo(Form("[%s] Std.Event %d/%d",GetName(), nEvents,nEvents));
    timer.Stop(); timer.Print(); timer.Start(); fflush(stdout);
 
-   // search for good matchings
+   // search for good matchings, among the candidates given by the index
+   // in the same order as a scan of the full buffer
+   const Float_t *evValues[3] = {&evVz[0], &evMult[0], &evAngle[0]};
+   const Double_t maxDiff[3] = {fMaxDiffVz, fMaxDiffMult, fMaxDiffAngle};
+   AliRsnMixingIndex mixIndex(nEvents, evValues, maxDiff, fContinuousMix);
    for (ievt = 0; ievt < nEvents; ievt++) {
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
       if (nmatched[ievt] >= fNMix) continue;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      for (iloop = 1; iloop < nEvents; iloop++) {
-         imix = ievt + iloop;
-         if (imix >= nEvents) imix -= nEvents;
+      mixIndex.Begin(ievt);
+      while ((imix = mixIndex.Next()) >= 0) {
          if (imix == ievt) continue;
-         // text next entry
-         fEvBuffer->GetEntry(imix);
          // skip if events are not matched
-         if (!EventsMatch(&evMain, fMiniEvent)) continue;
+         if (!EventsMatch(evVz[ievt], evMult[ievt], evAngle[ievt], evVz[imix], evMult[imix], evAngle[imix])) continue;
          // check that the array of good matches for mixed does not already contain main event
-         if (smatched[imix].Contains(Form("|%d|", ievt))) continue;
+         if (std::find(matches[imix].begin(), matches[imix].end(), ievt) != matches[imix].end()) continue;
          // check that the found good events has not enough matches already
          if (nmatched[imix] >= fNMix) continue;
          // add new mixing candidate
-         smatched[ievt].Append(Form("%d|", imix));
+         matches[ievt].push_back(imix);
          nmatched[ievt]++;
          nmatched[imix]++;
          if (nmatched[ievt] >= fNMix) break;
       }
-      AliDebugClass(1, Form("Matches for event %5d = %d [%s] (missing are declared above)", evMain.ID(), nmatched[ievt], smatched[ievt].Data()));
+      AliDebugClass(1, Form("Matches for event %5d = %d (missing are declared above)", ievt, nmatched[ievt]));
    }
 
    AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
-   TObjArray *list = 0x0;
-   TObjString *os = 0x0;
+   // the partners of an event mostly follow it closely in the buffer, hence the
+   // events are read through a small cache indexed by ID, so that each of them
+   // is read from the buffer about once instead of once per match
+   const Int_t nCache = 128;
+   std::vector<AliRsnMiniEvent *> cache(nCache, (AliRsnMiniEvent *)0x0);
+   std::vector<Int_t> cacheID(nCache, -1);
+   AliRsnMiniEvent *evMain = 0x0, *evMix = 0x0;
+   auto readEvent = [&](Int_t id, Int_t keepSlot) -> AliRsnMiniEvent * {
+      Int_t slot = id % nCache;
+      if (cacheID[slot] == id) return cache[slot];
+      if (slot == keepSlot) {
+         // do not overwrite the main event: use the cursor
+         fEvBuffer->SetBranchAddress("events", &fMiniEvent);
+         fEvBuffer->GetEntry(id);
+         return fMiniEvent;
+      }
+      if (!cache[slot]) cache[slot] = new AliRsnMiniEvent;
+      fEvBuffer->SetBranchAddress("events", &cache[slot]);
+      fEvBuffer->GetEntry(id);
+      cacheID[slot] = id;
+      return cache[slot];
+   };
    for (ievt = 0; ievt < nEvents; ievt++) {
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
       ifill = 0;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      list = smatched[ievt].Tokenize("|");
-      TObjArrayIter next(list);
-      while ( (os = (TObjString *)next()) ) {
-         imix = os->GetString().Atoi();
-         fEvBuffer->GetEntry(imix);
+      if (matches[ievt].empty()) continue;
+      evMain = readEvent(ievt, -1);
+      for (UInt_t im = 0; im < matches[ievt].size(); im++) {
+         imix = matches[ievt][im];
+         evMix = readEvent(imix, ievt % nCache);
          for (idef = 0; idef < nDefs; idef++) {
             def = (AliRsnMiniOutput *)fHistograms[idef];
             if (!def) continue;
             if (!def->IsTrackPairMix()) continue;
-            ifill += def->FillPair(&evMain, fMiniEvent, &fValues, kTRUE);
+            ifill += def->FillPair(evMain, evMix, &fValues, kTRUE);
             if (!def->IsSymmetric()) {
                AliDebugClass(2, "Reflecting non symmetric pair");
-               ifill += def->FillPair(fMiniEvent, &evMain, &fValues, kFALSE);
+               ifill += def->FillPair(evMix, evMain, &fValues, kFALSE);
             }
          }
       }
-      delete list;
    }
 
-   delete [] smatched;
+   // detach the buffer from the cache before deleting it
+   fEvBuffer->SetBranchAddress("events", &fMiniEvent);
+   for (Int_t ic = 0; ic < nCache; ic++) delete cache[ic];
 
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
@@ -1418,13 +1569,23 @@ Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEv
 //
 
    if (!event1 || !event2) return kFALSE;
+   return EventsMatch(event1->Vz(), event1->Mult(), event1->Angle(), event2->Vz(), event2->Mult(), event2->Angle());
+}
+
+//__________________________________________________________________________________________________
+Bool_t AliRsnMiniAnalysisTask::EventsMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const
+{
+//
+// Check if two events are compatible, from their values of vz, mult and angle.
+//
+
    Int_t ivz1, ivz2, imult1, imult2, iangle1, iangle2;
    Double_t dv, dm, da;
 
    if (fContinuousMix) {
-      dv = TMath::Abs(event1->Vz()    - event2->Vz()   );
-      dm = TMath::Abs(event1->Mult()  - event2->Mult() );
-      da = TMath::Abs(event1->Angle() - event2->Angle());
+      dv = TMath::Abs(vz1    - vz2   );
+      dm = TMath::Abs(mult1  - mult2 );
+      da = TMath::Abs(angle1 - angle2);
       if (dv > fMaxDiffVz) {
          //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Vz = %f", event1->ID(), event2->ID(), dv));
          return kFALSE;
@@ -1439,12 +1600,12 @@ Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEv
       }
       return kTRUE;
    } else {
-      ivz1 = (Int_t)(event1->Vz() / fMaxDiffVz);
-      ivz2 = (Int_t)(event2->Vz() / fMaxDiffVz);
-      imult1 = (Int_t)(event1->Mult() / fMaxDiffMult);
-      imult2 = (Int_t)(event2->Mult() / fMaxDiffMult);
-      iangle1 = (Int_t)(event1->Angle() / fMaxDiffAngle);
-      iangle2 = (Int_t)(event2->Angle() / fMaxDiffAngle);
+      ivz1 = (Int_t)(vz1 / fMaxDiffVz);
+      ivz2 = (Int_t)(vz2 / fMaxDiffVz);
+      imult1 = (Int_t)(mult1 / fMaxDiffMult);
+      imult2 = (Int_t)(mult2 / fMaxDiffMult);
+      iangle1 = (Int_t)(angle1 / fMaxDiffAngle);
+      iangle2 = (Int_t)(angle2 / fMaxDiffAngle);
       if (ivz1 != ivz2) return kFALSE;
       if (imult1 != imult2) return kFALSE;
       if (iangle1 != iangle2) return kFALSE;
@@ -50,6 +50,7 @@
 #include "TFile.h"
 #include "TMatrixD.h"
 #include "TRandom3.h"
+#include "TROOT.h"
 
 #include "AliHeader.h"  
 #include "AliGenEventHeader.h"  
@@ -117,6 +118,8 @@ ClassImp(AliAnalysisTaskFilteredTree)
   , fProcessAll(kFALSE)
   , fProcessCosmics(kFALSE)
   , fProcessITSTPCmatchOut(kFALSE)  // swittch to process ITS/TPC standalone tracks
+  , fTreeAutoFlush(0)
+  , fTreeImplicitMT(kFALSE)
   , fHighPtTree(0)
   , fV0Tree(0)
   , fdEdxTree(0)
@@ -206,6 +209,12 @@ void AliAnalysisTaskFilteredTree::UserCreateOutputObjects()
   fLaserTree = ((*fTreeSRedirector)<<"Laser").GetTree();
   fMCEffTree = ((*fTreeSRedirector)<<"MCEffTree").GetTree();
   fCosmicPairsTree = ((*fTreeSRedirector)<<"CosmicPairs").GetTree();
+  ConfigureOutputTree(fV0Tree);
+  ConfigureOutputTree(fHighPtTree);
+  ConfigureOutputTree(fdEdxTree);
+  ConfigureOutputTree(fLaserTree);
+  ConfigureOutputTree(fMCEffTree);
+  ConfigureOutputTree(fCosmicPairsTree);
 
   if (!fDummyTrack)  {
     fDummyTrack=new AliESDtrack();
@@ -2523,6 +2532,29 @@ Bool_t AliAnalysisTaskFilteredTree::IsFromStrangeness(Int_t label, AliStack *con
 }
 
 
+//_____________________________________________________________________________
+void AliAnalysisTaskFilteredTree::ConfigureOutputTree(TTree *tree)
+{
+  //
+  // Set the writing options of an output tree: the number of entries (>0)
+  // or bytes (<0) after which the baskets are flushed, and the parallel
+  // compression of the baskets at each flush. The latter needs ROOT built
+  // with imt and the implicit MT pool enabled by the job, e.g. with
+  // ROOT::EnableImplicitMT(n) in the steering macro
+  //
+  if (!tree) return;
+  if (fTreeAutoFlush!=0) tree->SetAutoFlush(fTreeAutoFlush);
+  if (fTreeImplicitMT) {
+#if defined(R__USE_IMT) && ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+    tree->SetImplicitMT(kTRUE);
+    if (!ROOT::IsImplicitMTEnabled())
+      AliWarning(Form("implicit MT is not enabled by the job, the baskets of %s are compressed sequentially",tree->GetName()));
+#else
+    AliWarning(Form("parallel basket compression needs ROOT >= 6.10 built with imt, %s is compressed sequentially",tree->GetName()));
+#endif
+  }
+}
+
 //_____________________________________________________________________________
 void AliAnalysisTaskFilteredTree::FinishTaskOutput() 
 {
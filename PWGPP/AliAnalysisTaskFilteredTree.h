@@ -113,9 +113,16 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   void SetFillTrees(Bool_t filltree) { fFillTree = filltree ;}
   Bool_t GetFillTrees() { return fFillTree ;}
 
+  // output tree writing
+  void SetTreeAutoFlush(Long64_t autoFlush) { fTreeAutoFlush = autoFlush; }
+  void SetTreeImplicitMT(Bool_t imt) { fTreeImplicitMT = imt; }
+  Long64_t GetTreeAutoFlush() const { return fTreeAutoFlush; }
+  Bool_t GetTreeImplicitMT() const { return fTreeImplicitMT; }
+
   void FillHistograms(AliESDtrack* const ptrack, AliExternalTrackParam* const ptpcInnerC, Double_t centralityF, Double_t chi2TPCInnerC);
   static void SetDefaultAliasesV0(TTree *treeV0);
  private:
+  void ConfigureOutputTree(TTree *tree);
 
   AliESDEvent *fESD;    //! ESD event
   AliMCEvent *fMC;      //! MC event
@@ -146,6 +153,8 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
   
   Bool_t fProcessCosmics; // look for cosmic pairs from random trigger
   Bool_t fProcessITSTPCmatchOut;  // swittch to process ITS/TPC standalone tracks
+  Long64_t fTreeAutoFlush;  // auto flush of the output trees (TTree::SetAutoFlush), 0: ROOT default
+  Bool_t fTreeImplicitMT;   // compress the baskets of the output trees on the ROOT implicit MT pool (enabled by the job)
 
   TTree* fHighPtTree;       //! list send on output slot 0
   TTree* fV0Tree;           //! list send on output slot 0
@@ -170,7 +179,7 @@ class AliAnalysisTaskFilteredTree : public AliAnalysisTaskSE {
 
   AliAnalysisTaskFilteredTree(const AliAnalysisTaskFilteredTree&); // not implemented
   AliAnalysisTaskFilteredTree& operator=(const AliAnalysisTaskFilteredTree&); // not implemented
-  ClassDef(AliAnalysisTaskFilteredTree, 1); // example of analysis
+  ClassDef(AliAnalysisTaskFilteredTree, 2); // example of analysis
 };
 
 #endif
@@ -17,6 +17,11 @@
 
 #include <TChain.h>
 #include <TFile.h>
+#include <TSystem.h>
+#include <TMap.h>
+#include <TMD5.h>
+#include <TObjArray.h>
+#include <TObjString.h>
  
 #include "AliTender.h"
 #include "AliTenderSupply.h"
@@ -41,7 +46,11 @@ AliTender::AliTender():
            fESDhandler(NULL),
            fESD(NULL),
            fSupplies(NULL),
-           fCDBSettings(NULL)
+           fCDBSettings(NULL),
+           fCDBSnapshotDir(),
+           fCDBSnapshot(),
+           fCDBSnapshotPending(kFALSE),
+           fCDBSnapshotRun(0)
 {
 // Dummy constructor
 }
@@ -58,7 +67,11 @@ AliTender::AliTender(const char* name):
            fESDhandler(NULL),
            fESD(NULL),
            fSupplies(NULL),
-           fCDBSettings(NULL)
+           fCDBSettings(NULL),
+           fCDBSnapshotDir(),
+           fCDBSnapshot(),
+           fCDBSnapshotPending(kFALSE),
+           fCDBSnapshotRun(0)
 {
 // Default constructor
   DefineOutput(1,  AliESDEvent::Class());
@@ -123,13 +136,19 @@ void AliTender::ConnectInputData(Option_t* option)
     fCDB->SetDefaultStorage(fDefaultStorage);
     // Unlock CDB
     fCDBkey = fCDB->SetLock(kFALSE, fCDBkey);
-    if(run){ fCDB->SetRun(fRun); }
+    if(run) fCDB->SetRun(fRun);
     // Lock CDB
     fCDBkey = fCDB->SetLock(kTRUE, fCDBkey);
   }
   TIter next(fSupplies);
   AliTenderSupply *supply;
   while ((supply=(AliTenderSupply*)next())) supply->Init();
+  // The snapshot depends on the specific storages set by the supplies
+  if(fHandleCDB && run && !fCDBSnapshotDir.IsNull()){
+    fCDBkey = fCDB->SetLock(kFALSE, fCDBkey);
+    SwitchCDBSnapshot();
+    fCDBkey = fCDB->SetLock(kTRUE, fCDBkey);
+  }
 }
 
 //______________________________________________________________________________
@@ -162,18 +181,14 @@ void AliTender::UserExec(Option_t* option)
     fRunChanged = kTRUE;
     fRun = fESD->GetRunNumber();
     fCDB = AliCDBManager::Instance();
-    if(fHandleCDB){
-      // Unlock CDB
-      fCDBkey = fCDB->SetLock(kFALSE, fCDBkey);
-      fCDB->SetRun(fRun);
-      // Lock CDB
-      fCDBkey = fCDB->SetLock(kTRUE, fCDBkey);
-    } 
+    if(fHandleCDB) SetCDBRun(fRun);
   }
   TIter next(fSupplies);
   AliTenderSupply *supply;
   while ((supply=(AliTenderSupply*)next())) supply->ProcessEvent();
   fRunChanged = kFALSE;
+  // The snapshot is written only for runs with processed events
+  SetCDBRunProcessed();
 
   if (TObject::TestBit(kCheckEventSelection)) fESDhandler->CheckSelectionMask();
 
@@ -181,9 +196,119 @@ void AliTender::UserExec(Option_t* option)
   if (!opt.Contains("NoPost")) PostData(1, fESD);
 }
 
+//______________________________________________________________________________
+void AliTender::FinishTaskOutput()
+{
+// Write the snapshot of the last run, with all objects loaded during the job
+   if (!fCDBSnapshotPending || !fCDB) return;
+   fCDBkey = fCDB->SetLock(kFALSE, fCDBkey);
+   WriteCDBSnapshot();
+   fCDBkey = fCDB->SetLock(kTRUE, fCDBkey);
+}
+
+//______________________________________________________________________________
+void AliTender::SetCDBRun(Int_t run)
+{
+// Move the CDB manager to a new run. The snapshot of the previous run is
+// written first, since the objects of the run are dropped from the cache.
+   fRun = run;
+   fCDB = AliCDBManager::Instance();
+   // Unlock CDB
+   fCDBkey = fCDB->SetLock(kFALSE, fCDBkey);
+   if (fCDBSnapshotPending) WriteCDBSnapshot();
+   fCDB->SetRun(fRun);
+   SwitchCDBSnapshot();
+   // Lock CDB
+   fCDBkey = fCDB->SetLock(kTRUE, fCDBkey);
+}
+
 //______________________________________________________________________________
 void AliTender::SetDefaultCDBStorage(const char *dbString)
 {
 // Set default CDB storage
    fDefaultStorage = dbString;
 }
+
+//______________________________________________________________________________
+TString AliTender::GetCDBSnapshotName(Int_t run) const
+{
+// Name of the OCDB snapshot of a run in the cache directory. The name contains
+// a hash of the storages (default and specific ones, as set by the supplies)
+// and of the supplies, so that jobs with a different tender configuration
+// never share snapshots.
+   TString key = fDefaultStorage;
+   AliCDBManager *cdb = fCDB ? fCDB : AliCDBManager::Instance();
+   if (cdb->GetStorageMap()) {
+      TObjArray entries;
+      entries.SetOwner();
+      TIter nextStorage(cdb->GetStorageMap());
+      TObject *calibType;
+      while ((calibType=nextStorage())) {
+         TObject *uri = cdb->GetStorageMap()->GetValue(calibType);
+         entries.Add(new TObjString(TString::Format("%s=%s", calibType->GetName(), uri ? uri->GetName() : "")));
+      }
+      entries.Sort();
+      for (Int_t i=0; i<entries.GetEntriesFast(); i++) key += TString::Format(";%s", entries.At(i)->GetName());
+   }
+   TIter nextSupply(fSupplies);
+   TObject *supply;
+   while ((supply=nextSupply())) key += TString::Format(";%s/%s", supply->ClassName(), supply->GetName());
+   TMD5 md5;
+   md5.Update((const UChar_t*)key.Data(), key.Length());
+   md5.Final();
+   TString dir = fCDBSnapshotDir;
+   gSystem->ExpandPathName(dir);
+   return TString::Format("%s/OCDB_%s_%09d.root", dir.Data(), md5.AsString(), run);
+}
+
+//______________________________________________________________________________
+void AliTender::SwitchCDBSnapshot()
+{
+// Read the OCDB objects of the current run from its snapshot, if a previous
+// job wrote one, otherwise write it once the supplies have loaded them.
+// Called with the CDB manager unlocked, after the run was set.
+   fCDBSnapshotPending = kFALSE;
+   if (fCDBSnapshotDir.IsNull() || !fRun) return;
+   if (!fCDBSnapshot.IsNull()) {
+      fCDB->UnsetSnapshotMode();
+      fCDBSnapshot = "";
+   }
+   TString name = GetCDBSnapshotName(fRun);
+   if (!gSystem->AccessPathName(name, kReadPermission)) {
+      if (fCDB->SetSnapshotMode(name)) {
+         fCDBSnapshot = name;
+         Info("SwitchCDBSnapshot", "Reading OCDB objects for run %d from snapshot %s", fRun, name.Data());
+         return;
+      }
+      Warning("SwitchCDBSnapshot", "Cannot use OCDB snapshot %s", name.Data());
+   }
+   fCDBSnapshotPending = kTRUE;
+   fCDBSnapshotRun = 0;
+}
+
+//______________________________________________________________________________
+void AliTender::WriteCDBSnapshot()
+{
+// Dump the OCDB objects loaded during the run of the pending snapshot (before
+// the CDB manager moves to the next run) to the snapshot cache.
+// The snapshot is written to a temporary file which is then renamed, so that
+// other jobs on the same node never read an incomplete snapshot.
+   fCDBSnapshotPending = kFALSE;
+   if (!fCDBSnapshotRun) return;
+   TString dir = fCDBSnapshotDir;
+   gSystem->ExpandPathName(dir);
+   gSystem->mkdir(dir, kTRUE);
+   TString name = GetCDBSnapshotName(fCDBSnapshotRun);
+   TString tmp = TString::Format("%s.%d.tmp", name.Data(), gSystem->GetPid());
+   fCDB->DumpToSnapshotFile(tmp, kFALSE);
+   if (gSystem->AccessPathName(tmp, kFileExists)) {
+      Warning("WriteCDBSnapshot", "Could not write OCDB snapshot %s", tmp.Data());
+      return;
+   }
+   if (gSystem->Rename(tmp, name)) {
+      Warning("WriteCDBSnapshot", "Could not move OCDB snapshot to %s", name.Data());
+      gSystem->Unlink(tmp);
+      return;
+   }
+   Info("WriteCDBSnapshot", "OCDB objects for run %d written to snapshot %s", fCDBSnapshotRun, name.Data());
+}
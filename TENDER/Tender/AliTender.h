@@ -43,9 +43,20 @@ private:
   AliESDEvent              *fESD;            //! Pointer to current ESD event
   TObjArray                *fSupplies;       // Array of tender supplies
   TObjArray                *fCDBSettings;    // Array with CDB configuration
+  TString                   fCDBSnapshotDir; // Directory of the per-run OCDB snapshot cache
+  TString                   fCDBSnapshot;    //! Snapshot file in use for the current run
+  Bool_t                    fCDBSnapshotPending; //! Snapshot of the current run to be written
+  Int_t                     fCDBSnapshotRun; //! Run of the pending snapshot
   
   AliTender(const AliTender &other);
   AliTender& operator=(const AliTender &other);
+  void                      SwitchCDBSnapshot();
+  void                      WriteCDBSnapshot();
+
+protected:
+  TString                   GetCDBSnapshotName(Int_t run) const;
+  void                      SetCDBRun(Int_t run);
+  void                      SetCDBRunProcessed() { if (fCDBSnapshotPending) fCDBSnapshotRun = fRun; }
 
 public:  
   AliTender();
@@ -67,6 +78,17 @@ public:
    * @param[in] doHandle If true, then the tender handles also the OCDB connection, otherwise not
    */
   void 			    SetHandleOCDB(Bool_t doHandle) { fHandleCDB = doHandle; }
+  /**
+   * Keep a snapshot of the OCDB objects used in each run in a local directory
+   * (e.g. on the node scratch disk), shared by all the jobs using it. When
+   * the run changes, the objects are read from the snapshot of the run if a
+   * previous job wrote it, otherwise the objects loaded during the run are
+   * written to the snapshot at the end of the run. Snapshots are only shared
+   * between jobs with the same storages (default and specific) and the same
+   * supplies. Only used when the tender handles the OCDB.
+   * @param[in] dir Directory of the snapshots, empty to switch off
+   */
+  void                      SetCDBSnapshotCache(const char *dir) { fCDBSnapshotDir = dir; }
   void SetESDhandler(AliESDInputHandler*esdH) {fESDhandler = esdH;}
 
   // Run control
@@ -74,7 +96,8 @@ public:
   virtual void              UserCreateOutputObjects();
 //  virtual Bool_t            Notify() {return kTRUE;}
   virtual void              UserExec(Option_t *option);
+  virtual void              FinishTaskOutput();
     
-  ClassDef(AliTender,4)  // Class describing the tender car for ESD analysis
+  ClassDef(AliTender,5)  // Class describing the tender car for ESD analysis
 };
 #endif